@@ -41,6 +41,8 @@ public:
         emitterRef->setSoftening(gpuParams.softening);
         emitterRef->setDamping(gpuParams.damping);
         emitterRef->setSolverSubsteps(gpuParams.solverSubsteps);
+        emitterRef->setGravitySolver(vkengine::ParticleGravitySolver::BarnesHut);
+        emitterRef->setOpeningAngle(0.6f);
         emitterRef->setLifetimeRange(1.0e6f, 1.0e6f);
 
         // Seed particles after warm-start in update().
@@ -71,10 +73,11 @@ private:
             return;
         }
         auto& particles = emitterRef->particles();
-        const std::size_t count = std::min(totalParticles, particles.size());
+        const std::size_t count = std::min(totalParticles, particles.capacity());
         if (count == 0) {
             return;
         }
+        particles.clear();
 
         std::uniform_real_distribution<float> radialDist(0.0f, 1.0f);
         std::uniform_real_distribution<float> verticalDist(-0.2f, 0.2f);
@@ -96,13 +99,14 @@ private:
             glm::vec3 velocity = tangential * orbitalSpeed;
             velocity.y += jitterDist(rng) * 0.15f;
 
-            auto& particle = particles[i];
+            vkengine::Particle particle{};
             particle.position = seed;
             particle.velocity = velocity;
             particle.mass = mass;
             particle.scale = glm::mix(0.03f, 0.12f, (mass - 0.4f) / 1.2f);
             particle.age = 0.0f;
             particle.lifetime = maxLifetime;
+            particles.push(particle);
         }
     }
 
@@ -118,7 +122,7 @@ private:
 
 int main(int argc, char** argv)
 try {
-    constexpr std::size_t PARTICLE_COUNT = 2000;
+    constexpr std::size_t PARTICLE_COUNT = 20000;
 
     NBodyEngine engine;
 
@@ -1,61 +1,126 @@
 #pragma once
 
+#include "engine/JobScheduler.hpp"
+
 #include <algorithm>
-#include <atomic>
 #include <cstddef>
-#include <thread>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 namespace core {
 
+// Data-parallel loops on top of the engine JobSystem. The pool is started on first use and lives
+// for the rest of the process, so a call costs a few job submissions instead of thread creation.
+// Work is handed out in contiguous [begin, end) chunks; the calling thread helps until the loop
+// is done, which also makes nested calls from inside a job safe.
+
+// Chunks per pool thread; a few more than one so uneven chunks still balance out.
+inline constexpr std::size_t kParallelForChunksPerThread = 4;
+
+namespace detail {
+
+inline vkengine::JobSystem& parallelForPool()
+{
+    auto& jobs = vkengine::JobSystem::instance();
+    if (jobs.threadCount() == 0) {
+        jobs.initialize();
+    }
+    return jobs;
+}
+
+// Grain heuristic: never below the caller's minimum, otherwise large enough to give each pool
+// thread kParallelForChunksPerThread chunks.
+inline std::size_t parallelForGrain(std::size_t count, std::size_t minChunkSize, std::size_t threadCount)
+{
+    const std::size_t targetChunks = std::max<std::size_t>(1, threadCount * kParallelForChunksPerThread);
+    return std::max({std::size_t{1}, minChunkSize, (count + targetChunks - 1) / targetChunks});
+}
+
+} // namespace detail
+
+// Threads in the pool behind these loops, starting it if needed. Lets callers size per-thread
+// scratch buffers.
+inline std::size_t parallelThreadCount()
+{
+    return detail::parallelForPool().threadCount();
+}
+
+// Invokes func(begin, end) over disjoint ranges covering [0, count).
 template <typename Func>
-inline void parallelFor(std::size_t count, std::size_t minChunkSize, Func&& func)
+inline void parallelForRange(std::size_t count, std::size_t minChunkSize, Func&& func)
 {
     if (count == 0) {
         return;
     }
-
-    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
-    const std::size_t maxThreads = hardwareThreads == 0 ? 1u : static_cast<std::size_t>(hardwareThreads);
-
-    if (maxThreads <= 1 || count < minChunkSize) {
-        for (std::size_t i = 0; i < count; ++i) {
-            func(i);
-        }
+    if (count <= std::max<std::size_t>(1, minChunkSize)) {
+        func(std::size_t{0}, count);
         return;
     }
 
-    const std::size_t maxUsableThreads = (count + minChunkSize - 1) / minChunkSize;
-    const std::size_t threadCount = std::min(maxThreads, std::max<std::size_t>(1, maxUsableThreads));
-
-    if (threadCount <= 1) {
-        for (std::size_t i = 0; i < count; ++i) {
-            func(i);
-        }
+    auto& jobs = detail::parallelForPool();
+    const std::size_t grain = detail::parallelForGrain(count, minChunkSize, jobs.threadCount());
+    const std::size_t chunkCount = (count + grain - 1) / grain;
+    if (chunkCount <= 1) {
+        func(std::size_t{0}, count);
         return;
     }
 
-    std::atomic_size_t index{0};
-    auto worker = [&]() {
-        while (true) {
-            const std::size_t i = index.fetch_add(1, std::memory_order_relaxed);
-            if (i >= count) {
-                break;
-            }
+    auto done = jobs.parallelFor(chunkCount, 1, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * grain;
+        func(begin, std::min(count, begin + grain));
+    });
+    jobs.wait(done);
+}
+
+// Invokes func(i) for every i in [0, count).
+template <typename Func>
+inline void parallelFor(std::size_t count, std::size_t minChunkSize, Func&& func)
+{
+    parallelForRange(count, minChunkSize, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
             func(i);
         }
+    });
+}
+
+// Folds func(accumulator, i) over [0, count) with one accumulator per pool thread, then merges
+// the accumulators with combine(lhs, rhs). Each chunk folds into its own value and merges it once
+// it is done, so a func that waits on nested parallel work (and may run another chunk of this
+// reduce on the same worker meanwhile) does not interleave with it. Threads outside the pool that
+// help with the loop share a single locked accumulator.
+template <typename T, typename Func, typename Combine>
+inline T parallelReduce(std::size_t count, std::size_t minChunkSize, T identity, Func&& func, Combine&& combine)
+{
+    struct alignas(64) Partial {
+        T value;
     };
 
-    std::vector<std::thread> threads;
-    threads.reserve(threadCount - 1);
-    for (std::size_t t = 0; t + 1 < threadCount; ++t) {
-        threads.emplace_back(worker);
-    }
-    worker();
+    auto& jobs = detail::parallelForPool();
+    const std::size_t workerCount = jobs.threadCount();
+    std::vector<Partial> partials(workerCount + 1, Partial{identity});
+    std::mutex externalMutex;
+
+    parallelForRange(count, minChunkSize, [&](std::size_t begin, std::size_t end) {
+        T local = identity;
+        for (std::size_t i = begin; i < end; ++i) {
+            func(local, i);
+        }
+
+        const std::size_t worker = jobs.currentWorkerIndex();
+        if (worker != vkengine::JobSystem::kNotAWorker && worker < workerCount) {
+            partials[worker].value = combine(std::move(partials[worker].value), std::move(local));
+            return;
+        }
+        std::lock_guard<std::mutex> lock(externalMutex);
+        partials[workerCount].value = combine(std::move(partials[workerCount].value), std::move(local));
+    });
 
-    for (auto& thread : threads) {
-        thread.join();
+    T result = std::move(identity);
+    for (auto& partial : partials) {
+        result = combine(std::move(result), std::move(partial.value));
     }
+    return result;
 }
 
 } // namespace core
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VKENGINE_SIMD_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VKENGINE_SIMD_SSE2 1
+#endif
+
+namespace core::simd {
+
+// Lane types for data-parallel kernels: a kernel written against these is instantiated for one
+// float, four (SSE2) and eight (AVX2) floats at a time. AVX2 is only enabled when the build
+// targets it (ENABLE_AVX2); SSE2 is the x86-64 baseline.
+struct ScalarLanes {
+    using Float = float;
+    using Mask = bool;
+    static constexpr std::size_t kWidth = 1;
+
+    static Float load(const float* p) { return *p; }
+    static void store(float* p, Float v) { *p = v; }
+    static Float set1(float v) { return v; }
+    static Float add(Float a, Float b) { return a + b; }
+    static Float sub(Float a, Float b) { return a - b; }
+    static Float mul(Float a, Float b) { return a * b; }
+    static Float div(Float a, Float b) { return a / b; }
+    static Float min(Float a, Float b) { return std::min(a, b); }
+    static Float max(Float a, Float b) { return std::max(a, b); }
+    static Float sqrt(Float a) { return std::sqrt(a); }
+    static Mask greater(Float a, Float b) { return a > b; }
+    static Float select(Mask m, Float a, Float b) { return m ? a : b; }
+};
+
+#if defined(VKENGINE_SIMD_SSE2)
+struct SseLanes {
+    using Float = __m128;
+    using Mask = __m128;
+    static constexpr std::size_t kWidth = 4;
+
+    static Float load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, Float v) { _mm_storeu_ps(p, v); }
+    static Float set1(float v) { return _mm_set1_ps(v); }
+    static Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+    static Float div(Float a, Float b) { return _mm_div_ps(a, b); }
+    static Float min(Float a, Float b) { return _mm_min_ps(a, b); }
+    static Float max(Float a, Float b) { return _mm_max_ps(a, b); }
+    static Float sqrt(Float a) { return _mm_sqrt_ps(a); }
+    static Mask greater(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+    static Float select(Mask m, Float a, Float b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+};
+#endif
+
+#if defined(VKENGINE_SIMD_AVX2)
+struct AvxLanes {
+    using Float = __m256;
+    using Mask = __m256;
+    static constexpr std::size_t kWidth = 8;
+
+    static Float load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, Float v) { _mm256_storeu_ps(p, v); }
+    static Float set1(float v) { return _mm256_set1_ps(v); }
+    static Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+    static Float div(Float a, Float b) { return _mm256_div_ps(a, b); }
+    static Float min(Float a, Float b) { return _mm256_min_ps(a, b); }
+    static Float max(Float a, Float b) { return _mm256_max_ps(a, b); }
+    static Float sqrt(Float a) { return _mm256_sqrt_ps(a); }
+    static Mask greater(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Float select(Mask m, Float a, Float b) { return _mm256_blendv_ps(b, a, m); }
+};
+#endif
+
+// Widest lane type of this build.
+#if defined(VKENGINE_SIMD_AVX2)
+using WidestLanes = AvxLanes;
+#elif defined(VKENGINE_SIMD_SSE2)
+using WidestLanes = SseLanes;
+#else
+using WidestLanes = ScalarLanes;
+#endif
+
+} // namespace core::simd
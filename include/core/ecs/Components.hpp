@@ -44,6 +44,13 @@ struct Transform {
     [[nodiscard]] glm::mat4 matrix() const;
 };
 
+// Kept by GameEngine for simulated objects: the transform before the last fixed tick and the
+// blend between it and the live transform, which is what modelMatrix() draws.
+struct InterpolatedTransform {
+    Transform previous;
+    Transform render;
+};
+
 struct PhysicsProperties {
     bool simulate{false};
     float mass{1.0f};
@@ -58,7 +65,16 @@ struct PhysicsProperties {
     float restitution{0.25f};
     float staticFriction{0.6f};
     float dynamicFriction{0.5f};
-
+    // Set by the physics system once the body's island has been at rest long enough; sleeping
+    // bodies are neither integrated nor solved until something wakes them.
+    bool sleeping{false};
+    float sleepTime{0.0f};
+
+    void wake()
+    {
+        sleeping = false;
+        sleepTime = 0.0f;
+    }
     void addForce(const glm::vec3& force) { accumulatedForces += force; }
     void clearForces() { accumulatedForces = glm::vec3(0.0f); }
     void addTorque(const glm::vec3& torque) { accumulatedTorque += torque; }
@@ -4,14 +4,32 @@
 
 namespace core::ecs {
 
+// An entity id packs a slot index (low bits) and a generation (high bits). Destroying an entity
+// bumps the generation of its slot, so handles kept past destruction stop comparing equal to the
+// recycled slot and are rejected by `Registry::contains`. Index 0 is reserved for the null entity.
 using EntityId = std::uint32_t;
 
+constexpr std::uint32_t kEntityIndexBits = 20;
+constexpr std::uint32_t kEntityGenerationBits = 32 - kEntityIndexBits;
+constexpr EntityId kEntityIndexMask = (EntityId{1} << kEntityIndexBits) - 1;
+constexpr EntityId kEntityGenerationMask = (EntityId{1} << kEntityGenerationBits) - 1;
+
+[[nodiscard]] constexpr std::uint32_t entityIndex(EntityId id) noexcept { return id & kEntityIndexMask; }
+[[nodiscard]] constexpr std::uint32_t entityGeneration(EntityId id) noexcept { return id >> kEntityIndexBits; }
+[[nodiscard]] constexpr EntityId makeEntityId(std::uint32_t index, std::uint32_t generation) noexcept
+{
+    return ((generation & kEntityGenerationMask) << kEntityIndexBits) | (index & kEntityIndexMask);
+}
+
 struct Entity {
     EntityId id{0};
 
     [[nodiscard]] constexpr bool valid() const noexcept { return id != 0; }
     explicit constexpr operator bool() const noexcept { return valid(); }
 
+    [[nodiscard]] constexpr std::uint32_t index() const noexcept { return entityIndex(id); }
+    [[nodiscard]] constexpr std::uint32_t generation() const noexcept { return entityGeneration(id); }
+
     friend constexpr bool operator==(Entity lhs, Entity rhs) noexcept { return lhs.id == rhs.id; }
     friend constexpr bool operator!=(Entity lhs, Entity rhs) noexcept { return !(lhs == rhs); }
 };
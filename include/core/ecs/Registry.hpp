@@ -1,11 +1,20 @@
 #pragma once
 
 #include "core/ecs/Entity.hpp"
+#include "engine/JobScheduler.hpp"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <map>
 #include <mutex>
 #include <memory>
+#include <new>
+#include <tuple>
 #include <typeindex>
 #include <typeinfo>
 #include <unordered_map>
@@ -16,28 +25,84 @@
 
 namespace core::ecs {
 
+// Threading model: reads (`has`, `get`, `tryGet`, `view`, `contains`) take no lock and may run
+// concurrently from any number of threads as long as no structural change (entity create/destroy,
+// component emplace/remove) happens at the same time. Structural changes made directly on the
+// registry serialize on `registryMutex` and belong on the owning thread between system phases.
+// Systems running on worker threads record structural changes into their per-thread
+// `CommandBuffer` (see `deferred()`) and the owner applies them at a sync point with
+// `flushDeferred()`.
 class Registry {
 public:
+    class CommandBuffer {
+    public:
+        // Reserves an entity slot immediately (briefly taking `registryMutex`) so that components
+        // can be queued for it, from this or any other buffer; the entity only becomes visible to
+        // `contains`/`entities` once the buffers are flushed.
+        Entity createEntity();
+        void destroyEntity(Entity entity);
+
+        template <typename Component, typename... Args>
+        void emplace(Entity entity, Args&&... args)
+        {
+            commands.push_back([entity, values = std::make_tuple(std::forward<Args>(args)...)](Registry& registry) mutable {
+                std::apply([&](auto&&... unpacked) {
+                    registry.emplace<Component>(entity, std::forward<decltype(unpacked)>(unpacked)...);
+                }, std::move(values));
+            });
+        }
+
+        template <typename Component>
+        void remove(Entity entity)
+        {
+            commands.push_back([entity](Registry& registry) { registry.remove<Component>(entity); });
+        }
+
+        [[nodiscard]] bool empty() const noexcept { return commands.empty() && createdEntities.empty(); }
+        [[nodiscard]] std::size_t size() const noexcept { return commands.size() + createdEntities.size(); }
+
+    private:
+        friend class Registry;
+        explicit CommandBuffer(Registry& owner) noexcept : ownerRegistry(&owner) {}
+
+        Registry* ownerRegistry{nullptr};
+        std::vector<Entity> createdEntities;
+        std::vector<std::function<void(Registry&)>> commands;
+    };
+
     Registry() = default;
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
 
     Entity createEntity();
     void destroyEntity(Entity entity);
 
     void clear();
 
+    // Returns the calling thread's command buffer for this registry. Recording is lock-free; the
+    // buffer is created (under `registryMutex`) the first time a thread asks for it.
+    CommandBuffer& deferred();
+
+    // Activates the entities created through every buffer, then applies each buffer's other
+    // commands in thread-registration order. Must be called from the owning thread while no worker
+    // is recording.
+    void flushDeferred();
+
     [[nodiscard]] const std::vector<EntityId>& entities() const noexcept { return activeEntities; }
     [[nodiscard]] bool contains(Entity entity) const noexcept
     {
-        if (!entity) {
-            return false;
-        }
-        return std::find(activeEntities.begin(), activeEntities.end(), entity.id) != activeEntities.end();
+        const std::uint32_t index = entity.index();
+        return index != 0 && index < entitySlots.size() && entitySlots[index].generation == entity.generation()
+            && entitySlots[index].activeSlot != kInvalidSlot;
     }
 
     template <typename Component, typename... Args>
     Component& emplace(Entity entity, Args&&... args)
     {
         std::scoped_lock lock(registryMutex);
+        if (!contains(entity)) {
+            throw std::runtime_error("Cannot add a component to an entity that is not alive");
+        }
         auto& pool = poolFor<Component>();
         return pool.emplace(entity.id, std::forward<Args>(args)...);
     }
@@ -45,7 +110,6 @@ public:
     template <typename Component>
     bool has(Entity entity) const noexcept
     {
-        std::scoped_lock lock(registryMutex);
         const auto* pool = findPool<Component>();
         if (!pool) {
             return false;
@@ -56,7 +120,6 @@ public:
     template <typename Component>
     Component& get(Entity entity)
     {
-        std::scoped_lock lock(registryMutex);
         auto* pool = findPool<Component>();
         if (!pool) {
             throw std::runtime_error("Component not present on entity");
@@ -67,7 +130,6 @@ public:
     template <typename Component>
     const Component& get(Entity entity) const
     {
-        std::scoped_lock lock(registryMutex);
         const auto* pool = findPool<Component>();
         if (!pool) {
             throw std::runtime_error("Component not present on entity");
@@ -78,7 +140,6 @@ public:
     template <typename Component>
     Component* tryGet(Entity entity) noexcept
     {
-        std::scoped_lock lock(registryMutex);
         auto* pool = findPool<Component>();
         if (!pool) {
             return nullptr;
@@ -89,7 +150,6 @@ public:
     template <typename Component>
     const Component* tryGet(Entity entity) const noexcept
     {
-        std::scoped_lock lock(registryMutex);
         const auto* pool = findPool<Component>();
         if (!pool) {
             return nullptr;
@@ -118,95 +178,283 @@ public:
         return emplace<Component>(entity, std::forward<Args>(args)...);
     }
 
+    // Iterates every entity that owns all of `Components`, driven by the smallest matching pool
+    // so that the cost is proportional to the rarest component rather than to the entity count.
+    // Components added from inside the callback are not visited; removing the current entity's
+    // driving component from inside the callback skips the entity swapped into its slot.
     template <typename... Components, typename Func>
     void view(Func&& func)
     {
-        std::scoped_lock lock(registryMutex);
-        for (EntityId id : activeEntities) {
-            const Entity entity{id};
-            if (((has<Components>(entity)) && ...)) {
-                func(entity, get<Components>(entity)...);
+        forDrivingPool<Components...>([&](auto& viewPools, auto* drivingPool) {
+            const std::size_t count = drivingPool->size();
+            for (std::size_t slot = 0; slot < count && slot < drivingPool->size(); ++slot) {
+                visitSlot(viewPools, drivingPool, slot, func);
             }
+        });
+    }
+
+    // Parallel counterpart of `view`: splits the driving pool into chunks of roughly
+    // `kParallelViewChunkBytes` of component data (or `chunkSize` entities when given) and runs
+    // them on `vkengine::JobSystem` workers, returning once every chunk has finished. The callback
+    // runs concurrently and must not make structural changes directly; record them through
+    // `deferred()` instead. Runs serially when the job system has no workers or the set is small.
+    template <typename... Components, typename Func>
+    void parallelView(Func&& func, std::size_t chunkSize = 0)
+    {
+        if (chunkSize == 0) {
+            chunkSize = std::max<std::size_t>(64, kParallelViewChunkBytes / (sizeof(EntityId) + (sizeof(Components) + ...)));
         }
+
+        forDrivingPool<Components...>([&](auto& viewPools, auto* drivingPool) {
+            const std::size_t count = drivingPool->size();
+            auto& jobs = vkengine::JobSystem::instance();
+            if (jobs.threadCount() == 0 || count <= chunkSize) {
+                for (std::size_t slot = 0; slot < count; ++slot) {
+                    visitSlot(viewPools, drivingPool, slot, func);
+                }
+                return;
+            }
+
+            const std::size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+            auto done = jobs.parallelFor(chunkCount, 1, [&](std::size_t chunk) {
+                const std::size_t end = std::min(count, (chunk + 1) * chunkSize);
+                for (std::size_t slot = chunk * chunkSize; slot < end; ++slot) {
+                    visitSlot(viewPools, drivingPool, slot, func);
+                }
+            });
+            jobs.wait(done);
+        });
     }
 
 private:
+    static constexpr std::size_t kParallelViewChunkBytes = 32 * 1024;
+
+    // Resolves the pools for `Components` and hands the smallest one to `visitor` together with
+    // the full pool tuple. Does nothing when any of the pools does not exist yet.
+    template <typename... Components, typename Visitor>
+    void forDrivingPool(Visitor&& visitor)
+    {
+        std::tuple<ComponentPool<Components>*...> viewPools{findPool<Components>()...};
+        if (((std::get<ComponentPool<Components>*>(viewPools) == nullptr) || ...)) {
+            return;
+        }
+
+        const IComponentPool* driver = nullptr;
+        ((driver = (driver == nullptr || std::get<ComponentPool<Components>*>(viewPools)->size() < driver->size())
+                       ? std::get<ComponentPool<Components>*>(viewPools)
+                       : driver),
+         ...);
+
+        ((driver == std::get<ComponentPool<Components>*>(viewPools)
+              ? visitor(viewPools, std::get<ComponentPool<Components>*>(viewPools))
+              : void()),
+         ...);
+    }
+
+    template <typename... Pools, typename DrivingPool, typename Func>
+    static void visitSlot(std::tuple<Pools*...>& viewPools, DrivingPool* drivingPool, std::size_t slot, Func& func)
+    {
+        const EntityId id = drivingPool->entityAt(slot);
+        if (!(std::get<Pools*>(viewPools)->contains(id) && ...)) {
+            return;
+        }
+        func(Entity{id}, std::get<Pools*>(viewPools)->get(id)...);
+    }
+
+    static constexpr std::uint32_t kInvalidSlot = std::numeric_limits<std::uint32_t>::max();
+
+    struct EntitySlot {
+        std::uint32_t generation{0};
+        std::uint32_t activeSlot{kInvalidSlot};
+    };
+
+    // Entity slots live in fixed-size pages that never move, and the page directory covers the
+    // whole index space up front. A command buffer can then append a slot on a worker thread
+    // while other threads read `contains()` lock-free: a slot only becomes readable once the
+    // release store of `count` publishes it. Appends happen under `registryMutex`.
+    class EntitySlotTable {
+    public:
+        static constexpr std::size_t kPageSize = 4096;
+        static constexpr std::size_t kPageCount = (static_cast<std::size_t>(kEntityIndexMask) + kPageSize) / kPageSize;
+
+        EntitySlotTable() = default;
+        EntitySlotTable(const EntitySlotTable&) = delete;
+        EntitySlotTable& operator=(const EntitySlotTable&) = delete;
+
+        ~EntitySlotTable()
+        {
+            for (auto& page : pages) {
+                delete[] page.load(std::memory_order_relaxed);
+            }
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return count.load(std::memory_order_acquire); }
+        [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+        EntitySlot& operator[](std::size_t index) noexcept
+        {
+            return pages[index / kPageSize].load(std::memory_order_relaxed)[index % kPageSize];
+        }
+        const EntitySlot& operator[](std::size_t index) const noexcept
+        {
+            return pages[index / kPageSize].load(std::memory_order_relaxed)[index % kPageSize];
+        }
+
+        void emplaceBack()
+        {
+            const std::size_t index = count.load(std::memory_order_relaxed);
+            auto& page = pages[index / kPageSize];
+            if (page.load(std::memory_order_relaxed) == nullptr) {
+                page.store(new EntitySlot[kPageSize], std::memory_order_relaxed);
+            }
+            (*this)[index] = EntitySlot{};
+            count.store(index + 1, std::memory_order_release);
+        }
+
+    private:
+        std::array<std::atomic<EntitySlot*>, kPageCount> pages{};
+        std::atomic<std::size_t> count{0};
+    };
+
     struct IComponentPool {
         virtual ~IComponentPool() = default;
         virtual void remove(EntityId entity) = 0;
         virtual void clear() = 0;
+        [[nodiscard]] virtual std::size_t size() const noexcept = 0;
+        [[nodiscard]] virtual bool contains(EntityId entity) const noexcept = 0;
     };
 
+    // Sparse-set pool: `sparse` maps an entity index to its slot in the packed arrays, `packed`
+    // holds the owning entity of every slot and the components live in fixed-size pages so
+    // that growing the pool never moves existing components. Removal swaps the last slot in.
+    // Lookups compare the full packed id, so a stale handle never sees a recycled slot's data.
     template <typename Component>
     struct ComponentPool final : IComponentPool {
-        Component& emplace(EntityId entity, Component&& value)
+        static constexpr std::size_t kPageSize = std::max<std::size_t>(1, 16384 / sizeof(Component));
+
+        ComponentPool() = default;
+        ComponentPool(const ComponentPool&) = delete;
+        ComponentPool& operator=(const ComponentPool&) = delete;
+
+        ~ComponentPool() override
         {
-            auto [it, _] = components.emplace(entity, std::move(value));
-            return it->second;
+            clear();
+            for (Component* page : pages) {
+                allocator.deallocate(page, kPageSize);
+            }
         }
 
         template <typename... Args>
         Component& emplace(EntityId entity, Args&&... args)
         {
-            auto [it, inserted] = components.try_emplace(entity, std::forward<Args>(args)...);
-            if (!inserted) {
-                it->second = Component(std::forward<Args>(args)...);
+            if (Component* existing = tryGet(entity)) {
+                *existing = Component(std::forward<Args>(args)...);
+                return *existing;
+            }
+
+            const std::size_t slot = packed.size();
+            if (slot == pages.size() * kPageSize) {
+                pages.push_back(allocator.allocate(kPageSize));
+            }
+            Component* storage = slotAddress(slot);
+            ::new (static_cast<void*>(storage)) Component(std::forward<Args>(args)...);
+
+            const std::uint32_t index = entityIndex(entity);
+            if (index >= sparse.size()) {
+                sparse.resize(static_cast<std::size_t>(index) + 1, kInvalidSlot);
             }
-            return it->second;
+            sparse[index] = static_cast<std::uint32_t>(slot);
+            packed.push_back(entity);
+            return *storage;
         }
 
-        bool contains(EntityId entity) const noexcept
+        [[nodiscard]] bool contains(EntityId entity) const noexcept override
         {
-            return components.find(entity) != components.end();
+            return slotOf(entity) != kInvalidSlot;
         }
 
         Component& get(EntityId entity)
         {
-            auto it = components.find(entity);
-            if (it == components.end()) {
+            const std::uint32_t slot = slotOf(entity);
+            if (slot == kInvalidSlot) {
                 throw std::runtime_error("Component missing on entity");
             }
-            return it->second;
+            return *slotAddress(slot);
         }
 
         const Component& get(EntityId entity) const
         {
-            auto it = components.find(entity);
-            if (it == components.end()) {
+            const std::uint32_t slot = slotOf(entity);
+            if (slot == kInvalidSlot) {
                 throw std::runtime_error("Component missing on entity");
             }
-            return it->second;
+            return *slotAddress(slot);
         }
 
         Component* tryGet(EntityId entity) noexcept
         {
-            auto it = components.find(entity);
-            if (it == components.end()) {
-                return nullptr;
-            }
-            return &it->second;
+            const std::uint32_t slot = slotOf(entity);
+            return slot == kInvalidSlot ? nullptr : slotAddress(slot);
         }
 
         const Component* tryGet(EntityId entity) const noexcept
         {
-            auto it = components.find(entity);
-            if (it == components.end()) {
-                return nullptr;
-            }
-            return &it->second;
+            const std::uint32_t slot = slotOf(entity);
+            return slot == kInvalidSlot ? nullptr : slotAddress(slot);
         }
 
+        // Unchecked access to the i-th packed component, used by views.
+        [[nodiscard]] Component& at(std::size_t slot) noexcept { return *slotAddress(slot); }
+        [[nodiscard]] EntityId entityAt(std::size_t slot) const noexcept { return packed[slot]; }
+
         void remove(EntityId entity) override
         {
-            components.erase(entity);
+            const std::uint32_t slot = slotOf(entity);
+            if (slot == kInvalidSlot) {
+                return;
+            }
+            const std::size_t last = packed.size() - 1;
+            if (slot != last) {
+                *slotAddress(slot) = std::move(*slotAddress(last));
+                packed[slot] = packed[last];
+                sparse[entityIndex(packed[slot])] = slot;
+            }
+            std::destroy_at(slotAddress(last));
+            packed.pop_back();
+            sparse[entityIndex(entity)] = kInvalidSlot;
         }
 
         void clear() override
         {
-            components.clear();
+            for (std::size_t slot = 0; slot < packed.size(); ++slot) {
+                std::destroy_at(slotAddress(slot));
+            }
+            packed.clear();
+            sparse.clear();
         }
 
-    std::unordered_map<EntityId, Component> components;
+        [[nodiscard]] std::size_t size() const noexcept override { return packed.size(); }
+
+    private:
+        [[nodiscard]] std::uint32_t slotOf(EntityId entity) const noexcept
+        {
+            const std::uint32_t index = entityIndex(entity);
+            if (index >= sparse.size()) {
+                return kInvalidSlot;
+            }
+            const std::uint32_t slot = sparse[index];
+            return (slot != kInvalidSlot && packed[slot] == entity) ? slot : kInvalidSlot;
+        }
+
+        [[nodiscard]] Component* slotAddress(std::size_t slot) const noexcept
+        {
+            return pages[slot / kPageSize] + (slot % kPageSize);
+        }
+
+        std::vector<std::uint32_t> sparse;
+        std::vector<EntityId> packed;
+        std::vector<Component*> pages;
+        std::allocator<Component> allocator;
     };
 
     template <typename Component>
@@ -243,31 +491,132 @@ private:
         return *static_cast<ComponentPool<Component>*>(it->second.get());
     }
 
+    static std::uint64_t nextInstanceId() noexcept
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // Pops a recycled slot (or appends a new one) and returns its current handle without
+    // activating it. Caller holds `registryMutex`.
+    Entity reserveEntity()
+    {
+        std::uint32_t index = 0;
+        if (!freeIndices.empty()) {
+            index = freeIndices.back();
+            freeIndices.pop_back();
+        } else {
+            if (entitySlots.empty()) {
+                entitySlots.emplaceBack();
+            }
+            if (entitySlots.size() > kEntityIndexMask) {
+                throw std::runtime_error("Entity index space exhausted");
+            }
+            index = static_cast<std::uint32_t>(entitySlots.size());
+            entitySlots.emplaceBack();
+        }
+        return Entity{makeEntityId(index, entitySlots[index].generation)};
+    }
+
+    void activateEntity(Entity entity)
+    {
+        entitySlots[entity.index()].activeSlot = static_cast<std::uint32_t>(activeEntities.size());
+        activeEntities.push_back(entity.id);
+    }
+
 private:
-    EntityId nextEntity{1};
+    // `activeEntities` is the dense list of live ids; `entitySlots` is the sparse side indexed by
+    // entity index, holding the current generation and the position in `activeEntities`.
     std::vector<EntityId> activeEntities;
+    EntitySlotTable entitySlots;
+    std::vector<std::uint32_t> freeIndices;
     std::unordered_map<std::type_index, std::unique_ptr<IComponentPool>> pools;
+    std::vector<std::unique_ptr<CommandBuffer>> commandBuffers;
+    const std::uint64_t instanceId{nextInstanceId()};
     mutable std::recursive_mutex registryMutex;
 };
 
+inline Entity Registry::CommandBuffer::createEntity()
+{
+    Entity entity{};
+    {
+        std::scoped_lock lock(ownerRegistry->registryMutex);
+        entity = ownerRegistry->reserveEntity();
+    }
+    createdEntities.push_back(entity);
+    return entity;
+}
+
+inline void Registry::CommandBuffer::destroyEntity(Entity entity)
+{
+    commands.push_back([entity](Registry& registry) { registry.destroyEntity(entity); });
+}
+
 inline Entity Registry::createEntity()
 {
     std::scoped_lock lock(registryMutex);
-    Entity entity{nextEntity++};
-    activeEntities.push_back(entity.id);
+    const Entity entity = reserveEntity();
+    activateEntity(entity);
     return entity;
 }
 
+inline Registry::CommandBuffer& Registry::deferred()
+{
+    // Keyed by instance id rather than address so a registry reallocated at the same address
+    // never picks up a stale buffer.
+    thread_local std::unordered_map<std::uint64_t, CommandBuffer*> threadBuffers;
+    if (auto it = threadBuffers.find(instanceId); it != threadBuffers.end()) {
+        return *it->second;
+    }
+
+    std::scoped_lock lock(registryMutex);
+    commandBuffers.push_back(std::unique_ptr<CommandBuffer>(new CommandBuffer(*this)));
+    CommandBuffer* buffer = commandBuffers.back().get();
+    threadBuffers.emplace(instanceId, buffer);
+    return *buffer;
+}
+
+inline void Registry::flushDeferred()
+{
+    std::scoped_lock lock(registryMutex);
+    // Creates go first: a buffer replayed earlier may already hold commands for an entity that a
+    // later buffer reserved.
+    for (auto& buffer : commandBuffers) {
+        for (const Entity entity : buffer->createdEntities) {
+            activateEntity(entity);
+        }
+        buffer->createdEntities.clear();
+    }
+
+    std::vector<std::function<void(Registry&)>> pending;
+    for (auto& buffer : commandBuffers) {
+        pending.swap(buffer->commands);
+        for (auto& command : pending) {
+            command(*this);
+        }
+        pending.clear();
+    }
+}
+
 inline void Registry::destroyEntity(Entity entity)
 {
     std::scoped_lock lock(registryMutex);
-    if (!entity) {
+    if (!contains(entity)) {
         return;
     }
     for (auto& [_, pool] : pools) {
         pool->remove(entity.id);
     }
-    activeEntities.erase(std::remove(activeEntities.begin(), activeEntities.end(), entity.id), activeEntities.end());
+
+    auto& slot = entitySlots[entity.index()];
+    const EntityId moved = activeEntities.back();
+    activeEntities[slot.activeSlot] = moved;
+    entitySlots[entityIndex(moved)].activeSlot = slot.activeSlot;
+    activeEntities.pop_back();
+
+    slot.activeSlot = kInvalidSlot;
+    slot.generation = (slot.generation + 1) & kEntityGenerationMask;
+    freeIndices.push_back(entity.index());
 }
 
 inline void Registry::clear()
@@ -277,7 +626,20 @@ inline void Registry::clear()
     for (auto& [_, pool] : pools) {
         pool->clear();
     }
-    nextEntity = 1;
+    for (auto& buffer : commandBuffers) {
+        buffer->createdEntities.clear();
+        buffer->commands.clear();
+    }
+
+    // Retire every slot (including ones reserved by command buffers) so outstanding handles go
+    // stale, then refill the free list so the lowest indices are handed out first again.
+    freeIndices.clear();
+    for (std::size_t index = entitySlots.size(); index-- > 1;) {
+        auto& slot = entitySlots[index];
+        slot.activeSlot = kInvalidSlot;
+        slot.generation = (slot.generation + 1) & kEntityGenerationMask;
+        freeIndices.push_back(static_cast<std::uint32_t>(index));
+    }
 }
 
 } // namespace core::ecs
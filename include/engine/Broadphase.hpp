@@ -0,0 +1,166 @@
+#pragma once
+
+#include "core/ecs/Components.hpp"
+#include "core/ecs/Entity.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace vkengine {
+
+// Dynamic AABB tree (incrementally balanced bounding volume hierarchy). Leaves store "fat"
+// bounds: the tight bounds grown by a margin and by the predicted displacement, so a body only
+// has to be reinserted once it leaves its fat box instead of every time it moves.
+class DynamicAabbTree {
+public:
+    using ProxyId = std::int32_t;
+    static constexpr ProxyId kNullProxy = -1;
+
+    ProxyId createProxy(const AABB& bounds, std::uint32_t userData);
+    void destroyProxy(ProxyId proxy);
+
+    // Returns true when the proxy had to be reinserted because it left its fat bounds.
+    bool moveProxy(ProxyId proxy, const AABB& bounds, const glm::vec3& displacement);
+
+    [[nodiscard]] const AABB& fatBounds(ProxyId proxy) const { return nodes[static_cast<std::size_t>(proxy)].bounds; }
+    [[nodiscard]] std::uint32_t userData(ProxyId proxy) const { return nodes[static_cast<std::size_t>(proxy)].userData; }
+    void setUserData(ProxyId proxy, std::uint32_t value) { nodes[static_cast<std::size_t>(proxy)].userData = value; }
+
+    // Calls visitor(proxy) for every leaf whose fat bounds overlap `bounds`; stop early by
+    // returning false.
+    template<typename Visitor>
+    void query(const AABB& bounds, Visitor&& visitor) const;
+
+    [[nodiscard]] int height() const { return root == kNullProxy ? 0 : nodes[static_cast<std::size_t>(root)].height; }
+    [[nodiscard]] std::size_t proxyCount() const { return leafCount; }
+
+    static constexpr float kFatMargin = 0.1f;
+    static constexpr float kDisplacementMultiplier = 4.0f;
+
+private:
+    struct Node {
+        AABB bounds{};
+        std::int32_t parent{kNullProxy};  // Doubles as the free-list link for unused nodes.
+        std::int32_t left{kNullProxy};
+        std::int32_t right{kNullProxy};
+        std::int32_t height{-1};          // 0 for leaves, -1 for free nodes.
+        std::uint32_t userData{0};
+
+        [[nodiscard]] bool isLeaf() const { return left == kNullProxy; }
+    };
+
+    std::int32_t allocateNode();
+    void freeNode(std::int32_t node);
+    void insertLeaf(std::int32_t leaf);
+    void removeLeaf(std::int32_t leaf);
+    std::int32_t balance(std::int32_t node);
+    void refit(std::int32_t node);
+
+    std::vector<Node> nodes;
+    std::int32_t root{kNullProxy};
+    std::int32_t freeList{kNullProxy};
+    std::size_t leafCount{0};
+    mutable std::vector<std::int32_t> queryStack;
+};
+
+// Persistent collision broadphase for the physics system. Bodies are keyed by entity id and
+// synced once per step with updateBody(); only bodies that left their fat bounds touch the tree,
+// and the overlapping-pair set is carried across steps and only re-examined for those bodies.
+class Broadphase {
+public:
+    // Registers the body on first sight, otherwise refreshes its bounds. `userData` is handed
+    // back by forEachPair() (the physics system passes the object's index for this step).
+    void updateBody(core::ecs::EntityId entity, const AABB& bounds, const glm::vec3& displacement, std::uint32_t userData);
+
+    // Drops bodies that were not updated since the previous call and refreshes the pair set.
+    void finishUpdate();
+
+    void clear();
+
+    // Calls visitor(userDataA, userDataB) for every pair whose fat bounds overlap.
+    template<typename Visitor>
+    void forEachPair(Visitor&& visitor) const;
+
+    [[nodiscard]] std::size_t bodyCount() const { return tree.proxyCount(); }
+    [[nodiscard]] std::size_t pairCount() const { return pairs.size(); }
+    [[nodiscard]] std::size_t movedLastUpdate() const { return lastMovedCount; }
+    [[nodiscard]] const DynamicAabbTree& aabbTree() const { return tree; }
+
+private:
+    using ProxyId = DynamicAabbTree::ProxyId;
+
+    struct Body {
+        core::ecs::EntityId entity{0};
+        ProxyId proxy{DynamicAabbTree::kNullProxy};
+        std::uint32_t stamp{0};
+    };
+
+    void removeBody(Body& body);
+    void addPair(ProxyId a, ProxyId b);
+
+    static std::uint64_t pairKey(ProxyId a, ProxyId b);
+
+    DynamicAabbTree tree;
+    std::vector<Body> bodies;  // Indexed by entity index.
+    std::size_t liveBodies{0};
+    std::size_t touchedBodies{0};
+    std::uint32_t currentStamp{1};
+
+    std::vector<ProxyId> movedProxies;
+    std::vector<ProxyId> deadProxies;
+    std::vector<std::uint8_t> proxyFlags;  // Indexed by proxy id.
+    std::vector<std::pair<ProxyId, ProxyId>> pairs;
+    std::unordered_set<std::uint64_t> pairKeys;
+    std::size_t lastMovedCount{0};
+};
+
+// ============================================================================
+// Template Implementations
+// ============================================================================
+
+template<typename Visitor>
+void DynamicAabbTree::query(const AABB& bounds, Visitor&& visitor) const
+{
+    if (root == kNullProxy) {
+        return;
+    }
+
+    queryStack.clear();
+    queryStack.push_back(root);
+    while (!queryStack.empty()) {
+        const std::int32_t index = queryStack.back();
+        queryStack.pop_back();
+
+        const Node& node = nodes[static_cast<std::size_t>(index)];
+        const bool overlaps = node.bounds.min.x <= bounds.max.x && node.bounds.max.x >= bounds.min.x &&
+                              node.bounds.min.y <= bounds.max.y && node.bounds.max.y >= bounds.min.y &&
+                              node.bounds.min.z <= bounds.max.z && node.bounds.max.z >= bounds.min.z;
+        if (!overlaps) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            if (!visitor(index)) {
+                return;
+            }
+        } else {
+            queryStack.push_back(node.left);
+            queryStack.push_back(node.right);
+        }
+    }
+}
+
+template<typename Visitor>
+void Broadphase::forEachPair(Visitor&& visitor) const
+{
+    for (const auto& [a, b] : pairs) {
+        visitor(tree.userData(a), tree.userData(b));
+    }
+}
+
+} // namespace vkengine
@@ -3,12 +3,19 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <filesystem>
 #include <functional>
+#include <iosfwd>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -143,17 +150,18 @@ private:
 // ============================================================================
 
 struct ProfileSample {
-    std::string name;
-    std::chrono::high_resolution_clock::time_point startTime;
-    std::chrono::high_resolution_clock::time_point endTime;
+    std::uint32_t nameId{0};
+    std::string_view name;  // Interned; valid for the life of the process.
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point endTime;
     std::uint32_t depth{0};
     std::uint64_t threadId{0};
 };
 
 struct ProfileFrame {
     std::uint64_t frameNumber{0};
-    std::chrono::high_resolution_clock::time_point frameStart;
-    std::chrono::high_resolution_clock::time_point frameEnd;
+    std::chrono::steady_clock::time_point frameStart;
+    std::chrono::steady_clock::time_point frameEnd;
     std::vector<ProfileSample> samples;
     float cpuTimeMs{0.0f};
     float gpuTimeMs{0.0f};
@@ -167,18 +175,36 @@ struct ProfileStats {
     std::uint32_t callCount{0};
 };
 
+struct ProfileThreadBuffer;
+
 // ============================================================================
 // Profiler
 // ============================================================================
 
+// Scopes can be recorded from any thread. Each thread writes completed scopes (name id, begin and
+// end timestamps, depth) into its own single-producer ring, so recording takes no lock and never
+// allocates; a full ring drops the scope and counts it. collect() drains the rings into the
+// current frame and the per-scope statistics, and endFrame() calls it. Frame control, collect()
+// and the queries belong to one thread (normally the main loop).
 class Profiler {
 public:
     static Profiler& instance();
 
     void beginFrame();
     void endFrame();
+    void collect();
+
+    // Returns a stable id for `name`; equal names share an id. PROFILE_SCOPE interns once per call
+    // site, so recording a scope never touches the string.
+    [[nodiscard]] std::uint32_t internName(std::string_view name);
+    [[nodiscard]] std::string_view nameOf(std::uint32_t nameId) const;
 
-    void beginSample(const std::string& name);
+    // Low-level scope recording used by ProfileScope. beginScope() returns 0 while disabled.
+    [[nodiscard]] static std::uint64_t beginScope() noexcept;
+    static void endScope(std::uint32_t nameId, std::uint64_t startTicks) noexcept;
+
+    // Stack-based API for call sites that cannot use PROFILE_SCOPE; interns on every call.
+    void beginSample(std::string_view name);
     void endSample();
 
     // GPU timing (requires Vulkan timestamp queries)
@@ -188,58 +214,136 @@ public:
     // Statistics
     [[nodiscard]] const ProfileFrame& currentFrame() const;
     [[nodiscard]] const ProfileFrame& previousFrame() const;
-    [[nodiscard]] ProfileStats getStats(const std::string& name) const;
+    // Per-call min/max/avg and the most recent call over the retained frames.
+    [[nodiscard]] ProfileStats getStats(std::string_view name) const;
+    [[nodiscard]] std::uint64_t droppedSamples() const;
     [[nodiscard]] float fps() const { return currentFps; }
     [[nodiscard]] float frameTime() const { return 1000.0f / currentFps; }
     [[nodiscard]] float cpuTime() const { return cpuFrameTime; }
     [[nodiscard]] float gpuTime() const { return gpuFrameTime; }
 
     // History for graphs
-    [[nodiscard]] const std::vector<float>& frameTimeHistory() const { return frameTimeHistoryBuffer; }
+    // Oldest first, at most historySize frames.
+    [[nodiscard]] std::vector<float> frameTimeHistory() const;
     [[nodiscard]] const std::vector<float>& cpuTimeHistory() const { return cpuTimeHistoryBuffer; }
     [[nodiscard]] const std::vector<float>& gpuTimeHistory() const { return gpuTimeHistoryBuffer; }
 
-    void setEnabled(bool enabled) { profilerEnabled = enabled; }
-    [[nodiscard]] bool isEnabled() const { return profilerEnabled; }
+    void setEnabled(bool enabled) { profilerEnabled.store(enabled, std::memory_order_relaxed); }
+    [[nodiscard]] bool isEnabled() const { return profilerEnabled.load(std::memory_order_relaxed); }
 
+    // Frames and per-scope statistics retained. Changing it discards the retained history.
     void setHistorySize(std::size_t size);
+    // Scopes each thread can hold between collects; applies to threads that start recording later.
+    void setThreadBufferCapacity(std::size_t events);
+
+    // Labels the calling thread in captures ("Main", "JobSystem Worker 2", ...).
+    void setThreadName(std::string_view name);
+
+    // Capture: keeps every sample from every thread for the next `frames` frames (0 = until
+    // endCapture()), independent of the rolling history, for offline inspection.
+    void beginCapture(std::size_t frames);
+    void endCapture();
+    [[nodiscard]] bool isCapturing() const { return capturing; }
+    [[nodiscard]] const std::vector<ProfileSample>& capturedSamples() const { return captureSamples; }
+    [[nodiscard]] std::size_t capturedFrameCount() const { return captureFrames.size(); }
+
+    // Writes the capture in Chrome Trace Event format (chrome://tracing, ui.perfetto.dev): one
+    // complete event per sample on its thread's track, frames on a separate "Frames" track.
+    void writeChromeTrace(std::ostream& out) const;
+    bool writeChromeTrace(const std::filesystem::path& path) const;
 
 private:
-    Profiler() = default;
+    // One frame's worth of calls to a scope.
+    struct ScopeFrameStats {
+        std::uint64_t frameNumber{~std::uint64_t{0}};
+        std::uint32_t callCount{0};
+        float totalMs{0.0f};
+        float minMs{0.0f};
+        float maxMs{0.0f};
+        float lastMs{0.0f};
+    };
+
+    struct CapturedFrame {
+        std::uint64_t frameNumber{0};
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+    };
+
+    Profiler();
+    ~Profiler();
+
+    ProfileThreadBuffer& threadBuffer();
+    [[nodiscard]] std::chrono::steady_clock::time_point toTimePoint(std::uint64_t ticks) const;
+    void calibrateTicks();
+
+    std::atomic<bool> profilerEnabled{true};
+
+    // Interned names; the deque keeps references stable as it grows.
+    mutable std::mutex nameMutex;
+    std::deque<std::string> names;
+    std::unordered_map<std::string_view, std::uint32_t> nameIds;
 
-    bool profilerEnabled{true};
+    mutable std::mutex bufferMutex;
+    std::vector<std::unique_ptr<ProfileThreadBuffer>> threadBuffers;
+    std::size_t threadBufferCapacity{1u << 16};
+    std::uint64_t droppedTotal{0};
+
+    // Ring of frames indexed by frame number, and per scope a ring of frame stats alongside it.
     std::vector<ProfileFrame> frameHistory;
-    std::size_t currentFrameIndex{0};
-    std::vector<std::pair<std::string, std::chrono::high_resolution_clock::time_point>> sampleStack;
-    std::uint32_t currentDepth{0};
+    std::uint64_t frameCount{0};
+    std::vector<std::vector<ScopeFrameStats>> scopeHistory;  // Guarded by bufferMutex.
+
+    std::unordered_map<std::uint64_t, std::string> threadNames;  // Guarded by bufferMutex.
+    bool capturing{false};
+    std::size_t captureFramesRemaining{0};
+    std::chrono::steady_clock::time_point captureStart;
+    std::vector<ProfileSample> captureSamples;
+    std::vector<CapturedFrame> captureFrames;
 
-    std::unordered_map<std::string, std::vector<float>> sampleHistory;
+    // Tick source calibration: ticks * nanosecondsPerTick since the anchor.
+    std::uint64_t anchorTicks{0};
+    std::chrono::steady_clock::time_point anchorTime;
+    double nanosecondsPerTick{1.0};
 
     float currentFps{0.0f};
     float cpuFrameTime{0.0f};
     float gpuFrameTime{0.0f};
 
-    std::vector<float> frameTimeHistoryBuffer;
+    std::vector<float> frameTimeHistoryBuffer;  // Ring of historySize slots.
+    std::size_t frameTimeHistoryHead{0};        // Slot the next frame time is written to.
+    std::size_t frameTimeHistoryCount{0};
     std::vector<float> cpuTimeHistoryBuffer;
     std::vector<float> gpuTimeHistoryBuffer;
     std::size_t historySize{120};
 };
 
-// RAII scope profiler
+// RAII scope profiler over an interned name id.
 class ProfileScope {
 public:
-    explicit ProfileScope(const std::string& name) : scopeName(name) {
-        Profiler::instance().beginSample(name);
-    }
+    explicit ProfileScope(std::uint32_t nameId) noexcept : scopeNameId(nameId), startTicks(Profiler::beginScope()) {}
     ~ProfileScope() {
-        Profiler::instance().endSample();
+        if (startTicks != 0) {
+            Profiler::endScope(scopeNameId, startTicks);
+        }
     }
 
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
 private:
-    std::string scopeName;
+    std::uint32_t scopeNameId;
+    std::uint64_t startTicks;
 };
 
-#define PROFILE_SCOPE(name) vkengine::ProfileScope _profileScope##__LINE__(name)
+#define VKENGINE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define VKENGINE_PROFILE_CONCAT(a, b) VKENGINE_PROFILE_CONCAT_IMPL(a, b)
+
+// `name` is interned the first time the call site runs and must not change between calls.
+#define PROFILE_SCOPE(name)                                                                        \
+    static const std::uint32_t VKENGINE_PROFILE_CONCAT(_profileName, __LINE__) =                   \
+        vkengine::Profiler::instance().internName(name);                                           \
+    vkengine::ProfileScope VKENGINE_PROFILE_CONCAT(_profileScope, __LINE__)(                      \
+        VKENGINE_PROFILE_CONCAT(_profileName, __LINE__))
 #define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
 
 // ============================================================================
@@ -360,8 +464,23 @@ struct LogEntry {
     std::chrono::system_clock::time_point timestamp;
 };
 
+// What log() does when the queue is full: drop the record (counted in droppedCount()) or wait
+// for the writer thread to make room.
+enum class LogOverflowPolicy {
+    Drop,
+    Block
+};
+
+struct LogQueue;
+
+// Callers only check the level, stamp the record and push it onto a bounded lock-free MPSC queue.
+// A background thread drains the queue in batches, formats the lines and does the console and
+// file writes, the history bookkeeping and the callbacks, so callbacks run on that thread.
+// Fatal records are flushed before log() returns.
 class Logger {
 public:
+    static constexpr std::size_t QueueCapacity = 8192;
+
     static Logger& instance();
 
     void log(LogLevel level, const std::string& message, const std::string& category = "");
@@ -374,11 +493,22 @@ public:
     void error(const std::string& message, const std::string& category = "");
     void fatal(const std::string& message, const std::string& category = "");
 
-    void setMinLevel(LogLevel level) { minLevel = level; }
-    [[nodiscard]] LogLevel getMinLevel() const { return minLevel; }
+    [[nodiscard]] bool shouldLog(LogLevel level) const { return level >= minLevel.load(std::memory_order_relaxed); }
+    void setMinLevel(LogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+    [[nodiscard]] LogLevel getMinLevel() const { return minLevel.load(std::memory_order_relaxed); }
+
+    void setOverflowPolicy(LogOverflowPolicy policy) { overflowPolicy.store(policy, std::memory_order_relaxed); }
+    [[nodiscard]] LogOverflowPolicy getOverflowPolicy() const { return overflowPolicy.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t droppedCount() const { return droppedRecords.load(std::memory_order_relaxed); }
 
-    void setMaxEntries(std::size_t max) { maxEntries = max; }
-    [[nodiscard]] const std::vector<LogEntry>& entries() const { return logEntries; }
+    // Blocks until every record logged before the call has been written.
+    void flush();
+
+    void setConsoleOutput(bool enabled) { consoleOutput.store(enabled, std::memory_order_relaxed); }
+
+    void setMaxEntries(std::size_t max);
+    // Snapshot of the most recent entries the writer has processed.
+    [[nodiscard]] std::vector<LogEntry> entries() const;
 
     void clear();
 
@@ -392,22 +522,78 @@ public:
     void removeCallback(const std::string& name);
 
 private:
-    Logger() = default;
-
-    LogLevel minLevel{LogLevel::Info};
+    Logger();
+    ~Logger();
+
+    void writerLoop();
+    void wakeWriter();
+
+    std::atomic<LogLevel> minLevel{LogLevel::Info};
+    std::atomic<LogOverflowPolicy> overflowPolicy{LogOverflowPolicy::Drop};
+    std::atomic<bool> consoleOutput{true};
+    std::atomic<std::uint64_t> droppedRecords{0};
+
+    std::unique_ptr<LogQueue> queue;
+    std::thread writer;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> writerSleeping{false};
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable flushCondition;
+
+    // Writer-side state, shared with the configuration calls above.
     std::size_t maxEntries{1000};
-    std::vector<LogEntry> logEntries;
+    std::deque<LogEntry> logEntries;
     std::unordered_map<std::string, LogCallback> callbacks;
-    std::ofstream* logFile{nullptr};
+    std::unique_ptr<std::ofstream> logFile;
     mutable std::mutex mutex;
 };
 
-#define EVE_LOG_TRACE(msg) vkengine::Logger::instance().log(vkengine::LogLevel::Trace, msg, __FILE__, __LINE__)
-#define EVE_LOG_DEBUG(msg) vkengine::Logger::instance().log(vkengine::LogLevel::Debug, msg, __FILE__, __LINE__)
-#define EVE_LOG_INFO(msg) vkengine::Logger::instance().log(vkengine::LogLevel::Info, msg, __FILE__, __LINE__)
-#define EVE_LOG_WARNING(msg) vkengine::Logger::instance().log(vkengine::LogLevel::Warning, msg, __FILE__, __LINE__)
-#define EVE_LOG_ERROR(msg) vkengine::Logger::instance().log(vkengine::LogLevel::Error, msg, __FILE__, __LINE__)
-#define EVE_LOG_FATAL(msg) vkengine::Logger::instance().log(vkengine::LogLevel::Fatal, msg, __FILE__, __LINE__)
+// Levels below EVE_LOG_MIN_LEVEL (0 = Trace ... 5 = Fatal) compile to nothing, arguments included.
+// Release builds drop trace and debug unless the build overrides it.
+#ifndef EVE_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define EVE_LOG_MIN_LEVEL 2
+#else
+#define EVE_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+// The message expression is only evaluated when the level passes the runtime filter.
+#define EVE_LOG_AT(level, msg)                                                                     \
+    do {                                                                                           \
+        auto& eveLogger_ = vkengine::Logger::instance();                                           \
+        if (eveLogger_.shouldLog(level)) {                                                         \
+            eveLogger_.log(level, msg, __FILE__, __LINE__);                                        \
+        }                                                                                          \
+    } while (false)
+
+#if EVE_LOG_MIN_LEVEL <= 0
+#define EVE_LOG_TRACE(msg) EVE_LOG_AT(vkengine::LogLevel::Trace, msg)
+#else
+#define EVE_LOG_TRACE(msg) ((void)0)
+#endif
+#if EVE_LOG_MIN_LEVEL <= 1
+#define EVE_LOG_DEBUG(msg) EVE_LOG_AT(vkengine::LogLevel::Debug, msg)
+#else
+#define EVE_LOG_DEBUG(msg) ((void)0)
+#endif
+#if EVE_LOG_MIN_LEVEL <= 2
+#define EVE_LOG_INFO(msg) EVE_LOG_AT(vkengine::LogLevel::Info, msg)
+#else
+#define EVE_LOG_INFO(msg) ((void)0)
+#endif
+#if EVE_LOG_MIN_LEVEL <= 3
+#define EVE_LOG_WARNING(msg) EVE_LOG_AT(vkengine::LogLevel::Warning, msg)
+#else
+#define EVE_LOG_WARNING(msg) ((void)0)
+#endif
+#if EVE_LOG_MIN_LEVEL <= 4
+#define EVE_LOG_ERROR(msg) EVE_LOG_AT(vkengine::LogLevel::Error, msg)
+#else
+#define EVE_LOG_ERROR(msg) ((void)0)
+#endif
+#define EVE_LOG_FATAL(msg) EVE_LOG_AT(vkengine::LogLevel::Fatal, msg)
 
 // ============================================================================
 // Debug Console Commands
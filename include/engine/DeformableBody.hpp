@@ -1,5 +1,7 @@
 #pragma once
 
+#include "engine/MassSpringSystem.hpp"
+
 #include <glm/glm.hpp>
 
 #include <cstddef>
@@ -7,14 +9,9 @@
 
 namespace vkengine {
 
+// Cloth grid simulated as a mass-spring network; see MassSpringSystem for the solver.
 class DeformableBody {
 public:
-    struct Node {
-        glm::vec3 position{0.0f};
-        glm::vec3 velocity{0.0f};
-        bool pinned{false};
-    };
-
     DeformableBody(int width, int height, float spacing);
 
     void simulate(float deltaSeconds, const glm::vec3& gravity) noexcept;
@@ -31,19 +28,15 @@ public:
     [[nodiscard]] int gridHeight() const noexcept { return clothHeight; }
     [[nodiscard]] float restSpacing() const noexcept { return spacing; }
 
-    [[nodiscard]] const std::vector<Node>& nodes() const noexcept { return nodeData; }
+    [[nodiscard]] std::size_t nodeCount() const noexcept { return network.size(); }
+    [[nodiscard]] glm::vec3 nodePosition(std::size_t i) const { return network.position(i); }
+    [[nodiscard]] glm::vec3 nodeVelocity(std::size_t i) const { return network.velocity(i); }
+    [[nodiscard]] bool nodePinned(std::size_t i) const { return network.pinned(i); }
     [[nodiscard]] const std::vector<uint32_t>& indices() const noexcept { return meshIndices; }
 
     void computeVertexNormals(std::vector<glm::vec3>& outNormals) const;
 
 private:
-    struct Spring {
-        std::size_t a;
-        std::size_t b;
-        float restLength;
-        float stiffness;
-    };
-
     [[nodiscard]] std::size_t index(int x, int y) const noexcept { return static_cast<std::size_t>(y * clothWidth + x); }
     void addSpring(int ax, int ay, int bx, int by, float stiffnessScale = 1.0f);
 
@@ -57,8 +50,7 @@ private:
     float damping{0.08f};
     float floorY{-1.5f};
 
-    std::vector<Node> nodeData;
-    std::vector<Spring> springs;
+    MassSpringSystem network;
     std::vector<uint32_t> meshIndices;
 };
 
@@ -143,7 +143,8 @@ public:
     [[nodiscard]] RenderComponent& render();
     [[nodiscard]] const RenderComponent& render() const;
 
-    [[nodiscard]] glm::mat4 modelMatrix() const { return transform().matrix(); }
+    // Interpolated between the last two fixed ticks for simulated objects, live transform otherwise.
+    [[nodiscard]] glm::mat4 modelMatrix() const;
 
     Collider& enableCollider(const glm::vec3& halfExtents, bool isStatic = false);
     void disableCollider();
@@ -223,6 +224,17 @@ private:
     MaterialLibrary materialLibrary{};
 };
 
+struct FixedTimestepSettings {
+    // Simulation ticks per second; physics, particles, cloth and soft bodies always advance by
+    // exactly 1 / tickRate.
+    float tickRate{60.0f};
+    // Catch-up budget: at most this many ticks run per update(). Time beyond it is dropped, so a
+    // long stall slows the simulation down instead of making the next frames slower still.
+    int maxTicksPerUpdate{5};
+    // Render simulated objects between their previous and current tick transforms.
+    bool interpolate{true};
+};
+
 class GameEngine : public IGameEngine {
 public:
     GameEngine();
@@ -239,9 +251,31 @@ public:
     GameObject& createObject(const std::string& name, MeshType meshType) override { return activeScene.createObject(name, meshType); }
     std::vector<GameObject*> createObjects(std::size_t count, MeshType meshType, const std::string& namePrefix = "") { return activeScene.createObjects(count, meshType, namePrefix); }
 
+    // Accumulates frame time and runs as many fixed ticks as it covers, then refreshes the
+    // interpolated render transforms.
     void update(float deltaSeconds) override;
 
+    void setFixedTimestep(const FixedTimestepSettings& settings);
+    [[nodiscard]] const FixedTimestepSettings& fixedTimestep() const noexcept { return timestep; }
+    [[nodiscard]] float fixedDeltaSeconds() const noexcept { return 1.0f / timestep.tickRate; }
+    // Fraction of a tick left in the accumulator; the blend factor used for rendering.
+    [[nodiscard]] float interpolationAlpha() const noexcept { return alpha; }
+    [[nodiscard]] std::uint64_t tickCount() const noexcept { return ticks; }
+    [[nodiscard]] int ticksLastUpdate() const noexcept { return lastUpdateTicks; }
+    [[nodiscard]] double droppedSimulationSeconds() const noexcept { return droppedSeconds; }
+
 private:
+    void simulateTick(float tickSeconds);
+    void capturePreviousTransforms();
+    void updateInterpolatedTransforms();
+
+    FixedTimestepSettings timestep{};
+    double accumulator{0.0};
+    float alpha{0.0f};
+    std::uint64_t ticks{0};
+    int lastUpdateTicks{0};
+    double droppedSeconds{0.0};
+
     Scene activeScene{};
     PhysicsSystem physicsSystem{};
     ParticleSystem particleSystem{};
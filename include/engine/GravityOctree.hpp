@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkengine {
+
+// Barnes-Hut octree over a set of point masses. build() sorts the points along a Morton curve and
+// builds the upper levels serially, then the subtrees below them on the job pool. Every node keeps
+// the total mass and centre of mass of its points; computeFields() treats a node as one mass when
+// it is small compared to its distance (size < openingAngle * distance) and opens it otherwise.
+class GravityOctree {
+public:
+    // Replaces the tree with one over `count` points. The arrays are copied and may be released
+    // afterwards.
+    void build(const glm::vec3* positions, const float* masses, std::size_t count);
+
+    // Writes the acceleration field at every point of the last build() into `fields`, in input
+    // order: G * sum_j m_j * d_ij / (|d_ij|^2 + softening)^(3/2) with d_ij = p_j - p_i. An opening
+    // angle of 0 opens every node and reproduces the direct sum.
+    void computeFields(float gravityConstant, float softening, float openingAngle, glm::vec3* fields) const;
+
+    [[nodiscard]] std::size_t size() const noexcept { return sortedPositions.size(); }
+    [[nodiscard]] std::size_t nodeCount() const noexcept { return nodes.size(); }
+
+    // Nodes with at most this many points are leaves and are summed directly.
+    static constexpr std::uint32_t kLeafCapacity = 8;
+    // Morton bits per axis; also the deepest level of the tree.
+    static constexpr std::uint32_t kMaxDepth = 21;
+
+private:
+    struct Node {
+        glm::vec3 centerOfMass{0.0f};
+        float mass{0.0f};
+        float size{0.0f};              // Edge length of the cell.
+        std::uint32_t firstChild{0};   // Children are stored contiguously.
+        std::uint32_t childCount{0};   // 0 for leaves.
+        std::uint32_t begin{0};        // Range of the node's points in the sorted arrays.
+        std::uint32_t end{0};
+    };
+
+    struct Key {
+        std::uint64_t code{0};
+        std::uint32_t index{0};
+    };
+
+    struct SubtreeTask {
+        std::uint32_t node{0};
+        std::uint32_t depth{0};
+    };
+
+    // Builds the children of `node` into `out`. Subtrees at most `deferLimit` points large are
+    // recorded in `deferred` instead of being built, when `deferred` is not null.
+    void buildNode(std::vector<Node>& out, std::uint32_t node, std::uint32_t depth, std::size_t deferLimit,
+                   std::vector<SubtreeTask>* deferred) const;
+    void computeMoments(Node& node, const std::vector<Node>& owner) const;
+
+    float rootSize{0.0f};
+    std::vector<Key> keys;
+    std::vector<Key> keyScratch;
+    std::vector<glm::vec3> sortedPositions;
+    std::vector<float> sortedMasses;
+    std::vector<Node> nodes;
+    std::vector<SubtreeTask> subtreeTasks;
+    std::vector<std::vector<Node>> subtreeNodes;
+};
+
+} // namespace vkengine
@@ -0,0 +1,436 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Job scheduler, split out of JobSystem.hpp so that low-level headers (the ECS registry,
+// core::parallelFor) can depend on it without pulling in the spatial types defined there.
+
+namespace vkengine {
+
+// ============================================================================
+// Job System
+// ============================================================================
+
+// Chase-Lev work-stealing deque. The owning worker pushes and pops at the bottom without
+// taking a lock; other threads steal from the top with a single CAS. The ring grows on demand
+// and retired rings stay alive until the deque is destroyed, so a thief that raced with a grow
+// never reads freed memory. T must be trivially copyable (the job system stores pointers).
+template<typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(std::size_t initialCapacity = 256);
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner thread only.
+    void push(T item);
+    std::optional<T> pop();
+
+    // Any thread.
+    std::optional<T> steal();
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    struct Ring {
+        explicit Ring(std::size_t cap) : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+
+        T load(std::int64_t index) const { return slots[static_cast<std::size_t>(index) & mask].load(std::memory_order_relaxed); }
+        void store(std::int64_t index, T value) { slots[static_cast<std::size_t>(index) & mask].store(value, std::memory_order_relaxed); }
+
+        std::size_t capacity;
+        std::size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Ring* grow(Ring* ring, std::int64_t bottom, std::int64_t top);
+
+    alignas(64) std::atomic<std::int64_t> topIndex{0};
+    alignas(64) std::atomic<std::int64_t> bottomIndex{0};
+    std::atomic<Ring*> ring{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings;
+};
+
+// Type-erased job callable with inline storage. Closures up to kInlineSize bytes (a couple of
+// pointers plus a range, which covers every internal job) are constructed in place; larger ones
+// fall back to a single heap allocation.
+class JobTask {
+public:
+    static constexpr std::size_t kInlineSize = 64;
+
+    JobTask() = default;
+    ~JobTask() { reset(); }
+
+    JobTask(const JobTask&) = delete;
+    JobTask& operator=(const JobTask&) = delete;
+
+    template<typename Func>
+    void emplace(Func&& function);
+    void reset();
+
+    void operator()() { invokeFn(storagePtr()); }
+    [[nodiscard]] bool empty() const { return invokeFn == nullptr; }
+
+private:
+    void* storagePtr() { return heapTarget ? heapTarget : static_cast<void*>(storage); }
+
+    alignas(std::max_align_t) unsigned char storage[kInlineSize];
+    void* heapTarget{nullptr};
+    void (*invokeFn)(void*){nullptr};
+    void (*destroyFn)(void*, bool heap){nullptr};
+};
+
+// Pooled job record. A job becomes runnable when pendingPredecessors drops to zero; finishing it
+// bumps the generation (which completes every handle to it) and releases its successors.
+struct alignas(64) Job {
+    JobTask task;
+    std::atomic<std::uint32_t> generation{1};
+    std::atomic<std::int32_t> pendingPredecessors{0};
+    std::atomic<bool> successorLock{false};
+    std::vector<Job*> successors;  // Guarded by successorLock; capacity is kept across reuse.
+};
+
+// Lightweight reference to a submitted job. Copyable and cheap; it stays safe to query after the
+// job finished and its record was recycled because completion is detected by generation.
+class JobHandle {
+public:
+    JobHandle() = default;
+
+    [[nodiscard]] bool valid() const { return job != nullptr; }
+    explicit operator bool() const { return valid(); }
+
+private:
+    friend class JobSystem;
+    JobHandle(Job* job, std::uint32_t generation) : job(job), generation(generation) {}
+
+    Job* job{nullptr};
+    std::uint32_t generation{0};
+};
+
+using JobFunction = std::function<void()>;
+
+// Work-stealing job scheduler. Each worker owns a WorkStealingDeque: jobs submitted from a
+// worker go to its own deque and are popped LIFO without synchronization, idle workers steal
+// FIFO from the others. Jobs submitted from non-worker threads enter through a shared injection
+// queue, which is the only locked structure on the hot path. Threads blocked in wait() help by
+// executing queued jobs instead of spinning.
+//
+// Jobs form a graph: submit() with dependencies registers the new job as a successor of each
+// unfinished predecessor, and it is queued exactly when the last one finishes, so nothing polls.
+// A frame can be expressed as a chain of continuations:
+//
+//     auto input     = jobs.submit(pollInput);
+//     auto physics   = jobs.submit(stepPhysics, input);
+//     auto particles = jobs.submit(updateParticles, physics);
+//     auto animation = jobs.submit(updateAnimation, particles);
+//     jobs.wait(jobs.submit(prepareRender, {animation, physics}));
+//
+// Job records come from a chunked arena with per-worker free lists, so steady-state submission
+// does not touch the heap.
+class JobSystem {
+public:
+    static JobSystem& instance();
+
+    void initialize(std::size_t threadCount = 0);  // 0 = hardware concurrency
+    void shutdown();
+
+    // Submit jobs; a job with dependencies runs after all of them have finished.
+    template<typename Func>
+    JobHandle submit(Func&& function);
+    template<typename Func>
+    JobHandle submit(Func&& function, JobHandle dependency);
+    template<typename Func>
+    JobHandle submit(Func&& function, std::initializer_list<JobHandle> dependencies);
+    template<typename Func>
+    JobHandle submit(Func&& function, const std::vector<JobHandle>& dependencies);
+
+    // Parallel for
+    template<typename Func>
+    JobHandle parallelFor(std::size_t count, std::size_t batchSize, Func&& function);
+
+    // Wait for job completion
+    void wait(JobHandle handle);
+    void waitAll();
+    [[nodiscard]] bool isComplete(JobHandle handle) const;
+
+    // Statistics
+    [[nodiscard]] std::size_t threadCount() const { return workerCount.load(std::memory_order_acquire); }
+    [[nodiscard]] std::size_t pendingJobs() const;
+    [[nodiscard]] std::size_t completedJobs() const { return completedJobCount; }
+    [[nodiscard]] std::size_t stolenJobs() const { return stolenJobCount; }
+    [[nodiscard]] std::size_t allocatedJobs() const;
+
+    // Index of the calling worker thread, or kNotAWorker for threads outside the pool.
+    static constexpr std::size_t kNotAWorker = static_cast<std::size_t>(-1);
+    [[nodiscard]] std::size_t currentWorkerIndex() const;
+
+private:
+    JobSystem() = default;
+    ~JobSystem();
+
+    static constexpr std::size_t kJobChunkSize = 256;
+    static constexpr std::size_t kLocalFreeJobLimit = 512;
+
+    void workerThread(std::size_t threadIndex);
+
+    // Job graph. A freshly allocated job holds one "build" reference in pendingPredecessors so
+    // that it cannot start while its dependencies are still being attached; schedule() drops it.
+    Job* allocateJob();
+    void recycleJob(Job* job);
+    void addDependency(Job* job, JobHandle dependency);
+    JobHandle schedule(Job* job);
+    void releaseDependency(Job* job);
+    void finishJob(Job* job);
+
+    void push(Job* job);
+    Job* findJob(std::size_t threadIndex);
+    bool runOne(std::size_t threadIndex);
+    void wakeWorkers();
+
+    // initialize() and shutdown() serialize on lifecycleMutex, so threads racing to start the pool
+    // on first use (core::parallelFor) get one pool. workerCount is published once it is running.
+    std::mutex lifecycleMutex;
+    std::atomic<std::size_t> workerCount{0};
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkStealingDeque<Job*>>> workerQueues;
+
+    std::deque<Job*> injectionQueue;
+    std::mutex injectionMutex;
+    std::atomic<std::size_t> injectedCount{0};
+
+    // Job arena: chunks are never released, so a JobHandle never dangles.
+    std::vector<std::unique_ptr<Job[]>> jobChunks;
+    std::vector<Job*> freeJobs;
+    mutable std::mutex arenaMutex;
+    std::vector<std::vector<Job*>> workerFreeJobs;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<std::size_t> sleepingWorkers{0};
+
+    std::atomic<std::size_t> queuedJobCount{0};
+    std::atomic<std::size_t> outstandingJobCount{0};
+    std::atomic<bool> running{false};
+    std::atomic<std::size_t> completedJobCount{0};
+    std::atomic<std::size_t> stolenJobCount{0};
+};
+
+// ============================================================================
+// Template Implementations
+// ============================================================================
+
+// JobTask Template Implementation
+template<typename Func>
+void JobTask::emplace(Func&& function) {
+    using Callable = std::decay_t<Func>;
+    reset();
+    if constexpr (sizeof(Callable) <= kInlineSize && alignof(Callable) <= alignof(std::max_align_t)) {
+        new (storage) Callable(std::forward<Func>(function));
+    } else {
+        heapTarget = new Callable(std::forward<Func>(function));
+    }
+    invokeFn = [](void* target) { (*static_cast<Callable*>(target))(); };
+    destroyFn = [](void* target, bool heap) {
+        if (heap) {
+            delete static_cast<Callable*>(target);
+        } else {
+            static_cast<Callable*>(target)->~Callable();
+        }
+    };
+}
+
+inline void JobTask::reset() {
+    if (destroyFn) {
+        destroyFn(storagePtr(), heapTarget != nullptr);
+    }
+    heapTarget = nullptr;
+    invokeFn = nullptr;
+    destroyFn = nullptr;
+}
+
+// JobSystem Template Implementation
+template<typename Func>
+JobHandle JobSystem::submit(Func&& function) {
+    Job* job = allocateJob();
+    job->task.emplace(std::forward<Func>(function));
+    return schedule(job);
+}
+
+template<typename Func>
+JobHandle JobSystem::submit(Func&& function, JobHandle dependency) {
+    Job* job = allocateJob();
+    job->task.emplace(std::forward<Func>(function));
+    addDependency(job, dependency);
+    return schedule(job);
+}
+
+template<typename Func>
+JobHandle JobSystem::submit(Func&& function, std::initializer_list<JobHandle> dependencies) {
+    Job* job = allocateJob();
+    job->task.emplace(std::forward<Func>(function));
+    for (const JobHandle& dependency : dependencies) {
+        addDependency(job, dependency);
+    }
+    return schedule(job);
+}
+
+template<typename Func>
+JobHandle JobSystem::submit(Func&& function, const std::vector<JobHandle>& dependencies) {
+    Job* job = allocateJob();
+    job->task.emplace(std::forward<Func>(function));
+    for (const JobHandle& dependency : dependencies) {
+        addDependency(job, dependency);
+    }
+    return schedule(job);
+}
+
+template<typename Func>
+JobHandle JobSystem::parallelFor(std::size_t count, std::size_t batchSize, Func&& function) {
+    if (count == 0) {
+        return {};
+    }
+
+    batchSize = std::max<std::size_t>(1, batchSize);
+    const std::size_t batchCount = (count + batchSize - 1) / batchSize;
+
+    // The returned handle belongs to an empty join job that every batch holds a predecessor
+    // reference on; it is queued when the last batch finishes.
+    Job* join = allocateJob();
+    join->task.emplace([]() {});
+    join->pendingPredecessors.fetch_add(static_cast<std::int32_t>(batchCount), std::memory_order_relaxed);
+    const JobHandle handle = schedule(join);
+
+    // One allocation per dispatch for the shared callable, none per batch.
+    auto dispatch = std::make_shared<std::decay_t<Func>>(std::forward<Func>(function));
+
+    auto spawnBatches = [this, dispatch, join, batchCount, batchSize, count]() {
+        for (std::size_t batch = 0; batch < batchCount; ++batch) {
+            const std::size_t begin = batch * batchSize;
+            const std::size_t end = std::min(count, begin + batchSize);
+            Job* job = allocateJob();
+            job->task.emplace([this, dispatch, join, begin, end]() {
+                for (std::size_t i = begin; i < end; ++i) {
+                    (*dispatch)(i);
+                }
+                releaseDependency(join);
+            });
+            schedule(job);
+        }
+    };
+
+    // From a worker the batches land in its own deque and get stolen from there. From any other
+    // thread a single spawner job goes through the injection queue instead of every batch.
+    if (currentWorkerIndex() != kNotAWorker || threadCount() == 0) {
+        spawnBatches();
+    } else {
+        submit(std::move(spawnBatches));
+    }
+    return handle;
+}
+
+// WorkStealingDeque Template Implementation
+template<typename T>
+WorkStealingDeque<T>::WorkStealingDeque(std::size_t initialCapacity) {
+    std::size_t capacity = 1;
+    while (capacity < std::max<std::size_t>(2, initialCapacity)) {
+        capacity <<= 1;
+    }
+    rings.push_back(std::make_unique<Ring>(capacity));
+    ring.store(rings.back().get(), std::memory_order_relaxed);
+}
+
+template<typename T>
+typename WorkStealingDeque<T>::Ring* WorkStealingDeque<T>::grow(Ring* current, std::int64_t bottom, std::int64_t top) {
+    auto larger = std::make_unique<Ring>(current->capacity * 2);
+    for (std::int64_t i = top; i < bottom; ++i) {
+        larger->store(i, current->load(i));
+    }
+    Ring* result = larger.get();
+    rings.push_back(std::move(larger));
+    return result;
+}
+
+template<typename T>
+void WorkStealingDeque<T>::push(T item) {
+    const std::int64_t bottom = bottomIndex.load(std::memory_order_relaxed);
+    const std::int64_t top = topIndex.load(std::memory_order_acquire);
+    Ring* current = ring.load(std::memory_order_relaxed);
+    if (bottom - top > static_cast<std::int64_t>(current->capacity) - 1) {
+        current = grow(current, bottom, top);
+        ring.store(current, std::memory_order_release);
+    }
+    current->store(bottom, item);
+    bottomIndex.store(bottom + 1, std::memory_order_release);
+}
+
+template<typename T>
+std::optional<T> WorkStealingDeque<T>::pop() {
+    const std::int64_t bottom = bottomIndex.load(std::memory_order_relaxed) - 1;
+    Ring* current = ring.load(std::memory_order_relaxed);
+    bottomIndex.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t top = topIndex.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        bottomIndex.store(bottom + 1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    T item = current->load(bottom);
+    if (top == bottom) {
+        // Last element: race against thieves for it.
+        const bool won = topIndex.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottomIndex.store(bottom + 1, std::memory_order_relaxed);
+        if (!won) {
+            return std::nullopt;
+        }
+    }
+    return item;
+}
+
+template<typename T>
+std::optional<T> WorkStealingDeque<T>::steal() {
+    std::int64_t top = topIndex.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t bottom = bottomIndex.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return std::nullopt;
+    }
+
+    Ring* current = ring.load(std::memory_order_acquire);
+    T item = current->load(top);
+    if (!topIndex.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return std::nullopt;
+    }
+    return item;
+}
+
+template<typename T>
+bool WorkStealingDeque<T>::empty() const {
+    return size() == 0;
+}
+
+template<typename T>
+std::size_t WorkStealingDeque<T>::size() const {
+    const std::int64_t bottom = bottomIndex.load(std::memory_order_relaxed);
+    const std::int64_t top = topIndex.load(std::memory_order_relaxed);
+    return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+}
+
+} // namespace vkengine
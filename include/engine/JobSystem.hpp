@@ -1,19 +1,24 @@
 #pragma once
 
+#include "engine/JobScheduler.hpp"
+
 #include <glm/glm.hpp>
 
 #include <algorithm>
 #include <array>
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <deque>
 #include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <optional>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -185,60 +190,6 @@ private:
     BlockHeader* freeList{nullptr};
 };
 
-// ============================================================================
-// Job System
-// ============================================================================
-
-class Job;
-using JobFunction = std::function<void()>;
-using JobHandle = std::shared_ptr<std::atomic<bool>>;
-
-class JobSystem {
-public:
-    static JobSystem& instance();
-
-    void initialize(std::size_t threadCount = 0);  // 0 = hardware concurrency
-    void shutdown();
-
-    // Submit jobs
-    JobHandle submit(JobFunction function);
-    JobHandle submit(JobFunction function, JobHandle dependency);
-    JobHandle submit(JobFunction function, const std::vector<JobHandle>& dependencies);
-
-    // Parallel for
-    template<typename Func>
-    JobHandle parallelFor(std::size_t count, std::size_t batchSize, Func&& function);
-
-    // Wait for job completion
-    void wait(JobHandle handle);
-    void waitAll();
-    [[nodiscard]] bool isComplete(JobHandle handle) const;
-
-    // Statistics
-    [[nodiscard]] std::size_t threadCount() const { return workers.size(); }
-    [[nodiscard]] std::size_t pendingJobs() const;
-    [[nodiscard]] std::size_t completedJobs() const { return completedJobCount; }
-
-private:
-    JobSystem() = default;
-    ~JobSystem();
-
-    void workerThread(std::size_t threadIndex);
-
-    struct JobData {
-        JobFunction function;
-        JobHandle completionFlag;
-        std::vector<JobHandle> dependencies;
-    };
-
-    std::vector<std::thread> workers;
-    std::deque<JobData> jobQueue;
-    std::mutex queueMutex;
-    std::condition_variable queueCondition;
-    std::atomic<bool> running{false};
-    std::atomic<std::size_t> completedJobCount{0};
-};
-
 // ============================================================================
 // Parallel Algorithms
 // ============================================================================
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkengine {
+
+// Structure-of-arrays mass-spring network behind DeformableBody and SoftBodyVolume. A step runs
+// three race-free passes on the job pool: every spring computes its force into its own slot, every
+// node gathers the forces of its springs through a CSR incidence list, and the nodes are
+// integrated with the vector lane kernels. No pass writes to memory another chunk reads, so the
+// result does not depend on the number of threads.
+class MassSpringSystem {
+public:
+    struct StepParams {
+        glm::vec3 gravity{0.0f};
+        float deltaSeconds{0.0f};
+        float massPerNode{1.0f};
+        float damping{0.0f};             // Velocity-proportional drag.
+        float velocityRetention{1.0f};   // Velocity scale after the acceleration update.
+        float minSpringLength{1e-5f};    // Shorter springs apply no force.
+        float floorY{0.0f};
+        float floorRestitution{0.0f};    // Falling nodes below the floor bounce with this factor.
+        float floorUpwardRetention{1.0f};// Rising nodes below the floor keep this fraction of vy.
+    };
+
+    void resize(std::size_t nodeCount);
+    [[nodiscard]] std::size_t size() const noexcept { return posX.size(); }
+    [[nodiscard]] std::size_t springCount() const noexcept { return springA.size(); }
+
+    void addSpring(std::size_t a, std::size_t b, float restLength, float stiffness);
+    // Triangle list used by computeVertexNormals(); indices refer to nodes.
+    void setTriangles(const std::vector<std::uint32_t>& indices);
+
+    void step(const StepParams& params);
+
+    // Area-weighted vertex normals of the triangle list; faces with a squared normal length
+    // below `minLength` are skipped and vertices without a usable normal get +Y.
+    void computeVertexNormals(float minLength, std::vector<glm::vec3>& outNormals) const;
+
+    [[nodiscard]] glm::vec3 position(std::size_t i) const { return {posX[i], posY[i], posZ[i]}; }
+    void setPosition(std::size_t i, const glm::vec3& value) { posX[i] = value.x; posY[i] = value.y; posZ[i] = value.z; }
+    [[nodiscard]] glm::vec3 velocity(std::size_t i) const { return {velX[i], velY[i], velZ[i]}; }
+    void setVelocity(std::size_t i, const glm::vec3& value) { velX[i] = value.x; velY[i] = value.y; velZ[i] = value.z; }
+    [[nodiscard]] bool pinned(std::size_t i) const { return freeMask[i] == 0.0f; }
+    void setPinned(std::size_t i, bool value) { freeMask[i] = value ? 0.0f : 1.0f; }
+
+private:
+    template<typename Lanes>
+    friend struct MassSpringKernel;
+
+    void buildIncidence();
+
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> accelX, accelY, accelZ;
+    std::vector<float> freeMask;  // 1 for free nodes, 0 for pinned ones.
+
+    std::vector<std::uint32_t> springA, springB;
+    std::vector<float> restLength;
+    std::vector<float> springStiffness;
+    std::vector<float> forceX, forceY, forceZ;  // Force on node a; node b receives the negation.
+
+    // For node i, incidence[incidenceOffsets[i] .. incidenceOffsets[i + 1]) holds 2 * spring for
+    // springs where i is node a and 2 * spring + 1 where it is node b.
+    std::vector<std::uint32_t> incidenceOffsets;
+    std::vector<std::uint32_t> incidence;
+    bool incidenceDirty{true};
+
+    std::vector<std::uint32_t> triangles;
+    // Same layout for triangles: the faces touching each vertex.
+    std::vector<std::uint32_t> vertexFaceOffsets;
+    std::vector<std::uint32_t> vertexFaces;
+    mutable std::vector<glm::vec3> faceNormals;  // Scratch for computeVertexNormals().
+};
+
+} // namespace vkengine
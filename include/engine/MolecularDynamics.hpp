@@ -45,6 +45,12 @@ public:
     void setMaxTimeStep(float maxStepSeconds) noexcept;
     void setMinimumInteractionDistance(float distance) noexcept;
     void setMaxSpeed(float speed) noexcept;
+    // Extra radius beyond the cutoff kept in the neighbor list. A larger skin rebuilds the list
+    // less often but evaluates more pairs per force pass.
+    void setNeighborSkin(float skin) noexcept;
+    [[nodiscard]] float neighborSkin() const noexcept { return skinDistance; }
+    // Number of times the neighbor list has been rebuilt; useful to tune the skin.
+    [[nodiscard]] std::uint64_t neighborListRebuildCount() const noexcept { return neighborRebuilds; }
     void addKineticEnergy(float energyJoules) noexcept;
     [[nodiscard]] float kineticEnergy() const noexcept;
 
@@ -59,6 +65,11 @@ public:
 private:
     void integrate(float dt);
     void computeForces();
+    // Adds the pair forces from the neighbor lists of atoms [begin, end) to `forces`, both sides
+    // of every pair, so blocks with separate buffers can run concurrently.
+    void accumulateForces(std::size_t begin, std::size_t end, glm::vec3* forces) const;
+    [[nodiscard]] bool neighborListStale() const noexcept;
+    void rebuildNeighborList();
     void applyBounds(MdAtom& atom) const;
     void refreshDerivedMaterialValues() noexcept;
     [[nodiscard]] double computeKineticEnergy() const noexcept;
@@ -73,6 +84,23 @@ private:
     float sigma6{1.0f};
     float cutoffSquared{9.0f};
     std::uint32_t maxSubsteps{32};
+
+    // Verlet neighbor list: for every atom i, the atoms j > i that were within cutoff + skin when
+    // it was built, in CSR form. It stays valid until some atom has moved more than skin / 2.
+    float skinDistance{0.3f};
+    bool neighborListDirty{true};
+    std::uint64_t neighborRebuilds{0};
+    std::vector<std::uint32_t> neighborOffsets;
+    std::vector<std::uint32_t> neighborIndices;
+    std::vector<glm::vec3> referencePositions;
+    // Linked-cell grid used to build the list: atoms sorted by cell, cellStart[c] is the first
+    // slot of cell c in cellAtoms.
+    std::vector<std::uint32_t> atomCells;
+    std::vector<std::uint32_t> cellStart;
+    std::vector<std::uint32_t> cellAtoms;
+    // One force buffer per concurrent block of the force pass, summed into MdAtom::force.
+    std::vector<std::uint32_t> forceBlockStart;
+    std::vector<std::vector<glm::vec3>> blockForces;
 };
 
 } // namespace vkengine
@@ -5,16 +5,20 @@
 
 #include "core/ecs/Components.hpp"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -81,11 +85,45 @@ struct PacketHeader {
     std::uint16_t checksum{0};
 };
 
+// Largest UDP payload over IPv4; send and receive buffers are sized for it.
+constexpr std::size_t MaxDatagramSize = 65507;
+
+// Default limit on a packet's wire size: stays under the 1280-byte IPv6 minimum MTU, so datagrams
+// are not fragmented. NetworkServer and NetworkClient size their receive slots from their limit.
+constexpr std::size_t DefaultMaxPacketSize = 1200;
+
+// Recycles packet payload storage. Buffers keep their capacity when released, so once the pool
+// has warmed up, building, copying and receiving packets does not touch the allocator.
+class PacketBufferPool {
+public:
+    static PacketBufferPool& shared();
+
+    [[nodiscard]] std::vector<std::uint8_t> acquire();
+    void release(std::vector<std::uint8_t>&& buffer);
+    [[nodiscard]] std::size_t pooledCount() const;
+
+    static constexpr std::size_t InitialCapacity = DefaultMaxPacketSize;
+    static constexpr std::size_t MaxPooledBuffers = 1024;
+    static constexpr std::size_t MaxPooledCapacity = MaxDatagramSize;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<std::vector<std::uint8_t>> freeBuffers;
+};
+
+// Payload plus header. Byte-level values are big-endian; bit-level values (writeBits and the
+// quantized, varint and compressed-quaternion helpers) are packed LSB-first into the following
+// bytes, and the next byte-level write or read starts on a fresh byte.
 class Packet {
 public:
     Packet();
     explicit Packet(std::uint16_t type);
     Packet(const std::uint8_t* data, std::size_t size);
+    Packet(const Packet& other);
+    Packet(Packet&& other) noexcept;
+    Packet& operator=(const Packet& other);
+    Packet& operator=(Packet&& other) noexcept;
+    ~Packet();
 
     // Writing
     void writeUInt8(std::uint8_t value);
@@ -98,13 +136,23 @@ public:
     void writeInt64(std::int64_t value);
     void writeFloat(float value);
     void writeDouble(double value);
-    void writeString(const std::string& value);
+    void writeString(std::string_view value);
     void writeVec2(const glm::vec2& value);
     void writeVec3(const glm::vec3& value);
     void writeVec4(const glm::vec4& value);
     void writeQuat(const glm::quat& value);
     void writeBytes(const void* data, std::size_t size);
 
+    // Bit-level writing
+    void writeBits(std::uint32_t value, std::uint32_t bitCount);
+    void writeBool(bool value);
+    void writeVarUInt(std::uint64_t value);                   // 7 bits per group.
+    void writeVarInt(std::int64_t value);                     // Zigzag, then writeVarUInt.
+    void writeQuantizedFloat(float value, float minValue, float maxValue, std::uint32_t bitCount);
+    void writeQuantizedVec3(const glm::vec3& value, float minValue, float maxValue, std::uint32_t bitCount);
+    // Smallest-three: 2 bits for the largest component, the other three in `bitCount` bits each.
+    void writeCompressedQuat(const glm::quat& value, std::uint32_t bitCount = 10);
+
     // Reading
     std::uint8_t readUInt8();
     std::uint16_t readUInt16();
@@ -117,30 +165,56 @@ public:
     float readFloat();
     double readDouble();
     std::string readString();
+    void readString(std::string& out);  // Reuses the capacity of `out`.
     glm::vec2 readVec2();
     glm::vec3 readVec3();
     glm::vec4 readVec4();
     glm::quat readQuat();
     void readBytes(void* data, std::size_t size);
 
+    // Bit-level reading
+    std::uint32_t readBits(std::uint32_t bitCount);
+    bool readBool();
+    std::uint64_t readVarUInt();
+    std::int64_t readVarInt();
+    float readQuantizedFloat(float minValue, float maxValue, std::uint32_t bitCount);
+    glm::vec3 readQuantizedVec3(float minValue, float maxValue, std::uint32_t bitCount);
+    glm::quat readCompressedQuat(std::uint32_t bitCount = 10);
+
+    // Set when a read ran past the end of the payload; such reads return zeros.
+    [[nodiscard]] bool readOverflowed() const { return readOverflow; }
+
     // Packet info
     [[nodiscard]] std::uint16_t type() const { return header.type; }
     [[nodiscard]] SequenceNumber sequence() const { return header.sequence; }
     [[nodiscard]] std::size_t payloadSize() const { return payload.size(); }
     [[nodiscard]] const std::vector<std::uint8_t>& data() const { return payload; }
+
+    // Wire format: HeaderSize bytes of header followed by the payload.
+    static constexpr std::size_t HeaderSize = 18;
+    [[nodiscard]] std::size_t wireSize() const { return HeaderSize + payload.size(); }
+    // Writes the wire format into `out` and returns the bytes written, or 0 if it does not fit.
+    std::size_t serializeInto(std::uint8_t* out, std::size_t capacity) const;
     [[nodiscard]] std::vector<std::uint8_t> serialize() const;
+    // Replaces header and payload with a datagram in wire format; false if it is malformed.
+    bool deserialize(const std::uint8_t* data, std::size_t size);
 
     void setType(std::uint16_t type) { header.type = type; }
     void setSequence(SequenceNumber seq) { header.sequence = seq; }
     void reset();
-    void resetRead() { readPos = 0; }
+    void resetRead();
 
 private:
+    std::uint8_t* appendBytes(std::size_t count);
+    const std::uint8_t* consumeBytes(std::size_t count);
     void ensureCapacity(std::size_t additionalBytes);
 
     PacketHeader header;
     std::vector<std::uint8_t> payload;
     std::size_t readPos{0};
+    std::uint32_t writeBitOffset{0};  // Bits used in the last payload byte; 0 when byte-aligned.
+    std::uint32_t readBitOffset{0};   // Bits consumed from payload[readPos].
+    bool readOverflow{false};
 };
 
 // ============================================================================
@@ -161,6 +235,8 @@ namespace PacketTypes {
     constexpr std::uint16_t RPC = 20;
     constexpr std::uint16_t StateSnapshot = 30;
     constexpr std::uint16_t StateDelta = 31;
+    constexpr std::uint16_t SnapshotAck = 32;
+    constexpr std::uint16_t OwnershipRequest = 33;
     constexpr std::uint16_t Input = 40;
     constexpr std::uint16_t UserBase = 100;  // User-defined packets start here
 }
@@ -228,6 +304,32 @@ private:
 // Socket Abstraction
 // ============================================================================
 
+struct Datagram {
+    NetworkAddress address;
+    const std::uint8_t* data{nullptr};
+    std::size_t size{0};
+};
+
+// Receive slots reused by Socket::receiveBatch(); datagrams stay valid until the next call.
+class DatagramBatch {
+public:
+    explicit DatagramBatch(std::size_t capacity = DefaultCapacity, std::size_t slotSize = MaxDatagramSize);
+
+    [[nodiscard]] std::size_t size() const { return count; }
+    [[nodiscard]] std::size_t capacity() const { return datagrams.size(); }
+    [[nodiscard]] const Datagram& operator[](std::size_t index) const { return datagrams[index]; }
+
+    static constexpr std::size_t DefaultCapacity = 32;
+
+private:
+    friend class Socket;
+
+    std::vector<std::uint8_t> storage;
+    std::vector<Datagram> datagrams;
+    std::size_t slotSize;
+    std::size_t count{0};
+};
+
 class Socket {
 public:
     Socket();
@@ -242,6 +344,15 @@ public:
     bool sendTo(const NetworkAddress& address, const void* data, std::size_t size);
     int receiveFrom(NetworkAddress& address, void* buffer, std::size_t bufferSize);
 
+    // Batched UDP operations: recvmmsg/sendmmsg on Linux, a loop of single calls elsewhere.
+    // receiveBatch() does not block and returns the number of datagrams read (0 if none were
+    // pending, -1 on error); sendBatch() returns the number of datagrams sent.
+    int receiveBatch(DatagramBatch& batch);
+    std::size_t sendBatch(const Datagram* datagrams, std::size_t count);
+    // Blocks until a datagram can be read or the timeout passes (epoll on Linux, poll elsewhere).
+    bool waitReadable(int timeoutMilliseconds);
+    [[nodiscard]] std::uint16_t localPort() const;
+
     // TCP operations (for initial connection or fallback)
     bool connect(const NetworkAddress& address);
     bool listen(std::uint16_t port, int backlog = 10);
@@ -256,9 +367,13 @@ public:
 
 private:
     int socketHandle{-1};
+    int pollHandle{-1};  // epoll instance watching socketHandle, created on first wait.
     bool isTcp{false};
 };
 
+// How long the network threads block waiting for datagrams before rechecking for shutdown.
+constexpr int NetworkPollTimeoutMs = 10;
+
 // ============================================================================
 // Network Events
 // ============================================================================
@@ -319,17 +434,28 @@ public:
     // Update (call each frame)
     void update();
 
-    // Server info
+    // Server info (the port picked by the OS when started on port 0)
     [[nodiscard]] std::uint16_t port() const { return serverPort; }
 
+    // Largest packet sent or accepted, in wire bytes; takes effect on the next start().
+    void setMaxPacketSize(std::size_t bytes) { maxPacketBytes = std::clamp<std::size_t>(bytes, Packet::HeaderSize, MaxDatagramSize); }
+    [[nodiscard]] std::size_t maxPacketSize() const { return maxPacketBytes; }
+    // Datagrams discarded because they did not parse as a packet.
+    [[nodiscard]] std::uint64_t droppedPackets() const { return droppedDatagrams.load(std::memory_order_relaxed); }
+
 private:
     void networkThread();
     void processIncomingPacket(const NetworkAddress& from, const std::uint8_t* data, std::size_t size);
+    // Shared by send() and the broadcasts: serializes once and sends every recipient in one batch.
+    // A valid target sends only to that client; otherwise every client except excludeId receives it.
+    void deliver(const Packet& packet, PacketReliability reliability, ClientId target, ClientId excludeId);
     ClientId generateClientId();
 
     std::unique_ptr<Socket> socket;
     std::uint16_t serverPort{0};
     std::uint32_t maxClients{32};
+    std::size_t maxPacketBytes{DefaultMaxPacketSize};
+    std::atomic<std::uint64_t> droppedDatagrams{0};
     std::atomic<bool> running{false};
     std::thread networkWorker;
 
@@ -383,13 +509,21 @@ public:
     [[nodiscard]] const ConnectionStats& stats() const { return statistics; }
     [[nodiscard]] float ping() const { return statistics.smoothedRTT * 1000.0f; }
 
+    // Largest packet sent or accepted, in wire bytes; takes effect on the next connect().
+    void setMaxPacketSize(std::size_t bytes) { maxPacketBytes = std::clamp<std::size_t>(bytes, Packet::HeaderSize, MaxDatagramSize); }
+    [[nodiscard]] std::size_t maxPacketSize() const { return maxPacketBytes; }
+    // Datagrams discarded because they did not parse as a packet.
+    [[nodiscard]] std::uint64_t droppedPackets() const { return droppedDatagrams.load(std::memory_order_relaxed); }
+
 private:
     void networkThread();
-    void processIncomingPacket(const std::uint8_t* data, std::size_t size);
+    void processIncomingPacket(const Packet& packet);
     void sendPing();
 
     std::unique_ptr<Socket> socket;
     NetworkAddress serverAddress;
+    std::size_t maxPacketBytes{DefaultMaxPacketSize};
+    std::atomic<std::uint64_t> droppedDatagrams{0};
     std::atomic<ConnectionState> connectionState{ConnectionState::Disconnected};
     std::thread networkWorker;
     std::atomic<bool> running{false};
@@ -439,6 +573,11 @@ struct ReplicatedComponent {
 // Network Synchronization System
 // ============================================================================
 
+// Replicates the transforms of registered entities as delta snapshots. The server keeps, per
+// client, the snapshots it sent and the newest one the client acknowledged; each delta is encoded
+// against that acknowledged baseline, so lost packets never corrupt the client's state and only
+// entities whose quantized transform changed cost more than nothing. The client keeps a window of
+// the snapshots it applied so any of them can serve as a baseline, and acknowledges each one.
 class NetworkSyncSystem {
 public:
     NetworkSyncSystem();
@@ -457,44 +596,133 @@ public:
                                      std::function<void(const T&, Packet&)> serialize,
                                      std::function<void(T&, Packet&)> deserialize);
 
-    // Sync updates
+    // Sync updates: a server sends every connected client a delta against its baseline.
     void update(Scene& scene, float deltaSeconds);
+    // Routes StateSnapshot, StateDelta, SnapshotAck and OwnershipRequest packets; returns false for
+    // packets that are not replication traffic.
+    bool processPacket(Scene& scene, ClientId sender, const Packet& packet);
 
-    // State snapshots
+    // State snapshots (full state, no baseline)
     Packet createSnapshot(const Scene& scene) const;
     void applySnapshot(Scene& scene, const Packet& snapshot);
 
-    // Delta compression
-    Packet createDelta(const Scene& scene) const;
-    void applyDelta(Scene& scene, const Packet& delta);
+    // Delta compression against the snapshot `clientId` last acknowledged. The snapshot is
+    // remembered as sent until it is acknowledged or falls out of the window.
+    Packet createDelta(const Scene& scene, ClientId clientId);
+    // Captures the scene once and hands every client's delta to `send`; update() sends through this.
+    void createDeltas(const Scene& scene, const std::vector<ClientId>& clients,
+                      const std::function<void(ClientId, const Packet&)>& send);
+    // Applies a delta or snapshot; false if its baseline is no longer known (the packet is
+    // dropped and the server keeps using the last acknowledged baseline). A full snapshot (baseline
+    // sequence 0) replaces the replicated state, so replicas it does not list are removed.
+    bool applyDelta(Scene& scene, const Packet& delta);
+    void acknowledgeSnapshot(ClientId clientId, SequenceNumber sequence);
+    // Acknowledgement of the newest applied snapshot, for the client to send back.
+    [[nodiscard]] Packet createAck() const;
+    [[nodiscard]] SequenceNumber lastAppliedSnapshot() const { return appliedSnapshots.empty() ? 0 : appliedSnapshots.back().sequence; }
+    [[nodiscard]] SequenceNumber acknowledgedSnapshot(ClientId clientId) const;
+    void removeClient(ClientId clientId);
+
+    // Interest management. A client with a view only receives entities within `radius` of
+    // `position`; entities that leave it are removed on the client, where their replicas are
+    // hidden until they come back. Changed entities compete for the per-client byte budget by
+    // priority, which grows every tick an entity is out of date and faster the closer it is, so
+    // distant entities are updated less often but never starve.
+    void setClientView(ClientId clientId, const glm::vec3& position, float radius);
+    void clearClientView(ClientId clientId);
+    // Payload bytes per client and tick; 0 means one datagram. The budget is capped to the server's
+    // max packet size (DefaultMaxPacketSize without a server), so every delta fits one datagram
+    // and whatever does not fit follows on later ticks.
+    void setBandwidthBudget(std::size_t bytesPerTick) { bandwidthBudget = bytesPerTick; }
+    [[nodiscard]] std::size_t getBandwidthBudget() const { return bandwidthBudget; }
+    // Edge of the uniform grid used to find the entities around each view.
+    void setInterestCellSize(float size) { interestCellSize = size > 0.0f ? size : interestCellSize; }
 
     // Ownership
     void setOwner(std::uint32_t networkId, ClientId owner);
     void requestOwnership(std::uint32_t networkId);
+    [[nodiscard]] const NetworkIdentity* identity(std::uint32_t networkId) const;
 
     // Network ID lookup
     [[nodiscard]] GameObject* getObject(std::uint32_t networkId);
     [[nodiscard]] std::uint32_t getNetworkId(const GameObject& object) const;
 
+    // Quantization of replicated transforms: units per step.
+    static constexpr float PositionResolution = 1.0f / 1024.0f;
+    static constexpr float RotationResolution = 1.0f / 4096.0f;
+    static constexpr float ScaleResolution = 1.0f / 1024.0f;
+    // Unacknowledged snapshots kept per client; a baseline older than this is not used.
+    static constexpr std::size_t SnapshotWindow = 32;
+
 private:
-    void sendEntityCreate(std::uint32_t networkId, const GameObject& object);
-    void sendEntityDestroy(std::uint32_t networkId);
-    void sendEntityUpdate(std::uint32_t networkId, const GameObject& object);
-    void processEntityCreate(const Packet& packet);
-    void processEntityDestroy(const Packet& packet);
-    void processEntityUpdate(const Packet& packet);
+    static constexpr std::size_t FieldCount = 9;  // position, rotation, scale
+
+    struct EntityState {
+        std::uint32_t networkId{0};
+        std::array<std::int32_t, FieldCount> fields{};
+    };
+
+    struct SnapshotRecord {
+        SequenceNumber sequence{0};
+        std::vector<EntityState> entities;  // Sorted by networkId.
+    };
+
+    struct ClientBaseline {
+        std::deque<SnapshotRecord> sent;
+        SnapshotRecord acked;
+        bool hasAck{false};
+        SequenceNumber nextSequence{1};
+
+        bool hasView{false};
+        glm::vec3 viewPosition{0.0f};
+        float viewRadius{0.0f};
+        std::vector<float> priority;  // Indexed by networkId.
+    };
+
+    struct Candidate {
+        std::uint32_t index{0};  // Into captureScratch.
+        std::uint32_t bits{0};   // Estimated encoded size.
+        bool selected{false};
+    };
+
+    void captureState(std::vector<EntityState>& out) const;
+    // Captures the registered entities once for all the deltas of a tick.
+    void prepareTick();
+    void buildInterestGrid();
+    // Indices into captureScratch of the entities relevant to `state`, in networkId order.
+    void gatherRelevant(const ClientBaseline& state, std::vector<std::uint32_t>& out);
+    void encodeClientDelta(ClientId clientId, Packet& packet);
+    // Payload bytes one client's delta may take.
+    [[nodiscard]] std::size_t payloadBudget() const;
+    static void encodeDelta(const std::vector<EntityState>& current, const SnapshotRecord* baseline,
+                            SequenceNumber sequence, Packet& packet);
+    void applyRecord(Scene& scene, const SnapshotRecord& record);
 
     NetworkServer* server{nullptr};
     NetworkClient* client{nullptr};
 
     std::unordered_map<std::uint32_t, GameObject*> networkIdToObject;
     std::unordered_map<const GameObject*, std::uint32_t> objectToNetworkId;
+    std::unordered_map<std::uint32_t, NetworkIdentity> identities;
     std::uint32_t nextNetworkId{1};
 
     std::unordered_map<std::string, ReplicatedComponent> componentRegistry;
 
-    // For delta compression
-    std::unordered_map<std::uint32_t, std::vector<std::uint8_t>> lastSentState;
+    // Server side: per-client baselines. Client side: the snapshots applied most recently.
+    std::unordered_map<ClientId, ClientBaseline> clientBaselines;
+    std::deque<SnapshotRecord> appliedSnapshots;
+    std::unordered_map<std::uint32_t, GameObject*> dormantObjects;  // Client: replicas out of interest.
+    std::vector<EntityState> captureScratch;
+
+    std::size_t bandwidthBudget{0};
+    float interestCellSize{32.0f};
+    bool interestGridValid{false};
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> interestGrid;  // (cell key, index), sorted.
+    std::vector<std::uint32_t> relevantScratch;
+    std::vector<Candidate> candidateScratch;
+    std::vector<std::uint32_t> orderScratch;
+    std::vector<EntityState> targetScratch;
+    std::vector<std::uint32_t> removedScratch;
 };
 
 // ============================================================================
@@ -531,25 +759,62 @@ private:
 // Lag Compensation
 // ============================================================================
 
-struct HistoricalState {
-    float timestamp;
-    std::unordered_map<std::uint32_t, Transform> transforms;
-};
-
+// Server-side history of every object's transform for validating hits at the time the shooter
+// saw them. Ticks are kept in a fixed ring of structure-of-arrays snapshots, indexed by object
+// position in Scene::objects(), so recording reuses the same storage every tick; lookups binary
+// search the ring and interpolate between the two neighbouring ticks.
 class LagCompensation {
 public:
-    LagCompensation(float historyDuration = 1.0f);
+    explicit LagCompensation(float historyDuration = 1.0f, float tickRate = 60.0f);
 
     void recordState(const Scene& scene, float timestamp);
-    void rewindTo(Scene& scene, float timestamp) const;
-    void restoreState(Scene& scene) const;
 
-    void setHistoryDuration(float seconds) { maxHistoryDuration = seconds; }
+    // Moves every recorded object to where it was at `timestamp` (clamped to the history).
+    void rewindTo(Scene& scene, float timestamp);
+    // Rewinds only the objects whose position at `timestamp` lies within `radius` of the segment
+    // from `origin` along the normalized `direction` for `maxDistance`; returns how many moved.
+    std::size_t rewindAlongRay(Scene& scene, float timestamp, const glm::vec3& origin, const glm::vec3& direction,
+                               float maxDistance, float radius);
+    // Puts back the transforms changed by the last rewind.
+    void restoreState(Scene& scene);
+    // Indices into Scene::objects() moved by the last rewind.
+    [[nodiscard]] const std::vector<std::size_t>& rewoundObjects() const { return rewound; }
+
+    // Interpolated transform of object `objectIndex` at `timestamp`; false if it is not recorded.
+    bool sample(std::size_t objectIndex, float timestamp, Transform& out) const;
+
+    void setHistoryDuration(float seconds);
+    [[nodiscard]] std::size_t historySize() const { return count; }
+    [[nodiscard]] std::size_t capacity() const { return ring.size(); }
 
 private:
+    struct TransformSnapshot {
+        float timestamp{0.0f};
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> rotations;
+        std::vector<glm::vec3> scales;
+    };
+
+    // The two snapshots around `timestamp` and the blend factor between them.
+    struct Bracket {
+        const TransformSnapshot* before{nullptr};
+        const TransformSnapshot* after{nullptr};
+        float alpha{0.0f};
+    };
+
+    // The `i`-th oldest snapshot.
+    [[nodiscard]] const TransformSnapshot& snapshotAt(std::size_t i) const { return ring[(head + i) % ring.size()]; }
+    [[nodiscard]] Bracket bracket(float timestamp) const;
+    static void blend(const Bracket& around, std::size_t index, Transform& out);
+    void rewindObject(Scene& scene, std::size_t index, const Bracket& around);
+
     float maxHistoryDuration;
-    std::deque<HistoricalState> stateHistory;
-    HistoricalState currentState;
+    float ticksPerSecond;
+    std::vector<TransformSnapshot> ring;
+    std::size_t head{0};   // Oldest snapshot.
+    std::size_t count{0};
+    std::vector<std::size_t> rewound;
+    std::vector<Transform> savedTransforms;  // Parallel to `rewound`.
 };
 
 // ============================================================================
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace vkengine {
+
+struct Particle {
+    glm::vec3 position{0.0f};
+    glm::vec3 velocity{0.0f};
+    float age{0.0f};
+    float lifetime{0.0f};
+    float scale{0.1f};
+    float mass{1.0f};
+
+    [[nodiscard]] bool alive() const noexcept { return age < lifetime; }
+};
+
+// Structure-of-arrays particle pool. Live particles always occupy slots [0, size()); a particle
+// that dies is swap-removed, so the update kernels and the render upload walk dense arrays and
+// never visit dead slots. The kernels run on the widest vector path the build enables.
+class ParticleStore {
+public:
+    // Storage is allocated up front; particles past a smaller capacity are dropped.
+    void setCapacity(std::size_t newCapacity);
+    [[nodiscard]] std::size_t capacity() const noexcept { return maxCount; }
+    [[nodiscard]] std::size_t size() const noexcept { return count; }
+    [[nodiscard]] bool empty() const noexcept { return count == 0; }
+    [[nodiscard]] bool full() const noexcept { return count >= maxCount; }
+
+    // Appends a particle; does nothing when the pool is full.
+    void push(const Particle& particle);
+    // Removes the particle in `slot` by moving the last particle into it.
+    void remove(std::size_t slot);
+    void clear() noexcept { count = 0; }
+
+    [[nodiscard]] Particle get(std::size_t slot) const;
+    void set(std::size_t slot, const Particle& particle);
+    [[nodiscard]] glm::vec3 position(std::size_t slot) const { return {posX[slot], posY[slot], posZ[slot]}; }
+    [[nodiscard]] float mass(std::size_t slot) const { return massValues[slot]; }
+
+    // v = (v + a dt) * damping, then p += v dt. The acceleration arrays hold size() entries.
+    void integrate(const float* accelX, const float* accelY, const float* accelZ, float damping, float deltaSeconds);
+    // Ages every particle and swap-removes the ones that reached their lifetime.
+    void advanceAges(float deltaSeconds);
+    // normalizedAge = clamp(age / lifetime, 0, 1) and color = mix(start, end, normalizedAge).
+    void updateColors(const glm::vec4& start, const glm::vec4& end);
+
+    // Views of the live particles; element i of every span is the same particle.
+    [[nodiscard]] std::span<const float> positionsX() const noexcept { return {posX.data(), count}; }
+    [[nodiscard]] std::span<const float> positionsY() const noexcept { return {posY.data(), count}; }
+    [[nodiscard]] std::span<const float> positionsZ() const noexcept { return {posZ.data(), count}; }
+    [[nodiscard]] std::span<const float> velocitiesX() const noexcept { return {velX.data(), count}; }
+    [[nodiscard]] std::span<const float> velocitiesY() const noexcept { return {velY.data(), count}; }
+    [[nodiscard]] std::span<const float> velocitiesZ() const noexcept { return {velZ.data(), count}; }
+    [[nodiscard]] std::span<const float> ages() const noexcept { return {ageValues.data(), count}; }
+    [[nodiscard]] std::span<const float> lifetimes() const noexcept { return {lifetimeValues.data(), count}; }
+    [[nodiscard]] std::span<const float> scales() const noexcept { return {scaleValues.data(), count}; }
+    [[nodiscard]] std::span<const float> masses() const noexcept { return {massValues.data(), count}; }
+    // As of the last updateColors().
+    [[nodiscard]] std::span<const float> normalizedAges() const noexcept { return {normalizedAgeValues.data(), count}; }
+    [[nodiscard]] std::span<const float> colorsR() const noexcept { return {colorR.data(), count}; }
+    [[nodiscard]] std::span<const float> colorsG() const noexcept { return {colorG.data(), count}; }
+    [[nodiscard]] std::span<const float> colorsB() const noexcept { return {colorB.data(), count}; }
+    [[nodiscard]] std::span<const float> colorsA() const noexcept { return {colorA.data(), count}; }
+
+    // Float lanes of the update kernels in this build (1 when only the scalar path exists).
+    [[nodiscard]] static std::size_t simdWidth() noexcept;
+
+private:
+    template<typename Lanes>
+    friend struct ParticleKernel;
+
+    std::size_t count{0};
+    std::size_t maxCount{0};
+
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> ageValues;
+    std::vector<float> lifetimeValues;
+    std::vector<float> scaleValues;
+    std::vector<float> massValues;
+    std::vector<float> normalizedAgeValues;
+    std::vector<float> colorR, colorG, colorB, colorA;
+};
+
+} // namespace vkengine
@@ -2,6 +2,8 @@
 
 #include "core/ecs/Components.hpp"
 #include "core/ecs/Registry.hpp"
+#include "engine/GravityOctree.hpp"
+#include "engine/ParticleStore.hpp"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
@@ -33,15 +35,10 @@ enum class ParticleRenderMode : std::uint32_t {
 
 constexpr std::size_t kParticleShapeCount = 3;
 
-struct Particle {
-    glm::vec3 position{0.0f};
-    glm::vec3 velocity{0.0f};
-    float age{0.0f};
-    float lifetime{0.0f};
-    float scale{0.1f};
-    float mass{1.0f};
-
-    [[nodiscard]] bool alive() const noexcept { return age < lifetime; }
+// How ParticleEmitter sums the mutual gravity of its particles.
+enum class ParticleGravitySolver : std::uint32_t {
+    Direct = 0,    // Exact all-pairs sum, O(n^2).
+    BarnesHut = 1  // Octree approximation, O(n log n); see setOpeningAngle().
 };
 
 class ParticleEmitter {
@@ -87,17 +84,26 @@ public:
     void setSoftening(float value) noexcept { softening = std::max(0.0f, value); }
     void setDamping(float value) noexcept { damping = std::clamp(value, 0.0f, 1.0f); }
     void setSolverSubsteps(std::uint32_t substeps) noexcept { solverSubsteps = std::max<std::uint32_t>(1, substeps); }
+    void setGravitySolver(ParticleGravitySolver solver) noexcept { gravitySolver = solver; }
+    // Barnes-Hut accuracy: a cell is treated as one mass when its size is below this fraction of
+    // its distance. 0 is exact; 0.5 - 0.7 is the usual range.
+    void setOpeningAngle(float theta) noexcept { openingAngle = std::clamp(theta, 0.0f, 2.0f); }
+    [[nodiscard]] ParticleGravitySolver gravitySolverValue() const noexcept { return gravitySolver; }
+    [[nodiscard]] float openingAngleValue() const noexcept { return openingAngle; }
     void setMaxParticles(std::size_t maxParticles);
 
     [[nodiscard]] const std::string& name() const noexcept { return emitterName; }
-    [[nodiscard]] std::vector<Particle>& particles() noexcept { return particlePool; }
-    [[nodiscard]] const std::vector<Particle>& particles() const noexcept { return particlePool; }
-    [[nodiscard]] std::size_t maxParticles() const noexcept { return particlePool.size(); }
+    // Live particles only; the pool is filled to capacity on the first update().
+    [[nodiscard]] ParticleStore& particles() noexcept { return particlePool; }
+    [[nodiscard]] const ParticleStore& particles() const noexcept { return particlePool; }
+    [[nodiscard]] std::size_t maxParticles() const noexcept { return particlePool.capacity(); }
 
     void update(float deltaSeconds);
 
 private:
-    void spawnParticle(Particle& particle);
+    void accumulateDirectAccelerations(float minMassValue);
+    void accumulateTreeAccelerations(float minMassValue);
+    Particle spawnParticle();
     glm::vec3 randomDirection();
     void warmStartParticles();
 
@@ -118,8 +124,15 @@ private:
     float damping{0.999f};
     std::uint32_t solverSubsteps{4};
     float accumulator{0.0f};
-    std::vector<Particle> particlePool;
-    std::vector<glm::vec3> accelerationScratch;
+    ParticleStore particlePool;
+    std::vector<float> accelerationX;
+    std::vector<float> accelerationY;
+    std::vector<float> accelerationZ;
+    ParticleGravitySolver gravitySolver{ParticleGravitySolver::Direct};
+    float openingAngle{0.5f};
+    GravityOctree gravityTree;
+    std::vector<glm::vec3> gravityPositions;
+    std::vector<glm::vec3> gravityFields;
     bool needsWarmStart{true};
     ParticleShape particleShape{ParticleShape::SoftCircle};
     ParticleRenderMode renderMode{ParticleRenderMode::Billboard};
@@ -141,6 +154,8 @@ public:
 
     void update(float deltaSeconds);
 
+    // Calls func(emitter, store) for every enabled emitter. The store's spans cover exactly the live
+    // particles, so callers can process them as contiguous arrays.
     template <typename Func>
     void forEachAliveParticleWithEmitter(Func&& func) const
     {
@@ -152,30 +167,17 @@ public:
                 return;
             }
             const auto& emitter = *component.emitter;
-            for (const auto& particle : component.emitter->particles()) {
-                if (particle.alive()) {
-                    func(emitter, particle);
-                }
+            if (!emitter.particles().empty()) {
+                func(emitter, emitter.particles());
             }
         });
     }
 
+    // Calls func(store) for every enabled emitter with live particles.
     template <typename Func>
     void forEachAliveParticle(Func&& func) const
     {
-        if (ecsRegistry == nullptr) {
-            return;
-        }
-        ecsRegistry->view<ParticleEmitterComponent>([&](auto, ParticleEmitterComponent& component) {
-            if (!component.enabled || !component.emitter) {
-                return;
-            }
-            for (const auto& particle : component.emitter->particles()) {
-                if (particle.alive()) {
-                    func(particle);
-                }
-            }
-        });
+        forEachAliveParticleWithEmitter([&](const ParticleEmitter&, const ParticleStore& store) { func(store); });
     }
 
 private:
@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
+
 namespace vkengine {
 
 struct AABB;
@@ -17,6 +19,8 @@ struct CollisionResult {
 struct Contact {
     GameObject* a{nullptr};
     GameObject* b{nullptr};
+    std::uint32_t indexA{0};  // Positions of a/b in the scene object list, used to build islands.
+    std::uint32_t indexB{0};
     glm::vec3 normal{0.0f};
     glm::vec3 contactPoint{0.0f};
     glm::vec3 ra{0.0f};
@@ -39,6 +43,8 @@ glm::mat3 inertiaTensor(const GameObject& object);
 glm::mat3 inverseInertiaTensor(const GameObject& object);
 glm::vec3 applyInverseInertia(const glm::mat3& inverse, const glm::vec3& value);
 glm::vec3 estimateContactPoint(const GameObject& a, const GameObject& b, const glm::vec3& normal, float penetration = 0.0f);
+glm::vec3 estimateContactPoint(const glm::vec3& posA, const AABB& boundsA, const glm::vec3& posB, const AABB& boundsB,
+                               const glm::vec3& normal);
 bool computePenetration(const AABB& a, const AABB& b, CollisionResult& result);
 float combineCoefficient(float a, float b);
 
@@ -4,6 +4,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 namespace vkengine {
 
@@ -12,6 +13,8 @@ struct AABB;
 class Scene;
 class GameObject;
 class GpuCollisionSystem;
+class Broadphase;
+class RigidBodyStore;
 
 class PhysicsSystem {
 public:
@@ -35,8 +38,27 @@ public:
     [[nodiscard]] GpuCollisionSystem* gpuCollision() noexcept { return gpuCollisionSystem.get(); }
     [[nodiscard]] const GpuCollisionSystem* gpuCollision() const noexcept { return gpuCollisionSystem.get(); }
 
+    // Island sleeping: a contact island whose bodies all stay below the speed thresholds for
+    // kTimeToSleep seconds is put to sleep and skipped until a force, a new velocity or contact
+    // with an awake body wakes it. The linear threshold applies to the distance moved per step.
+    static constexpr float kSleepLinearVelocity = 0.05f;
+    static constexpr float kSleepAngularVelocity = 0.05f;
+    static constexpr float kTimeToSleep = 0.5f;
+
+    void setSleepingEnabled(bool enabled) noexcept { sleepingEnabled = enabled; }
+    [[nodiscard]] bool isSleepingEnabled() const noexcept { return sleepingEnabled; }
+
     void update(Scene& scene, float deltaSeconds);
 
+    // Statistics from the last CPU collision pass.
+    [[nodiscard]] std::size_t islandCount() const noexcept { return lastIslandCount; }
+    [[nodiscard]] std::size_t sleepingBodyCount() const noexcept { return lastSleepingCount; }
+
+    // Persistent CPU broadphase, kept across steps (exposed for statistics).
+    [[nodiscard]] const Broadphase& cpuBroadphase() const noexcept { return *broadphase; }
+    // Structure-of-arrays body state from the last update (index i is scene.objectsCached()[i]).
+    [[nodiscard]] const RigidBodyStore& rigidBodies() const noexcept { return *bodies; }
+
 private:
     void resolveCollisions(Scene& scene, float deltaSeconds);
     void resolveCollisionsGpu(Scene& scene, float deltaSeconds);
@@ -44,7 +66,13 @@ private:
 private:
     glm::vec3 gravity{0.0f, -9.81f, 0.0f};
     bool useGpuCollision{false};
+    bool sleepingEnabled{true};
+    std::size_t lastIslandCount{0};
+    std::size_t lastSleepingCount{0};
     std::unique_ptr<GpuCollisionSystem> gpuCollisionSystem;
+    std::unique_ptr<Broadphase> broadphase;
+    std::unique_ptr<RigidBodyStore> bodies;  // Packed body state, synced with the ECS once per update.
+    std::vector<glm::vec3> stepStartPositions;  // Per scene object, for sleep detection.
 };
 
 } // namespace vkengine
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "core/ecs/Components.hpp"
+#include "core/ecs/Entity.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkengine {
+
+class GameObject;
+
+// Structure-of-arrays copy of the rigid-body state the physics step works on. It is filled from
+// the ECS once per frame with gather(), integrated and solved in place for every substep, and
+// written back with scatter(). Orientations are kept as quaternions; they are only converted
+// from/to the Euler angles in Transform when game code changed the rotation or on write-back.
+class RigidBodyStore {
+public:
+    // Copies the state of `objects` in; index i in the store is objects[i]. Sleeping bodies that
+    // were given a velocity or force since the last scatter() are woken, all of them when
+    // `allowSleeping` is false.
+    void gather(const std::vector<GameObject*>& objects, bool allowSleeping);
+
+    // Writes the state back to the ECS and clears the accumulated forces and torques.
+    void scatter(const std::vector<GameObject*>& objects);
+
+    // Semi-implicit Euler step for every awake simulated body, split into chunks on the job pool.
+    // Each chunk uses the widest vector path the build enables (AVX2, SSE2) and finishes its
+    // remainder with the scalar kernel. Forces and torques are consumed by the first call after
+    // gather().
+    void integrate(const glm::vec3& gravity, float deltaSeconds);
+
+    // Same step with the scalar kernel only; the reference for the vector paths.
+    void integrateScalar(const glm::vec3& gravity, float deltaSeconds);
+
+    // Largest speed an awake body would reach after one step of `deltaSeconds`.
+    [[nodiscard]] float maxPredictedSpeed(const glm::vec3& gravity, float deltaSeconds) const;
+
+    [[nodiscard]] std::size_t size() const noexcept { return count; }
+    // Float lanes of the vector integrator in this build (1 when only the scalar path exists).
+    [[nodiscard]] static std::size_t simdWidth() noexcept;
+
+    [[nodiscard]] glm::vec3 position(std::size_t i) const { return {posX[i], posY[i], posZ[i]}; }
+    void setPosition(std::size_t i, const glm::vec3& value) { posX[i] = value.x; posY[i] = value.y; posZ[i] = value.z; }
+    [[nodiscard]] glm::vec3 velocity(std::size_t i) const { return {velX[i], velY[i], velZ[i]}; }
+    void setVelocity(std::size_t i, const glm::vec3& value) { velX[i] = value.x; velY[i] = value.y; velZ[i] = value.z; }
+    [[nodiscard]] glm::vec3 angularVelocity(std::size_t i) const { return {angX[i], angY[i], angZ[i]}; }
+    void setAngularVelocity(std::size_t i, const glm::vec3& value) { angX[i] = value.x; angY[i] = value.y; angZ[i] = value.z; }
+    [[nodiscard]] glm::quat orientation(std::size_t i) const { return {rotW[i], rotX[i], rotY[i], rotZ[i]}; }
+    [[nodiscard]] glm::vec3 halfExtents(std::size_t i) const { return {halfX[i], halfY[i], halfZ[i]}; }
+
+    // World AABB of the collider, matching GameObject::worldBounds().
+    [[nodiscard]] AABB worldBounds(std::size_t i) const;
+    // R * diag(inverse body inertia) * R^T, matching physics_detail::inverseInertiaTensor().
+    [[nodiscard]] glm::mat3 inverseInertiaWorld(std::size_t i) const;
+
+    [[nodiscard]] bool hasCollider(std::size_t i) const { return (flags[i] & kHasCollider) != 0; }
+    [[nodiscard]] bool isSimulated(std::size_t i) const { return (flags[i] & kSimulated) != 0; }
+    [[nodiscard]] bool isSleeping(std::size_t i) const { return (flags[i] & kSleeping) != 0; }
+    void wake(std::size_t i);
+    void putToSleep(std::size_t i);
+
+    // 0 for bodies without a collider, static colliders and invalid masses.
+    std::vector<float> contactInverseMass;
+    std::vector<float> restitution;
+    std::vector<float> staticFriction;
+    std::vector<float> dynamicFriction;
+    std::vector<float> sleepTime;
+    std::vector<core::ecs::EntityId> entities;
+
+private:
+    enum Flags : std::uint8_t {
+        kHasCollider = 1u << 0,
+        kStaticCollider = 1u << 1,
+        kSimulated = 1u << 2,  // simulate is set and the mass is valid.
+        kSleeping = 1u << 3,
+    };
+
+    template<typename Lanes>
+    friend struct RigidBodyKernel;
+
+    void resize(std::size_t newCount);
+    void refreshIntegrationMask(std::size_t i);
+    void integrateRange(const glm::vec3& gravity, float deltaSeconds, std::size_t begin, std::size_t end);
+    void finishIntegration();
+
+    std::size_t count{0};
+
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> angX, angY, angZ;
+    std::vector<float> rotX, rotY, rotZ, rotW;
+    std::vector<float> forceX, forceY, forceZ;
+    std::vector<float> torqueX, torqueY, torqueZ;
+    std::vector<float> accelX, accelY, accelZ;
+    std::vector<float> inverseMass;                  // 1 / mass, 0 for invalid masses.
+    std::vector<float> linearDamping;                // Clamped to [0, 1].
+    std::vector<float> angularDissipation;           // Angular damping plus material dissipation.
+    std::vector<float> inertiaX, inertiaY, inertiaZ; // Body-frame principal inertia.
+    std::vector<float> invInertiaX, invInertiaY, invInertiaZ;
+    std::vector<float> halfX, halfY, halfZ;
+    std::vector<float> integrationMask;              // 1 for awake simulated bodies, 0 otherwise.
+    std::vector<std::uint8_t> flags;
+    std::vector<glm::vec3> eulerRotation;            // Transform::rotation as of the last sync.
+    bool forcesPending{false};
+};
+
+} // namespace vkengine
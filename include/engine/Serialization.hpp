@@ -7,6 +7,8 @@
 
 #include <glm/glm.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <memory>
@@ -201,6 +203,9 @@ class SceneSerializer {
 public:
     SceneSerializer() = default;
 
+    // Stamped into the "version" field of JSON scenes; versioned apart from the binary format.
+    // Version 2 added angular velocity, friction and collidable to the physics properties.
+    static constexpr std::uint32_t JsonVersion = 2;
     // Serialize entire scene to JSON
     [[nodiscard]] std::shared_ptr<JsonValue> serialize(const Scene& scene) const;
 
@@ -211,6 +216,18 @@ public:
     bool saveToFile(const Scene& scene, const std::filesystem::path& path) const;
     bool loadFromFile(Scene& scene, const std::filesystem::path& path) const;
 
+    // Binary scene format: a versioned header, then one flat array per component (transforms,
+    // physics, render state, colliders, lights) with strings deduplicated into a table, so loading
+    // is a single read or memory map followed by bulk object creation. JSON stays the format for
+    // diffs and debugging; custom component serializers only apply to JSON.
+    static constexpr std::uint32_t BinaryVersion = 1;
+    [[nodiscard]] std::vector<std::uint8_t> serializeBinary(const Scene& scene) const;
+    // Clears the scene and loads `data`; false (with the scene untouched) if it is not a valid
+    // scene of this or an older version.
+    bool deserializeBinary(Scene& scene, const std::uint8_t* data, std::size_t size) const;
+    bool saveBinaryFile(const Scene& scene, const std::filesystem::path& path) const;
+    bool loadBinaryFile(Scene& scene, const std::filesystem::path& path, bool memoryMap = true) const;
+
     // Serialize individual game object
     [[nodiscard]] std::shared_ptr<JsonValue> serializeGameObject(const GameObject& object) const;
     void deserializeGameObject(Scene& scene, const JsonValue& data) const;
@@ -2,6 +2,7 @@
 
 #include <glm/glm.hpp>
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <string>
@@ -22,6 +23,21 @@ struct MeshData {
     glm::vec3 boundsMax{0.0f};
 };
 
-[[nodiscard]] MeshData loadStlMesh(const std::filesystem::path& path);
+struct MeshLoadOptions {
+    // Merge corners that fall in the same weldTolerance-sized grid cell and whose face normals
+    // agree within creaseAngleDegrees into one indexed vertex. STL stores every triangle corner
+    // separately, so this is what shrinks the vertex buffer before upload.
+    bool weldVertices = true;
+    float weldTolerance = 1e-5f;
+    // 0 keeps flat shading exact; larger angles also merge across soft edges and average normals.
+    float creaseAngleDegrees = 0.0f;
+};
+
+// Memory-maps the file where the platform allows it. Binary STL is decoded straight from the
+// mapping; ASCII STL is split at facet boundaries and parsed in parallel.
+[[nodiscard]] MeshData loadStlMesh(const std::filesystem::path& path, const MeshLoadOptions& options = {});
+
+// Parses an STL image that is already in memory (binary or ASCII).
+[[nodiscard]] MeshData parseStlMesh(const std::uint8_t* data, std::size_t size, const MeshLoadOptions& options = {});
 
 } // namespace vkengine
@@ -3569,59 +3569,75 @@ void VulkanRenderer::updateParticleVertexBuffer(float /*deltaSeconds*/)
     }
 
     std::array<std::vector<ParticleVertex>, vkengine::kParticleShapeCount> shapeBuckets;
-    engine->particles().forEachAliveParticleWithEmitter([&](const vkengine::ParticleEmitter& emitter, const vkengine::Particle& particle) {
-        const glm::vec3 center = particle.position;
-        const float normalizedAge = particle.lifetime > 0.0f
-                        ? glm::clamp(particle.age / particle.lifetime, 0.0f, 1.0f)
-                        : 1.0f;
-        const float fade = 1.0f - normalizedAge;
-        const float hotCore = std::pow(fade, 2.6f);
-        const float taper = glm::mix(1.0f, 0.35f, normalizedAge);
-        const float flicker = 0.75f + 0.25f * glm::sin(20.0f * particle.age + glm::dot(particle.position, glm::vec3(11.3f, 7.1f, 5.7f)));
-        const float billboardSize = std::max(0.018f, particle.scale * (0.35f + 0.95f * hotCore) * taper);
-        const glm::vec3 right = cameraRight * billboardSize;
-        const glm::vec3 up = cameraUp * billboardSize;
-
-        const glm::vec4 startColor = emitter.getStartColor();
-        const glm::vec4 endColor = emitter.getEndColor();
-        const glm::vec4 baseColor = glm::mix(startColor, endColor, normalizedAge);
-        const float alpha = glm::clamp(baseColor.a * (0.25f + 1.05f * hotCore) * flicker * fade, 0.0f, 1.0f);
-        const glm::vec4 color{baseColor.r, baseColor.g, baseColor.b, alpha};
-
-        if (emitter.renderModeValue() == vkengine::ParticleRenderMode::Mesh) {
-            vkengine::RenderComponent render{};
-            render.mesh = emitter.meshTypeValue();
-            render.meshResource = emitter.meshResourceValue();
-            render.albedoTexture = "__default__";
-            render.baseColor = color;
-            render.opacity = alpha;
-
-            glm::mat4 model{1.0f};
-            model = glm::translate(model, center);
-            model = glm::scale(model, glm::vec3(emitter.meshScaleValue()));
-
-            particleMeshInstances.push_back({model, std::move(render)});
+    engine->particles().forEachAliveParticleWithEmitter([&](const vkengine::ParticleEmitter& emitter, const vkengine::ParticleStore& store) {
+        const std::size_t count = store.size();
+        const auto posX = store.positionsX();
+        const auto posY = store.positionsY();
+        const auto posZ = store.positionsZ();
+        const auto ages = store.ages();
+        const auto scales = store.scales();
+        const auto normalizedAges = store.normalizedAges();
+        const auto colorR = store.colorsR();
+        const auto colorG = store.colorsG();
+        const auto colorB = store.colorsB();
+        const auto colorA = store.colorsA();
+
+        const bool meshMode = emitter.renderModeValue() == vkengine::ParticleRenderMode::Mesh;
+        const auto shapeIndex = static_cast<std::size_t>(emitter.shape());
+        if (!meshMode && shapeIndex >= shapeBuckets.size()) {
             return;
         }
-
         const float shapeValue = static_cast<float>(emitter.shape());
-        ParticleVertex v0{center - right + up, {0.0f, 1.0f}, color, shapeValue};
-        ParticleVertex v1{center + right + up, {1.0f, 1.0f}, color, shapeValue};
-        ParticleVertex v2{center + right - up, {1.0f, 0.0f}, color, shapeValue};
-        ParticleVertex v3{center - right - up, {0.0f, 0.0f}, color, shapeValue};
+        ParticleVertex* out = nullptr;
+        if (!meshMode) {
+            auto& bucket = shapeBuckets[shapeIndex];
+            const std::size_t base = bucket.size();
+            bucket.resize(base + 6 * count);
+            out = bucket.data() + base;
+        }
 
-        const auto shapeIndex = static_cast<std::size_t>(emitter.shape());
-        if (shapeIndex >= shapeBuckets.size()) {
-            return;
+        for (std::size_t i = 0; i < count; ++i) {
+            const glm::vec3 center{posX[i], posY[i], posZ[i]};
+            const float normalizedAge = normalizedAges[i];
+            const float fade = 1.0f - normalizedAge;
+            const float hotCore = std::pow(fade, 2.6f);
+            const float taper = glm::mix(1.0f, 0.35f, normalizedAge);
+            const float flicker = 0.75f + 0.25f * glm::sin(20.0f * ages[i] + glm::dot(center, glm::vec3(11.3f, 7.1f, 5.7f)));
+            const float alpha = glm::clamp(colorA[i] * (0.25f + 1.05f * hotCore) * flicker * fade, 0.0f, 1.0f);
+            const glm::vec4 color{colorR[i], colorG[i], colorB[i], alpha};
+
+            if (meshMode) {
+                vkengine::RenderComponent render{};
+                render.mesh = emitter.meshTypeValue();
+                render.meshResource = emitter.meshResourceValue();
+                render.albedoTexture = "__default__";
+                render.baseColor = color;
+                render.opacity = alpha;
+
+                glm::mat4 model{1.0f};
+                model = glm::translate(model, center);
+                model = glm::scale(model, glm::vec3(emitter.meshScaleValue()));
+
+                particleMeshInstances.push_back({model, std::move(render)});
+                continue;
+            }
+
+            const float billboardSize = std::max(0.018f, scales[i] * (0.35f + 0.95f * hotCore) * taper);
+            const glm::vec3 right = cameraRight * billboardSize;
+            const glm::vec3 up = cameraUp * billboardSize;
+            const ParticleVertex v0{center - right + up, {0.0f, 1.0f}, color, shapeValue};
+            const ParticleVertex v1{center + right + up, {1.0f, 1.0f}, color, shapeValue};
+            const ParticleVertex v2{center + right - up, {1.0f, 0.0f}, color, shapeValue};
+            const ParticleVertex v3{center - right - up, {0.0f, 0.0f}, color, shapeValue};
+
+            *out++ = v0;
+            *out++ = v2;
+            *out++ = v1;
+
+            *out++ = v0;
+            *out++ = v3;
+            *out++ = v2;
         }
-        auto& bucket = shapeBuckets[shapeIndex];
-        bucket.push_back(v0);
-        bucket.push_back(v2);
-        bucket.push_back(v1);
-
-        bucket.push_back(v0);
-        bucket.push_back(v3);
-        bucket.push_back(v2);
     });
 
     uint32_t runningOffset = 0;
@@ -3723,8 +3739,8 @@ void VulkanRenderer::updateDeformableMeshes()
         if (body == nullptr) {
             return;
         }
-        const auto& nodes = body->nodes();
-        if (nodes.empty()) {
+        const std::size_t nodeCount = body->nodeCount();
+        if (nodeCount == 0) {
             return;
         }
 
@@ -3732,11 +3748,11 @@ void VulkanRenderer::updateDeformableMeshes()
         body->computeVertexNormals(normals);
 
         const uint32_t vertexOffset = static_cast<uint32_t>(deformableVertexScratch.size());
-        deformableVertexScratch.reserve(deformableVertexScratch.size() + nodes.size());
-        for (std::size_t i = 0; i < nodes.size(); ++i) {
+        deformableVertexScratch.reserve(deformableVertexScratch.size() + nodeCount);
+        for (std::size_t i = 0; i < nodeCount; ++i) {
             Vertex v{};
-            v.pos = nodes[i].position;
-            v.color = nodes[i].pinned ? pinnedColor : freeColor;
+            v.pos = body->nodePosition(i);
+            v.color = body->nodePinned(i) ? pinnedColor : freeColor;
             v.normal = i < normals.size() ? normals[i] : glm::vec3(0.0f, 1.0f, 0.0f);
             deformableVertexScratch.push_back(v);
         }
@@ -4,6 +4,7 @@
  */
 
 #include "engine/AssetPipeline.hpp"
+#include "engine/DebugTools.hpp"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
@@ -284,7 +285,8 @@ void AssetManager::initialize(std::size_t numThreads) {
     running = true;
     
     for (std::size_t i = 0; i < numThreads; ++i) {
-        workerThreads.emplace_back([this] {
+        workerThreads.emplace_back([this, i] {
+            Profiler::instance().setThreadName("Asset Worker " + std::to_string(i));
             processLoadQueue();
         });
     }
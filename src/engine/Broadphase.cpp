@@ -0,0 +1,462 @@
+#include "engine/Broadphase.hpp"
+
+#include <algorithm>
+
+namespace vkengine {
+
+namespace {
+
+AABB mergeBounds(const AABB& a, const AABB& b)
+{
+    return AABB{glm::min(a.min, b.min), glm::max(a.max, b.max)};
+}
+
+float surfaceArea(const AABB& bounds)
+{
+    const glm::vec3 d = bounds.max - bounds.min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+bool containsBounds(const AABB& outer, const AABB& inner)
+{
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+           inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+bool overlapsBounds(const AABB& a, const AABB& b)
+{
+    return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+           a.min.y <= b.max.y && a.max.y >= b.min.y &&
+           a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+AABB fatten(const AABB& bounds, const glm::vec3& displacement, float margin)
+{
+    AABB fat{bounds.min - glm::vec3(margin), bounds.max + glm::vec3(margin)};
+    const glm::vec3 predicted = displacement * DynamicAabbTree::kDisplacementMultiplier;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (predicted[axis] < 0.0f) {
+            fat.min[axis] += predicted[axis];
+        } else {
+            fat.max[axis] += predicted[axis];
+        }
+    }
+    return fat;
+}
+
+constexpr std::uint8_t kProxyMoved = 1u << 0u;
+constexpr std::uint8_t kProxyDead = 1u << 1u;
+
+} // namespace
+
+// ============================================================================
+// DynamicAabbTree
+// ============================================================================
+
+std::int32_t DynamicAabbTree::allocateNode()
+{
+    if (freeList == kNullProxy) {
+        nodes.emplace_back();
+        return static_cast<std::int32_t>(nodes.size() - 1);
+    }
+
+    const std::int32_t node = freeList;
+    freeList = nodes[static_cast<std::size_t>(node)].parent;
+    nodes[static_cast<std::size_t>(node)] = Node{};
+    return node;
+}
+
+void DynamicAabbTree::freeNode(std::int32_t node)
+{
+    Node& freed = nodes[static_cast<std::size_t>(node)];
+    freed.parent = freeList;
+    freed.left = kNullProxy;
+    freed.right = kNullProxy;
+    freed.height = -1;
+    freeList = node;
+}
+
+DynamicAabbTree::ProxyId DynamicAabbTree::createProxy(const AABB& bounds, std::uint32_t userData)
+{
+    const std::int32_t leaf = allocateNode();
+    Node& node = nodes[static_cast<std::size_t>(leaf)];
+    node.bounds = fatten(bounds, glm::vec3(0.0f), kFatMargin);
+    node.userData = userData;
+    node.height = 0;
+    insertLeaf(leaf);
+    ++leafCount;
+    return leaf;
+}
+
+void DynamicAabbTree::destroyProxy(ProxyId proxy)
+{
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --leafCount;
+}
+
+bool DynamicAabbTree::moveProxy(ProxyId proxy, const AABB& bounds, const glm::vec3& displacement)
+{
+    const AABB fat = fatten(bounds, displacement, kFatMargin);
+    const AABB& current = nodes[static_cast<std::size_t>(proxy)].bounds;
+    if (containsBounds(current, bounds)) {
+        // Still inside; only refresh if the stored box has become much larger than needed
+        // (e.g. after a fast body slowed down), since oversized leaves produce extra pairs.
+        const AABB huge{fat.min - glm::vec3(4.0f * kFatMargin), fat.max + glm::vec3(4.0f * kFatMargin)};
+        if (containsBounds(huge, current)) {
+            return false;
+        }
+    }
+
+    removeLeaf(proxy);
+    nodes[static_cast<std::size_t>(proxy)].bounds = fat;
+    insertLeaf(proxy);
+    return true;
+}
+
+void DynamicAabbTree::insertLeaf(std::int32_t leaf)
+{
+    if (root == kNullProxy) {
+        root = leaf;
+        nodes[static_cast<std::size_t>(leaf)].parent = kNullProxy;
+        return;
+    }
+
+    // Descend towards the sibling with the lowest surface-area cost.
+    const AABB leafBounds = nodes[static_cast<std::size_t>(leaf)].bounds;
+    std::int32_t index = root;
+    while (!nodes[static_cast<std::size_t>(index)].isLeaf()) {
+        const Node& node = nodes[static_cast<std::size_t>(index)];
+        const float area = surfaceArea(node.bounds);
+        const float combinedArea = surfaceArea(mergeBounds(node.bounds, leafBounds));
+        const float cost = 2.0f * combinedArea;
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+
+        const auto descendCost = [&](std::int32_t child) {
+            const Node& childNode = nodes[static_cast<std::size_t>(child)];
+            const float mergedArea = surfaceArea(mergeBounds(leafBounds, childNode.bounds));
+            return (childNode.isLeaf() ? mergedArea : mergedArea - surfaceArea(childNode.bounds)) + inheritanceCost;
+        };
+        const float costLeft = descendCost(node.left);
+        const float costRight = descendCost(node.right);
+
+        if (cost < costLeft && cost < costRight) {
+            break;
+        }
+        index = costLeft < costRight ? node.left : node.right;
+    }
+
+    const std::int32_t sibling = index;
+    const std::int32_t oldParent = nodes[static_cast<std::size_t>(sibling)].parent;
+    const std::int32_t newParent = allocateNode();
+
+    Node& parent = nodes[static_cast<std::size_t>(newParent)];
+    parent.parent = oldParent;
+    parent.bounds = mergeBounds(leafBounds, nodes[static_cast<std::size_t>(sibling)].bounds);
+    parent.height = nodes[static_cast<std::size_t>(sibling)].height + 1;
+    parent.left = sibling;
+    parent.right = leaf;
+
+    if (oldParent != kNullProxy) {
+        Node& grandParent = nodes[static_cast<std::size_t>(oldParent)];
+        if (grandParent.left == sibling) {
+            grandParent.left = newParent;
+        } else {
+            grandParent.right = newParent;
+        }
+    } else {
+        root = newParent;
+    }
+    nodes[static_cast<std::size_t>(sibling)].parent = newParent;
+    nodes[static_cast<std::size_t>(leaf)].parent = newParent;
+
+    refit(newParent);
+}
+
+void DynamicAabbTree::removeLeaf(std::int32_t leaf)
+{
+    if (leaf == root) {
+        root = kNullProxy;
+        return;
+    }
+
+    const std::int32_t parent = nodes[static_cast<std::size_t>(leaf)].parent;
+    const std::int32_t grandParent = nodes[static_cast<std::size_t>(parent)].parent;
+    const std::int32_t sibling = nodes[static_cast<std::size_t>(parent)].left == leaf
+        ? nodes[static_cast<std::size_t>(parent)].right
+        : nodes[static_cast<std::size_t>(parent)].left;
+
+    if (grandParent != kNullProxy) {
+        Node& grand = nodes[static_cast<std::size_t>(grandParent)];
+        if (grand.left == parent) {
+            grand.left = sibling;
+        } else {
+            grand.right = sibling;
+        }
+        nodes[static_cast<std::size_t>(sibling)].parent = grandParent;
+        freeNode(parent);
+        refit(grandParent);
+    } else {
+        root = sibling;
+        nodes[static_cast<std::size_t>(sibling)].parent = kNullProxy;
+        freeNode(parent);
+    }
+}
+
+void DynamicAabbTree::refit(std::int32_t index)
+{
+    while (index != kNullProxy) {
+        index = balance(index);
+
+        Node& node = nodes[static_cast<std::size_t>(index)];
+        const Node& left = nodes[static_cast<std::size_t>(node.left)];
+        const Node& right = nodes[static_cast<std::size_t>(node.right)];
+        node.height = 1 + std::max(left.height, right.height);
+        node.bounds = mergeBounds(left.bounds, right.bounds);
+
+        index = node.parent;
+    }
+}
+
+// Single AVL-style rotation that lifts the taller child of `a` one level when the subtree
+// heights differ by more than one. Returns the index of the subtree's new root.
+std::int32_t DynamicAabbTree::balance(std::int32_t a)
+{
+    Node& nodeA = nodes[static_cast<std::size_t>(a)];
+    if (nodeA.isLeaf() || nodeA.height < 2) {
+        return a;
+    }
+
+    const std::int32_t b = nodeA.left;
+    const std::int32_t c = nodeA.right;
+    Node& nodeB = nodes[static_cast<std::size_t>(b)];
+    Node& nodeC = nodes[static_cast<std::size_t>(c)];
+    const std::int32_t heightDelta = nodeC.height - nodeB.height;
+
+    const auto replaceChild = [&](std::int32_t parent, std::int32_t oldChild, std::int32_t newChild) {
+        if (parent == kNullProxy) {
+            root = newChild;
+            return;
+        }
+        Node& parentNode = nodes[static_cast<std::size_t>(parent)];
+        if (parentNode.left == oldChild) {
+            parentNode.left = newChild;
+        } else {
+            parentNode.right = newChild;
+        }
+    };
+
+    if (heightDelta > 1) {
+        // Rotate C up.
+        const std::int32_t f = nodeC.left;
+        const std::int32_t g = nodeC.right;
+        Node& nodeF = nodes[static_cast<std::size_t>(f)];
+        Node& nodeG = nodes[static_cast<std::size_t>(g)];
+
+        nodeC.left = a;
+        nodeC.parent = nodeA.parent;
+        nodeA.parent = c;
+        replaceChild(nodeC.parent, a, c);
+
+        if (nodeF.height > nodeG.height) {
+            nodeC.right = f;
+            nodeA.right = g;
+            nodeG.parent = a;
+            nodeA.bounds = mergeBounds(nodeB.bounds, nodeG.bounds);
+            nodeC.bounds = mergeBounds(nodeA.bounds, nodeF.bounds);
+            nodeA.height = 1 + std::max(nodeB.height, nodeG.height);
+            nodeC.height = 1 + std::max(nodeA.height, nodeF.height);
+        } else {
+            nodeC.right = g;
+            nodeA.right = f;
+            nodeF.parent = a;
+            nodeA.bounds = mergeBounds(nodeB.bounds, nodeF.bounds);
+            nodeC.bounds = mergeBounds(nodeA.bounds, nodeG.bounds);
+            nodeA.height = 1 + std::max(nodeB.height, nodeF.height);
+            nodeC.height = 1 + std::max(nodeA.height, nodeG.height);
+        }
+        return c;
+    }
+
+    if (heightDelta < -1) {
+        // Rotate B up.
+        const std::int32_t d = nodeB.left;
+        const std::int32_t e = nodeB.right;
+        Node& nodeD = nodes[static_cast<std::size_t>(d)];
+        Node& nodeE = nodes[static_cast<std::size_t>(e)];
+
+        nodeB.left = a;
+        nodeB.parent = nodeA.parent;
+        nodeA.parent = b;
+        replaceChild(nodeB.parent, a, b);
+
+        if (nodeD.height > nodeE.height) {
+            nodeB.right = d;
+            nodeA.left = e;
+            nodeE.parent = a;
+            nodeA.bounds = mergeBounds(nodeC.bounds, nodeE.bounds);
+            nodeB.bounds = mergeBounds(nodeA.bounds, nodeD.bounds);
+            nodeA.height = 1 + std::max(nodeC.height, nodeE.height);
+            nodeB.height = 1 + std::max(nodeA.height, nodeD.height);
+        } else {
+            nodeB.right = e;
+            nodeA.left = d;
+            nodeD.parent = a;
+            nodeA.bounds = mergeBounds(nodeC.bounds, nodeD.bounds);
+            nodeB.bounds = mergeBounds(nodeA.bounds, nodeE.bounds);
+            nodeA.height = 1 + std::max(nodeC.height, nodeD.height);
+            nodeB.height = 1 + std::max(nodeA.height, nodeE.height);
+        }
+        return b;
+    }
+
+    return a;
+}
+
+// ============================================================================
+// Broadphase
+// ============================================================================
+
+std::uint64_t Broadphase::pairKey(ProxyId a, ProxyId b)
+{
+    const auto lo = static_cast<std::uint32_t>(std::min(a, b));
+    const auto hi = static_cast<std::uint32_t>(std::max(a, b));
+    return (static_cast<std::uint64_t>(lo) << 32u) | static_cast<std::uint64_t>(hi);
+}
+
+void Broadphase::updateBody(core::ecs::EntityId entity, const AABB& bounds, const glm::vec3& displacement, std::uint32_t userData)
+{
+    const std::uint32_t index = core::ecs::entityIndex(entity);
+    if (index >= bodies.size()) {
+        bodies.resize(static_cast<std::size_t>(index) + 1);
+    }
+
+    Body& body = bodies[index];
+    if (body.proxy != DynamicAabbTree::kNullProxy && body.entity != entity) {
+        // The entity slot was recycled; the old body is gone.
+        removeBody(body);
+    }
+
+    bool moved = false;
+    if (body.proxy == DynamicAabbTree::kNullProxy) {
+        body.entity = entity;
+        body.proxy = tree.createProxy(bounds, userData);
+        ++liveBodies;
+        moved = true;
+    } else {
+        moved = tree.moveProxy(body.proxy, bounds, displacement);
+        tree.setUserData(body.proxy, userData);
+    }
+
+    if (moved) {
+        const auto proxyIndex = static_cast<std::size_t>(body.proxy);
+        if (proxyIndex >= proxyFlags.size()) {
+            proxyFlags.resize(proxyIndex + 1, 0);
+        }
+        if ((proxyFlags[proxyIndex] & kProxyMoved) == 0) {
+            proxyFlags[proxyIndex] |= kProxyMoved;
+            movedProxies.push_back(body.proxy);
+        }
+    }
+
+    if (body.stamp != currentStamp) {
+        body.stamp = currentStamp;
+        ++touchedBodies;
+    }
+}
+
+void Broadphase::removeBody(Body& body)
+{
+    // The proxy stays in the tree until finishUpdate() has dropped its pairs, so its id cannot
+    // be handed out again in the meantime.
+    const auto proxyIndex = static_cast<std::size_t>(body.proxy);
+    if (proxyIndex >= proxyFlags.size()) {
+        proxyFlags.resize(proxyIndex + 1, 0);
+    }
+    proxyFlags[proxyIndex] |= kProxyDead;
+    deadProxies.push_back(body.proxy);
+
+    if (body.stamp == currentStamp) {
+        --touchedBodies;
+    }
+    body = Body{};
+    --liveBodies;
+}
+
+void Broadphase::addPair(ProxyId a, ProxyId b)
+{
+    if (pairKeys.insert(pairKey(a, b)).second) {
+        pairs.emplace_back(std::min(a, b), std::max(a, b));
+    }
+}
+
+void Broadphase::finishUpdate()
+{
+    if (touchedBodies != liveBodies) {
+        for (Body& body : bodies) {
+            if (body.proxy != DynamicAabbTree::kNullProxy && body.stamp != currentStamp) {
+                removeBody(body);
+            }
+        }
+    }
+    touchedBodies = 0;
+    ++currentStamp;
+
+    // Pairs between bodies that kept their fat bounds cannot have changed; only look at pairs
+    // that involve a moved or removed proxy.
+    if (!movedProxies.empty() || !deadProxies.empty()) {
+        for (std::size_t i = 0; i < pairs.size();) {
+            const auto [a, b] = pairs[i];
+            const std::uint8_t flags = proxyFlags[static_cast<std::size_t>(a)] | proxyFlags[static_cast<std::size_t>(b)];
+            const bool drop = (flags & kProxyDead) != 0 ||
+                              ((flags & kProxyMoved) != 0 && !overlapsBounds(tree.fatBounds(a), tree.fatBounds(b)));
+            if (drop) {
+                pairKeys.erase(pairKey(a, b));
+                pairs[i] = pairs.back();
+                pairs.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    for (ProxyId proxy : deadProxies) {
+        tree.destroyProxy(proxy);
+        proxyFlags[static_cast<std::size_t>(proxy)] = 0;
+    }
+    deadProxies.clear();
+
+    for (ProxyId proxy : movedProxies) {
+        if ((proxyFlags[static_cast<std::size_t>(proxy)] & kProxyMoved) == 0) {
+            continue;  // Removed after it moved.
+        }
+        tree.query(tree.fatBounds(proxy), [&](ProxyId other) {
+            if (other != proxy) {
+                addPair(proxy, other);
+            }
+            return true;
+        });
+    }
+    for (ProxyId proxy : movedProxies) {
+        proxyFlags[static_cast<std::size_t>(proxy)] &= static_cast<std::uint8_t>(~kProxyMoved);
+    }
+    lastMovedCount = movedProxies.size();
+    movedProxies.clear();
+}
+
+void Broadphase::clear()
+{
+    tree = DynamicAabbTree{};
+    bodies.clear();
+    liveBodies = 0;
+    touchedBodies = 0;
+    currentStamp = 1;
+    movedProxies.clear();
+    deadProxies.clear();
+    proxyFlags.clear();
+    pairs.clear();
+    pairKeys.clear();
+    lastMovedCount = 0;
+}
+
+} // namespace vkengine
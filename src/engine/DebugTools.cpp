@@ -8,6 +8,7 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -18,6 +19,15 @@
 #include <unistd.h>
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define VKENGINE_PROFILER_TSC 1
+#endif
+
 namespace vkengine {
 
 // ============================================================================
@@ -400,77 +410,376 @@ void DebugDraw::clear() {
 // Profiler Implementation
 // ============================================================================
 
+// One completed scope as written by its thread.
+struct ProfileEvent {
+    std::uint64_t startTicks;
+    std::uint64_t endTicks;
+    std::uint32_t nameId;
+    std::uint32_t depth;
+};
+
+// Single-producer ring: the owning thread advances head, Profiler::collect() advances tail.
+struct ProfileThreadBuffer {
+    explicit ProfileThreadBuffer(std::size_t capacity) : events(capacity), mask(capacity - 1) {}
+
+    void push(const ProfileEvent& event) noexcept {
+        const std::uint64_t position = head.load(std::memory_order_relaxed);
+        if (position - tail.load(std::memory_order_acquire) > mask) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events[position & mask] = event;
+        head.store(position + 1, std::memory_order_release);
+    }
+
+    std::vector<ProfileEvent> events;
+    std::uint64_t mask;
+    std::uint64_t threadId{0};       // Guarded by Profiler::bufferMutex.
+    std::uint32_t depth{0};          // Owner thread only.
+    std::atomic<bool> retired{false};  // Set when the owner exits; the buffer can then be reused.
+    std::atomic<std::uint64_t> dropped{0};
+    alignas(64) std::atomic<std::uint64_t> head{0};
+    alignas(64) std::atomic<std::uint64_t> tail{0};
+};
+
+namespace {
+
+std::uint64_t readTicks() noexcept {
+#if defined(VKENGINE_PROFILER_TSC)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+struct ProfileBufferHandle {
+    ProfileThreadBuffer* buffer{nullptr};
+    ~ProfileBufferHandle() {
+        if (buffer != nullptr) {
+            buffer->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ProfileBufferHandle tlsProfileBuffer;
+thread_local std::vector<std::pair<std::uint32_t, std::uint64_t>> tlsOpenSamples;
+
+} // namespace
+
 Profiler& Profiler::instance() {
-    static Profiler profiler;
-    return profiler;
+    // Never destroyed: threads that exit during shutdown still retire their buffers.
+    static Profiler* profiler = new Profiler();
+    return *profiler;
+}
+
+Profiler::Profiler() {
+    frameHistory.resize(historySize);
+    frameTimeHistoryBuffer.resize(historySize);
+    anchorTicks = readTicks();
+    anchorTime = std::chrono::steady_clock::now();
+#if defined(VKENGINE_PROFILER_TSC)
+    // Rough first estimate of the TSC rate; collect() refines it as the baseline grows.
+    while (std::chrono::steady_clock::now() - anchorTime < std::chrono::microseconds(500)) {
+    }
+    calibrateTicks();
+#else
+    nanosecondsPerTick = 1.0e9 * static_cast<double>(std::chrono::steady_clock::period::num) /
+                         static_cast<double>(std::chrono::steady_clock::period::den);
+#endif
 }
 
-void Profiler::beginFrame() {
-    if (!profilerEnabled) return;
-    
-    // Move current frame to history
-    if (frameHistory.size() >= historySize) {
-        frameHistory.erase(frameHistory.begin());
+Profiler::~Profiler() = default;
+
+void Profiler::calibrateTicks() {
+#if defined(VKENGINE_PROFILER_TSC)
+    const std::uint64_t ticks = readTicks();
+    const auto now = std::chrono::steady_clock::now();
+    if (ticks > anchorTicks) {
+        nanosecondsPerTick = std::chrono::duration<double, std::nano>(now - anchorTime).count() /
+                             static_cast<double>(ticks - anchorTicks);
     }
-    
-    ProfileFrame frame;
-    frame.frameNumber = currentFrameIndex++;
-    frame.frameStart = std::chrono::high_resolution_clock::now();
-    frameHistory.push_back(frame);
+#endif
+}
+
+std::chrono::steady_clock::time_point Profiler::toTimePoint(std::uint64_t ticks) const {
+    const double nanoseconds = static_cast<double>(static_cast<std::int64_t>(ticks - anchorTicks)) * nanosecondsPerTick;
+    return anchorTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double, std::nano>(nanoseconds));
+}
+
+std::uint32_t Profiler::internName(std::string_view name) {
+    std::lock_guard<std::mutex> lock(nameMutex);
+    if (auto it = nameIds.find(name); it != nameIds.end()) {
+        return it->second;
+    }
+    const auto id = static_cast<std::uint32_t>(names.size());
+    names.emplace_back(name);
+    nameIds.emplace(names.back(), id);
+    return id;
+}
+
+std::string_view Profiler::nameOf(std::uint32_t nameId) const {
+    std::lock_guard<std::mutex> lock(nameMutex);
+    return nameId < names.size() ? std::string_view(names[nameId]) : std::string_view();
+}
+
+ProfileThreadBuffer& Profiler::threadBuffer() {
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    ProfileThreadBuffer* claimed = nullptr;
+    for (auto& buffer : threadBuffers) {
+        if (buffer->retired.load(std::memory_order_acquire) &&
+            buffer->head.load(std::memory_order_relaxed) == buffer->tail.load(std::memory_order_relaxed)) {
+            claimed = buffer.get();
+            break;
+        }
+    }
+    if (claimed == nullptr) {
+        threadBuffers.push_back(std::make_unique<ProfileThreadBuffer>(threadBufferCapacity));
+        claimed = threadBuffers.back().get();
+    } else if (claimed->events.size() != threadBufferCapacity) {
+        // Drained, so the ring can be resized without losing events.
+        claimed->events.resize(threadBufferCapacity);
+        claimed->mask = threadBufferCapacity - 1;
+    }
+    claimed->threadId = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    claimed->depth = 0;
+    claimed->retired.store(false, std::memory_order_relaxed);
+    tlsProfileBuffer.buffer = claimed;
+    return *claimed;
+}
+
+std::uint64_t Profiler::beginScope() noexcept {
+    Profiler& profiler = instance();
+    if (!profiler.isEnabled()) {
+        return 0;
+    }
+    ProfileThreadBuffer* buffer = tlsProfileBuffer.buffer;
+    if (buffer == nullptr) {
+        try {
+            buffer = &profiler.threadBuffer();
+        } catch (...) {
+            return 0;
+        }
+    }
+    ++buffer->depth;
+    return readTicks();
+}
+
+void Profiler::endScope(std::uint32_t nameId, std::uint64_t startTicks) noexcept {
+    const std::uint64_t endTicks = readTicks();
+    ProfileThreadBuffer& buffer = *tlsProfileBuffer.buffer;
+    const std::uint32_t depth = --buffer.depth;
+    buffer.push(ProfileEvent{startTicks, endTicks, nameId, depth});
+}
+
+void Profiler::beginFrame() {
+    if (!isEnabled()) return;
+
+    ProfileFrame& frame = frameHistory[frameCount % frameHistory.size()];
+    frame.frameNumber = frameCount++;
+    frame.frameStart = std::chrono::steady_clock::now();
+    frame.frameEnd = {};
+    frame.samples.clear();
+    frame.cpuTimeMs = 0.0f;
+    frame.gpuTimeMs = 0.0f;
 }
 
 void Profiler::endFrame() {
-    if (!profilerEnabled || frameHistory.empty()) return;
-    
-    ProfileFrame& frame = frameHistory.back();
-    frame.frameEnd = std::chrono::high_resolution_clock::now();
+    if (!isEnabled() || frameCount == 0) return;
+
+    collect();
+    ProfileFrame& frame = frameHistory[(frameCount - 1) % frameHistory.size()];
+    frame.frameEnd = std::chrono::steady_clock::now();
     frame.cpuTimeMs = std::chrono::duration<float, std::milli>(frame.frameEnd - frame.frameStart).count();
-    
+
     cpuFrameTime = frame.cpuTimeMs;
-    
-    // Update frame time history
-    frameTimeHistoryBuffer.push_back(frame.cpuTimeMs);
-    if (frameTimeHistoryBuffer.size() > historySize) {
-        frameTimeHistoryBuffer.erase(frameTimeHistoryBuffer.begin());
+
+    if (capturing) {
+        captureFrames.push_back(CapturedFrame{frame.frameNumber, frame.frameStart, frame.frameEnd});
+        if (captureFramesRemaining > 0 && --captureFramesRemaining == 0) {
+            capturing = false;
+        }
     }
-    
+
+    // Update frame time history
+    frameTimeHistoryBuffer[frameTimeHistoryHead] = frame.cpuTimeMs;
+    frameTimeHistoryHead = (frameTimeHistoryHead + 1) % frameTimeHistoryBuffer.size();
+    frameTimeHistoryCount = (std::min)(frameTimeHistoryCount + 1, frameTimeHistoryBuffer.size());
+
     // Calculate FPS
     if (frame.cpuTimeMs > 0) {
         currentFps = 1000.0f / frame.cpuTimeMs;
     }
 }
 
-void Profiler::beginSample(const std::string& name) {
-    if (!profilerEnabled) return;
-    sampleStack.push_back({name, std::chrono::high_resolution_clock::now()});
-    currentDepth++;
+void Profiler::collect() {
+    calibrateTicks();
+    // Scopes finished before the first frame count towards frame 0.
+    const std::uint64_t frameNumber = frameCount > 0 ? frameCount - 1 : 0;
+    ProfileFrame* frame = frameCount > 0 ? &frameHistory[frameNumber % frameHistory.size()] : nullptr;
+    const double msPerTick = nanosecondsPerTick * 1.0e-6;
+
+    std::lock_guard<std::mutex> bufferLock(bufferMutex);
+    std::lock_guard<std::mutex> nameLock(nameMutex);
+    if (scopeHistory.size() < names.size()) {
+        scopeHistory.resize(names.size(), std::vector<ScopeFrameStats>(historySize));
+    }
+
+    for (auto& buffer : threadBuffers) {
+        const std::uint64_t end = buffer->head.load(std::memory_order_acquire);
+        for (std::uint64_t position = buffer->tail.load(std::memory_order_relaxed); position != end; ++position) {
+            const ProfileEvent& event = buffer->events[position & buffer->mask];
+            const auto ms = static_cast<float>(static_cast<double>(event.endTicks - event.startTicks) * msPerTick);
+
+            ScopeFrameStats& stats = scopeHistory[event.nameId][frameNumber % historySize];
+            if (stats.frameNumber != frameNumber) {
+                stats = ScopeFrameStats{};
+                stats.frameNumber = frameNumber;
+                stats.minMs = ms;
+                stats.maxMs = ms;
+            }
+            ++stats.callCount;
+            stats.totalMs += ms;
+            stats.minMs = (std::min)(stats.minMs, ms);
+            stats.maxMs = (std::max)(stats.maxMs, ms);
+            stats.lastMs = ms;
+
+            if (frame != nullptr || capturing) {
+                ProfileSample sample;
+                sample.nameId = event.nameId;
+                sample.name = names[event.nameId];
+                sample.startTime = toTimePoint(event.startTicks);
+                sample.endTime = toTimePoint(event.endTicks);
+                sample.depth = event.depth;
+                sample.threadId = buffer->threadId;
+                if (frame != nullptr) {
+                    frame->samples.push_back(sample);
+                }
+                if (capturing) {
+                    captureSamples.push_back(sample);
+                }
+            }
+        }
+        buffer->tail.store(end, std::memory_order_release);
+        droppedTotal += buffer->dropped.exchange(0, std::memory_order_relaxed);
+    }
 }
 
-void Profiler::endSample() {
-    if (!profilerEnabled || sampleStack.empty()) return;
-    
-    auto [name, startTime] = sampleStack.back();
-    sampleStack.pop_back();
-    currentDepth--;
-    
-    auto endTime = std::chrono::high_resolution_clock::now();
-    float ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
-    
-    // Record sample
-    if (!frameHistory.empty()) {
-        ProfileSample sample;
-        sample.name = name;
-        sample.startTime = startTime;
-        sample.endTime = endTime;
-        sample.depth = currentDepth;
-        frameHistory.back().samples.push_back(sample);
+void Profiler::setThreadName(std::string_view name) {
+    ProfileThreadBuffer* buffer = tlsProfileBuffer.buffer;
+    if (buffer == nullptr) {
+        buffer = &threadBuffer();
     }
-    
-    // Update sample history
-    auto& history = sampleHistory[name];
-    history.push_back(ms);
-    if (history.size() > historySize) {
-        history.erase(history.begin());
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    threadNames[buffer->threadId] = std::string(name);
+}
+
+void Profiler::beginCapture(std::size_t frames) {
+    collect();  // Scopes that finished before the capture stay out of it.
+    captureSamples.clear();
+    captureFrames.clear();
+    captureFramesRemaining = frames;
+    captureStart = std::chrono::steady_clock::now();
+    capturing = true;
+}
+
+void Profiler::endCapture() {
+    if (!capturing) return;
+    collect();
+    capturing = false;
+}
+
+namespace {
+
+void writeTraceString(std::ostream& out, std::string_view text) {
+    out << '"';
+    for (const char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u00" << "0123456789abcdef"[(c >> 4) & 0xF] << "0123456789abcdef"[c & 0xF];
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+void Profiler::writeChromeTrace(std::ostream& out) const {
+    const auto micros = [&](std::chrono::steady_clock::time_point time) {
+        return std::chrono::duration<double, std::micro>(time - captureStart).count();
+    };
+
+    // Thread ids are hashes; the trace gets small ids in order of first appearance, with 0
+    // reserved for the frame track.
+    std::unordered_map<std::uint64_t, std::uint32_t> tids;
+    std::vector<std::uint64_t> threadOrder;
+    for (const ProfileSample& sample : captureSamples) {
+        if (tids.emplace(sample.threadId, static_cast<std::uint32_t>(threadOrder.size() + 1)).second) {
+            threadOrder.push_back(sample.threadId);
+        }
+    }
+
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"vkengine\"}},\n";
+    out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Frames\"}}";
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        for (std::size_t i = 0; i < threadOrder.size(); ++i) {
+            auto it = threadNames.find(threadOrder[i]);
+            const std::string name = it != threadNames.end() ? it->second : "Thread " + std::to_string(i + 1);
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << (i + 1)
+                << ",\"args\":{\"name\":";
+            writeTraceString(out, name);
+            out << "}}";
+        }
+    }
+
+    for (const CapturedFrame& frame : captureFrames) {
+        out << ",\n{\"name\":\"Frame " << frame.frameNumber << "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":0"
+            << ",\"ts\":" << micros(frame.start) << ",\"dur\":" << micros(frame.end) - micros(frame.start) << '}';
+    }
+    for (const ProfileSample& sample : captureSamples) {
+        out << ",\n{\"name\":";
+        writeTraceString(out, sample.name);
+        out << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tids[sample.threadId]
+            << ",\"ts\":" << micros(sample.startTime) << ",\"dur\":" << micros(sample.endTime) - micros(sample.startTime)
+            << ",\"args\":{\"depth\":" << sample.depth << "}}";
+    }
+    out << "\n]}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool Profiler::writeChromeTrace(const std::filesystem::path& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+    writeChromeTrace(file);
+    return file.good();
+}
+
+void Profiler::beginSample(std::string_view name) {
+    const std::uint32_t nameId = internName(name);
+    tlsOpenSamples.emplace_back(nameId, beginScope());
+}
+
+void Profiler::endSample() {
+    if (tlsOpenSamples.empty()) return;
+
+    const auto [nameId, startTicks] = tlsOpenSamples.back();
+    tlsOpenSamples.pop_back();
+    if (startTicks != 0) {
+        endScope(nameId, startTicks);
     }
 }
 
@@ -485,44 +794,97 @@ void Profiler::endGpuSample() {
 
 const ProfileFrame& Profiler::currentFrame() const {
     static ProfileFrame empty;
-    if (frameHistory.empty()) return empty;
-    return frameHistory.back();
+    if (frameCount == 0) return empty;
+    return frameHistory[(frameCount - 1) % frameHistory.size()];
 }
 
 const ProfileFrame& Profiler::previousFrame() const {
     static ProfileFrame empty;
-    if (frameHistory.size() < 2) return empty;
-    return frameHistory[frameHistory.size() - 2];
+    if (frameCount < 2) return empty;
+    return frameHistory[(frameCount - 2) % frameHistory.size()];
 }
 
-ProfileStats Profiler::getStats(const std::string& name) const {
+ProfileStats Profiler::getStats(std::string_view name) const {
     ProfileStats stats;
-    auto it = sampleHistory.find(name);
-    if (it == sampleHistory.end() || it->second.empty()) return stats;
-    
-    const auto& history = it->second;
-    stats.callCount = static_cast<std::uint32_t>(history.size());
-    stats.lastTime = history.back();
-    
-    float sum = 0;
-    stats.minTime = history[0];
-    stats.maxTime = history[0];
-    
-    for (float t : history) {
-        sum += t;
-        stats.minTime = (std::min)(stats.minTime, t);
-        stats.maxTime = (std::max)(stats.maxTime, t);
+    // collect() rewrites scopeHistory under bufferMutex; hold it for the whole scan.
+    std::lock_guard<std::mutex> bufferLock(bufferMutex);
+    std::uint32_t nameId = 0;
+    {
+        std::lock_guard<std::mutex> nameLock(nameMutex);
+        auto it = nameIds.find(name);
+        if (it == nameIds.end() || it->second >= scopeHistory.size()) return stats;
+        nameId = it->second;
+    }
+
+    const std::uint64_t newest = frameCount > 0 ? frameCount - 1 : 0;
+    float totalMs = 0.0f;
+    std::uint64_t lastFrame = 0;
+    for (const ScopeFrameStats& frame : scopeHistory[nameId]) {
+        if (frame.callCount == 0 || frame.frameNumber > newest || frame.frameNumber + historySize <= newest) {
+            continue;
+        }
+        stats.minTime = stats.callCount == 0 ? frame.minMs : (std::min)(stats.minTime, frame.minMs);
+        stats.maxTime = (std::max)(stats.maxTime, frame.maxMs);
+        if (stats.callCount == 0 || frame.frameNumber >= lastFrame) {
+            lastFrame = frame.frameNumber;
+            stats.lastTime = frame.lastMs;
+        }
+        stats.callCount += frame.callCount;
+        totalMs += frame.totalMs;
+    }
+
+    if (stats.callCount > 0) {
+        stats.avgTime = totalMs / static_cast<float>(stats.callCount);
     }
-    
-    stats.avgTime = sum / static_cast<float>(history.size());
     return stats;
 }
 
+std::vector<float> Profiler::frameTimeHistory() const {
+    std::vector<float> history;
+    history.reserve(frameTimeHistoryCount);
+    const std::size_t capacity = frameTimeHistoryBuffer.size();
+    const std::size_t oldest = (frameTimeHistoryHead + capacity - frameTimeHistoryCount) % capacity;
+    for (std::size_t i = 0; i < frameTimeHistoryCount; ++i) {
+        history.push_back(frameTimeHistoryBuffer[(oldest + i) % capacity]);
+    }
+    return history;
+}
+
+std::uint64_t Profiler::droppedSamples() const {
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    std::uint64_t dropped = droppedTotal;
+    for (const auto& buffer : threadBuffers) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
 void Profiler::setHistorySize(std::size_t size) {
-    historySize = size;
-    if (frameHistory.size() > size) {
-        frameHistory.erase(frameHistory.begin(), frameHistory.begin() + (frameHistory.size() - size));
+    historySize = (std::max)(size, std::size_t{1});
+    frameHistory.assign(historySize, ProfileFrame{});
+    frameCount = 0;
+    std::lock_guard<std::mutex> bufferLock(bufferMutex);
+    std::lock_guard<std::mutex> nameLock(nameMutex);
+    scopeHistory.clear();
+
+    // Keep the newest frame times that still fit, re-laid out from slot 0.
+    std::vector<float> retained = frameTimeHistory();
+    if (retained.size() > historySize) {
+        retained.erase(retained.begin(), retained.end() - static_cast<std::ptrdiff_t>(historySize));
+    }
+    frameTimeHistoryCount = retained.size();
+    frameTimeHistoryHead = frameTimeHistoryCount % historySize;
+    retained.resize(historySize);
+    frameTimeHistoryBuffer = std::move(retained);
+}
+
+void Profiler::setThreadBufferCapacity(std::size_t events) {
+    std::size_t capacity = 64;
+    while (capacity < events) {
+        capacity *= 2;
     }
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    threadBufferCapacity = capacity;
 }
 
 // ============================================================================
@@ -655,71 +1017,286 @@ void EntityInspector::drawSceneStats() {
 // Logger Implementation
 // ============================================================================
 
+// One slot of the MPSC ring. Producers claim a position with a CAS on enqueuePos, fill the slot
+// and publish it by bumping its sequence; the writer is the only consumer.
+struct LogRecord {
+    LogLevel level{LogLevel::Info};
+    int line{0};
+    const char* file{nullptr};
+    std::chrono::system_clock::time_point timestamp;
+    std::string message;
+    std::string category;
+};
+
+struct LogQueue {
+    struct Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        LogRecord record;
+    };
+
+    explicit LogQueue(std::size_t capacity)
+        : slots(std::make_unique<Slot[]>(capacity)), mask(capacity - 1) {
+        for (std::size_t i = 0; i < capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Moves from record only on success.
+    bool tryPush(LogRecord& record) {
+        std::uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & mask];
+            const std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int64_t>(sequence - pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record = std::move(record);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(LogRecord& out) {
+        Slot& slot = slots[dequeuePos & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            return false;
+        }
+        out = std::move(slot.record);
+        slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+    [[nodiscard]] bool hasPending() const {
+        return slots[dequeuePos & mask].sequence.load(std::memory_order_acquire) == dequeuePos + 1;
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+    alignas(64) std::atomic<std::uint64_t> enqueuePos{0};
+    alignas(64) std::uint64_t dequeuePos{0};
+    // Number of records the writer has fully handled; flush() waits on it.
+    std::atomic<std::uint64_t> written{0};
+};
+
+static_assert((Logger::QueueCapacity & (Logger::QueueCapacity - 1)) == 0, "Logger queue capacity must be a power of two");
+
+namespace {
+
+constexpr std::size_t kLogBatchSize = 256;
+
+const char* logLevelTag(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace:   return "[TRACE] ";
+        case LogLevel::Debug:   return "[DEBUG] ";
+        case LogLevel::Info:    return "[INFO]  ";
+        case LogLevel::Warning: return "[WARN]  ";
+        case LogLevel::Error:   return "[ERROR] ";
+        case LogLevel::Fatal:   return "[FATAL] ";
+    }
+    return "";
+}
+
+// Writer-thread formatter; caches the clock string for the current second.
+class LogLineFormatter {
+public:
+    void append(const LogRecord& record, std::string& out) {
+        const std::time_t time = std::chrono::system_clock::to_time_t(record.timestamp);
+        if (time != cachedTime) {
+            std::tm tm{};
+#ifdef _WIN32
+            localtime_s(&tm, &time);
+#else
+            localtime_r(&time, &tm);
+#endif
+            cachedLength = std::strftime(cachedClock, sizeof(cachedClock), "%H:%M:%S ", &tm);
+            cachedTime = time;
+        }
+        out.append(cachedClock, cachedLength);
+        out += logLevelTag(record.level);
+        if (!record.category.empty()) {
+            out += '[';
+            out += record.category;
+            out += "] ";
+        }
+        out += record.message;
+        if (record.file) {
+            out += " (";
+            out += record.file;
+            out += ':';
+            out += std::to_string(record.line);
+            out += ')';
+        }
+        out += '\n';
+    }
+
+private:
+    std::time_t cachedTime{-1};
+    char cachedClock[16]{};
+    std::size_t cachedLength{0};
+};
+
+} // namespace
+
 Logger& Logger::instance() {
     static Logger logger;
     return logger;
 }
 
+Logger::Logger()
+    : queue(std::make_unique<LogQueue>(QueueCapacity)) {
+    writer = std::thread([this]() { writerLoop(); });
+}
+
+Logger::~Logger() {
+    stopping.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeCondition.notify_one();
+    }
+    if (writer.joinable()) {
+        writer.join();
+    }
+    closeLogFile();
+}
+
 void Logger::log(LogLevel level, const std::string& message, const std::string& category) {
     log(level, message, nullptr, 0, category);
 }
 
-void Logger::log(LogLevel level, const std::string& message, const char* file, int lineNum, 
+void Logger::log(LogLevel level, const std::string& message, const char* file, int lineNum,
                  const std::string& category) {
-    if (level < minLevel) return;
-    
-    LogEntry entry;
-    entry.level = level;
-    entry.message = message;
-    entry.category = category;
-    entry.file = file ? file : "";
-    entry.line = lineNum;
-    entry.timestamp = std::chrono::system_clock::now();
-    
-    {
-        std::lock_guard<std::mutex> lock(mutex);
-        logEntries.push_back(entry);
-        if (logEntries.size() > maxEntries) {
-            logEntries.erase(logEntries.begin());
+    if (!shouldLog(level)) return;
+
+    LogRecord record;
+    record.level = level;
+    record.line = lineNum;
+    record.file = file;
+    record.timestamp = std::chrono::system_clock::now();
+    record.message = message;
+    record.category = category;
+
+    if (!queue->tryPush(record)) {
+        // The writer thread must never wait on itself (callbacks may log).
+        const bool block = overflowPolicy.load(std::memory_order_relaxed) == LogOverflowPolicy::Block &&
+                           std::this_thread::get_id() != writer.get_id();
+        if (!block) {
+            droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
+        do {
+            wakeWriter();
+            std::this_thread::yield();
+        } while (!queue->tryPush(record));
     }
-    
-    // Console output
-    auto time = std::chrono::system_clock::to_time_t(entry.timestamp);
-    std::tm tm;
-#ifdef _WIN32
-    localtime_s(&tm, &time);
-#else
-    localtime_r(&time, &tm);
-#endif
-    
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%H:%M:%S") << " ";
-    
-    switch (level) {
-        case LogLevel::Trace:   oss << "[TRACE] "; break;
-        case LogLevel::Debug:   oss << "[DEBUG] "; break;
-        case LogLevel::Info:    oss << "[INFO]  "; break;
-        case LogLevel::Warning: oss << "[WARN]  "; break;
-        case LogLevel::Error:   oss << "[ERROR] "; break;
-        case LogLevel::Fatal:   oss << "[FATAL] "; break;
+
+    // Only the first producer after the writer went idle pays for the wake-up.
+    if (writerSleeping.load(std::memory_order_seq_cst) && writerSleeping.exchange(false)) {
+        wakeWriter();
     }
-    
-    if (!category.empty()) oss << "[" << category << "] ";
-    oss << message;
-    if (file) oss << " (" << file << ":" << lineNum << ")";
-    
-    std::cout << oss.str() << std::endl;
-    
-    // File output
-    if (logFile && logFile->is_open()) {
-        *logFile << oss.str() << "\n";
-        logFile->flush();
+    if (level == LogLevel::Fatal) {
+        flush();
     }
-    
-    // Callbacks
-    for (const auto& [name, callback] : callbacks) {
-        callback(entry);
+}
+
+void Logger::wakeWriter() {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    wakeCondition.notify_one();
+}
+
+void Logger::flush() {
+    if (std::this_thread::get_id() == writer.get_id()) return;
+    const std::uint64_t target = queue->enqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    wakeCondition.notify_one();
+    flushCondition.wait(lock, [&]() { return queue->written.load(std::memory_order_acquire) >= target; });
+}
+
+void Logger::writerLoop() {
+    std::vector<LogRecord> batch(kLogBatchSize);
+    std::vector<LogEntry> newEntries;
+    newEntries.reserve(kLogBatchSize);
+    std::vector<LogCallback> activeCallbacks;
+    std::string text;
+    LogLineFormatter formatter;
+
+    for (;;) {
+        std::size_t count = 0;
+        while (count < kLogBatchSize && queue->tryPop(batch[count])) {
+            ++count;
+        }
+
+        if (count == 0) {
+            if (stopping.load(std::memory_order_acquire)) break;
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            writerSleeping.store(true, std::memory_order_seq_cst);
+            // The timeout covers a producer that checked writerSleeping just before it was set.
+            wakeCondition.wait_for(lock, std::chrono::milliseconds(20), [&]() {
+                return queue->hasPending() || stopping.load(std::memory_order_acquire);
+            });
+            writerSleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        text.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            formatter.append(batch[i], text);
+        }
+        if (consoleOutput.load(std::memory_order_relaxed)) {
+            std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+            std::cout.flush();
+        }
+
+        newEntries.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            LogRecord& record = batch[i];
+            LogEntry& entry = newEntries.emplace_back();
+            entry.level = record.level;
+            entry.message = std::move(record.message);
+            entry.category = std::move(record.category);
+            entry.file = record.file ? record.file : "";
+            entry.line = record.line;
+            entry.timestamp = record.timestamp;
+        }
+
+        // Callbacks run outside the lock so they may query or reconfigure the logger.
+        activeCallbacks.clear();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (logFile && logFile->is_open()) {
+                logFile->write(text.data(), static_cast<std::streamsize>(text.size()));
+                logFile->flush();
+            }
+            for (const auto& [name, callback] : callbacks) {
+                activeCallbacks.push_back(callback);
+            }
+        }
+        for (const LogEntry& entry : newEntries) {
+            for (const LogCallback& callback : activeCallbacks) {
+                callback(entry);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (LogEntry& entry : newEntries) {
+                logEntries.push_back(std::move(entry));
+            }
+            while (logEntries.size() > maxEntries) {
+                logEntries.pop_front();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            queue->written.fetch_add(count, std::memory_order_release);
+        }
+        flushCondition.notify_all();
     }
 }
 
@@ -747,29 +1324,45 @@ void Logger::fatal(const std::string& message, const std::string& category) {
     log(LogLevel::Fatal, message, category);
 }
 
+void Logger::setMaxEntries(std::size_t max) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maxEntries = max;
+    while (logEntries.size() > maxEntries) {
+        logEntries.pop_front();
+    }
+}
+
+std::vector<LogEntry> Logger::entries() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return {logEntries.begin(), logEntries.end()};
+}
+
 void Logger::clear() {
     std::lock_guard<std::mutex> lock(mutex);
     logEntries.clear();
 }
 
 void Logger::setLogFile(const std::string& path) {
-    closeLogFile();
-    logFile = new std::ofstream(path, std::ios::app);
+    auto file = std::make_unique<std::ofstream>(path, std::ios::app);
+    std::lock_guard<std::mutex> lock(mutex);
+    logFile = std::move(file);
 }
 
 void Logger::closeLogFile() {
+    std::lock_guard<std::mutex> lock(mutex);
     if (logFile) {
         logFile->close();
-        delete logFile;
-        logFile = nullptr;
+        logFile.reset();
     }
 }
 
 void Logger::addCallback(const std::string& name, LogCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
     callbacks[name] = std::move(callback);
 }
 
 void Logger::removeCallback(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
     callbacks.erase(name);
 }
 
@@ -1,7 +1,6 @@
 #include "engine/DeformableBody.hpp"
 
 #include <glm/gtc/constants.hpp>
-#include <glm/gtx/norm.hpp>
 
 #include <algorithm>
 
@@ -16,18 +15,15 @@ DeformableBody::DeformableBody(int width, int height, float vertexSpacing)
     , clothHeight(std::max(2, height))
     , spacing(std::max(0.05f, vertexSpacing))
 {
-    nodeData.resize(static_cast<std::size_t>(clothWidth * clothHeight));
+    network.resize(static_cast<std::size_t>(clothWidth * clothHeight));
 
     for (int y = 0; y < clothHeight; ++y) {
         for (int x = 0; x < clothWidth; ++x) {
-            const std::size_t idx = index(x, y);
-            nodeData[idx].position = glm::vec3{
+            network.setPosition(index(x, y), glm::vec3{
                 (x - clothWidth * 0.5f) * spacing,
                 0.0f,
                 (y - clothHeight * 0.5f) * spacing
-            };
-            nodeData[idx].velocity = glm::vec3(0.0f);
-            nodeData[idx].pinned = false;
+            });
         }
     }
 
@@ -61,6 +57,7 @@ DeformableBody::DeformableBody(int width, int height, float vertexSpacing)
             meshIndices.push_back(i2);
         }
     }
+    network.setTriangles(meshIndices);
 }
 
 void DeformableBody::pinNode(int x, int y, bool value) noexcept
@@ -68,7 +65,7 @@ void DeformableBody::pinNode(int x, int y, bool value) noexcept
     if (x < 0 || x >= clothWidth || y < 0 || y >= clothHeight) {
         return;
     }
-    nodeData[index(x, y)].pinned = value;
+    network.setPinned(index(x, y), value);
 }
 
 void DeformableBody::pinTopEdge(bool value) noexcept
@@ -81,8 +78,8 @@ void DeformableBody::pinTopEdge(bool value) noexcept
 void DeformableBody::addCentralImpulse(const glm::vec3& impulse) noexcept
 {
     const std::size_t center = index(clothWidth / 2, clothHeight / 2);
-    if (center < nodeData.size() && !nodeData[center].pinned) {
-        nodeData[center].velocity += impulse;
+    if (center < network.size() && !network.pinned(center)) {
+        network.setVelocity(center, network.velocity(center) + impulse);
     }
 }
 
@@ -90,9 +87,8 @@ void DeformableBody::addSpring(int ax, int ay, int bx, int by, float stiffnessSc
 {
     const std::size_t ia = index(ax, ay);
     const std::size_t ib = index(bx, by);
-    const glm::vec3 delta = nodeData[ib].position - nodeData[ia].position;
-    const float rest = glm::length(delta);
-    springs.push_back(Spring{ia, ib, rest, stiffness * stiffnessScale});
+    const float rest = glm::length(network.position(ib) - network.position(ia));
+    network.addSpring(ia, ib, rest, stiffness * stiffnessScale);
 }
 
 void DeformableBody::simulate(float deltaSeconds, const glm::vec3& gravity) noexcept
@@ -101,72 +97,22 @@ void DeformableBody::simulate(float deltaSeconds, const glm::vec3& gravity) noex
         return;
     }
 
-    const float dt = std::min(deltaSeconds, MAX_DT);
-    std::vector<glm::vec3> accelerations(nodeData.size(), gravity);
-
-    for (const Spring& spring : springs) {
-        const Node& a = nodeData[spring.a];
-        const Node& b = nodeData[spring.b];
-        glm::vec3 delta = b.position - a.position;
-        float currentLength = glm::length(delta);
-        if (currentLength < MIN_LENGTH) {
-            continue;
-        }
-        glm::vec3 dir = delta / currentLength;
-        float stretch = currentLength - spring.restLength;
-        glm::vec3 force = spring.stiffness * stretch * dir;
-        if (!a.pinned) {
-            accelerations[spring.a] += force / massPerNode;
-        }
-        if (!b.pinned) {
-            accelerations[spring.b] -= force / massPerNode;
-        }
-    }
-
-    for (std::size_t i = 0; i < nodeData.size(); ++i) {
-        Node& node = nodeData[i];
-        if (node.pinned) {
-            node.velocity = glm::vec3(0.0f);
-            continue;
-        }
-
-        glm::vec3 accel = accelerations[i] - damping * node.velocity;
-        node.velocity += accel * dt;
-        node.velocity *= (1.0f - damping * 0.5f);
-        node.position += node.velocity * dt;
-
-        if (node.position.y < floorY) {
-            node.position.y = floorY;
-            node.velocity.y = 0.0f;
-        }
-    }
+    MassSpringSystem::StepParams params;
+    params.gravity = gravity;
+    params.deltaSeconds = std::min(deltaSeconds, MAX_DT);
+    params.massPerNode = massPerNode;
+    params.damping = damping;
+    params.velocityRetention = 1.0f - damping * 0.5f;
+    params.minSpringLength = MIN_LENGTH;
+    params.floorY = floorY;
+    params.floorRestitution = 0.0f;
+    params.floorUpwardRetention = 0.0f;
+    network.step(params);
 }
 
 void DeformableBody::computeVertexNormals(std::vector<glm::vec3>& outNormals) const
 {
-    outNormals.assign(nodeData.size(), glm::vec3(0.0f));
-    for (std::size_t i = 0; i + 2 < meshIndices.size(); i += 3) {
-        const uint32_t ia = meshIndices[i];
-        const uint32_t ib = meshIndices[i + 1];
-        const uint32_t ic = meshIndices[i + 2];
-        const glm::vec3& a = nodeData[ia].position;
-        const glm::vec3& b = nodeData[ib].position;
-        const glm::vec3& c = nodeData[ic].position;
-        glm::vec3 normal = glm::cross(b - a, c - a);
-        if (glm::length2(normal) < MIN_LENGTH) {
-            continue;
-        }
-        outNormals[ia] += normal;
-        outNormals[ib] += normal;
-        outNormals[ic] += normal;
-    }
-    for (auto& normal : outNormals) {
-        if (glm::length2(normal) > MIN_LENGTH) {
-            normal = glm::normalize(normal);
-        } else {
-            normal = glm::vec3(0.0f, 1.0f, 0.0f);
-        }
-    }
+    network.computeVertexNormals(MIN_LENGTH, outNormals);
 }
 
 } // namespace vkengine
@@ -1,6 +1,7 @@
 #include "engine/GameEngine.hpp"
 
 #include "core/ParallelFor.hpp"
+#include "engine/DebugTools.hpp"
 
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -29,6 +30,18 @@ std::string makeName(const std::string& requested, const char* prefix, std::uint
     }
     return std::string(prefix) + std::to_string(counter++);
 }
+// A frame delta within this fraction of a tick of a whole tick counts as one, so a frame rate
+// equal to the tick rate does not alternate between zero and two ticks on rounding noise.
+constexpr double kTickSnapFraction = 1.0e-4;
+
+// Euler angles blend the short way round, so a wrap at +-pi does not spin the object.
+glm::vec3 blendAngles(const glm::vec3& from, const glm::vec3& to, float t)
+{
+    constexpr float twoPi = glm::two_pi<float>();
+    const glm::vec3 delta{std::remainder(to.x - from.x, twoPi), std::remainder(to.y - from.y, twoPi),
+                          std::remainder(to.z - from.z, twoPi)};
+    return from + delta * t;
+}
 } // namespace
 
 GameEngine::GameEngine()
@@ -83,6 +96,14 @@ const Transform& GameObject::transform() const
     return registry().get<Transform>(entityHandle);
 }
 
+glm::mat4 GameObject::modelMatrix() const
+{
+    if (const auto* interpolated = registry().tryGet<InterpolatedTransform>(entityHandle)) {
+        return interpolated->render.matrix();
+    }
+    return transform().matrix();
+}
+
 PhysicsProperties& GameObject::physics()
 {
     return registry().get<PhysicsProperties>(entityHandle);
@@ -600,15 +621,53 @@ void Scene::clear()
     sceneLights.clear();
 }
 
+void GameEngine::setFixedTimestep(const FixedTimestepSettings& settings)
+{
+    timestep = settings;
+    timestep.tickRate = std::max(timestep.tickRate, 1.0f);
+    timestep.maxTicksPerUpdate = std::max(timestep.maxTicksPerUpdate, 1);
+    accumulator = std::min(accumulator, 1.0 / static_cast<double>(timestep.tickRate));
+}
+
 void GameEngine::update(float deltaSeconds)
 {
-    physicsSystem.update(activeScene, deltaSeconds);
-    particleSystem.update(deltaSeconds);
+    PROFILE_SCOPE("GameEngine.Update");
+    const double tickSeconds = 1.0 / static_cast<double>(timestep.tickRate);
+    accumulator += std::max(static_cast<double>(deltaSeconds), 0.0);
+
+    int dueTicks = static_cast<int>(std::floor(accumulator / tickSeconds + kTickSnapFraction));
+    if (dueTicks > timestep.maxTicksPerUpdate) {
+        const double backlog = accumulator - timestep.maxTicksPerUpdate * tickSeconds;
+        droppedSeconds += backlog;
+        accumulator -= backlog;
+        dueTicks = timestep.maxTicksPerUpdate;
+    }
+
+    for (int tick = 0; tick < dueTicks; ++tick) {
+        // Only the transforms before the last tick of the frame are ever blended with.
+        if (timestep.interpolate && tick + 1 == dueTicks) {
+            capturePreviousTransforms();
+        }
+        simulateTick(static_cast<float>(tickSeconds));
+        accumulator -= tickSeconds;
+    }
+    accumulator = std::max(accumulator, 0.0);
+    ticks += static_cast<std::uint64_t>(dueTicks);
+    lastUpdateTicks = dueTicks;
+    alpha = static_cast<float>(std::clamp(accumulator / tickSeconds, 0.0, 1.0));
+
+    updateInterpolatedTransforms();
+}
+
+void GameEngine::simulateTick(float tickSeconds)
+{
+    physicsSystem.update(activeScene, tickSeconds);
+    particleSystem.update(tickSeconds);
 
-        std::vector<DeformableBody*> cloths;
-        std::vector<SoftBodyVolume*> softBodies;
-        cloths.reserve(activeScene.objectsCached().size());
-        softBodies.reserve(activeScene.objectsCached().size());
+    std::vector<DeformableBody*> cloths;
+    std::vector<SoftBodyVolume*> softBodies;
+    cloths.reserve(activeScene.objectsCached().size());
+    softBodies.reserve(activeScene.objectsCached().size());
 
     for (auto* object : activeScene.objectsCached()) {
         if (auto* cloth = object->deformable()) {
@@ -621,11 +680,54 @@ void GameEngine::update(float deltaSeconds)
 
     const auto gravity = physicsSystem.getGravity();
     core::parallelFor(cloths.size(), 8, [&](std::size_t index) {
-        cloths[index]->simulate(deltaSeconds, gravity);
+        cloths[index]->simulate(tickSeconds, gravity);
     });
     core::parallelFor(softBodies.size(), 8, [&](std::size_t index) {
-        softBodies[index]->simulate(deltaSeconds, gravity);
+        softBodies[index]->simulate(tickSeconds, gravity);
     });
+
+    // Sync point: apply structural changes recorded by systems on worker threads.
+    activeScene.registry().flushDeferred();
+}
+
+void GameEngine::capturePreviousTransforms()
+{
+    auto& registry = activeScene.registry();
+    std::vector<core::ecs::Entity> untracked;
+    registry.view<PhysicsProperties, Transform>([&](core::ecs::Entity entity, PhysicsProperties& physics, Transform& transform) {
+        if (!physics.simulate) {
+            return;
+        }
+        if (auto* interpolated = registry.tryGet<InterpolatedTransform>(entity)) {
+            interpolated->previous = transform;
+        } else {
+            untracked.push_back(entity);
+        }
+    });
+    for (const core::ecs::Entity entity : untracked) {
+        const Transform& transform = registry.get<Transform>(entity);
+        registry.emplace<InterpolatedTransform>(entity, InterpolatedTransform{transform, transform});
+    }
+}
+
+void GameEngine::updateInterpolatedTransforms()
+{
+    auto& registry = activeScene.registry();
+    std::vector<core::ecs::Entity> stale;
+    registry.view<InterpolatedTransform, Transform, PhysicsProperties>(
+        [&](core::ecs::Entity entity, InterpolatedTransform& interpolated, Transform& current, PhysicsProperties& physics) {
+            // Objects that stopped simulating, or all of them once interpolation is off, draw live.
+            if (!timestep.interpolate || !physics.simulate) {
+                stale.push_back(entity);
+                return;
+            }
+            interpolated.render.position = glm::mix(interpolated.previous.position, current.position, alpha);
+            interpolated.render.rotation = blendAngles(interpolated.previous.rotation, current.rotation, alpha);
+            interpolated.render.scale = glm::mix(interpolated.previous.scale, current.scale, alpha);
+        });
+    for (const core::ecs::Entity entity : stale) {
+        registry.remove<InterpolatedTransform>(entity);
+    }
 }
 
 } // namespace vkengine
@@ -0,0 +1,263 @@
+#include "engine/GravityOctree.hpp"
+
+#include "core/ParallelFor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace vkengine {
+
+namespace {
+
+constexpr std::size_t kMinPointsPerChunk = 256;
+constexpr std::size_t kMinKeysPerSortBlock = 4096;
+// Subtrees smaller than this are never split off as separate jobs.
+constexpr std::size_t kMinPointsPerSubtree = 1024;
+
+// Spreads the low 21 bits of v so that two zero bits follow each one.
+std::uint64_t spreadBits(std::uint64_t v)
+{
+    v &= 0x1fffffull;
+    v = (v | (v << 32)) & 0x1f00000000ffffull;
+    v = (v | (v << 16)) & 0x1f0000ff0000ffull;
+    v = (v | (v << 8)) & 0x100f00f00f00f00full;
+    v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+    v = (v | (v << 2)) & 0x1249249249249249ull;
+    return v;
+}
+
+} // namespace
+
+void GravityOctree::build(const glm::vec3* positions, const float* masses, std::size_t count)
+{
+    nodes.clear();
+    keys.resize(count);
+    sortedPositions.resize(count);
+    sortedMasses.resize(count);
+    if (count == 0) {
+        return;
+    }
+
+    glm::vec3 minCorner{positions[0]};
+    glm::vec3 maxCorner{positions[0]};
+    for (std::size_t i = 1; i < count; ++i) {
+        minCorner = glm::min(minCorner, positions[i]);
+        maxCorner = glm::max(maxCorner, positions[i]);
+    }
+    const glm::vec3 extent = maxCorner - minCorner;
+    rootSize = std::max({extent.x, extent.y, extent.z, 1e-6f}) * 1.0001f;
+
+    constexpr float kCellsPerAxis = static_cast<float>(1u << kMaxDepth);
+    const float cellsPerUnit = kCellsPerAxis / rootSize;
+    core::parallelFor(count, kMinPointsPerChunk, [&](std::size_t i) {
+        std::uint64_t code = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            const float cell = (positions[i][axis] - minCorner[axis]) * cellsPerUnit;
+            // Also maps NaN to cell 0.
+            const float clamped = cell >= 0.0f ? std::min(cell, kCellsPerAxis - 1.0f) : 0.0f;
+            code |= spreadBits(static_cast<std::uint64_t>(clamped)) << axis;
+        }
+        keys[i] = Key{code, static_cast<std::uint32_t>(i)};
+    });
+
+    // Blocks are sorted on the pool, then merged pairwise in rounds.
+    const auto keyLess = [](const Key& a, const Key& b) { return a.code != b.code ? a.code < b.code : a.index < b.index; };
+    const std::size_t blockSize = std::max(kMinKeysPerSortBlock, count / (core::parallelThreadCount() + 1) + 1);
+    const std::size_t blockCount = (count + blockSize - 1) / blockSize;
+    core::parallelFor(blockCount, 1, [&](std::size_t block) {
+        const auto first = keys.begin() + static_cast<std::ptrdiff_t>(block * blockSize);
+        const auto last = keys.begin() + static_cast<std::ptrdiff_t>(std::min(count, (block + 1) * blockSize));
+        std::sort(first, last, keyLess);
+    });
+    keyScratch.resize(count);
+    for (std::size_t width = blockSize; width < count; width *= 2) {
+        const std::size_t mergeCount = (count + 2 * width - 1) / (2 * width);
+        core::parallelFor(mergeCount, 1, [&](std::size_t merge) {
+            const std::size_t begin = merge * 2 * width;
+            const std::size_t middle = std::min(count, begin + width);
+            const std::size_t end = std::min(count, begin + 2 * width);
+            std::merge(keys.begin() + static_cast<std::ptrdiff_t>(begin), keys.begin() + static_cast<std::ptrdiff_t>(middle),
+                       keys.begin() + static_cast<std::ptrdiff_t>(middle), keys.begin() + static_cast<std::ptrdiff_t>(end),
+                       keyScratch.begin() + static_cast<std::ptrdiff_t>(begin), keyLess);
+        });
+        keys.swap(keyScratch);
+    }
+
+    core::parallelFor(count, kMinPointsPerChunk, [&](std::size_t slot) {
+        sortedPositions[slot] = positions[keys[slot].index];
+        sortedMasses[slot] = masses[keys[slot].index];
+    });
+
+    // Upper levels serially; subtrees small enough to be one job each are left for the pool and
+    // spliced in behind the upper levels.
+    Node root{};
+    root.size = rootSize;
+    root.end = static_cast<std::uint32_t>(count);
+    nodes.push_back(root);
+    subtreeTasks.clear();
+    const std::size_t deferLimit = std::max(kMinPointsPerSubtree, count / (4 * (core::parallelThreadCount() + 1)));
+    buildNode(nodes, 0, 0, deferLimit, &subtreeTasks);
+    const std::size_t topCount = nodes.size();
+
+    if (subtreeNodes.size() < subtreeTasks.size()) {
+        subtreeNodes.resize(subtreeTasks.size());
+    }
+    core::parallelFor(subtreeTasks.size(), 1, [&](std::size_t t) {
+        auto& local = subtreeNodes[t];
+        local.clear();
+        local.push_back(nodes[subtreeTasks[t].node]);
+        buildNode(local, 0, subtreeTasks[t].depth, 0, nullptr);
+    });
+
+    std::vector<std::size_t> bases(subtreeTasks.size());
+    std::size_t total = topCount;
+    for (std::size_t t = 0; t < subtreeTasks.size(); ++t) {
+        bases[t] = total;
+        total += subtreeNodes[t].size() - 1;
+    }
+    nodes.resize(total);
+    core::parallelFor(subtreeTasks.size(), 1, [&](std::size_t t) {
+        const auto& local = subtreeNodes[t];
+        const auto remap = [&](Node node) {
+            if (node.childCount > 0) {
+                node.firstChild = static_cast<std::uint32_t>(bases[t] + node.firstChild - 1);
+            }
+            return node;
+        };
+        nodes[subtreeTasks[t].node] = remap(local[0]);
+        for (std::size_t k = 1; k < local.size(); ++k) {
+            nodes[bases[t] + k - 1] = remap(local[k]);
+        }
+    });
+
+    // Children always follow their parent, so a reverse pass sees them finished.
+    for (std::size_t i = topCount; i-- > 0;) {
+        computeMoments(nodes[i], nodes);
+    }
+}
+
+void GravityOctree::buildNode(std::vector<Node>& out, std::uint32_t node, std::uint32_t depth, std::size_t deferLimit,
+                              std::vector<SubtreeTask>* deferred) const
+{
+    const std::uint32_t begin = out[node].begin;
+    const std::uint32_t end = out[node].end;
+    if (end - begin <= kLeafCapacity || depth >= kMaxDepth) {
+        out[node].childCount = 0;
+        if (deferred == nullptr) {
+            computeMoments(out[node], out);
+        }
+        return;
+    }
+    if (deferred != nullptr && end - begin <= deferLimit) {
+        deferred->push_back(SubtreeTask{node, depth});
+        return;
+    }
+
+    // Keys are sorted, so each octant of this node is a contiguous run.
+    const std::uint32_t shift = 3 * (kMaxDepth - 1 - depth);
+    std::array<std::uint32_t, 9> split{};
+    split[0] = begin;
+    for (std::uint32_t octant = 0; octant < 8; ++octant) {
+        const auto first = keys.begin() + split[octant];
+        const auto last = keys.begin() + end;
+        const auto it = std::partition_point(first, last, [&](const Key& key) { return ((key.code >> shift) & 7u) <= octant; });
+        split[octant + 1] = static_cast<std::uint32_t>(it - keys.begin());
+    }
+
+    const auto firstChild = static_cast<std::uint32_t>(out.size());
+    std::uint32_t childCount = 0;
+    const float childSize = 0.5f * out[node].size;
+    for (std::uint32_t octant = 0; octant < 8; ++octant) {
+        if (split[octant + 1] > split[octant]) {
+            Node child{};
+            child.size = childSize;
+            child.begin = split[octant];
+            child.end = split[octant + 1];
+            out.push_back(child);
+            ++childCount;
+        }
+    }
+    out[node].firstChild = firstChild;
+    out[node].childCount = childCount;
+
+    for (std::uint32_t c = 0; c < childCount; ++c) {
+        buildNode(out, firstChild + c, depth + 1, deferLimit, deferred);
+    }
+    if (deferred == nullptr) {
+        computeMoments(out[node], out);
+    }
+}
+
+void GravityOctree::computeMoments(Node& node, const std::vector<Node>& owner) const
+{
+    float mass = 0.0f;
+    glm::vec3 weighted{0.0f};
+    glm::vec3 centroid{0.0f};
+    if (node.childCount == 0) {
+        for (std::uint32_t j = node.begin; j < node.end; ++j) {
+            mass += sortedMasses[j];
+            weighted += sortedPositions[j] * sortedMasses[j];
+            centroid += sortedPositions[j];
+        }
+        centroid /= static_cast<float>(std::max(1u, node.end - node.begin));
+    } else {
+        for (std::uint32_t c = 0; c < node.childCount; ++c) {
+            const Node& child = owner[node.firstChild + c];
+            mass += child.mass;
+            weighted += child.centerOfMass * child.mass;
+            centroid += child.centerOfMass;
+        }
+        centroid /= static_cast<float>(node.childCount);
+    }
+    node.mass = mass;
+    node.centerOfMass = mass > 0.0f ? weighted / mass : centroid;
+}
+
+void GravityOctree::computeFields(float gravityConstant, float softening, float openingAngle, glm::vec3* fields) const
+{
+    const std::size_t count = sortedPositions.size();
+    if (count == 0) {
+        return;
+    }
+
+    const float openingSquared = openingAngle * openingAngle;
+    core::parallelForRange(count, kMinPointsPerChunk, [&](std::size_t begin, std::size_t end) {
+        // Each opened node pops one entry and pushes at most eight.
+        std::array<std::uint32_t, 8 * (kMaxDepth + 1)> stack{};
+        for (std::size_t slot = begin; slot < end; ++slot) {
+            const glm::vec3 position = sortedPositions[slot];
+            glm::vec3 field{0.0f};
+            std::size_t top = 0;
+            stack[top++] = 0;
+            while (top > 0) {
+                const Node& node = nodes[stack[--top]];
+                if (node.childCount == 0) {
+                    for (std::uint32_t j = node.begin; j < node.end; ++j) {
+                        if (j == slot) {
+                            continue;
+                        }
+                        const glm::vec3 offset = sortedPositions[j] - position;
+                        const float invDist = 1.0f / std::sqrt(glm::dot(offset, offset) + softening);
+                        field += offset * (sortedMasses[j] * invDist * invDist * invDist);
+                    }
+                    continue;
+                }
+
+                const glm::vec3 offset = node.centerOfMass - position;
+                const float distSquared = glm::dot(offset, offset);
+                if (node.size * node.size < openingSquared * distSquared) {
+                    const float invDist = 1.0f / std::sqrt(distSquared + softening);
+                    field += offset * (node.mass * invDist * invDist * invDist);
+                    continue;
+                }
+                for (std::uint32_t c = 0; c < node.childCount; ++c) {
+                    stack[top++] = node.firstChild + c;
+                }
+            }
+            fields[keys[slot].index] = field * gravityConstant;
+        }
+    });
+}
+
+} // namespace vkengine
@@ -1,5 +1,7 @@
 #include "engine/JobSystem.hpp"
 
+#include "engine/DebugTools.hpp"
+
 #include <algorithm>
 #include <chrono>
 
@@ -189,6 +191,26 @@ void FreeListAllocator::reset() {
 // Job System Implementation
 // ============================================================================
 
+namespace {
+// Identifies the pool worker running on this thread so submit() can use its local deque.
+thread_local const JobSystem* tlsJobSystem = nullptr;
+thread_local std::size_t tlsWorkerIndex = JobSystem::kNotAWorker;
+
+// Successor lists are short and only contended while a predecessor is finishing, so a spin lock
+// per job is cheaper than a mutex per job.
+void lockSuccessors(Job& job) {
+    while (job.successorLock.exchange(true, std::memory_order_acquire)) {
+        while (job.successorLock.load(std::memory_order_relaxed)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void unlockSuccessors(Job& job) {
+    job.successorLock.store(false, std::memory_order_release);
+}
+} // namespace
+
 JobSystem& JobSystem::instance() {
     static JobSystem inst;
     return inst;
@@ -199,6 +221,7 @@ JobSystem::~JobSystem() {
 }
 
 void JobSystem::initialize(std::size_t threadCount) {
+    std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex);
     if (running.load()) {
         return; // Already initialized
     }
@@ -209,20 +232,33 @@ void JobSystem::initialize(std::size_t threadCount) {
     }
     
     running = true;
-    
+
+    workerQueues.clear();
+    workerQueues.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        workerQueues.push_back(std::make_unique<WorkStealingDeque<Job*>>());
+    }
+    workerFreeJobs.assign(threadCount, {});
+
     workers.reserve(threadCount);
     for (std::size_t i = 0; i < threadCount; ++i) {
         workers.emplace_back(&JobSystem::workerThread, this, i);
     }
+    workerCount.store(threadCount, std::memory_order_release);
 }
 
 void JobSystem::shutdown() {
+    std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex);
     if (!running.load()) {
         return;
     }
-    
+
+    workerCount.store(0, std::memory_order_release);
     running = false;
-    queueCondition.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCondition.notify_all();
     
     for (auto& worker : workers) {
         if (worker.joinable()) {
@@ -231,112 +267,250 @@ void JobSystem::shutdown() {
     }
     
     workers.clear();
+
+    // Finish whatever is still queued on the calling thread. Every dependency is itself a job,
+    // so draining the queues also releases all of their successors.
+    while (runOne(kNotAWorker)) {
+    }
+    workerQueues.clear();
+
+    std::lock_guard<std::mutex> lock(arenaMutex);
+    for (auto& localJobs : workerFreeJobs) {
+        freeJobs.insert(freeJobs.end(), localJobs.begin(), localJobs.end());
+    }
+    workerFreeJobs.clear();
 }
 
-JobHandle JobSystem::submit(JobFunction function) {
-    auto handle = std::make_shared<std::atomic<bool>>(false);
-    
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        jobQueue.push_back({std::move(function), handle, {}});
+std::size_t JobSystem::currentWorkerIndex() const {
+    return tlsJobSystem == this ? tlsWorkerIndex : kNotAWorker;
+}
+
+std::size_t JobSystem::allocatedJobs() const {
+    std::lock_guard<std::mutex> lock(arenaMutex);
+    return jobChunks.size() * kJobChunkSize;
+}
+
+Job* JobSystem::allocateJob() {
+    Job* job = nullptr;
+    const std::size_t workerIndex = currentWorkerIndex();
+    if (workerIndex != kNotAWorker && !workerFreeJobs[workerIndex].empty()) {
+        job = workerFreeJobs[workerIndex].back();
+        workerFreeJobs[workerIndex].pop_back();
+    } else {
+        std::lock_guard<std::mutex> lock(arenaMutex);
+        if (freeJobs.empty()) {
+            auto chunk = std::make_unique<Job[]>(kJobChunkSize);
+            for (std::size_t i = kJobChunkSize; i-- > 0;) {
+                freeJobs.push_back(&chunk[i]);
+            }
+            jobChunks.push_back(std::move(chunk));
+        }
+        job = freeJobs.back();
+        freeJobs.pop_back();
+
+        // Refill the worker's local list while we hold the lock anyway.
+        if (workerIndex != kNotAWorker) {
+            auto& localJobs = workerFreeJobs[workerIndex];
+            const std::size_t refill = std::min(freeJobs.size(), kJobChunkSize / 4);
+            localJobs.insert(localJobs.end(), freeJobs.end() - static_cast<std::ptrdiff_t>(refill), freeJobs.end());
+            freeJobs.resize(freeJobs.size() - refill);
+        }
     }
-    
-    queueCondition.notify_one();
-    return handle;
+
+    job->pendingPredecessors.store(1, std::memory_order_relaxed);
+    ++outstandingJobCount;
+    return job;
+}
+
+void JobSystem::recycleJob(Job* job) {
+    const std::size_t workerIndex = currentWorkerIndex();
+    if (workerIndex != kNotAWorker) {
+        auto& localJobs = workerFreeJobs[workerIndex];
+        localJobs.push_back(job);
+        if (localJobs.size() > kLocalFreeJobLimit) {
+            // Jobs allocated by one thread and finished by another drift between lists; hand
+            // the surplus back so the allocating side does not keep growing the arena.
+            const std::size_t surplus = localJobs.size() / 2;
+            std::lock_guard<std::mutex> lock(arenaMutex);
+            freeJobs.insert(freeJobs.end(), localJobs.end() - static_cast<std::ptrdiff_t>(surplus), localJobs.end());
+            localJobs.resize(localJobs.size() - surplus);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(arenaMutex);
+    freeJobs.push_back(job);
 }
 
-JobHandle JobSystem::submit(JobFunction function, JobHandle dependency) {
-    auto handle = std::make_shared<std::atomic<bool>>(false);
-    
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        jobQueue.push_back({std::move(function), handle, {dependency}});
+void JobSystem::addDependency(Job* job, JobHandle dependency) {
+    Job* predecessor = dependency.job;
+    if (!predecessor) {
+        return;
     }
-    
-    queueCondition.notify_one();
+
+    // A predecessor that already finished has a newer generation; there is nothing to wait for.
+    lockSuccessors(*predecessor);
+    if (predecessor->generation.load(std::memory_order_relaxed) == dependency.generation) {
+        job->pendingPredecessors.fetch_add(1, std::memory_order_relaxed);
+        predecessor->successors.push_back(job);
+    }
+    unlockSuccessors(*predecessor);
+}
+
+JobHandle JobSystem::schedule(Job* job) {
+    // Read the generation before dropping the build reference: once released the job may run
+    // and be recycled at any time.
+    JobHandle handle(job, job->generation.load(std::memory_order_relaxed));
+    releaseDependency(job);
     return handle;
 }
 
-JobHandle JobSystem::submit(JobFunction function, const std::vector<JobHandle>& dependencies) {
-    auto handle = std::make_shared<std::atomic<bool>>(false);
-    
+void JobSystem::releaseDependency(Job* job) {
+    if (job->pendingPredecessors.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        push(job);
+    }
+}
+
+void JobSystem::finishJob(Job* job) {
+    job->task.reset();
+
+    lockSuccessors(*job);
+    job->generation.fetch_add(1, std::memory_order_release);
+    unlockSuccessors(*job);
+
+    // After the generation bump no one appends to the list, so it can be walked unlocked.
+    for (Job* successor : job->successors) {
+        releaseDependency(successor);
+    }
+    job->successors.clear();
+
+    recycleJob(job);
+    ++completedJobCount;
+    --outstandingJobCount;
+}
+
+void JobSystem::push(Job* job) {
+    queuedJobCount.fetch_add(1, std::memory_order_seq_cst);
+    const std::size_t workerIndex = currentWorkerIndex();
+    if (workerIndex != kNotAWorker) {
+        workerQueues[workerIndex]->push(job);
+    } else {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        injectionQueue.push_back(job);
+        injectedCount.fetch_add(1, std::memory_order_release);
+    }
+    wakeWorkers();
+}
+
+void JobSystem::wakeWorkers() {
+    // Pairs with the sleepingWorkers increment in workerThread: either the sleeper sees the new
+    // queued count or we see the sleeper and notify under the mutex.
+    if (sleepingWorkers.load(std::memory_order_seq_cst) == 0) {
+        return;
+    }
     {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        jobQueue.push_back({std::move(function), handle, dependencies});
+        std::lock_guard<std::mutex> lock(sleepMutex);
     }
-    
-    queueCondition.notify_one();
-    return handle;
+    sleepCondition.notify_one();
+}
+
+Job* JobSystem::findJob(std::size_t threadIndex) {
+    if (threadIndex != kNotAWorker && threadIndex < workerQueues.size()) {
+        if (auto job = workerQueues[threadIndex]->pop()) {
+            return *job;
+        }
+    }
+
+    if (injectedCount.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        if (!injectionQueue.empty()) {
+            Job* job = injectionQueue.front();
+            injectionQueue.pop_front();
+            injectedCount.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    const std::size_t queueCount = workerQueues.size();
+    if (queueCount == 0) {
+        return nullptr;
+    }
+    const std::size_t start = threadIndex == kNotAWorker ? 0 : threadIndex + 1;
+    for (std::size_t offset = 0; offset < queueCount; ++offset) {
+        const std::size_t victim = (start + offset) % queueCount;
+        if (victim == threadIndex) {
+            continue;
+        }
+        if (auto job = workerQueues[victim]->steal()) {
+            ++stolenJobCount;
+            return *job;
+        }
+    }
+    return nullptr;
+}
+
+bool JobSystem::runOne(std::size_t threadIndex) {
+    Job* job = findJob(threadIndex);
+    if (!job) {
+        return false;
+    }
+
+    --queuedJobCount;
+    PROFILE_SCOPE("JobSystem.Job");
+    job->task();
+    finishJob(job);
+    return true;
 }
 
 void JobSystem::wait(JobHandle handle) {
-    while (handle && !handle->load()) {
-        std::this_thread::yield();
+    PROFILE_SCOPE("JobSystem.Wait");
+    const std::size_t workerIndex = currentWorkerIndex();
+    while (!isComplete(handle)) {
+        if (!runOne(workerIndex)) {
+            std::this_thread::yield();
+        }
     }
 }
 
 void JobSystem::waitAll() {
-    while (pendingJobs() > 0) {
-        std::this_thread::yield();
+    const std::size_t workerIndex = currentWorkerIndex();
+    while (outstandingJobCount.load(std::memory_order_acquire) > 0) {
+        if (!runOne(workerIndex)) {
+            std::this_thread::yield();
+        }
     }
 }
 
 bool JobSystem::isComplete(JobHandle handle) const {
-    return !handle || handle->load();
+    return !handle.job || handle.job->generation.load(std::memory_order_acquire) != handle.generation;
 }
 
 std::size_t JobSystem::pendingJobs() const {
-    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(queueMutex));
-    return jobQueue.size();
+    return queuedJobCount.load(std::memory_order_relaxed);
 }
 
-void JobSystem::workerThread(std::size_t /*threadIndex*/) {
-    while (running.load()) {
-        JobData job;
-        
+void JobSystem::workerThread(std::size_t threadIndex) {
+    tlsJobSystem = this;
+    tlsWorkerIndex = threadIndex;
+    Profiler::instance().setThreadName("JobSystem Worker " + std::to_string(threadIndex));
+
+    while (running.load(std::memory_order_acquire)) {
+        if (runOne(threadIndex)) {
+            continue;
+        }
+
+        sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
         {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            queueCondition.wait(lock, [this] {
-                return !running.load() || !jobQueue.empty();
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait(lock, [this] {
+                return !running.load() || queuedJobCount.load(std::memory_order_seq_cst) > 0;
             });
-            
-            if (!running.load() && jobQueue.empty()) {
-                return;
-            }
-            
-            // Find a job with satisfied dependencies
-            auto it = jobQueue.begin();
-            while (it != jobQueue.end()) {
-                bool dependenciesMet = true;
-                for (const auto& dep : it->dependencies) {
-                    if (dep && !dep->load()) {
-                        dependenciesMet = false;
-                        break;
-                    }
-                }
-                
-                if (dependenciesMet) {
-                    job = std::move(*it);
-                    jobQueue.erase(it);
-                    break;
-                }
-                ++it;
-            }
-            
-            if (!job.function) {
-                continue; // No ready job found
-            }
-        }
-        
-        // Execute the job
-        if (job.function) {
-            job.function();
-            if (job.completionFlag) {
-                job.completionFlag->store(true);
-            }
-            ++completedJobCount;
         }
+        sleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
     }
+
+    tlsJobSystem = nullptr;
+    tlsWorkerIndex = kNotAWorker;
 }
 
 // ============================================================================
@@ -0,0 +1,190 @@
+#include "engine/Network.hpp"
+
+#include "engine/GameEngine.hpp"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace vkengine {
+
+namespace {
+
+// Per-axis delta wrapped to [-pi, pi] before scaling: two ticks either side of the +-pi seam are
+// a small turn apart, not nearly a full revolution.
+glm::vec3 mixAngles(const glm::vec3& from, const glm::vec3& to, float alpha) {
+    constexpr float twoPi = glm::two_pi<float>();
+    const glm::vec3 delta{std::remainder(to.x - from.x, twoPi), std::remainder(to.y - from.y, twoPi),
+                          std::remainder(to.z - from.z, twoPi)};
+    return from + delta * alpha;
+}
+
+} // namespace
+
+// ============================================================================
+// LagCompensation Implementation
+// ============================================================================
+
+LagCompensation::LagCompensation(float historyDuration, float tickRate)
+    : maxHistoryDuration(historyDuration), ticksPerSecond(tickRate) {
+    setHistoryDuration(historyDuration);
+}
+
+void LagCompensation::setHistoryDuration(float seconds) {
+    maxHistoryDuration = seconds;
+    const auto slots = static_cast<std::size_t>(std::ceil(std::max(seconds, 0.0f) * ticksPerSecond)) + 1;
+    ring.assign(slots, TransformSnapshot{});
+    head = 0;
+    count = 0;
+}
+
+void LagCompensation::recordState(const Scene& scene, float timestamp) {
+    if (count > 0 && timestamp < snapshotAt(count - 1).timestamp) {
+        count = 0;  // Time went backwards; the history no longer lines up.
+    }
+    while (count > 0 && snapshotAt(0).timestamp < timestamp - maxHistoryDuration) {
+        head = (head + 1) % ring.size();
+        --count;
+    }
+
+    std::size_t slot;
+    if (count == ring.size()) {
+        slot = head;
+        head = (head + 1) % ring.size();
+    } else {
+        slot = (head + count) % ring.size();
+        ++count;
+    }
+
+    // The slot's arrays keep their capacity, so steady-state recording does not allocate.
+    TransformSnapshot& snapshot = ring[slot];
+    const auto& objects = scene.objects();
+    snapshot.timestamp = timestamp;
+    snapshot.positions.resize(objects.size());
+    snapshot.rotations.resize(objects.size());
+    snapshot.scales.resize(objects.size());
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        const Transform& transform = objects[i].transform();
+        snapshot.positions[i] = transform.position;
+        snapshot.rotations[i] = transform.rotation;
+        snapshot.scales[i] = transform.scale;
+    }
+}
+
+LagCompensation::Bracket LagCompensation::bracket(float timestamp) const {
+    Bracket around;
+    if (count == 0) {
+        return around;
+    }
+    if (timestamp <= snapshotAt(0).timestamp) {
+        around.before = around.after = &snapshotAt(0);
+        return around;
+    }
+    if (timestamp >= snapshotAt(count - 1).timestamp) {
+        around.before = around.after = &snapshotAt(count - 1);
+        return around;
+    }
+
+    // First snapshot strictly after `timestamp`; the one before it is at or before it.
+    std::size_t low = 1;
+    std::size_t high = count - 1;
+    while (low < high) {
+        const std::size_t mid = (low + high) / 2;
+        if (snapshotAt(mid).timestamp > timestamp) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    around.before = &snapshotAt(low - 1);
+    around.after = &snapshotAt(low);
+    const float span = around.after->timestamp - around.before->timestamp;
+    around.alpha = span > 0.0f ? (timestamp - around.before->timestamp) / span : 1.0f;
+    return around;
+}
+
+void LagCompensation::blend(const Bracket& around, std::size_t index, Transform& out) {
+    // Objects created between the two ticks only exist in the later one.
+    if (index >= around.before->positions.size()) {
+        out.position = around.after->positions[index];
+        out.rotation = around.after->rotations[index];
+        out.scale = around.after->scales[index];
+        return;
+    }
+    out.position = glm::mix(around.before->positions[index], around.after->positions[index], around.alpha);
+    out.rotation = mixAngles(around.before->rotations[index], around.after->rotations[index], around.alpha);
+    out.scale = glm::mix(around.before->scales[index], around.after->scales[index], around.alpha);
+}
+
+bool LagCompensation::sample(std::size_t objectIndex, float timestamp, Transform& out) const {
+    const Bracket around = bracket(timestamp);
+    if (around.after == nullptr || objectIndex >= around.after->positions.size()) {
+        return false;
+    }
+    blend(around, objectIndex, out);
+    return true;
+}
+
+void LagCompensation::rewindObject(Scene& scene, std::size_t index, const Bracket& around) {
+    Transform& transform = scene.objects()[index].transform();
+    rewound.push_back(index);
+    savedTransforms.push_back(transform);
+    blend(around, index, transform);
+}
+
+void LagCompensation::rewindTo(Scene& scene, float timestamp) {
+    restoreState(scene);
+    const Bracket around = bracket(timestamp);
+    if (around.after == nullptr) {
+        return;
+    }
+    const std::size_t objectCount = std::min(around.after->positions.size(), scene.objects().size());
+    for (std::size_t i = 0; i < objectCount; ++i) {
+        rewindObject(scene, i, around);
+    }
+}
+
+std::size_t LagCompensation::rewindAlongRay(Scene& scene, float timestamp, const glm::vec3& origin,
+                                            const glm::vec3& direction, float maxDistance, float radius) {
+    restoreState(scene);
+    const Bracket around = bracket(timestamp);
+    if (around.after == nullptr) {
+        return 0;
+    }
+
+    // Only the recorded positions are scanned; the scene is touched for the objects near the ray.
+    const std::size_t objectCount = std::min(around.after->positions.size(), scene.objects().size());
+    const std::size_t blended = std::min(around.before->positions.size(), objectCount);
+    const float radiusSquared = radius * radius;
+    const auto nearRay = [&](const glm::vec3& position) {
+        const glm::vec3 offset = position - origin;
+        const float along = std::clamp(glm::dot(offset, direction), 0.0f, maxDistance);
+        const glm::vec3 lateral = offset - direction * along;
+        return glm::dot(lateral, lateral) <= radiusSquared;
+    };
+    for (std::size_t i = 0; i < blended; ++i) {
+        if (nearRay(glm::mix(around.before->positions[i], around.after->positions[i], around.alpha))) {
+            rewindObject(scene, i, around);
+        }
+    }
+    for (std::size_t i = blended; i < objectCount; ++i) {
+        if (nearRay(around.after->positions[i])) {
+            rewindObject(scene, i, around);
+        }
+    }
+    return rewound.size();
+}
+
+void LagCompensation::restoreState(Scene& scene) {
+    auto& objects = scene.objects();
+    for (std::size_t k = 0; k < rewound.size(); ++k) {
+        if (rewound[k] < objects.size()) {
+            objects[rewound[k]].transform() = savedTransforms[k];
+        }
+    }
+    rewound.clear();
+    savedTransforms.clear();
+}
+
+} // namespace vkengine
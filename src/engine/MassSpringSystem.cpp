@@ -0,0 +1,205 @@
+#include "engine/MassSpringSystem.hpp"
+
+#include "core/ParallelFor.hpp"
+#include "core/SimdLanes.hpp"
+
+#include <glm/gtx/norm.hpp>
+
+#include <cmath>
+
+namespace vkengine {
+
+namespace {
+
+constexpr std::size_t kMinSpringsPerChunk = 4096;
+constexpr std::size_t kMinNodesPerChunk = 2048;
+constexpr std::size_t kMinFacesPerChunk = 4096;
+
+// Turns per-item counts in offsets[1..n] into CSR offsets.
+void prefixSum(std::vector<std::uint32_t>& offsets)
+{
+    for (std::size_t i = 1; i < offsets.size(); ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+}
+
+} // namespace
+
+// Integrates nodes [begin, end) kWidth at a time and returns the first index it did not reach.
+template<typename L>
+struct MassSpringKernel {
+    using F = typename L::Float;
+
+    static std::size_t integrate(MassSpringSystem& s, const MassSpringSystem::StepParams& p, std::size_t begin, std::size_t end)
+    {
+        const F zero = L::set1(0.0f);
+        const F dt = L::set1(p.deltaSeconds);
+        const F damping = L::set1(p.damping);
+        const F retention = L::set1(p.velocityRetention);
+        const F floorY = L::set1(p.floorY);
+        const F bounce = L::set1(-p.floorRestitution);
+        const F upward = L::set1(p.floorUpwardRetention);
+
+        std::size_t i = begin;
+        for (; i + L::kWidth <= end; i += L::kWidth) {
+            const auto isFree = L::greater(L::load(s.freeMask.data() + i), zero);
+            const auto axis = [&](std::vector<float>& position, std::vector<float>& velocity, const std::vector<float>& acceleration) {
+                const F v = L::load(velocity.data() + i);
+                const F a = L::sub(L::load(acceleration.data() + i), L::mul(damping, v));
+                const F newV = L::mul(L::add(v, L::mul(a, dt)), retention);
+                const F x = L::load(position.data() + i);
+                L::store(velocity.data() + i, L::select(isFree, newV, zero));
+                L::store(position.data() + i, L::select(isFree, L::add(x, L::mul(newV, dt)), x));
+                return newV;
+            };
+            axis(s.posX, s.velX, s.accelX);
+            const F vy = axis(s.posY, s.velY, s.accelY);
+            axis(s.posZ, s.velZ, s.accelZ);
+
+            // Floor contact for free nodes that ended up below it.
+            const F y = L::load(s.posY.data() + i);
+            const auto below = L::greater(floorY, y);
+            const F responseVy = L::select(L::greater(zero, vy), L::mul(bounce, vy), L::mul(upward, vy));
+            L::store(s.posY.data() + i, L::select(isFree, L::select(below, floorY, y), y));
+            L::store(s.velY.data() + i, L::select(isFree, L::select(below, responseVy, vy), zero));
+        }
+        return i;
+    }
+};
+
+void MassSpringSystem::resize(std::size_t nodeCount)
+{
+    for (auto* array : {&posX, &posY, &posZ, &velX, &velY, &velZ, &accelX, &accelY, &accelZ}) {
+        array->resize(nodeCount, 0.0f);
+    }
+    freeMask.resize(nodeCount, 1.0f);
+    incidenceDirty = true;
+}
+
+void MassSpringSystem::addSpring(std::size_t a, std::size_t b, float rest, float stiffness)
+{
+    springA.push_back(static_cast<std::uint32_t>(a));
+    springB.push_back(static_cast<std::uint32_t>(b));
+    restLength.push_back(rest);
+    springStiffness.push_back(stiffness);
+    forceX.push_back(0.0f);
+    forceY.push_back(0.0f);
+    forceZ.push_back(0.0f);
+    incidenceDirty = true;
+}
+
+void MassSpringSystem::setTriangles(const std::vector<std::uint32_t>& indices)
+{
+    triangles.assign(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(indices.size() / 3 * 3));
+    const std::size_t faceCount = triangles.size() / 3;
+    faceNormals.resize(faceCount);
+
+    vertexFaceOffsets.assign(size() + 1, 0);
+    for (const std::uint32_t vertex : triangles) {
+        ++vertexFaceOffsets[vertex + 1];
+    }
+    prefixSum(vertexFaceOffsets);
+    vertexFaces.resize(triangles.size());
+    std::vector<std::uint32_t> cursor(vertexFaceOffsets.begin(), vertexFaceOffsets.end() - 1);
+    for (std::size_t corner = 0; corner < triangles.size(); ++corner) {
+        vertexFaces[cursor[triangles[corner]]++] = static_cast<std::uint32_t>(corner / 3);
+    }
+}
+
+void MassSpringSystem::buildIncidence()
+{
+    incidenceOffsets.assign(size() + 1, 0);
+    for (std::size_t s = 0; s < springA.size(); ++s) {
+        ++incidenceOffsets[springA[s] + 1];
+        ++incidenceOffsets[springB[s] + 1];
+    }
+    prefixSum(incidenceOffsets);
+    incidence.resize(2 * springA.size());
+    std::vector<std::uint32_t> cursor(incidenceOffsets.begin(), incidenceOffsets.end() - 1);
+    for (std::size_t s = 0; s < springA.size(); ++s) {
+        incidence[cursor[springA[s]]++] = static_cast<std::uint32_t>(2 * s);
+        incidence[cursor[springB[s]]++] = static_cast<std::uint32_t>(2 * s + 1);
+    }
+    incidenceDirty = false;
+}
+
+void MassSpringSystem::step(const StepParams& params)
+{
+    const std::size_t nodeCount = size();
+    if (nodeCount == 0 || params.deltaSeconds <= 0.0f) {
+        return;
+    }
+    if (incidenceDirty) {
+        buildIncidence();
+    }
+
+    // Springs: Hooke force along the spring, written to the spring's own slot.
+    core::parallelForRange(springA.size(), kMinSpringsPerChunk, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t s = begin; s < end; ++s) {
+            const std::uint32_t a = springA[s];
+            const std::uint32_t b = springB[s];
+            const float dx = posX[b] - posX[a];
+            const float dy = posY[b] - posY[a];
+            const float dz = posZ[b] - posZ[a];
+            const float length = std::sqrt(dx * dx + dy * dy + dz * dz);
+            const float scale = length < params.minSpringLength
+                                    ? 0.0f
+                                    : springStiffness[s] * (length - restLength[s]) / length;
+            forceX[s] = scale * dx;
+            forceY[s] = scale * dy;
+            forceZ[s] = scale * dz;
+        }
+    });
+
+    // Nodes: gravity plus the forces of the incident springs.
+    const float inverseMass = 1.0f / params.massPerNode;
+    core::parallelForRange(nodeCount, kMinNodesPerChunk, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            glm::vec3 force{0.0f};
+            for (std::uint32_t k = incidenceOffsets[i]; k < incidenceOffsets[i + 1]; ++k) {
+                const std::uint32_t entry = incidence[k];
+                const std::uint32_t s = entry >> 1;
+                const glm::vec3 springForce{forceX[s], forceY[s], forceZ[s]};
+                force += (entry & 1u) != 0 ? -springForce : springForce;
+            }
+            accelX[i] = params.gravity.x + force.x * inverseMass;
+            accelY[i] = params.gravity.y + force.y * inverseMass;
+            accelZ[i] = params.gravity.z + force.z * inverseMass;
+        }
+    });
+
+    core::parallelForRange(nodeCount, kMinNodesPerChunk, [&](std::size_t begin, std::size_t end) {
+#if defined(VKENGINE_SIMD_AVX2)
+        begin = MassSpringKernel<core::simd::AvxLanes>::integrate(*this, params, begin, end);
+#endif
+#if defined(VKENGINE_SIMD_SSE2)
+        begin = MassSpringKernel<core::simd::SseLanes>::integrate(*this, params, begin, end);
+#endif
+        MassSpringKernel<core::simd::ScalarLanes>::integrate(*this, params, begin, end);
+    });
+}
+
+void MassSpringSystem::computeVertexNormals(float minLength, std::vector<glm::vec3>& outNormals) const
+{
+    const std::size_t faceCount = triangles.size() / 3;
+    core::parallelFor(faceCount, kMinFacesPerChunk, [&](std::size_t face) {
+        const glm::vec3 a = position(triangles[3 * face]);
+        const glm::vec3 b = position(triangles[3 * face + 1]);
+        const glm::vec3 c = position(triangles[3 * face + 2]);
+        const glm::vec3 normal = glm::cross(b - a, c - a);
+        faceNormals[face] = glm::length2(normal) < minLength ? glm::vec3(0.0f) : normal;
+    });
+
+    outNormals.resize(size());
+    core::parallelFor(size(), kMinNodesPerChunk, [&](std::size_t vertex) {
+        glm::vec3 normal{0.0f};
+        if (vertex + 1 < vertexFaceOffsets.size()) {
+            for (std::uint32_t k = vertexFaceOffsets[vertex]; k < vertexFaceOffsets[vertex + 1]; ++k) {
+                normal += faceNormals[vertexFaces[k]];
+            }
+        }
+        outNormals[vertex] = glm::length2(normal) > minLength ? glm::normalize(normal) : glm::vec3(0.0f, 1.0f, 0.0f);
+    });
+}
+
+} // namespace vkengine
@@ -1,11 +1,24 @@
 #include "engine/MolecularDynamics.hpp"
 
+#include "core/ParallelFor.hpp"
+
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 
 namespace vkengine {
 
+namespace {
+
+constexpr std::size_t kMinAtomsPerChunk = 1024;
+// Below this many listed pairs per block the force pass is not worth splitting further.
+constexpr std::size_t kMinPairsPerForceBlock = 16384;
+// Caps the cell grid for sparse systems; cells can always be larger than cutoff + skin.
+constexpr std::size_t kMaxCellsPerAtom = 2;
+
+} // namespace
+
 MdMaterial MdMaterial::copper()
 {
     MdMaterial material{};
@@ -38,6 +51,7 @@ void MolecularDynamicsSimulation::setMaterial(const MdMaterial& material) noexce
 {
     materialParams = material;
     refreshDerivedMaterialValues();
+    neighborListDirty = true;
 }
 
 void MolecularDynamicsSimulation::setMaxSubsteps(std::uint32_t substeps) noexcept
@@ -63,6 +77,12 @@ void MolecularDynamicsSimulation::setMaxSpeed(float speed) noexcept
     maxSpeed = std::max(minSpeed, speed);
 }
 
+void MolecularDynamicsSimulation::setNeighborSkin(float skin) noexcept
+{
+    skinDistance = std::max(0.0f, skin);
+    neighborListDirty = true;
+}
+
 void MolecularDynamicsSimulation::addKineticEnergy(float energyJoules) noexcept
 {
     if (energyJoules <= 0.0f || atomBuffer.empty()) {
@@ -116,12 +136,14 @@ MdAtom& MolecularDynamicsSimulation::addAtom(const glm::vec3& position, const gl
     atom.velocity = velocity;
     atom.mass = materialParams.mass;
     atomBuffer.emplace_back(atom);
+    neighborListDirty = true;
     return atomBuffer.back();
 }
 
 void MolecularDynamicsSimulation::clearAtoms()
 {
     atomBuffer.clear();
+    neighborListDirty = true;
 }
 
 void MolecularDynamicsSimulation::step(float deltaSeconds)
@@ -184,19 +206,67 @@ void MolecularDynamicsSimulation::integrate(float dt)
 
 void MolecularDynamicsSimulation::computeForces()
 {
-    if (atomBuffer.empty()) {
+    const std::size_t count = atomBuffer.size();
+    if (count == 0) {
         return;
     }
 
-    for (auto& atom : atomBuffer) {
-        atom.force = glm::vec3(0.0f);
+    if (neighborListStale()) {
+        rebuildNeighborList();
+    }
+
+    // Blocks of consecutive atoms with roughly equal pair counts, one force buffer each. Buffers
+    // are kept zeroed between passes, so only the ones sized for a different atom count need
+    // clearing here.
+    const std::size_t pairCount = neighborIndices.size();
+    std::size_t blockCount = 1;
+    if (count > kMinAtomsPerChunk) {
+        const std::size_t threads = core::parallelThreadCount() + 1;
+        blockCount = std::clamp<std::size_t>(pairCount / kMinPairsPerForceBlock, 1, threads);
+    }
+
+    if (blockForces.size() < blockCount) {
+        blockForces.resize(blockCount);
+    }
+    for (std::size_t b = 0; b < blockCount; ++b) {
+        if (blockForces[b].size() != count) {
+            blockForces[b].assign(count, glm::vec3(0.0f));
+        }
+    }
+
+    forceBlockStart.resize(blockCount + 1);
+    forceBlockStart[0] = 0;
+    forceBlockStart[blockCount] = static_cast<std::uint32_t>(count);
+    for (std::size_t b = 1; b < blockCount; ++b) {
+        const std::uint32_t targetPair = static_cast<std::uint32_t>(pairCount * b / blockCount);
+        const auto it = std::lower_bound(neighborOffsets.begin(), neighborOffsets.end() - 1, targetPair);
+        forceBlockStart[b] = std::max(forceBlockStart[b - 1], static_cast<std::uint32_t>(it - neighborOffsets.begin()));
     }
 
+    core::parallelFor(blockCount, 1, [&](std::size_t b) {
+        accumulateForces(forceBlockStart[b], forceBlockStart[b + 1], blockForces[b].data());
+    });
+
+    core::parallelFor(count, kMinAtomsPerChunk, [&](std::size_t i) {
+        glm::vec3 total{0.0f};
+        for (std::size_t b = 0; b < blockCount; ++b) {
+            total += blockForces[b][i];
+            blockForces[b][i] = glm::vec3(0.0f);
+        }
+        atomBuffer[i].force = total;
+    });
+}
+
+void MolecularDynamicsSimulation::accumulateForces(std::size_t begin, std::size_t end, glm::vec3* forces) const
+{
     const float minDistanceSquared = minDistance * minDistance;
 
-    for (std::size_t i = 0; i + 1 < atomBuffer.size(); ++i) {
-        for (std::size_t j = i + 1; j < atomBuffer.size(); ++j) {
-            glm::vec3 delta = atomBuffer[j].position - atomBuffer[i].position;
+    for (std::size_t i = begin; i < end; ++i) {
+        const glm::vec3 position = atomBuffer[i].position;
+        glm::vec3 force{0.0f};
+        for (std::uint32_t k = neighborOffsets[i]; k < neighborOffsets[i + 1]; ++k) {
+            const std::uint32_t j = neighborIndices[k];
+            glm::vec3 delta = atomBuffer[j].position - position;
             float r2 = glm::dot(delta, delta);
             r2 = std::max(r2, minDistanceSquared);
             if (r2 > cutoffSquared) {
@@ -209,10 +279,139 @@ void MolecularDynamicsSimulation::computeForces()
             const float forceMag = 24.0f * materialParams.epsilon * invR2 * term * (2.0f * term - 1.0f);
             const glm::vec3 forceVec = forceMag * delta;
 
-            atomBuffer[i].force += forceVec;
-            atomBuffer[j].force -= forceVec;
+            force += forceVec;
+            forces[j] -= forceVec;
+        }
+        forces[i] += force;
+    }
+}
+
+bool MolecularDynamicsSimulation::neighborListStale() const noexcept
+{
+    if (neighborListDirty || referencePositions.size() != atomBuffer.size()) {
+        return true;
+    }
+
+    // Two atoms that each moved less than half the skin cannot have closed more than the skin.
+    const float halfSkin = 0.5f * skinDistance;
+    const float limitSquared = halfSkin * halfSkin;
+    for (std::size_t i = 0; i < atomBuffer.size(); ++i) {
+        const glm::vec3 moved = atomBuffer[i].position - referencePositions[i];
+        if (glm::dot(moved, moved) > limitSquared) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MolecularDynamicsSimulation::rebuildNeighborList()
+{
+    const std::size_t count = atomBuffer.size();
+    const float listRadius = std::sqrt(cutoffSquared) + skinDistance;
+    const float listRadiusSquared = listRadius * listRadius;
+
+    glm::vec3 minCorner{atomBuffer[0].position};
+    glm::vec3 maxCorner{atomBuffer[0].position};
+    referencePositions.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const glm::vec3& position = atomBuffer[i].position;
+        referencePositions[i] = position;
+        minCorner = glm::min(minCorner, position);
+        maxCorner = glm::max(maxCorner, position);
+    }
+
+    // Cells at least listRadius wide, so every partner of an atom lies in the 27 cells around it.
+    const glm::vec3 extent = maxCorner - minCorner;
+    std::array<std::size_t, 3> dims{};
+    for (int axis = 0; axis < 3; ++axis) {
+        dims[axis] = std::max<std::size_t>(1, static_cast<std::size_t>(extent[axis] / listRadius));
+    }
+    const std::size_t maxCells = std::max<std::size_t>(27, count * kMaxCellsPerAtom);
+    while (dims[0] * dims[1] * dims[2] > maxCells) {
+        auto& largest = *std::max_element(dims.begin(), dims.end());
+        largest = (largest + 1) / 2;
+    }
+
+    glm::vec3 cellsPerUnit{0.0f};
+    for (int axis = 0; axis < 3; ++axis) {
+        if (extent[axis] > 0.0f) {
+            cellsPerUnit[axis] = static_cast<float>(dims[axis]) / extent[axis];
+        }
+    }
+    const auto cellCoord = [&](const glm::vec3& position, int axis) {
+        const auto cell = static_cast<std::size_t>(std::max(0.0f, (position[axis] - minCorner[axis]) * cellsPerUnit[axis]));
+        return std::min(cell, dims[axis] - 1);
+    };
+
+    // Counting sort of the atoms by cell; atoms keep index order within a cell.
+    const std::size_t cellCount = dims[0] * dims[1] * dims[2];
+    atomCells.resize(count);
+    cellStart.assign(cellCount + 1, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        const glm::vec3& position = atomBuffer[i].position;
+        const std::size_t cell = (cellCoord(position, 2) * dims[1] + cellCoord(position, 1)) * dims[0] + cellCoord(position, 0);
+        atomCells[i] = static_cast<std::uint32_t>(cell);
+        ++cellStart[cell + 1];
+    }
+    for (std::size_t c = 0; c < cellCount; ++c) {
+        cellStart[c + 1] += cellStart[c];
+    }
+    cellAtoms.resize(count);
+    {
+        // neighborOffsets is rewritten below; borrow it as the per-cell fill cursor.
+        std::vector<std::uint32_t>& cursor = neighborOffsets;
+        cursor.assign(cellStart.begin(), cellStart.end() - 1);
+        for (std::size_t i = 0; i < count; ++i) {
+            cellAtoms[cursor[atomCells[i]]++] = static_cast<std::uint32_t>(i);
         }
     }
+
+    // Calls visit(j) for every j > i within listRadius of atom i.
+    const auto forEachPartner = [&](std::size_t i, auto&& visit) {
+        const glm::vec3 position = atomBuffer[i].position;
+        const std::size_t cell = atomCells[i];
+        const std::size_t cx = cell % dims[0];
+        const std::size_t cy = (cell / dims[0]) % dims[1];
+        const std::size_t cz = cell / (dims[0] * dims[1]);
+        for (std::size_t z = (cz > 0 ? cz - 1 : 0); z <= std::min(cz + 1, dims[2] - 1); ++z) {
+            for (std::size_t y = (cy > 0 ? cy - 1 : 0); y <= std::min(cy + 1, dims[1] - 1); ++y) {
+                for (std::size_t x = (cx > 0 ? cx - 1 : 0); x <= std::min(cx + 1, dims[0] - 1); ++x) {
+                    const std::size_t other = (z * dims[1] + y) * dims[0] + x;
+                    for (std::uint32_t slot = cellStart[other]; slot < cellStart[other + 1]; ++slot) {
+                        const std::uint32_t j = cellAtoms[slot];
+                        if (j <= i) {
+                            continue;
+                        }
+                        const glm::vec3 delta = atomBuffer[j].position - position;
+                        if (glm::dot(delta, delta) <= listRadiusSquared) {
+                            visit(j);
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    // Two passes over the grid, count then fill, so the list is written in place without
+    // per-thread staging.
+    neighborOffsets.assign(count + 1, 0);
+    core::parallelFor(count, kMinAtomsPerChunk, [&](std::size_t i) {
+        std::uint32_t partners = 0;
+        forEachPartner(i, [&](std::uint32_t) { ++partners; });
+        neighborOffsets[i + 1] = partners;
+    });
+    for (std::size_t i = 0; i < count; ++i) {
+        neighborOffsets[i + 1] += neighborOffsets[i];
+    }
+
+    neighborIndices.resize(neighborOffsets[count]);
+    core::parallelFor(count, kMinAtomsPerChunk, [&](std::size_t i) {
+        std::uint32_t slot = neighborOffsets[i];
+        forEachPartner(i, [&](std::uint32_t j) { neighborIndices[slot++] = j; });
+    });
+
+    neighborListDirty = false;
+    ++neighborRebuilds;
 }
 
 void MolecularDynamicsSimulation::applyBounds(MdAtom& atom) const
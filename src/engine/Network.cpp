@@ -1,6 +1,9 @@
 #include "engine/Network.hpp"
 
+#include "engine/DebugTools.hpp"
+
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <iostream>
 
@@ -15,6 +18,12 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <cerrno>
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
 #endif
 
 namespace vkengine {
@@ -23,6 +32,117 @@ namespace vkengine {
 // Packet Implementation
 // ============================================================================
 
+namespace {
+
+constexpr float kSmallestThreeBound = 0.70710678f;  // Largest value of a non-largest component.
+
+void storeUInt16(std::uint8_t* out, std::uint16_t value) {
+    out[0] = static_cast<std::uint8_t>(value >> 8);
+    out[1] = static_cast<std::uint8_t>(value & 0xFF);
+}
+
+void storeUInt32(std::uint8_t* out, std::uint32_t value) {
+    out[0] = static_cast<std::uint8_t>(value >> 24);
+    out[1] = static_cast<std::uint8_t>((value >> 16) & 0xFF);
+    out[2] = static_cast<std::uint8_t>((value >> 8) & 0xFF);
+    out[3] = static_cast<std::uint8_t>(value & 0xFF);
+}
+
+std::uint16_t loadUInt16(const std::uint8_t* in) {
+    return static_cast<std::uint16_t>((in[0] << 8) | in[1]);
+}
+
+std::uint32_t loadUInt32(const std::uint8_t* in) {
+    return (static_cast<std::uint32_t>(in[0]) << 24) | (static_cast<std::uint32_t>(in[1]) << 16) |
+           (static_cast<std::uint32_t>(in[2]) << 8) | static_cast<std::uint32_t>(in[3]);
+}
+
+std::uint32_t maxQuantized(std::uint32_t bitCount) {
+    return bitCount >= 32 ? 0xFFFFFFFFu : (1u << bitCount) - 1u;
+}
+
+std::uint32_t quantize(float value, float minValue, float maxValue, std::uint32_t bitCount) {
+    const float range = maxValue - minValue;
+    const float t = range > 0.0f ? std::clamp((value - minValue) / range, 0.0f, 1.0f) : 0.0f;
+    return static_cast<std::uint32_t>(std::lround(static_cast<double>(t) * maxQuantized(bitCount)));
+}
+
+float dequantize(std::uint32_t value, float minValue, float maxValue, std::uint32_t bitCount) {
+    const double t = static_cast<double>(value) / maxQuantized(bitCount);
+    return minValue + static_cast<float>(t) * (maxValue - minValue);
+}
+
+// Per-thread buffer outgoing packets are serialized into instead of a freshly allocated vector.
+std::uint8_t* sendScratch() {
+    thread_local std::array<std::uint8_t, MaxDatagramSize> sendBuffer;
+    return sendBuffer.data();
+}
+
+bool sendPacket(Socket& socket, const NetworkAddress& address, const Packet& packet, std::size_t maxSize) {
+    const std::size_t size = packet.serializeInto(sendScratch(), maxSize);
+    return size > 0 && socket.sendTo(address, sendScratch(), size);
+}
+
+sockaddr_in toSocketAddress(const NetworkAddress& address) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(address.port);
+    inet_pton(AF_INET, address.host.c_str(), &addr.sin_addr);
+    return addr;
+}
+
+void fromSocketAddress(const sockaddr_in& addr, NetworkAddress& address) {
+    char hostBuf[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr.sin_addr, hostBuf, sizeof(hostBuf));
+    address.host = hostBuf;
+    address.port = ntohs(addr.sin_port);
+}
+
+} // namespace
+
+// ============================================================================
+// PacketBufferPool Implementation
+// ============================================================================
+
+PacketBufferPool& PacketBufferPool::shared() {
+    static PacketBufferPool pool;
+    return pool;
+}
+
+std::vector<std::uint8_t> PacketBufferPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!freeBuffers.empty()) {
+            std::vector<std::uint8_t> buffer = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+            return buffer;
+        }
+    }
+    std::vector<std::uint8_t> buffer;
+    buffer.reserve(InitialCapacity);
+    return buffer;
+}
+
+void PacketBufferPool::release(std::vector<std::uint8_t>&& buffer) {
+    if (buffer.capacity() == 0 || buffer.capacity() > MaxPooledCapacity) {
+        return;
+    }
+    buffer.clear();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (freeBuffers.size() < MaxPooledBuffers) {
+        freeBuffers.push_back(std::move(buffer));
+    }
+}
+
+std::size_t PacketBufferPool::pooledCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return freeBuffers.size();
+}
+
+// ============================================================================
+// Packet Implementation
+// ============================================================================
+
 Packet::Packet() = default;
 
 Packet::Packet(std::uint16_t packetType) {
@@ -31,33 +151,105 @@ Packet::Packet(std::uint16_t packetType) {
 
 Packet::Packet(const std::uint8_t* data, std::size_t size) {
     if (data && size > 0) {
-        payload.assign(data, data + size);
+        std::memcpy(appendBytes(size), data, size);
     }
 }
 
+Packet::Packet(const Packet& other)
+    : header(other.header), readPos(other.readPos), readBitOffset(other.readBitOffset), readOverflow(other.readOverflow) {
+    if (!other.payload.empty()) {
+        std::memcpy(appendBytes(other.payload.size()), other.payload.data(), other.payload.size());
+    }
+    writeBitOffset = other.writeBitOffset;
+}
+
+Packet::Packet(Packet&& other) noexcept
+    : header(other.header), payload(std::move(other.payload)), readPos(other.readPos),
+      writeBitOffset(other.writeBitOffset), readBitOffset(other.readBitOffset), readOverflow(other.readOverflow) {
+    other.reset();
+}
+
+Packet& Packet::operator=(const Packet& other) {
+    if (this != &other) {
+        payload.clear();
+        if (!other.payload.empty()) {
+            std::memcpy(appendBytes(other.payload.size()), other.payload.data(), other.payload.size());
+        }
+        header = other.header;
+        readPos = other.readPos;
+        writeBitOffset = other.writeBitOffset;
+        readBitOffset = other.readBitOffset;
+        readOverflow = other.readOverflow;
+    }
+    return *this;
+}
+
+Packet& Packet::operator=(Packet&& other) noexcept {
+    if (this != &other) {
+        PacketBufferPool::shared().release(std::move(payload));
+        payload = std::move(other.payload);
+        header = other.header;
+        readPos = other.readPos;
+        writeBitOffset = other.writeBitOffset;
+        readBitOffset = other.readBitOffset;
+        readOverflow = other.readOverflow;
+        other.reset();
+    }
+    return *this;
+}
+
+Packet::~Packet() {
+    PacketBufferPool::shared().release(std::move(payload));
+}
+
 void Packet::ensureCapacity(std::size_t additionalBytes) {
-    payload.reserve(payload.size() + additionalBytes);
+    if (payload.capacity() == 0) {
+        payload = PacketBufferPool::shared().acquire();
+    }
+    if (payload.size() + additionalBytes > payload.capacity()) {
+        payload.reserve(std::max(payload.size() + additionalBytes, payload.capacity() * 2));
+    }
+}
+
+std::uint8_t* Packet::appendBytes(std::size_t count) {
+    ensureCapacity(count);
+    writeBitOffset = 0;
+    const std::size_t offset = payload.size();
+    payload.resize(offset + count);
+    return payload.data() + offset;
+}
+
+const std::uint8_t* Packet::consumeBytes(std::size_t count) {
+    if (readBitOffset != 0) {
+        ++readPos;
+        readBitOffset = 0;
+    }
+    if (readPos + count > payload.size()) {
+        readPos = payload.size();
+        readOverflow = true;
+        return nullptr;
+    }
+    const std::uint8_t* bytes = payload.data() + readPos;
+    readPos += count;
+    return bytes;
 }
 
 void Packet::writeUInt8(std::uint8_t value) {
-    payload.push_back(value);
+    *appendBytes(1) = value;
 }
 
 void Packet::writeUInt16(std::uint16_t value) {
-    payload.push_back(static_cast<std::uint8_t>(value >> 8));
-    payload.push_back(static_cast<std::uint8_t>(value & 0xFF));
+    storeUInt16(appendBytes(2), value);
 }
 
 void Packet::writeUInt32(std::uint32_t value) {
-    payload.push_back(static_cast<std::uint8_t>(value >> 24));
-    payload.push_back(static_cast<std::uint8_t>((value >> 16) & 0xFF));
-    payload.push_back(static_cast<std::uint8_t>((value >> 8) & 0xFF));
-    payload.push_back(static_cast<std::uint8_t>(value & 0xFF));
+    storeUInt32(appendBytes(4), value);
 }
 
 void Packet::writeUInt64(std::uint64_t value) {
-    writeUInt32(static_cast<std::uint32_t>(value >> 32));
-    writeUInt32(static_cast<std::uint32_t>(value & 0xFFFFFFFF));
+    std::uint8_t* out = appendBytes(8);
+    storeUInt32(out, static_cast<std::uint32_t>(value >> 32));
+    storeUInt32(out + 4, static_cast<std::uint32_t>(value & 0xFFFFFFFF));
 }
 
 void Packet::writeInt8(std::int8_t value) {
@@ -88,11 +280,11 @@ void Packet::writeDouble(double value) {
     writeUInt64(bits);
 }
 
-void Packet::writeString(const std::string& str) {
-    writeUInt16(static_cast<std::uint16_t>(str.size()));
-    for (char c : str) {
-        writeUInt8(static_cast<std::uint8_t>(c));
-    }
+void Packet::writeString(std::string_view str) {
+    const std::size_t length = std::min<std::size_t>(str.size(), 0xFFFF);
+    std::uint8_t* out = appendBytes(2 + length);
+    storeUInt16(out, static_cast<std::uint16_t>(length));
+    std::memcpy(out + 2, str.data(), length);
 }
 
 void Packet::writeVec2(const glm::vec2& value) {
@@ -121,35 +313,90 @@ void Packet::writeQuat(const glm::quat& value) {
 }
 
 void Packet::writeBytes(const void* data, std::size_t size) {
-    const auto* bytes = static_cast<const std::uint8_t*>(data);
-    for (std::size_t i = 0; i < size; i++) {
-        writeUInt8(bytes[i]);
+    if (size > 0) {
+        std::memcpy(appendBytes(size), data, size);
+    }
+}
+
+void Packet::writeBits(std::uint32_t value, std::uint32_t bitCount) {
+    bitCount = std::min(bitCount, 32u);
+    std::uint64_t bits = bitCount == 32 ? value : (value & ((1u << bitCount) - 1u));
+    while (bitCount > 0) {
+        if (writeBitOffset == 0) {
+            ensureCapacity(1);
+            payload.push_back(0);
+        }
+        const std::uint32_t chunk = std::min(bitCount, 8 - writeBitOffset);
+        payload.back() |= static_cast<std::uint8_t>((bits & ((1u << chunk) - 1u)) << writeBitOffset);
+        bits >>= chunk;
+        bitCount -= chunk;
+        writeBitOffset = (writeBitOffset + chunk) & 7u;
+    }
+}
+
+void Packet::writeBool(bool value) {
+    writeBits(value ? 1u : 0u, 1);
+}
+
+void Packet::writeVarUInt(std::uint64_t value) {
+    while (value >= 0x80) {
+        writeBits(static_cast<std::uint32_t>(value & 0x7F) | 0x80u, 8);
+        value >>= 7;
+    }
+    writeBits(static_cast<std::uint32_t>(value), 8);
+}
+
+void Packet::writeVarInt(std::int64_t value) {
+    const std::uint64_t zigzag = (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    writeVarUInt(zigzag);
+}
+
+void Packet::writeQuantizedFloat(float value, float minValue, float maxValue, std::uint32_t bitCount) {
+    writeBits(quantize(value, minValue, maxValue, bitCount), bitCount);
+}
+
+void Packet::writeQuantizedVec3(const glm::vec3& value, float minValue, float maxValue, std::uint32_t bitCount) {
+    writeQuantizedFloat(value.x, minValue, maxValue, bitCount);
+    writeQuantizedFloat(value.y, minValue, maxValue, bitCount);
+    writeQuantizedFloat(value.z, minValue, maxValue, bitCount);
+}
+
+void Packet::writeCompressedQuat(const glm::quat& value, std::uint32_t bitCount) {
+    const float components[4] = {value.x, value.y, value.z, value.w};
+    std::uint32_t largest = 0;
+    for (std::uint32_t i = 1; i < 4; ++i) {
+        if (std::abs(components[i]) > std::abs(components[largest])) {
+            largest = i;
+        }
+    }
+    // q and -q are the same rotation; flip so the dropped component is positive.
+    const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+    writeBits(largest, 2);
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        if (i != largest) {
+            writeQuantizedFloat(sign * components[i], -kSmallestThreeBound, kSmallestThreeBound, bitCount);
+        }
     }
 }
 
 std::uint8_t Packet::readUInt8() {
-    if (readPos >= payload.size()) return 0;
-    return payload[readPos++];
+    const std::uint8_t* in = consumeBytes(1);
+    return in ? in[0] : 0;
 }
 
 std::uint16_t Packet::readUInt16() {
-    std::uint16_t value = static_cast<std::uint16_t>(readUInt8()) << 8;
-    value |= readUInt8();
-    return value;
+    const std::uint8_t* in = consumeBytes(2);
+    return in ? loadUInt16(in) : 0;
 }
 
 std::uint32_t Packet::readUInt32() {
-    std::uint32_t value = static_cast<std::uint32_t>(readUInt8()) << 24;
-    value |= static_cast<std::uint32_t>(readUInt8()) << 16;
-    value |= static_cast<std::uint32_t>(readUInt8()) << 8;
-    value |= readUInt8();
-    return value;
+    const std::uint8_t* in = consumeBytes(4);
+    return in ? loadUInt32(in) : 0;
 }
 
 std::uint64_t Packet::readUInt64() {
-    std::uint64_t high = readUInt32();
-    std::uint64_t low = readUInt32();
-    return (high << 32) | low;
+    const std::uint8_t* in = consumeBytes(8);
+    return in ? (static_cast<std::uint64_t>(loadUInt32(in)) << 32) | loadUInt32(in + 4) : 0;
 }
 
 std::int8_t Packet::readInt8() {
@@ -183,15 +430,21 @@ double Packet::readDouble() {
 }
 
 std::string Packet::readString() {
-    std::uint16_t length = readUInt16();
     std::string str;
-    str.reserve(length);
-    for (std::uint16_t i = 0; i < length; ++i) {
-        str.push_back(static_cast<char>(readUInt8()));
-    }
+    readString(str);
     return str;
 }
 
+void Packet::readString(std::string& out) {
+    const std::uint16_t length = readUInt16();
+    const std::uint8_t* in = consumeBytes(length);
+    if (in) {
+        out.assign(reinterpret_cast<const char*>(in), length);
+    } else {
+        out.clear();
+    }
+}
+
 glm::vec2 Packet::readVec2() {
     float x = readFloat();
     float y = readFloat();
@@ -222,51 +475,140 @@ glm::quat Packet::readQuat() {
 }
 
 void Packet::readBytes(void* data, std::size_t size) {
-    auto* bytes = static_cast<std::uint8_t*>(data);
-    for (std::size_t i = 0; i < size; i++) {
-        bytes[i] = readUInt8();
+    const std::uint8_t* in = consumeBytes(size);
+    if (in) {
+        std::memcpy(data, in, size);
+    } else {
+        std::memset(data, 0, size);
+    }
+}
+
+std::uint32_t Packet::readBits(std::uint32_t bitCount) {
+    bitCount = std::min(bitCount, 32u);
+    std::uint64_t value = 0;
+    std::uint32_t filled = 0;
+    while (filled < bitCount) {
+        if (readPos >= payload.size()) {
+            readOverflow = true;
+            return 0;
+        }
+        const std::uint32_t chunk = std::min(bitCount - filled, 8 - readBitOffset);
+        const std::uint32_t bits = (payload[readPos] >> readBitOffset) & ((1u << chunk) - 1u);
+        value |= static_cast<std::uint64_t>(bits) << filled;
+        filled += chunk;
+        readBitOffset += chunk;
+        if (readBitOffset == 8) {
+            readBitOffset = 0;
+            ++readPos;
+        }
+    }
+    return static_cast<std::uint32_t>(value);
+}
+
+bool Packet::readBool() {
+    return readBits(1) != 0;
+}
+
+std::uint64_t Packet::readVarUInt() {
+    std::uint64_t value = 0;
+    for (std::uint32_t shift = 0; shift < 64; shift += 7) {
+        const std::uint32_t group = readBits(8);
+        value |= static_cast<std::uint64_t>(group & 0x7F) << shift;
+        if ((group & 0x80) == 0) {
+            return value;
+        }
+    }
+    readOverflow = true;
+    return value;
+}
+
+std::int64_t Packet::readVarInt() {
+    const std::uint64_t zigzag = readVarUInt();
+    return static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+}
+
+float Packet::readQuantizedFloat(float minValue, float maxValue, std::uint32_t bitCount) {
+    return dequantize(readBits(bitCount), minValue, maxValue, bitCount);
+}
+
+glm::vec3 Packet::readQuantizedVec3(float minValue, float maxValue, std::uint32_t bitCount) {
+    const float x = readQuantizedFloat(minValue, maxValue, bitCount);
+    const float y = readQuantizedFloat(minValue, maxValue, bitCount);
+    const float z = readQuantizedFloat(minValue, maxValue, bitCount);
+    return glm::vec3(x, y, z);
+}
+
+glm::quat Packet::readCompressedQuat(std::uint32_t bitCount) {
+    const std::uint32_t largest = readBits(2);
+    float components[4];
+    float sumSquares = 0.0f;
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        if (i != largest) {
+            components[i] = readQuantizedFloat(-kSmallestThreeBound, kSmallestThreeBound, bitCount);
+            sumSquares += components[i] * components[i];
+        }
+    }
+    components[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSquares));
+    return glm::quat(components[3], components[0], components[1], components[2]);
+}
+
+std::size_t Packet::serializeInto(std::uint8_t* out, std::size_t capacity) const {
+    const std::size_t size = wireSize();
+    if (out == nullptr || size > capacity || payload.size() > 0xFFFF) {
+        return 0;
+    }
+
+    storeUInt16(out, header.type);
+    storeUInt32(out + 2, header.sequence);
+    storeUInt32(out + 6, header.ack);
+    storeUInt32(out + 10, header.ackBitfield);
+    storeUInt16(out + 14, static_cast<std::uint16_t>(payload.size()));
+    storeUInt16(out + 16, 0);  // Checksum (placeholder)
+    if (!payload.empty()) {
+        std::memcpy(out + HeaderSize, payload.data(), payload.size());
     }
+    return size;
 }
 
 std::vector<std::uint8_t> Packet::serialize() const {
-    std::vector<std::uint8_t> result;
-    result.reserve(sizeof(PacketHeader) + payload.size());
-    
-    // Write header
-    result.push_back(static_cast<std::uint8_t>(header.type >> 8));
-    result.push_back(static_cast<std::uint8_t>(header.type & 0xFF));
-    result.push_back(static_cast<std::uint8_t>(header.sequence >> 24));
-    result.push_back(static_cast<std::uint8_t>((header.sequence >> 16) & 0xFF));
-    result.push_back(static_cast<std::uint8_t>((header.sequence >> 8) & 0xFF));
-    result.push_back(static_cast<std::uint8_t>(header.sequence & 0xFF));
-    result.push_back(static_cast<std::uint8_t>(header.ack >> 24));
-    result.push_back(static_cast<std::uint8_t>((header.ack >> 16) & 0xFF));
-    result.push_back(static_cast<std::uint8_t>((header.ack >> 8) & 0xFF));
-    result.push_back(static_cast<std::uint8_t>(header.ack & 0xFF));
-    result.push_back(static_cast<std::uint8_t>(header.ackBitfield >> 24));
-    result.push_back(static_cast<std::uint8_t>((header.ackBitfield >> 16) & 0xFF));
-    result.push_back(static_cast<std::uint8_t>((header.ackBitfield >> 8) & 0xFF));
-    result.push_back(static_cast<std::uint8_t>(header.ackBitfield & 0xFF));
-    
-    // Payload size
-    std::uint16_t size = static_cast<std::uint16_t>(payload.size());
-    result.push_back(static_cast<std::uint8_t>(size >> 8));
-    result.push_back(static_cast<std::uint8_t>(size & 0xFF));
-    
-    // Checksum (placeholder)
-    result.push_back(0);
-    result.push_back(0);
-    
-    // Payload
-    result.insert(result.end(), payload.begin(), payload.end());
-    
+    std::vector<std::uint8_t> result(wireSize());
+    result.resize(serializeInto(result.data(), result.size()));
     return result;
 }
 
+bool Packet::deserialize(const std::uint8_t* data, std::size_t size) {
+    if (data == nullptr || size < HeaderSize) {
+        return false;
+    }
+    const std::size_t declaredPayload = loadUInt16(data + 14);
+    if (HeaderSize + declaredPayload > size) {
+        return false;
+    }
+
+    reset();
+    header.type = loadUInt16(data);
+    header.sequence = loadUInt32(data + 2);
+    header.ack = loadUInt32(data + 6);
+    header.ackBitfield = loadUInt32(data + 10);
+    header.payloadSize = static_cast<std::uint16_t>(declaredPayload);
+    header.checksum = loadUInt16(data + 16);
+    if (declaredPayload > 0) {
+        std::memcpy(appendBytes(declaredPayload), data + HeaderSize, declaredPayload);
+    }
+    return true;
+}
+
 void Packet::reset() {
     header = PacketHeader{};
     payload.clear();
+    writeBitOffset = 0;
+    resetRead();
+}
+
+void Packet::resetRead() {
     readPos = 0;
+    readBitOffset = 0;
+    readOverflow = false;
 }
 
 // ============================================================================
@@ -327,6 +669,10 @@ void Connection::setLastReceivedSequence(SequenceNumber seq) {
 // Socket Implementation
 // ============================================================================
 
+DatagramBatch::DatagramBatch(std::size_t capacity, std::size_t slotBytes)
+    : storage(capacity * slotBytes), datagrams(capacity), slotSize(slotBytes) {
+}
+
 Socket::Socket() = default;
 
 Socket::~Socket() {
@@ -354,10 +700,7 @@ bool Socket::bind(std::uint16_t port) {
 bool Socket::sendTo(const NetworkAddress& address, const void* data, std::size_t size) {
     if (socketHandle < 0) return false;
     
-    sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(address.port);
-    inet_pton(AF_INET, address.host.c_str(), &addr.sin_addr);
+    sockaddr_in addr = toSocketAddress(address);
     
     auto sent = ::sendto(socketHandle, static_cast<const char*>(data), static_cast<int>(size), 0,
                          reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
@@ -374,15 +717,136 @@ int Socket::receiveFrom(NetworkAddress& address, void* buffer, std::size_t buffe
                             reinterpret_cast<sockaddr*>(&addr), &addrLen);
     
     if (received > 0) {
-        char hostBuf[INET_ADDRSTRLEN];
-        inet_ntop(AF_INET, &addr.sin_addr, hostBuf, sizeof(hostBuf));
-        address.host = hostBuf;
-        address.port = ntohs(addr.sin_port);
+        fromSocketAddress(addr, address);
     }
     
     return received;
 }
 
+int Socket::receiveBatch(DatagramBatch& batch) {
+    batch.count = 0;
+    if (socketHandle < 0) return -1;
+
+#ifdef __linux__
+    constexpr std::size_t kMaxBatch = 64;
+    std::array<mmsghdr, kMaxBatch> messages{};
+    std::array<iovec, kMaxBatch> vectors{};
+    std::array<sockaddr_in, kMaxBatch> addresses{};
+    const std::size_t capacity = std::min(batch.capacity(), kMaxBatch);
+    for (std::size_t i = 0; i < capacity; ++i) {
+        vectors[i].iov_base = batch.storage.data() + i * batch.slotSize;
+        vectors[i].iov_len = batch.slotSize;
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    const int received = recvmmsg(socketHandle, messages.data(), static_cast<unsigned int>(capacity), MSG_DONTWAIT, nullptr);
+    if (received < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+    for (int i = 0; i < received; ++i) {
+        Datagram& datagram = batch.datagrams[batch.count++];
+        fromSocketAddress(addresses[i], datagram.address);
+        datagram.data = batch.storage.data() + static_cast<std::size_t>(i) * batch.slotSize;
+        datagram.size = messages[i].msg_len;
+    }
+#else
+    for (std::size_t i = 0; i < batch.capacity(); ++i) {
+        Datagram& datagram = batch.datagrams[batch.count];
+        std::uint8_t* slot = batch.storage.data() + i * batch.slotSize;
+        const int received = receiveFrom(datagram.address, slot, batch.slotSize);
+        if (received <= 0) {
+            break;
+        }
+        datagram.data = slot;
+        datagram.size = static_cast<std::size_t>(received);
+        ++batch.count;
+    }
+#endif
+    return static_cast<int>(batch.count);
+}
+
+std::size_t Socket::sendBatch(const Datagram* datagrams, std::size_t count) {
+    if (socketHandle < 0) return 0;
+
+#ifdef __linux__
+    constexpr std::size_t kMaxBatch = 64;
+    std::array<mmsghdr, kMaxBatch> messages{};
+    std::array<iovec, kMaxBatch> vectors{};
+    std::array<sockaddr_in, kMaxBatch> addresses{};
+    std::size_t sent = 0;
+    while (sent < count) {
+        const std::size_t chunk = std::min(count - sent, kMaxBatch);
+        for (std::size_t i = 0; i < chunk; ++i) {
+            const Datagram& datagram = datagrams[sent + i];
+            addresses[i] = toSocketAddress(datagram.address);
+            vectors[i].iov_base = const_cast<std::uint8_t*>(datagram.data);
+            vectors[i].iov_len = datagram.size;
+            messages[i] = mmsghdr{};
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        }
+        const int result = sendmmsg(socketHandle, messages.data(), static_cast<unsigned int>(chunk), 0);
+        if (result <= 0) {
+            break;
+        }
+        sent += static_cast<std::size_t>(result);
+    }
+    return sent;
+#else
+    std::size_t sent = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (sendTo(datagrams[i].address, datagrams[i].data, datagrams[i].size)) {
+            ++sent;
+        }
+    }
+    return sent;
+#endif
+}
+
+bool Socket::waitReadable(int timeoutMilliseconds) {
+    if (socketHandle < 0) return false;
+
+#if defined(__linux__)
+    if (pollHandle < 0) {
+        pollHandle = epoll_create1(EPOLL_CLOEXEC);
+        if (pollHandle < 0) return false;
+        epoll_event watch{};
+        watch.events = EPOLLIN;
+        watch.data.fd = socketHandle;
+        if (epoll_ctl(pollHandle, EPOLL_CTL_ADD, socketHandle, &watch) < 0) {
+            ::close(pollHandle);
+            pollHandle = -1;
+            return false;
+        }
+    }
+    epoll_event ready{};
+    return epoll_wait(pollHandle, &ready, 1, timeoutMilliseconds) > 0;
+#elif defined(_WIN32)
+    WSAPOLLFD watch{};
+    watch.fd = static_cast<SOCKET>(socketHandle);
+    watch.events = POLLRDNORM;
+    return WSAPoll(&watch, 1, timeoutMilliseconds) > 0;
+#else
+    pollfd watch{};
+    watch.fd = socketHandle;
+    watch.events = POLLIN;
+    return ::poll(&watch, 1, timeoutMilliseconds) > 0;
+#endif
+}
+
+std::uint16_t Socket::localPort() const {
+    if (socketHandle < 0) return 0;
+    sockaddr_in addr{};
+    socklen_t addrLen = sizeof(addr);
+    if (getsockname(socketHandle, reinterpret_cast<sockaddr*>(&addr), &addrLen) < 0) return 0;
+    return ntohs(addr.sin_port);
+}
+
 bool Socket::connect(const NetworkAddress& address) {
     socketHandle = static_cast<int>(::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
     if (socketHandle < 0) return false;
@@ -451,6 +915,12 @@ int Socket::receive(void* buffer, std::size_t bufferSize) {
 }
 
 void Socket::close() {
+#ifdef __linux__
+    if (pollHandle >= 0) {
+        ::close(pollHandle);
+        pollHandle = -1;
+    }
+#endif
     if (socketHandle >= 0) {
 #ifdef _WIN32
         closesocket(socketHandle);
@@ -507,7 +977,7 @@ bool NetworkServer::start(std::uint16_t port, std::uint32_t max) {
     }
     
     socket->setNonBlocking(true);
-    serverPort = port;
+    serverPort = socket->localPort();
     maxClients = max;
     running = true;
     
@@ -574,28 +1044,39 @@ std::size_t NetworkServer::clientCount() const {
 }
 
 void NetworkServer::send(ClientId clientId, const Packet& packet, PacketReliability reliability) {
-    (void)reliability;  // TODO: implement reliability
-    
-    std::lock_guard<std::mutex> lock(connectionMutex);
-    auto it = connections.find(clientId);
-    if (it == connections.end()) return;
-    
-    auto data = packet.serialize();
-    socket->sendTo(it->second->address(), data.data(), data.size());
+    if (clientId == InvalidClientId) return;
+    deliver(packet, reliability, clientId, InvalidClientId);
 }
 
 void NetworkServer::broadcast(const Packet& packet, PacketReliability reliability) {
-    for (ClientId id : connectedClients()) {
-        send(id, packet, reliability);
-    }
+    broadcastExcept(InvalidClientId, packet, reliability);
 }
 
 void NetworkServer::broadcastExcept(ClientId excludeId, const Packet& packet, PacketReliability reliability) {
-    for (ClientId id : connectedClients()) {
-        if (id != excludeId) {
-            send(id, packet, reliability);
+    deliver(packet, reliability, InvalidClientId, excludeId);
+}
+
+void NetworkServer::deliver(const Packet& packet, PacketReliability reliability, ClientId target, ClientId excludeId) {
+    (void)reliability;  // TODO: implement reliability
+
+    const std::size_t size = packet.serializeInto(sendScratch(), maxPacketBytes);
+    if (size == 0) return;
+
+    thread_local std::vector<Datagram> datagrams;
+    datagrams.clear();
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    if (target != InvalidClientId) {
+        auto it = connections.find(target);
+        if (it == connections.end()) return;
+        datagrams.push_back(Datagram{it->second->address(), sendScratch(), size});
+    } else {
+        for (const auto& [id, connection] : connections) {
+            if (id != excludeId) {
+                datagrams.push_back(Datagram{connection->address(), sendScratch(), size});
+            }
         }
     }
+    socket->sendBatch(datagrams.data(), datagrams.size());
 }
 
 bool NetworkServer::pollEvent(NetworkEvent& event) {
@@ -642,22 +1123,29 @@ void NetworkServer::update() {
 }
 
 void NetworkServer::networkThread() {
-    std::vector<std::uint8_t> buffer(65536);
+    Profiler::instance().setThreadName("Network Server");
+    DatagramBatch batch(DatagramBatch::DefaultCapacity, maxPacketBytes);
     
     while (running) {
-        NetworkAddress fromAddr;
-        int received = socket->receiveFrom(fromAddr, buffer.data(), buffer.size());
+        if (!socket->waitReadable(NetworkPollTimeoutMs)) continue;
         
-        if (received > 0) {
-            processIncomingPacket(fromAddr, buffer.data(), received);
+        // Drain everything that is pending before blocking again.
+        while (running && socket->receiveBatch(batch) > 0) {
+            PROFILE_SCOPE("NetworkServer.ProcessBatch");
+            for (std::size_t i = 0; i < batch.size(); ++i) {
+                processIncomingPacket(batch[i].address, batch[i].data, batch[i].size);
+            }
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 }
 
 void NetworkServer::processIncomingPacket(const NetworkAddress& from, const std::uint8_t* data, std::size_t size) {
-    if (size < sizeof(PacketHeader)) return;
+    // Parse before touching the connection table so a malformed datagram cannot claim a slot.
+    auto packet = std::make_unique<Packet>();
+    if (!packet->deserialize(data, size)) {
+        droppedDatagrams.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
     
     // Find or create connection
     std::string addrKey = from.host + ":" + std::to_string(from.port);
@@ -684,9 +1172,6 @@ void NetworkServer::processIncomingPacket(const NetworkAddress& from, const std:
     
     if (clientId == InvalidClientId) return;
     
-    // Create packet from data
-    auto packet = std::make_unique<Packet>(data, size);
-    
     // Queue event
     std::lock_guard<std::mutex> lock(eventMutex);
     NetworkEvent event;
@@ -726,8 +1211,7 @@ bool NetworkClient::connect(const std::string& host, std::uint16_t port) {
     
     // Send connection request
     Packet packet(PacketTypes::ConnectionRequest);
-    auto data = packet.serialize();
-    socket->sendTo(serverAddress, data.data(), data.size());
+    sendPacket(*socket, serverAddress, packet, maxPacketBytes);
     
     connectionState = ConnectionState::Connecting;
     running = true;
@@ -741,8 +1225,7 @@ void NetworkClient::disconnect() {
     
     // Send disconnect packet
     Packet packet(PacketTypes::Disconnect);
-    auto data = packet.serialize();
-    socket->sendTo(serverAddress, data.data(), data.size());
+    sendPacket(*socket, serverAddress, packet, maxPacketBytes);
     
     running = false;
     connectionState = ConnectionState::Disconnected;
@@ -756,8 +1239,7 @@ void NetworkClient::send(const Packet& packet, PacketReliability reliability) {
     (void)reliability;
     if (!running) return;
     
-    auto data = packet.serialize();
-    socket->sendTo(serverAddress, data.data(), data.size());
+    sendPacket(*socket, serverAddress, packet, maxPacketBytes);
 }
 
 bool NetworkClient::pollEvent(NetworkEvent& event) {
@@ -804,14 +1286,11 @@ void NetworkClient::update() {
 
 void NetworkClient::sendPing() {
     Packet packet(PacketTypes::Ping);
-    auto data = packet.serialize();
-    socket->sendTo(serverAddress, data.data(), data.size());
+    sendPacket(*socket, serverAddress, packet, maxPacketBytes);
     lastPingTime = std::chrono::steady_clock::now();
 }
 
-void NetworkClient::processIncomingPacket(const std::uint8_t* data, std::size_t size) {
-    Packet packet(data, size);
-    
+void NetworkClient::processIncomingPacket(const Packet& packet) {
     switch (packet.type()) {
         case PacketTypes::ConnectionAccept:
             connectionState = ConnectionState::Connected;
@@ -836,23 +1315,29 @@ void NetworkClient::processIncomingPacket(const std::uint8_t* data, std::size_t
 }
 
 void NetworkClient::networkThread() {
-    std::vector<std::uint8_t> buffer(65536);
+    Profiler::instance().setThreadName("Network Client");
+    DatagramBatch batch(DatagramBatch::DefaultCapacity, maxPacketBytes);
     
     while (running) {
-        NetworkAddress fromAddr;
-        int received = socket->receiveFrom(fromAddr, buffer.data(), buffer.size());
+        if (!socket->waitReadable(NetworkPollTimeoutMs)) continue;
         
-        if (received > 0) {
-            processIncomingPacket(buffer.data(), static_cast<std::size_t>(received));
-            
-            std::lock_guard<std::mutex> lock(eventMutex);
-            NetworkEvent event;
-            event.type = NetworkEvent::Type::DataReceived;
-            event.packet = std::make_unique<Packet>(buffer.data(), static_cast<std::size_t>(received));
-            eventQueue.push_back(std::move(event));
+        while (running && socket->receiveBatch(batch) > 0) {
+            PROFILE_SCOPE("NetworkClient.ProcessBatch");
+            for (std::size_t i = 0; i < batch.size(); ++i) {
+                auto packet = std::make_unique<Packet>();
+                if (!packet->deserialize(batch[i].data, batch[i].size)) {
+                    droppedDatagrams.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                processIncomingPacket(*packet);
+                
+                std::lock_guard<std::mutex> lock(eventMutex);
+                NetworkEvent event;
+                event.type = NetworkEvent::Type::DataReceived;
+                event.packet = std::move(packet);
+                eventQueue.push_back(std::move(event));
+            }
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 }
 
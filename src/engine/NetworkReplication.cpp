@@ -0,0 +1,611 @@
+#include "engine/Network.hpp"
+
+#include "engine/GameEngine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace vkengine {
+
+namespace {
+
+// Client-side snapshots kept as possible baselines; twice the server's window so any baseline the
+// server may still pick is available.
+constexpr std::size_t kAppliedSnapshotWindow = 2 * NetworkSyncSystem::SnapshotWindow;
+
+std::int32_t quantizeField(float value, float resolution) {
+    return static_cast<std::int32_t>(std::lround(value / resolution));
+}
+
+// Worst case of the fields every delta carries: the baseline sequence and the changed and
+// removed counts, each a varuint of at most 32 bits.
+constexpr std::size_t kDeltaOverheadBits = 3 * 8 * 5;
+
+std::uint32_t varUIntBytes(std::uint64_t value) {
+    std::uint32_t bytes = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++bytes;
+    }
+    return bytes;
+}
+
+std::uint32_t varIntBytes(std::int64_t value) {
+    return varUIntBytes((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+glm::ivec3 cellOf(const glm::vec3& position, float cellSize) {
+    return glm::ivec3(glm::floor(position / cellSize));
+}
+
+// 21 bits per axis; cells further than 2^20 from the origin alias, which only costs extra
+// distance checks.
+std::uint64_t cellKey(const glm::ivec3& cell) {
+    constexpr std::uint64_t mask = (1u << 21) - 1;
+    return ((static_cast<std::uint64_t>(cell.x) & mask) << 42) | ((static_cast<std::uint64_t>(cell.y) & mask) << 21) |
+           (static_cast<std::uint64_t>(cell.z) & mask);
+}
+
+template<std::size_t N>
+glm::vec3 positionOf(const std::array<std::int32_t, N>& fields) {
+    return glm::vec3(static_cast<float>(fields[0]), static_cast<float>(fields[1]), static_cast<float>(fields[2])) *
+           NetworkSyncSystem::PositionResolution;
+}
+
+// Upper bound on an encoded entity: the id gap (never larger than the id), the dirty mask and the
+// varint of every dirty field.
+template<std::size_t N>
+std::uint32_t estimateEntityBits(std::uint32_t networkId, const std::array<std::int32_t, N>& current,
+                                 const std::array<std::int32_t, N>* baseline) {
+    std::uint32_t bits = 8 * varUIntBytes(networkId) + static_cast<std::uint32_t>(N);
+    for (std::size_t field = 0; field < N; ++field) {
+        const std::int64_t reference = baseline ? (*baseline)[field] : 0;
+        if (current[field] != reference) bits += 8 * varIntBytes(current[field] - reference);
+    }
+    return bits;
+}
+
+} // namespace
+
+// ============================================================================
+// NetworkSyncSystem Implementation
+// ============================================================================
+
+NetworkSyncSystem::NetworkSyncSystem() = default;
+
+void NetworkSyncSystem::setServer(NetworkServer* networkServer) {
+    server = networkServer;
+}
+
+void NetworkSyncSystem::setClient(NetworkClient* networkClient) {
+    client = networkClient;
+}
+
+std::uint32_t NetworkSyncSystem::registerEntity(GameObject& object, NetworkAuthority authority) {
+    auto existing = objectToNetworkId.find(&object);
+    if (existing != objectToNetworkId.end()) {
+        return existing->second;
+    }
+
+    const std::uint32_t networkId = nextNetworkId++;
+    networkIdToObject[networkId] = &object;
+    objectToNetworkId[&object] = networkId;
+    NetworkIdentity& id = identities[networkId];
+    id.networkId = networkId;
+    id.authority = authority;
+    return networkId;
+}
+
+void NetworkSyncSystem::unregisterEntity(std::uint32_t networkId) {
+    auto it = networkIdToObject.find(networkId);
+    if (it == networkIdToObject.end()) return;
+    objectToNetworkId.erase(it->second);
+    networkIdToObject.erase(it);
+    identities.erase(networkId);
+}
+
+void NetworkSyncSystem::unregisterEntity(GameObject& object) {
+    auto it = objectToNetworkId.find(&object);
+    if (it != objectToNetworkId.end()) {
+        unregisterEntity(it->second);
+    }
+}
+
+void NetworkSyncSystem::update(Scene& scene, float /*deltaSeconds*/) {
+    if (server == nullptr) return;
+    createDeltas(scene, server->connectedClients(), [this](ClientId clientId, const Packet& packet) {
+        server->send(clientId, packet, PacketReliability::Unreliable);
+    });
+}
+
+bool NetworkSyncSystem::processPacket(Scene& scene, ClientId sender, const Packet& packet) {
+    switch (packet.type()) {
+        case PacketTypes::StateSnapshot:
+        case PacketTypes::StateDelta:
+            if (applyDelta(scene, packet) && client != nullptr) {
+                client->send(createAck(), PacketReliability::Unreliable);
+            }
+            return true;
+        case PacketTypes::SnapshotAck: {
+            Packet reader = packet;
+            reader.resetRead();
+            acknowledgeSnapshot(sender, static_cast<SequenceNumber>(reader.readVarUInt()));
+            return true;
+        }
+        case PacketTypes::OwnershipRequest: {
+            Packet reader = packet;
+            reader.resetRead();
+            const std::uint32_t networkId = static_cast<std::uint32_t>(reader.readVarUInt());
+            auto it = identities.find(networkId);
+            if (it != identities.end() && it->second.authority != NetworkAuthority::Server) {
+                setOwner(networkId, sender);
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void NetworkSyncSystem::captureState(std::vector<EntityState>& out) const {
+    out.clear();
+    out.reserve(networkIdToObject.size());
+    for (const auto& [networkId, object] : networkIdToObject) {
+        const Transform& transform = object->transform();
+        EntityState state;
+        state.networkId = networkId;
+        for (int axis = 0; axis < 3; ++axis) {
+            state.fields[axis] = quantizeField(transform.position[axis], PositionResolution);
+            state.fields[3 + axis] = quantizeField(transform.rotation[axis], RotationResolution);
+            state.fields[6 + axis] = quantizeField(transform.scale[axis], ScaleResolution);
+        }
+        out.push_back(state);
+    }
+    std::sort(out.begin(), out.end(), [](const EntityState& a, const EntityState& b) { return a.networkId < b.networkId; });
+}
+
+// Layout after the header (whose sequence is the snapshot's): varuint baseline sequence (0 for
+// none), varuint number of changed entities, then per entity a varuint id gap, a 9-bit dirty mask
+// and a zigzag varint delta for every dirty field; finally the removed entities as id gaps. New
+// entities are encoded against an all-zero state.
+void NetworkSyncSystem::encodeDelta(const std::vector<EntityState>& current, const SnapshotRecord* baseline,
+                                    SequenceNumber sequence, Packet& packet) {
+    static const std::vector<EntityState> empty;
+    const std::vector<EntityState>& previous = baseline ? baseline->entities : empty;
+
+    packet.setSequence(sequence);
+    packet.writeVarUInt(baseline ? baseline->sequence : 0);
+
+    std::size_t changed = 0;
+    for (std::size_t i = 0, j = 0; i < current.size(); ++i) {
+        while (j < previous.size() && previous[j].networkId < current[i].networkId) ++j;
+        if (j == previous.size() || previous[j].networkId != current[i].networkId ||
+            previous[j].fields != current[i].fields) {
+            ++changed;
+        }
+    }
+    packet.writeVarUInt(changed);
+
+    std::uint32_t lastId = 0;
+    for (std::size_t i = 0, j = 0; i < current.size(); ++i) {
+        while (j < previous.size() && previous[j].networkId < current[i].networkId) ++j;
+        const bool known = j < previous.size() && previous[j].networkId == current[i].networkId;
+        std::array<std::int32_t, FieldCount> reference{};
+        if (known) {
+            if (previous[j].fields == current[i].fields) continue;
+            reference = previous[j].fields;
+        }
+
+        std::uint32_t dirtyBits = 0;
+        for (std::size_t field = 0; field < FieldCount; ++field) {
+            if (current[i].fields[field] != reference[field]) dirtyBits |= 1u << field;
+        }
+        packet.writeVarUInt(current[i].networkId - lastId);
+        lastId = current[i].networkId;
+        packet.writeBits(dirtyBits, FieldCount);
+        for (std::size_t field = 0; field < FieldCount; ++field) {
+            if (dirtyBits & (1u << field)) {
+                packet.writeVarInt(static_cast<std::int64_t>(current[i].fields[field]) - reference[field]);
+            }
+        }
+    }
+
+    std::size_t removed = 0;
+    for (std::size_t i = 0, j = 0; j < previous.size(); ++j) {
+        while (i < current.size() && current[i].networkId < previous[j].networkId) ++i;
+        if (i == current.size() || current[i].networkId != previous[j].networkId) ++removed;
+    }
+    packet.writeVarUInt(removed);
+    lastId = 0;
+    for (std::size_t i = 0, j = 0; j < previous.size(); ++j) {
+        while (i < current.size() && current[i].networkId < previous[j].networkId) ++i;
+        if (i == current.size() || current[i].networkId != previous[j].networkId) {
+            packet.writeVarUInt(previous[j].networkId - lastId);
+            lastId = previous[j].networkId;
+        }
+    }
+}
+
+Packet NetworkSyncSystem::createSnapshot(const Scene& /*scene*/) const {
+    std::vector<EntityState> current;
+    captureState(current);
+    Packet packet(PacketTypes::StateSnapshot);
+    encodeDelta(current, nullptr, 0, packet);
+    return packet;
+}
+
+void NetworkSyncSystem::applySnapshot(Scene& scene, const Packet& snapshot) {
+    applyDelta(scene, snapshot);
+}
+
+Packet NetworkSyncSystem::createDelta(const Scene& /*scene*/, ClientId clientId) {
+    prepareTick();
+    Packet packet(PacketTypes::StateDelta);
+    encodeClientDelta(clientId, packet);
+    return packet;
+}
+
+void NetworkSyncSystem::createDeltas(const Scene& /*scene*/, const std::vector<ClientId>& clients,
+                                     const std::function<void(ClientId, const Packet&)>& send) {
+    if (clients.empty()) return;
+    prepareTick();
+    Packet packet;
+    for (ClientId clientId : clients) {
+        packet.reset();
+        packet.setType(PacketTypes::StateDelta);
+        encodeClientDelta(clientId, packet);
+        send(clientId, packet);
+    }
+}
+
+void NetworkSyncSystem::prepareTick() {
+    captureState(captureScratch);
+    interestGridValid = false;
+}
+
+void NetworkSyncSystem::buildInterestGrid() {
+    interestGrid.clear();
+    interestGrid.reserve(captureScratch.size());
+    for (std::size_t i = 0; i < captureScratch.size(); ++i) {
+        interestGrid.emplace_back(cellKey(cellOf(positionOf(captureScratch[i].fields), interestCellSize)),
+                                  static_cast<std::uint32_t>(i));
+    }
+    std::sort(interestGrid.begin(), interestGrid.end());
+    interestGridValid = true;
+}
+
+void NetworkSyncSystem::gatherRelevant(const ClientBaseline& state, std::vector<std::uint32_t>& out) {
+    out.clear();
+    if (!state.hasView) {
+        out.resize(captureScratch.size());
+        for (std::size_t i = 0; i < out.size(); ++i) out[i] = static_cast<std::uint32_t>(i);
+        return;
+    }
+    if (!interestGridValid) buildInterestGrid();
+
+    const glm::ivec3 low = cellOf(state.viewPosition - glm::vec3(state.viewRadius), interestCellSize);
+    const glm::ivec3 high = cellOf(state.viewPosition + glm::vec3(state.viewRadius), interestCellSize);
+    const float radiusSquared = state.viewRadius * state.viewRadius;
+    for (int x = low.x; x <= high.x; ++x) {
+        for (int y = low.y; y <= high.y; ++y) {
+            for (int z = low.z; z <= high.z; ++z) {
+                const std::uint64_t key = cellKey(glm::ivec3(x, y, z));
+                auto it = std::lower_bound(interestGrid.begin(), interestGrid.end(), std::make_pair(key, std::uint32_t{0}));
+                for (; it != interestGrid.end() && it->first == key; ++it) {
+                    const glm::vec3 offset = positionOf(captureScratch[it->second].fields) - state.viewPosition;
+                    if (glm::dot(offset, offset) <= radiusSquared) out.push_back(it->second);
+                }
+            }
+        }
+    }
+    std::sort(out.begin(), out.end());
+}
+
+void NetworkSyncSystem::encodeClientDelta(ClientId clientId, Packet& packet) {
+    ClientBaseline& state = clientBaselines[clientId];
+
+    // A baseline the client may have evicted is not used; fall back to a full snapshot.
+    const SnapshotRecord* baseline = nullptr;
+    if (state.hasAck && state.nextSequence - state.acked.sequence <= SnapshotWindow) {
+        baseline = &state.acked;
+    }
+    static const std::vector<EntityState> empty;
+    const std::vector<EntityState>& previous = baseline ? baseline->entities : empty;
+    const auto findPrevious = [&](std::size_t& cursor, std::uint32_t networkId) -> const EntityState* {
+        while (cursor < previous.size() && previous[cursor].networkId < networkId) ++cursor;
+        return cursor < previous.size() && previous[cursor].networkId == networkId ? &previous[cursor] : nullptr;
+    };
+
+    gatherRelevant(state, relevantScratch);
+    if (state.priority.size() < nextNetworkId) state.priority.resize(nextNetworkId, 0.0f);
+
+    // Relevant entities that differ from the baseline become candidates and gain priority.
+    candidateScratch.clear();
+    std::size_t totalBits = 0;
+    std::size_t cursor = 0;
+    for (const std::uint32_t index : relevantScratch) {
+        const EntityState& current = captureScratch[index];
+        const EntityState* known = findPrevious(cursor, current.networkId);
+        if (known && known->fields == current.fields) continue;
+
+        float weight = 1.0f;
+        if (state.hasView) {
+            const float distance = glm::length(positionOf(current.fields) - state.viewPosition);
+            weight = state.viewRadius / (state.viewRadius + distance);
+        }
+        state.priority[current.networkId] += weight;
+        const std::uint32_t bits = estimateEntityBits(current.networkId, current.fields, known ? &known->fields : nullptr);
+        candidateScratch.push_back(Candidate{index, bits, true});
+        totalBits += bits;
+    }
+
+    // Every delta fits the budget, which never exceeds one datagram. Removals are charged first,
+    // in id order; baseline entities whose removal does not fit stay on the client until a later
+    // tick.
+    const std::size_t budgetBits = 8 * payloadBudget();
+    std::size_t remainingBits = budgetBits > kDeltaOverheadBits ? budgetBits - kDeltaOverheadBits : 0;
+    std::size_t removalsAllowed = 0;
+    for (std::size_t i = 0, r = 0; i < previous.size(); ++i) {
+        while (r < relevantScratch.size() && captureScratch[relevantScratch[r]].networkId < previous[i].networkId) ++r;
+        if (r < relevantScratch.size() && captureScratch[relevantScratch[r]].networkId == previous[i].networkId) continue;
+        const std::size_t bits = 8 * varUIntBytes(previous[i].networkId);
+        if (bits > remainingBits) break;
+        remainingBits -= bits;
+        ++removalsAllowed;
+    }
+
+    // Over budget: the highest priorities that still fit are sent, the rest wait.
+    if (totalBits > remainingBits) {
+        orderScratch.resize(candidateScratch.size());
+        for (std::size_t i = 0; i < orderScratch.size(); ++i) orderScratch[i] = static_cast<std::uint32_t>(i);
+        std::sort(orderScratch.begin(), orderScratch.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return state.priority[captureScratch[candidateScratch[a].index].networkId] >
+                   state.priority[captureScratch[candidateScratch[b].index].networkId];
+        });
+        for (const std::uint32_t i : orderScratch) {
+            Candidate& candidate = candidateScratch[i];
+            candidate.selected = candidate.bits <= remainingBits;
+            if (candidate.selected) remainingBits -= candidate.bits;
+        }
+    }
+
+    // The snapshot the client will hold: the baseline, plus the selected changes, minus the
+    // removals that fit.
+    targetScratch.clear();
+    cursor = 0;
+    std::size_t next = 0;
+    const auto keepUnlessRemoved = [&](const EntityState& stale) {
+        if (removalsAllowed > 0) {
+            --removalsAllowed;
+        } else {
+            targetScratch.push_back(stale);
+        }
+    };
+    for (const std::uint32_t index : relevantScratch) {
+        const EntityState& current = captureScratch[index];
+        while (cursor < previous.size() && previous[cursor].networkId < current.networkId) {
+            keepUnlessRemoved(previous[cursor++]);
+        }
+        const EntityState* known = findPrevious(cursor, current.networkId);
+        if (known) ++cursor;
+        if (next < candidateScratch.size() && candidateScratch[next].index == index) {
+            if (candidateScratch[next++].selected) {
+                state.priority[current.networkId] = 0.0f;
+                targetScratch.push_back(current);
+            } else if (known) {
+                targetScratch.push_back(*known);
+            }
+        } else {
+            targetScratch.push_back(*known);
+        }
+    }
+    while (cursor < previous.size()) {
+        keepUnlessRemoved(previous[cursor++]);
+    }
+
+    const SequenceNumber sequence = state.nextSequence++;
+    encodeDelta(targetScratch, baseline, sequence, packet);
+
+    if (state.sent.size() == SnapshotWindow) {
+        SnapshotRecord recycled = std::move(state.sent.front());
+        state.sent.pop_front();
+        recycled.sequence = sequence;
+        recycled.entities.assign(targetScratch.begin(), targetScratch.end());
+        state.sent.push_back(std::move(recycled));
+    } else {
+        state.sent.push_back(SnapshotRecord{sequence, targetScratch});
+    }
+}
+
+std::size_t NetworkSyncSystem::payloadBudget() const {
+    const std::size_t packetLimit = (server ? server->maxPacketSize() : DefaultMaxPacketSize) - Packet::HeaderSize;
+    return bandwidthBudget == 0 ? packetLimit : std::min(bandwidthBudget, packetLimit);
+}
+
+void NetworkSyncSystem::setClientView(ClientId clientId, const glm::vec3& position, float radius) {
+    ClientBaseline& state = clientBaselines[clientId];
+    state.hasView = true;
+    state.viewPosition = position;
+    state.viewRadius = radius;
+}
+
+void NetworkSyncSystem::clearClientView(ClientId clientId) {
+    auto it = clientBaselines.find(clientId);
+    if (it != clientBaselines.end()) {
+        it->second.hasView = false;
+    }
+}
+
+void NetworkSyncSystem::acknowledgeSnapshot(ClientId clientId, SequenceNumber sequence) {
+    auto it = clientBaselines.find(clientId);
+    if (it == clientBaselines.end()) return;
+    ClientBaseline& state = it->second;
+    if (state.hasAck && sequence <= state.acked.sequence) return;  // Stale or duplicate ack.
+
+    while (!state.sent.empty() && state.sent.front().sequence < sequence) {
+        state.sent.pop_front();
+    }
+    if (state.sent.empty() || state.sent.front().sequence != sequence) return;
+    state.acked = std::move(state.sent.front());
+    state.sent.pop_front();
+    state.hasAck = true;
+}
+
+SequenceNumber NetworkSyncSystem::acknowledgedSnapshot(ClientId clientId) const {
+    auto it = clientBaselines.find(clientId);
+    return it != clientBaselines.end() && it->second.hasAck ? it->second.acked.sequence : 0;
+}
+
+void NetworkSyncSystem::removeClient(ClientId clientId) {
+    clientBaselines.erase(clientId);
+}
+
+bool NetworkSyncSystem::applyDelta(Scene& scene, const Packet& delta) {
+    Packet reader = delta;
+    reader.resetRead();
+    const SequenceNumber sequence = reader.sequence();
+    const SequenceNumber baselineSequence = static_cast<SequenceNumber>(reader.readVarUInt());
+
+    if (sequence != 0 && !appliedSnapshots.empty() && sequence <= appliedSnapshots.back().sequence) {
+        return false;  // Older than what is already applied.
+    }
+    const SnapshotRecord* baseline = nullptr;
+    if (baselineSequence != 0) {
+        auto it = std::find_if(appliedSnapshots.begin(), appliedSnapshots.end(),
+                               [&](const SnapshotRecord& record) { return record.sequence == baselineSequence; });
+        if (it == appliedSnapshots.end()) return false;
+        baseline = &*it;
+    }
+
+    // Rebuild the full state: baseline entities, overwritten by the changed ones, minus removals.
+    SnapshotRecord record;
+    record.sequence = sequence;
+    if (baseline) record.entities = baseline->entities;
+
+    const std::uint64_t changed = reader.readVarUInt();
+    std::uint32_t networkId = 0;
+    for (std::uint64_t n = 0; n < changed && !reader.readOverflowed(); ++n) {
+        networkId += static_cast<std::uint32_t>(reader.readVarUInt());
+        auto it = std::lower_bound(record.entities.begin(), record.entities.end(), networkId,
+                                   [](const EntityState& state, std::uint32_t id) { return state.networkId < id; });
+        if (it == record.entities.end() || it->networkId != networkId) {
+            it = record.entities.insert(it, EntityState{networkId, {}});
+        }
+        const std::uint32_t dirtyBits = reader.readBits(FieldCount);
+        for (std::size_t field = 0; field < FieldCount; ++field) {
+            if (dirtyBits & (1u << field)) {
+                it->fields[field] = static_cast<std::int32_t>(it->fields[field] + reader.readVarInt());
+            }
+        }
+    }
+
+    const std::uint64_t removed = reader.readVarUInt();
+    networkId = 0;
+    removedScratch.clear();
+    for (std::uint64_t n = 0; n < removed && !reader.readOverflowed(); ++n) {
+        networkId += static_cast<std::uint32_t>(reader.readVarUInt());
+        auto it = std::lower_bound(record.entities.begin(), record.entities.end(), networkId,
+                                   [](const EntityState& state, std::uint32_t id) { return state.networkId < id; });
+        if (it != record.entities.end() && it->networkId == networkId) {
+            record.entities.erase(it);
+            removedScratch.push_back(networkId);
+        }
+    }
+    // Nothing is touched until the whole packet has parsed.
+    if (reader.readOverflowed()) return false;
+
+    // A full snapshot (baseline 0) carries no removal list: the server sends one when the client's
+    // baseline aged out, and whatever was destroyed or left interest meanwhile is simply absent.
+    // Replicas of the newest applied state that it does not list are removed like explicit ones.
+    if (baselineSequence == 0 && !appliedSnapshots.empty()) {
+        const std::vector<EntityState>& previous = appliedSnapshots.back().entities;
+        for (std::size_t i = 0, j = 0; j < previous.size(); ++j) {
+            while (i < record.entities.size() && record.entities[i].networkId < previous[j].networkId) ++i;
+            if (i == record.entities.size() || record.entities[i].networkId != previous[j].networkId) {
+                removedScratch.push_back(previous[j].networkId);
+            }
+        }
+    }
+
+    for (const std::uint32_t removedId : removedScratch) {
+        // Hidden and kept aside so the replica is reused if the entity comes back into interest.
+        if (GameObject* object = getObject(removedId)) {
+            object->render().visible = false;
+            dormantObjects[removedId] = object;
+        }
+        unregisterEntity(removedId);
+    }
+    applyRecord(scene, record);
+    if (sequence != 0) {
+        appliedSnapshots.push_back(std::move(record));
+        while (appliedSnapshots.size() > kAppliedSnapshotWindow) {
+            appliedSnapshots.pop_front();
+        }
+    }
+    return true;
+}
+
+void NetworkSyncSystem::applyRecord(Scene& scene, const SnapshotRecord& record) {
+    for (const EntityState& state : record.entities) {
+        GameObject* object = getObject(state.networkId);
+        if (object == nullptr) {
+            // First sight of a replicated entity: give it a local object under the server's id.
+            auto dormant = dormantObjects.find(state.networkId);
+            if (dormant != dormantObjects.end()) {
+                object = dormant->second;
+                object->render().visible = true;
+                dormantObjects.erase(dormant);
+            } else {
+                object = &scene.createObject("Network_" + std::to_string(state.networkId), MeshType::Cube);
+            }
+            networkIdToObject[state.networkId] = object;
+            objectToNetworkId[object] = state.networkId;
+            identities[state.networkId].networkId = state.networkId;
+            nextNetworkId = std::max(nextNetworkId, state.networkId + 1);
+        }
+        Transform& transform = object->transform();
+        for (int axis = 0; axis < 3; ++axis) {
+            transform.position[axis] = static_cast<float>(state.fields[axis]) * PositionResolution;
+            transform.rotation[axis] = static_cast<float>(state.fields[3 + axis]) * RotationResolution;
+            transform.scale[axis] = static_cast<float>(state.fields[6 + axis]) * ScaleResolution;
+        }
+    }
+}
+
+Packet NetworkSyncSystem::createAck() const {
+    Packet packet(PacketTypes::SnapshotAck);
+    packet.writeVarUInt(lastAppliedSnapshot());
+    return packet;
+}
+
+void NetworkSyncSystem::setOwner(std::uint32_t networkId, ClientId owner) {
+    auto it = identities.find(networkId);
+    if (it != identities.end()) {
+        it->second.owner = owner;
+    }
+}
+
+void NetworkSyncSystem::requestOwnership(std::uint32_t networkId) {
+    if (client == nullptr) return;
+    Packet packet(PacketTypes::OwnershipRequest);
+    packet.writeVarUInt(networkId);
+    client->send(packet);
+}
+
+const NetworkIdentity* NetworkSyncSystem::identity(std::uint32_t networkId) const {
+    auto it = identities.find(networkId);
+    return it != identities.end() ? &it->second : nullptr;
+}
+
+GameObject* NetworkSyncSystem::getObject(std::uint32_t networkId) {
+    auto it = networkIdToObject.find(networkId);
+    return it != networkIdToObject.end() ? it->second : nullptr;
+}
+
+std::uint32_t NetworkSyncSystem::getNetworkId(const GameObject& object) const {
+    auto it = objectToNetworkId.find(&object);
+    return it != objectToNetworkId.end() ? it->second : 0;
+}
+
+} // namespace vkengine
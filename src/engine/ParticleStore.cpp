@@ -0,0 +1,181 @@
+#include "engine/ParticleStore.hpp"
+
+#include "core/SimdLanes.hpp"
+
+#include <algorithm>
+
+namespace vkengine {
+
+namespace {
+
+// Runs kernel(lanes, begin) from the widest lane type down to scalar; each call returns the first
+// index it did not reach, so the narrower types only see the remainder.
+template<typename Kernel>
+void runWidestFirst(Kernel&& kernel)
+{
+    std::size_t next = 0;
+#if defined(VKENGINE_SIMD_AVX2)
+    next = kernel(core::simd::AvxLanes{}, next);
+#endif
+#if defined(VKENGINE_SIMD_SSE2)
+    next = kernel(core::simd::SseLanes{}, next);
+#endif
+    kernel(core::simd::ScalarLanes{}, next);
+}
+
+} // namespace
+
+// Kernels over particles [begin, size()) kWidth at a time; each returns the first index it did not
+// reach.
+template<typename L>
+struct ParticleKernel {
+    using F = typename L::Float;
+
+    static std::size_t integrate(ParticleStore& s, const float* accelX, const float* accelY, const float* accelZ,
+                                 float damping, float deltaSeconds, std::size_t begin)
+    {
+        const F dt = L::set1(deltaSeconds);
+        const F damp = L::set1(damping);
+        const auto axis = [&](std::vector<float>& position, std::vector<float>& velocity, const float* acceleration, std::size_t i) {
+            const F v = L::mul(L::add(L::load(velocity.data() + i), L::mul(L::load(acceleration + i), dt)), damp);
+            L::store(velocity.data() + i, v);
+            L::store(position.data() + i, L::add(L::load(position.data() + i), L::mul(v, dt)));
+        };
+
+        std::size_t i = begin;
+        for (; i + L::kWidth <= s.count; i += L::kWidth) {
+            axis(s.posX, s.velX, accelX, i);
+            axis(s.posY, s.velY, accelY, i);
+            axis(s.posZ, s.velZ, accelZ, i);
+        }
+        return i;
+    }
+
+    static std::size_t age(ParticleStore& s, float deltaSeconds, std::size_t begin)
+    {
+        const F dt = L::set1(deltaSeconds);
+        std::size_t i = begin;
+        for (; i + L::kWidth <= s.count; i += L::kWidth) {
+            L::store(s.ageValues.data() + i, L::add(L::load(s.ageValues.data() + i), dt));
+        }
+        return i;
+    }
+
+    static std::size_t colors(ParticleStore& s, const glm::vec4& start, const glm::vec4& end, std::size_t begin)
+    {
+        const F zero = L::set1(0.0f);
+        const F one = L::set1(1.0f);
+        const F startR = L::set1(start.x), deltaR = L::set1(end.x - start.x);
+        const F startG = L::set1(start.y), deltaG = L::set1(end.y - start.y);
+        const F startB = L::set1(start.z), deltaB = L::set1(end.z - start.z);
+        const F startA = L::set1(start.w), deltaA = L::set1(end.w - start.w);
+
+        std::size_t i = begin;
+        for (; i + L::kWidth <= s.count; i += L::kWidth) {
+            const F lifetime = L::load(s.lifetimeValues.data() + i);
+            const auto positive = L::greater(lifetime, zero);
+            const F ratio = L::div(L::load(s.ageValues.data() + i), L::select(positive, lifetime, one));
+            const F t = L::select(positive, L::min(one, L::max(zero, ratio)), one);
+            L::store(s.normalizedAgeValues.data() + i, t);
+            L::store(s.colorR.data() + i, L::add(startR, L::mul(deltaR, t)));
+            L::store(s.colorG.data() + i, L::add(startG, L::mul(deltaG, t)));
+            L::store(s.colorB.data() + i, L::add(startB, L::mul(deltaB, t)));
+            L::store(s.colorA.data() + i, L::add(startA, L::mul(deltaA, t)));
+        }
+        return i;
+    }
+};
+
+void ParticleStore::setCapacity(std::size_t newCapacity)
+{
+    maxCount = newCapacity;
+    count = std::min(count, maxCount);
+    for (auto* array : {&posX, &posY, &posZ, &velX, &velY, &velZ, &ageValues, &lifetimeValues, &scaleValues, &massValues,
+                        &normalizedAgeValues, &colorR, &colorG, &colorB, &colorA}) {
+        array->resize(maxCount, 0.0f);
+    }
+}
+
+void ParticleStore::push(const Particle& particle)
+{
+    if (full()) {
+        return;
+    }
+    set(count++, particle);
+    normalizedAgeValues[count - 1] = 0.0f;
+}
+
+void ParticleStore::remove(std::size_t slot)
+{
+    const std::size_t last = count - 1;
+    if (slot != last) {
+        for (auto* array : {&posX, &posY, &posZ, &velX, &velY, &velZ, &ageValues, &lifetimeValues, &scaleValues, &massValues,
+                            &normalizedAgeValues, &colorR, &colorG, &colorB, &colorA}) {
+            (*array)[slot] = (*array)[last];
+        }
+    }
+    count = last;
+}
+
+Particle ParticleStore::get(std::size_t slot) const
+{
+    Particle particle{};
+    particle.position = position(slot);
+    particle.velocity = {velX[slot], velY[slot], velZ[slot]};
+    particle.age = ageValues[slot];
+    particle.lifetime = lifetimeValues[slot];
+    particle.scale = scaleValues[slot];
+    particle.mass = massValues[slot];
+    return particle;
+}
+
+void ParticleStore::set(std::size_t slot, const Particle& particle)
+{
+    posX[slot] = particle.position.x;
+    posY[slot] = particle.position.y;
+    posZ[slot] = particle.position.z;
+    velX[slot] = particle.velocity.x;
+    velY[slot] = particle.velocity.y;
+    velZ[slot] = particle.velocity.z;
+    ageValues[slot] = particle.age;
+    lifetimeValues[slot] = particle.lifetime;
+    scaleValues[slot] = particle.scale;
+    massValues[slot] = particle.mass;
+}
+
+void ParticleStore::integrate(const float* accelX, const float* accelY, const float* accelZ, float damping, float deltaSeconds)
+{
+    runWidestFirst([&](auto lanes, std::size_t begin) {
+        return ParticleKernel<decltype(lanes)>::integrate(*this, accelX, accelY, accelZ, damping, deltaSeconds, begin);
+    });
+}
+
+void ParticleStore::advanceAges(float deltaSeconds)
+{
+    runWidestFirst([&](auto lanes, std::size_t begin) {
+        return ParticleKernel<decltype(lanes)>::age(*this, deltaSeconds, begin);
+    });
+
+    // Slot i is checked again after a removal, since it now holds the former last particle.
+    for (std::size_t i = 0; i < count;) {
+        if (ageValues[i] >= lifetimeValues[i]) {
+            remove(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void ParticleStore::updateColors(const glm::vec4& start, const glm::vec4& end)
+{
+    runWidestFirst([&](auto lanes, std::size_t begin) {
+        return ParticleKernel<decltype(lanes)>::colors(*this, start, end, begin);
+    });
+}
+
+std::size_t ParticleStore::simdWidth() noexcept
+{
+    return core::simd::WidestLanes::kWidth;
+}
+
+} // namespace vkengine
@@ -53,11 +53,8 @@ void ParticleEmitter::setMassRange(float minMassValue, float maxMassValue) noexc
 
 void ParticleEmitter::setMaxParticles(std::size_t maxParticles)
 {
-    particlePool.resize(std::max<std::size_t>(1, maxParticles));
-    accelerationScratch.resize(particlePool.size(), glm::vec3(0.0f));
-    for (auto& particle : particlePool) {
-        particle.age = particle.lifetime = 1.0f;
-    }
+    particlePool.setCapacity(std::max<std::size_t>(1, maxParticles));
+    particlePool.clear();
     needsWarmStart = true;
 }
 
@@ -68,95 +65,117 @@ void ParticleEmitter::update(float deltaSeconds)
         needsWarmStart = false;
     }
 
-    if (particlePool.empty() || deltaSeconds <= 0.0f) {
+    if (particlePool.capacity() == 0 || deltaSeconds <= 0.0f) {
         return;
     }
 
     accumulator += emissionRate * deltaSeconds;
 
-    if (accelerationScratch.size() < particlePool.size()) {
-        accelerationScratch.resize(particlePool.size(), glm::vec3(0.0f));
-    }
-
-    std::vector<std::size_t> aliveIndices;
-    aliveIndices.reserve(particlePool.size());
-    for (std::size_t i = 0; i < particlePool.size(); ++i) {
-        if (particlePool[i].alive()) {
-            aliveIndices.push_back(i);
-        }
-    }
-
-    if (!aliveIndices.empty()) {
+    if (!particlePool.empty()) {
         const std::uint32_t steps = std::max<std::uint32_t>(1, solverSubsteps);
         const float stepDt = deltaSeconds / static_cast<float>(steps);
         const float minMassValue = std::max(1e-4f, minMass);
 
-        auto resetAccelerations = [&]() {
-            for (auto idx : aliveIndices) {
-                accelerationScratch[idx] = glm::vec3(0.0f);
-            }
-        };
-
-        auto accumulateAccelerations = [&]() {
-            resetAccelerations();
-            const float gravitationalConstant = gravityConstant;
-            for (std::size_t a = 0; a < aliveIndices.size(); ++a) {
-                const std::size_t idxA = aliveIndices[a];
-                Particle& particleA = particlePool[idxA];
-                for (std::size_t b = a + 1; b < aliveIndices.size(); ++b) {
-                    const std::size_t idxB = aliveIndices[b];
-                    Particle& particleB = particlePool[idxB];
-                    glm::vec3 offset = particleB.position - particleA.position;
-                    float distSqr = glm::length2(offset) + softening;
-                    float invDist = 1.0f / std::sqrt(distSqr);
-                    float invDist3 = invDist * invDist * invDist;
-                    glm::vec3 direction = offset * invDist3;
-                    float massProduct = gravitationalConstant * particleA.mass * particleB.mass;
-                    glm::vec3 force = direction * massProduct;
-                    accelerationScratch[idxA] += force / std::max(minMassValue, particleA.mass);
-                    accelerationScratch[idxB] -= force / std::max(minMassValue, particleB.mass);
-                }
-            }
-        };
+        const std::size_t aliveCount = particlePool.size();
+        accelerationX.resize(aliveCount);
+        accelerationY.resize(aliveCount);
+        accelerationZ.resize(aliveCount);
+
+        // Without mutual gravity the accelerations stay zero and only the integration runs.
+        const bool gravityEnabled = gravityConstant != 0.0f;
+        if (!gravityEnabled) {
+            std::fill(accelerationX.begin(), accelerationX.end(), 0.0f);
+            std::fill(accelerationY.begin(), accelerationY.end(), 0.0f);
+            std::fill(accelerationZ.begin(), accelerationZ.end(), 0.0f);
+        }
 
         for (std::uint32_t step = 0; step < steps; ++step) {
-            accumulateAccelerations();
-            for (auto idx : aliveIndices) {
-                Particle& particle = particlePool[idx];
-                particle.velocity += accelerationScratch[idx] * stepDt;
-                particle.velocity *= damping;
-                particle.position += particle.velocity * stepDt;
+            if (gravityEnabled && gravitySolver == ParticleGravitySolver::BarnesHut) {
+                accumulateTreeAccelerations(minMassValue);
+            } else if (gravityEnabled) {
+                accumulateDirectAccelerations(minMassValue);
             }
+            particlePool.integrate(accelerationX.data(), accelerationY.data(), accelerationZ.data(), damping, stepDt);
         }
 
-        for (auto idx : aliveIndices) {
-            particlePool[idx].age += deltaSeconds;
-        }
+        particlePool.advanceAges(deltaSeconds);
     }
 
     const std::size_t particlesToSpawn = static_cast<std::size_t>(accumulator);
     accumulator -= static_cast<float>(particlesToSpawn);
 
-    std::size_t spawned = 0;
-    for (auto& particle : particlePool) {
-        if (spawned >= particlesToSpawn) {
-            break;
-        }
-        if (!particle.alive()) {
-            spawnParticle(particle);
-            ++spawned;
+    for (std::size_t spawned = 0; spawned < particlesToSpawn && !particlePool.full(); ++spawned) {
+        particlePool.push(spawnParticle());
+    }
+
+    particlePool.updateColors(startColorValue, endColorValue);
+}
+
+void ParticleEmitter::accumulateDirectAccelerations(float minMassValue)
+{
+    const std::size_t aliveCount = particlePool.size();
+    std::fill(accelerationX.begin(), accelerationX.end(), 0.0f);
+    std::fill(accelerationY.begin(), accelerationY.end(), 0.0f);
+    std::fill(accelerationZ.begin(), accelerationZ.end(), 0.0f);
+
+    const auto posX = particlePool.positionsX();
+    const auto posY = particlePool.positionsY();
+    const auto posZ = particlePool.positionsZ();
+    const auto masses = particlePool.masses();
+    const float gravitationalConstant = gravityConstant;
+    for (std::size_t a = 0; a < aliveCount; ++a) {
+        const glm::vec3 positionA{posX[a], posY[a], posZ[a]};
+        const float massA = masses[a];
+        const float invMassA = 1.0f / std::max(minMassValue, massA);
+        glm::vec3 accelerationA{0.0f};
+        for (std::size_t b = a + 1; b < aliveCount; ++b) {
+            const glm::vec3 offset = glm::vec3{posX[b], posY[b], posZ[b]} - positionA;
+            const float distSqr = glm::length2(offset) + softening;
+            const float invDist = 1.0f / std::sqrt(distSqr);
+            const float invDist3 = invDist * invDist * invDist;
+            const glm::vec3 force = offset * invDist3 * (gravitationalConstant * massA * masses[b]);
+            accelerationA += force * invMassA;
+            const glm::vec3 accelerationB = force / std::max(minMassValue, masses[b]);
+            accelerationX[b] -= accelerationB.x;
+            accelerationY[b] -= accelerationB.y;
+            accelerationZ[b] -= accelerationB.z;
         }
+        accelerationX[a] += accelerationA.x;
+        accelerationY[a] += accelerationA.y;
+        accelerationZ[a] += accelerationA.z;
+    }
+}
+
+void ParticleEmitter::accumulateTreeAccelerations(float minMassValue)
+{
+    const std::size_t aliveCount = particlePool.size();
+    gravityPositions.resize(aliveCount);
+    gravityFields.resize(aliveCount);
+    const auto masses = particlePool.masses();
+    for (std::size_t a = 0; a < aliveCount; ++a) {
+        gravityPositions[a] = particlePool.position(a);
+    }
+    gravityTree.build(gravityPositions.data(), masses.data(), aliveCount);
+    gravityTree.computeFields(gravityConstant, softening, openingAngle, gravityFields.data());
+    // Same mass clamp as the direct sum: a = F / max(minMass, m).
+    for (std::size_t a = 0; a < aliveCount; ++a) {
+        const glm::vec3 acceleration = gravityFields[a] * (masses[a] / std::max(minMassValue, masses[a]));
+        accelerationX[a] = acceleration.x;
+        accelerationY[a] = acceleration.y;
+        accelerationZ[a] = acceleration.z;
     }
 }
 
-void ParticleEmitter::spawnParticle(Particle& particle)
+Particle ParticleEmitter::spawnParticle()
 {
+    Particle particle{};
     particle.position = originPoint;
     particle.velocity = randomDirection() * glm::mix(minSpeed, maxSpeed, uniform(rng));
     particle.age = 0.0f;
     particle.lifetime = glm::mix(minLifetime, maxLifetime, uniform(rng));
     particle.scale = glm::mix(0.1f, 0.3f, uniform(rng));
     particle.mass = glm::mix(minMass, maxMass, uniform(rng));
+    return particle;
 }
 
 glm::vec3 ParticleEmitter::randomDirection()
@@ -187,10 +206,13 @@ glm::vec3 ParticleEmitter::randomDirection()
 
 void ParticleEmitter::warmStartParticles()
 {
-    for (auto& particle : particlePool) {
-        spawnParticle(particle);
+    particlePool.clear();
+    while (!particlePool.full()) {
+        Particle particle = spawnParticle();
         particle.age = particle.lifetime * uniform(rng);
+        particlePool.push(particle);
     }
+    particlePool.updateColors(startColorValue, endColorValue);
 }
 
 ParticleEmitter& ParticleSystem::createEmitter(const std::string& name)
@@ -1,8 +1,12 @@
 #include "engine/PhysicsSystem.hpp"
 
+#include "core/ParallelFor.hpp"
+#include "engine/Broadphase.hpp"
+#include "engine/DebugTools.hpp"
 #include "engine/PhysicsDetail.hpp"
 #include "engine/GameEngine.hpp"
 #include "engine/GpuCollisionSystem.hpp"
+#include "engine/RigidBodyStore.hpp"
 
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -11,8 +15,9 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
-#include <unordered_map>
-#include <unordered_set>
+#include <numeric>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace vkengine {
@@ -95,15 +100,15 @@ glm::vec3 applyInverseInertia(const glm::mat3& inverse, const glm::vec3& value)
 }
 
 glm::vec3 estimateContactPoint(const GameObject& a, const GameObject& b, const glm::vec3& normal, float /*penetration*/)
+{
+    return estimateContactPoint(a.transform().position, a.worldBounds(), b.transform().position, b.worldBounds(), normal);
+}
+
+glm::vec3 estimateContactPoint(const glm::vec3& posA, const AABB& boundsA, const glm::vec3& posB, const AABB& boundsB,
+                               const glm::vec3& normal)
 {
     // Estimate contact point on the surface between the two AABBs
     // The contact point should be on the face of the collision
-    const glm::vec3& posA = a.transform().position;
-    const glm::vec3& posB = b.transform().position;
-    
-    const AABB boundsA = a.worldBounds();
-    const AABB boundsB = b.worldBounds();
-    
     // Find the contact point by projecting centers onto the separating plane
     // The contact point lies on the face of object A that faces the collision normal
     glm::vec3 contactOnA = posA;
@@ -177,42 +182,10 @@ float combineCoefficient(float a, float b)
     return std::sqrt(product);
 }
 
-struct CellCoord {
-    int x{0};
-    int y{0};
-    int z{0};
-
-    bool operator==(const CellCoord& other) const noexcept
-    {
-        return x == other.x && y == other.y && z == other.z;
-    }
-};
-
-struct CellCoordHash {
-    std::size_t operator()(const CellCoord& cell) const noexcept
-    {
-        const std::size_t hx = static_cast<std::size_t>(cell.x) * 73856093u;
-        const std::size_t hy = static_cast<std::size_t>(cell.y) * 19349663u;
-        const std::size_t hz = static_cast<std::size_t>(cell.z) * 83492791u;
-        return hx ^ hy ^ hz;
-    }
-};
-
-CellCoord toCell(const glm::vec3& pos, const glm::vec3& origin, float cellSize)
-{
-    const glm::vec3 rel = (pos - origin) / cellSize;
-    return CellCoord{
-        static_cast<int>(std::floor(rel.x)),
-        static_cast<int>(std::floor(rel.y)),
-        static_cast<int>(std::floor(rel.z))
-    };
-}
-
-uint64_t makePairKey(uint32_t a, uint32_t b)
+bool isFiniteBounds(const AABB& bounds)
 {
-    const uint32_t minId = std::min(a, b);
-    const uint32_t maxId = std::max(a, b);
-    return (static_cast<uint64_t>(minId) << 32u) | static_cast<uint64_t>(maxId);
+    return std::isfinite(bounds.min.x) && std::isfinite(bounds.min.y) && std::isfinite(bounds.min.z) &&
+           std::isfinite(bounds.max.x) && std::isfinite(bounds.max.y) && std::isfinite(bounds.max.z);
 }
 } // namespace physics_detail
 
@@ -220,6 +193,8 @@ using namespace physics_detail;
 
 PhysicsSystem::PhysicsSystem()
     : gpuCollisionSystem(std::make_unique<GpuCollisionSystem>())
+    , broadphase(std::make_unique<Broadphase>())
+    , bodies(std::make_unique<RigidBodyStore>())
 {
 }
 
@@ -233,108 +208,58 @@ void PhysicsSystem::update(Scene& scene, float deltaSeconds)
     if (deltaSeconds <= 0.0f) {
         return;
     }
+    PROFILE_SCOPE("PhysicsSystem.Update");
 
     const auto& objects = scene.objectsCached();
     if (objects.empty()) {
         return;
     }
 
-    float maxSpeed = 0.0f;
-    for (auto* object : objects) {
-        auto& properties = object->physics();
-        if (!properties.simulate || properties.mass <= 0.0f || !std::isfinite(properties.mass)) {
-            properties.lastAcceleration = glm::vec3(0.0f);
-            properties.clearForces();
-            properties.clearTorques();
-            continue;
-        }
+    // Islands and sleep state are only tracked by the CPU solver.
+    const bool gpuCollisions = useGpuCollision && gpuCollisionSystem && gpuCollisionSystem->isEnabled();
+    const bool allowSleeping = sleepingEnabled && !gpuCollisions;
 
-        const glm::vec3 gravityForce = gravity * properties.mass;
-        const glm::vec3 totalForce = gravityForce + properties.accumulatedForces;
-        const glm::vec3 acceleration = totalForce / properties.mass;
-        maxSpeed = std::max(maxSpeed, glm::length(properties.velocity + acceleration * deltaSeconds));
-    }
+    // The ECS is read once here and written back once at the end; every substep in between runs on
+    // the packed body arrays.
+    bodies->gather(objects, allowSleeping);
 
+    const float maxSpeed = bodies->maxPredictedSpeed(gravity, deltaSeconds);
     constexpr float maxDisplacementPerStep = 0.25f;
     const int subSteps = std::clamp(static_cast<int>(std::ceil((maxSpeed * deltaSeconds) / maxDisplacementPerStep)), 1, 16);
     const float subDelta = deltaSeconds / static_cast<float>(subSteps);
 
     for (int step = 0; step < subSteps; ++step) {
-        for (auto* object : objects) {
-            auto& properties = object->physics();
-            if (!properties.simulate || properties.mass <= 0.0f || !std::isfinite(properties.mass)) {
-                properties.lastAcceleration = glm::vec3(0.0f);
-                properties.clearForces();
-                properties.clearTorques();
-                continue;
-            }
-
-            const glm::vec3 gravityForce = gravity * properties.mass;
-            const glm::vec3 totalForce = gravityForce + properties.accumulatedForces;
-            const glm::vec3 acceleration = totalForce / properties.mass;
-
-            properties.velocity += acceleration * subDelta;
-            const float linearDamping = std::clamp(properties.linearDamping, 0.0f, 1.0f);
-            properties.velocity *= std::max(0.0f, 1.0f - linearDamping * subDelta);
-
-            auto& transform = object->transform();
-            transform.position += properties.velocity * subDelta;
-
-            const glm::mat3 inertia = inertiaTensor(*object);
-            const glm::mat3 invInertia = inverseInertiaTensor(*object);
-            const glm::vec3 omega = properties.angularVelocity;
-            const glm::vec3 gyroscopicTorque = glm::cross(omega, inertia * omega);
-            const float angularDamping = std::clamp(properties.angularDamping, 0.0f, 1.0f);
-            const float materialDissipation = std::clamp(properties.dynamicFriction + (1.0f - properties.restitution) * 0.5f, 0.0f, 1.0f);
-            const float dampingCoefficient = std::clamp(angularDamping + materialDissipation, 0.0f, 1.5f);
-            const glm::vec3 dampingTorque = -dampingCoefficient * omega;
-            const glm::vec3 netTorque = properties.accumulatedTorque - gyroscopicTorque + dampingTorque;
-            const glm::vec3 angularAcceleration = invInertia * netTorque;
-
-            properties.angularVelocity += angularAcceleration * subDelta;
-
-            // Clamp angular velocity to prevent instability
-            constexpr float maxAngularSpeed = 15.0f; // Reduced from 20
-            const float angularSpeed = glm::length(properties.angularVelocity);
-            if (angularSpeed > maxAngularSpeed) {
-                properties.angularVelocity *= maxAngularSpeed / angularSpeed;
-            }
-            
-            // Integrate rotation using quaternion to avoid Euler drift
-            if (angularSpeed > 0.0f) {
-                glm::quat orientation = glm::quat(transform.rotation);
-                const glm::vec3 omegaStep = properties.angularVelocity;
-                const glm::quat omegaQuat{0.0f, omegaStep.x, omegaStep.y, omegaStep.z};
-                const glm::quat qDot = 0.5f * omegaQuat * orientation;
-                orientation = glm::normalize(orientation + qDot * subDelta);
-                transform.rotation = glm::eulerAngles(orientation);
-            }
-
-            for (int axis = 0; axis < 3; ++axis) {
-                transform.rotation[axis] = std::fmod(transform.rotation[axis], glm::two_pi<float>());
-                if (transform.rotation[axis] < 0.0f) {
-                    transform.rotation[axis] += glm::two_pi<float>();
-                }
+        if (allowSleeping) {
+            stepStartPositions.resize(bodies->size());
+            for (std::size_t i = 0; i < bodies->size(); ++i) {
+                stepStartPositions[i] = bodies->position(i);
             }
+        }
 
-            properties.lastAcceleration = acceleration;
-            properties.clearForces();
-            properties.clearTorques();
+        {
+            PROFILE_SCOPE("PhysicsSystem.Integrate");
+            bodies->integrate(gravity, subDelta);
         }
 
-        // Use GPU collision detection if enabled and initialized
-        if (useGpuCollision && gpuCollisionSystem && gpuCollisionSystem->isEnabled()) {
+        // Use GPU collision detection if enabled and initialized. It reads the scene objects, so
+        // the body state takes a round trip through the ECS on this path.
+        if (gpuCollisions) {
+            bodies->scatter(objects);
             resolveCollisionsGpu(scene, subDelta);
+            bodies->gather(objects, allowSleeping);
         } else {
             resolveCollisions(scene, subDelta);
         }
     }
+
+    bodies->scatter(objects);
 }
 
 void PhysicsSystem::resolveCollisions(Scene& scene, float deltaSeconds)
 {
+    PROFILE_SCOPE("PhysicsSystem.ResolveCollisions");
     const auto& objects = scene.objectsCached();
-    if (objects.size() < 2) {
+    if (objects.size() < 2 || bodies->size() != objects.size()) {
         return;
     }
 
@@ -342,328 +267,427 @@ void PhysicsSystem::resolveCollisions(Scene& scene, float deltaSeconds)
         return;
     }
 
+    lastIslandCount = 0;
+    lastSleepingCount = 0;
+
     constexpr float penetrationSlop = 0.0005f;
     constexpr float positionCorrectionPercent = 0.95f;
     constexpr float baumgarteFactor = 0.4f;
     constexpr int velocityIterations = 16;
 
-    const auto computeInverseMass = [](const GameObject& object, const Collider* collider) {
-        if (!collider || collider->isStatic) {
-            return 0.0f;
-        }
-        const auto& props = object.physics();
-        if (props.mass <= 0.0f || !std::isfinite(props.mass)) {
-            return 0.0f;
-        }
-        return 1.0f / props.mass;
-    };
+    RigidBodyStore& store = *bodies;
+    const std::vector<float>& inverseMasses = store.contactInverseMass;
 
+    // Sync the persistent broadphase. Bodies still inside their fat bounds cost a containment
+    // test; only the ones that left them are reinserted and re-queried for new pairs.
     std::vector<AABB> bounds(objects.size());
-    glm::vec3 worldMin{std::numeric_limits<float>::max()};
-    glm::vec3 worldMax{std::numeric_limits<float>::lowest()};
-    float maxHalfExtent = 0.0f;
-
-    for (size_t i = 0; i < objects.size(); ++i) {
-        GameObject& object = *objects[i];
-        if (!object.hasCollider()) {
+    std::size_t colliderCount = 0;
+    for (uint32_t i = 0; i < objects.size(); ++i) {
+        if (!store.hasCollider(i)) {
             continue;
         }
-        bounds[i] = object.worldBounds();
-        worldMin = glm::min(worldMin, bounds[i].min);
-        worldMax = glm::max(worldMax, bounds[i].max);
-        const glm::vec3 half = (bounds[i].max - bounds[i].min) * 0.5f;
-        maxHalfExtent = std::max(maxHalfExtent, std::max(half.x, std::max(half.y, half.z)));
+        bounds[i] = store.worldBounds(i);
+        if (!isFiniteBounds(bounds[i])) {
+            continue;
+        }
+        const glm::vec3 displacement = inverseMasses[i] > 0.0f ? store.velocity(i) * deltaSeconds : glm::vec3(0.0f);
+        broadphase->updateBody(store.entities[i], bounds[i], displacement, i);
+        ++colliderCount;
     }
+    broadphase->finishUpdate();
 
-    if (!std::isfinite(worldMin.x) || !std::isfinite(worldMax.x)) {
+    if (colliderCount < 2) {
         return;
     }
 
-    const float cellSize = std::max(0.5f, maxHalfExtent * 2.0f);
-    std::unordered_map<CellCoord, std::vector<uint32_t>, CellCoordHash> grid;
-    grid.reserve(objects.size() * 2);
+    std::vector<Contact> contacts;
+    contacts.reserve(objects.size());
+    std::vector<std::pair<uint32_t, uint32_t>> sleepingLinks;
 
-    for (uint32_t i = 0; i < objects.size(); ++i) {
-        GameObject& object = *objects[i];
-        if (!object.hasCollider()) {
-            continue;
+    broadphase->forEachPair([&](uint32_t i, uint32_t j) {
+        if (i > j) {
+            std::swap(i, j);
         }
-        const AABB& aabb = bounds[i];
-        const CellCoord minCell = toCell(aabb.min, worldMin, cellSize);
-        const CellCoord maxCell = toCell(aabb.max, worldMin, cellSize);
-        for (int z = minCell.z; z <= maxCell.z; ++z) {
-            for (int y = minCell.y; y <= maxCell.y; ++y) {
-                for (int x = minCell.x; x <= maxCell.x; ++x) {
-                    grid[CellCoord{x, y, z}].push_back(i);
-                }
-            }
+        if (!store.hasCollider(i) || !store.hasCollider(j)) {
+            return;
         }
-    }
 
-    std::unordered_set<uint64_t> uniquePairs;
-    uniquePairs.reserve(objects.size() * 4);
+        const float invMassA = inverseMasses[i];
+        const float invMassB = inverseMasses[j];
+        const float invMassSum = invMassA + invMassB;
+        if (invMassSum <= 0.0f) {
+            return;
+        }
 
-    std::vector<Contact> contacts;
-    contacts.reserve(objects.size());
+        // Nothing can move between two sleeping bodies or a sleeping and a static one, so skip the
+        // narrow phase. Sleeping neighbours are still linked so a pile wakes up as a whole.
+        const bool sleepingA = invMassA > 0.0f && store.isSleeping(i);
+        const bool sleepingB = invMassB > 0.0f && store.isSleeping(j);
+        if ((sleepingA || invMassA <= 0.0f) && (sleepingB || invMassB <= 0.0f)) {
+            if (sleepingA && sleepingB) {
+                sleepingLinks.emplace_back(i, j);
+            }
+            return;
+        }
 
-    for (const auto& cell : grid) {
-        const auto& indices = cell.second;
-        if (indices.size() < 2) {
-            continue;
+        CollisionResult result;
+        if (!computePenetration(bounds[i], bounds[j], result)) {
+            return;
         }
-        for (size_t idxA = 0; idxA < indices.size(); ++idxA) {
-            for (size_t idxB = idxA + 1; idxB < indices.size(); ++idxB) {
-                const uint32_t i = indices[idxA];
-                const uint32_t j = indices[idxB];
-                const uint64_t key = makePairKey(i, j);
-                if (!uniquePairs.insert(key).second) {
-                    continue;
-                }
 
-                GameObject& a = *objects[i];
-                GameObject& b = *objects[j];
-                if (!a.hasCollider() || !b.hasCollider()) {
-                    continue;
-                }
+        if (result.penetrationDepth <= 0.0f) {
+            return;
+        }
 
-                CollisionResult result;
-                if (!computePenetration(bounds[i], bounds[j], result)) {
-                    continue;
-                }
+        // An awake body touched a sleeping one.
+        if (sleepingA) {
+            store.wake(i);
+        }
+        if (sleepingB) {
+            store.wake(j);
+        }
 
-                const float invMassA = computeInverseMass(a, a.collider());
-                const float invMassB = computeInverseMass(b, b.collider());
-                const float invMassSum = invMassA + invMassB;
+        glm::vec3 positionA = store.position(i);
+        glm::vec3 positionB = store.position(j);
+        if (result.penetrationDepth > penetrationSlop * 2.0f) {
+            const float correctionAmount = (result.penetrationDepth - penetrationSlop) * 0.5f;
+            const glm::vec3 correction = correctionAmount * result.normal;
+            if (invMassA > 0.0f) {
+                positionA -= correction * (invMassA / invMassSum);
+                store.setPosition(i, positionA);
+            }
+            if (invMassB > 0.0f) {
+                positionB += correction * (invMassB / invMassSum);
+                store.setPosition(j, positionB);
+            }
+            result.penetrationDepth -= correctionAmount;
+        }
 
-                if (invMassSum <= 0.0f || result.penetrationDepth <= 0.0f) {
-                    continue;
-                }
+        Contact contact{};
+        contact.a = objects[i];
+        contact.b = objects[j];
+        contact.indexA = i;
+        contact.indexB = j;
+        contact.normal = result.normal;
+        contact.penetration = result.penetrationDepth;
+        contact.contactPoint = estimateContactPoint(positionA, store.worldBounds(i), positionB, store.worldBounds(j), result.normal);
+        contact.ra = contact.contactPoint - positionA;
+        contact.rb = contact.contactPoint - positionB;
+        contact.invMassA = invMassA;
+        contact.invMassB = invMassB;
+        contact.invInertiaA = store.inverseInertiaWorld(i);
+        contact.invInertiaB = store.inverseInertiaWorld(j);
 
-                if (result.penetrationDepth > penetrationSlop * 2.0f) {
-                    const float correctionAmount = (result.penetrationDepth - penetrationSlop) * 0.5f;
-                    const glm::vec3 correction = correctionAmount * result.normal;
-                    if (invMassA > 0.0f) {
-                        a.transform().position -= correction * (invMassA / invMassSum);
-                    }
-                    if (invMassB > 0.0f) {
-                        b.transform().position += correction * (invMassB / invMassSum);
-                    }
-                    result.penetrationDepth -= correctionAmount;
-                }
+        contact.restitution = std::clamp(std::min(store.restitution[i], store.restitution[j]), 0.0f, 0.9f);
+        contact.staticFriction = combineCoefficient(store.staticFriction[i], store.staticFriction[j]);
+        contact.dynamicFriction = combineCoefficient(store.dynamicFriction[i], store.dynamicFriction[j]);
+
+        contacts.emplace_back(contact);
+    });
+
+    // Simulation islands: dynamic bodies connected through contacts. Static bodies do not join
+    // islands because the solver only reads them, so two islands never write the same body.
+    std::vector<uint32_t> islandParent(objects.size());
+    std::iota(islandParent.begin(), islandParent.end(), 0u);
+    const auto findIsland = [&](uint32_t index) {
+        while (islandParent[index] != index) {
+            islandParent[index] = islandParent[islandParent[index]];
+            index = islandParent[index];
+        }
+        return index;
+    };
+    const auto joinIslands = [&](uint32_t a, uint32_t b) {
+        a = findIsland(a);
+        b = findIsland(b);
+        if (a != b) {
+            islandParent[std::max(a, b)] = std::min(a, b);
+        }
+    };
+    for (const auto& contact : contacts) {
+        if (contact.invMassA > 0.0f && contact.invMassB > 0.0f) {
+            joinIslands(contact.indexA, contact.indexB);
+        }
+    }
+    for (const auto& [i, j] : sleepingLinks) {
+        joinIslands(i, j);
+    }
 
-                Contact contact{};
-                contact.a = &a;
-                contact.b = &b;
-                contact.normal = result.normal;
-                contact.penetration = result.penetrationDepth;
-                contact.contactPoint = estimateContactPoint(a, b, result.normal, result.penetrationDepth);
-                contact.ra = contact.contactPoint - a.transform().position;
-                contact.rb = contact.contactPoint - b.transform().position;
-                contact.invMassA = invMassA;
-                contact.invMassB = invMassB;
-                contact.invInertiaA = inverseInertiaTensor(a);
-                contact.invInertiaB = inverseInertiaTensor(b);
-
-                auto& propsA = a.physics();
-                auto& propsB = b.physics();
-                contact.restitution = std::clamp(std::min(propsA.restitution, propsB.restitution), 0.0f, 0.9f);
-                contact.staticFriction = combineCoefficient(propsA.staticFriction, propsB.staticFriction);
-                contact.dynamicFriction = combineCoefficient(propsA.dynamicFriction, propsB.dynamicFriction);
-
-                contacts.emplace_back(contact);
+    // Wake every sleeping body that shares an island with an awake one. Their contacts are
+    // generated from the next step on.
+    std::vector<uint8_t> islandAwake(objects.size(), 0);
+    for (uint32_t i = 0; i < objects.size(); ++i) {
+        if (inverseMasses[i] > 0.0f && !store.isSleeping(i)) {
+            islandAwake[findIsland(i)] = 1;
+        }
+    }
+    if (!sleepingLinks.empty()) {
+        for (uint32_t i = 0; i < objects.size(); ++i) {
+            if (inverseMasses[i] > 0.0f && store.isSleeping(i) && islandAwake[findIsland(i)]) {
+                store.wake(i);
             }
         }
     }
 
-    if (contacts.empty()) {
-        return;
+    // Bucket contacts by island, keeping their relative order so a single island is solved
+    // exactly like the old global contact list.
+    constexpr uint32_t noIsland = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> islandIndex(objects.size(), noIsland);
+    std::vector<uint32_t> contactIsland(contacts.size());
+    std::vector<std::size_t> islandOffsets(1, 0);
+    for (std::size_t c = 0; c < contacts.size(); ++c) {
+        const Contact& contact = contacts[c];
+        const uint32_t root = findIsland(contact.invMassA > 0.0f ? contact.indexA : contact.indexB);
+        if (islandIndex[root] == noIsland) {
+            islandIndex[root] = static_cast<uint32_t>(islandOffsets.size() - 1);
+            islandOffsets.push_back(0);
+        }
+        contactIsland[c] = islandIndex[root];
+        ++islandOffsets[islandIndex[root] + 1];
+    }
+    const std::size_t islandCount = islandOffsets.size() - 1;
+    for (std::size_t island = 0; island < islandCount; ++island) {
+        islandOffsets[island + 1] += islandOffsets[island];
+    }
+    std::vector<Contact> islandSortedContacts(contacts.size());
+    {
+        std::vector<std::size_t> cursor(islandOffsets.begin(), islandOffsets.end() - 1);
+        for (std::size_t c = 0; c < contacts.size(); ++c) {
+            islandSortedContacts[cursor[contactIsland[c]]++] = contacts[c];
+        }
     }
 
-    // Sequential impulse solver with angular response
-    // Uses proper effective mass calculation including rotational inertia
-    for (int iteration = 0; iteration < velocityIterations; ++iteration) {
-        for (auto& contact : contacts) {
-            const float invMassSum = contact.totalInverseMass();
-            if (invMassSum <= 0.0f) {
-                continue;
-            }
+    const auto solveIsland = [&](std::size_t island) {
+        const std::span<Contact> islandContacts(islandSortedContacts.data() + islandOffsets[island],
+                                                islandOffsets[island + 1] - islandOffsets[island]);
 
-            GameObject& objA = *contact.a;
-            GameObject& objB = *contact.b;
-            auto& propsA = objA.physics();
-            auto& propsB = objB.physics();
+        // Sequential impulse solver with angular response
+        // Uses proper effective mass calculation including rotational inertia
+        for (int iteration = 0; iteration < velocityIterations; ++iteration) {
+            for (auto& contact : islandContacts) {
+                const float invMassSum = contact.totalInverseMass();
+                if (invMassSum <= 0.0f) {
+                    continue;
+                }
 
-            // Compute point velocities including angular contribution
-            const glm::vec3 velPointA = propsA.velocity + glm::cross(propsA.angularVelocity, contact.ra);
-            const glm::vec3 velPointB = propsB.velocity + glm::cross(propsB.angularVelocity, contact.rb);
-            const glm::vec3 relativeVel = velPointB - velPointA;
-            const float velAlongNormal = glm::dot(relativeVel, contact.normal);
+                glm::vec3 velocityA = store.velocity(contact.indexA);
+                glm::vec3 angularVelocityA = store.angularVelocity(contact.indexA);
+                glm::vec3 velocityB = store.velocity(contact.indexB);
+                glm::vec3 angularVelocityB = store.angularVelocity(contact.indexB);
+
+                // Compute point velocities including angular contribution
+                const glm::vec3 velPointA = velocityA + glm::cross(angularVelocityA, contact.ra);
+                const glm::vec3 velPointB = velocityB + glm::cross(angularVelocityB, contact.rb);
+                const glm::vec3 relativeVel = velPointB - velPointA;
+                const float velAlongNormal = glm::dot(relativeVel, contact.normal);
             
-            // Skip if objects are separating and not deeply penetrating
-            if (velAlongNormal > 0.0f && contact.penetration <= penetrationSlop) {
-                continue;
-            }
+                // Skip if objects are separating and not deeply penetrating
+                if (velAlongNormal > 0.0f && contact.penetration <= penetrationSlop) {
+                    continue;
+                }
 
-            // Compute effective mass including angular terms
-            // K = 1/m_a + 1/m_b + (r_a x n)^T * I_a^-1 * (r_a x n) + (r_b x n)^T * I_b^-1 * (r_b x n)
-            const glm::vec3 raCrossN = glm::cross(contact.ra, contact.normal);
-            const glm::vec3 rbCrossN = glm::cross(contact.rb, contact.normal);
+                // Compute effective mass including angular terms
+                // K = 1/m_a + 1/m_b + (r_a x n)^T * I_a^-1 * (r_a x n) + (r_b x n)^T * I_b^-1 * (r_b x n)
+                const glm::vec3 raCrossN = glm::cross(contact.ra, contact.normal);
+                const glm::vec3 rbCrossN = glm::cross(contact.rb, contact.normal);
             
-            float denom = invMassSum;
-            // Add angular contribution to effective mass
-            const glm::vec3 angularTermA = applyInverseInertia(contact.invInertiaA, raCrossN);
-            const glm::vec3 angularTermB = applyInverseInertia(contact.invInertiaB, rbCrossN);
-            denom += glm::dot(raCrossN, angularTermA) + glm::dot(rbCrossN, angularTermB);
+                float denom = invMassSum;
+                // Add angular contribution to effective mass
+                const glm::vec3 angularTermA = applyInverseInertia(contact.invInertiaA, raCrossN);
+                const glm::vec3 angularTermB = applyInverseInertia(contact.invInertiaB, rbCrossN);
+                denom += glm::dot(raCrossN, angularTermA) + glm::dot(rbCrossN, angularTermB);
             
-            if (denom <= std::numeric_limits<float>::epsilon()) {
-                continue;
-            }
+                if (denom <= std::numeric_limits<float>::epsilon()) {
+                    continue;
+                }
 
-            // Baumgarte stabilization for position correction
-            float penetrationBias = 0.0f;
-            if (contact.penetration > penetrationSlop) {
-                penetrationBias = baumgarteFactor * (contact.penetration - penetrationSlop) / deltaSeconds;
-            }
+                // Baumgarte stabilization for position correction
+                float penetrationBias = 0.0f;
+                if (contact.penetration > penetrationSlop) {
+                    penetrationBias = baumgarteFactor * (contact.penetration - penetrationSlop) / deltaSeconds;
+                }
 
-            // Calculate impulse magnitude
-            float normalImpulseMag = -(1.0f + contact.restitution) * velAlongNormal + penetrationBias;
-            normalImpulseMag /= denom;
+                // Calculate impulse magnitude
+                float normalImpulseMag = -(1.0f + contact.restitution) * velAlongNormal + penetrationBias;
+                normalImpulseMag /= denom;
 
-            // Only apply separating impulse
-            normalImpulseMag = std::max(0.0f, normalImpulseMag);
+                // Only apply separating impulse
+                normalImpulseMag = std::max(0.0f, normalImpulseMag);
             
-            // Clamp impulse to prevent instability
-            constexpr float maxNormalImpulse = 50.0f;
-            normalImpulseMag = std::min(normalImpulseMag, maxNormalImpulse);
+                // Clamp impulse to prevent instability
+                constexpr float maxNormalImpulse = 50.0f;
+                normalImpulseMag = std::min(normalImpulseMag, maxNormalImpulse);
 
-            const glm::vec3 impulse = normalImpulseMag * contact.normal;
+                const glm::vec3 impulse = normalImpulseMag * contact.normal;
 
-            // Apply linear impulse
-            if (contact.invMassA > 0.0f) {
-                propsA.velocity -= impulse * contact.invMassA;
-            }
-            if (contact.invMassB > 0.0f) {
-                propsB.velocity += impulse * contact.invMassB;
-            }
+                // Apply linear impulse
+                if (contact.invMassA > 0.0f) {
+                    velocityA -= impulse * contact.invMassA;
+                }
+                if (contact.invMassB > 0.0f) {
+                    velocityB += impulse * contact.invMassB;
+                }
             
-            // Apply angular impulse: torque = r x impulse, angular_vel_change = I^-1 * torque
-            constexpr float angularImpulseScale = 0.5f; // Scale down angular response for stability
-            constexpr float maxAngularImpulse = 5.0f;
+                // Apply angular impulse: torque = r x impulse, angular_vel_change = I^-1 * torque
+                constexpr float angularImpulseScale = 0.5f; // Scale down angular response for stability
+                constexpr float maxAngularImpulse = 5.0f;
             
-            if (contact.invMassA > 0.0f) {
-                glm::vec3 angularImpulseA = glm::cross(contact.ra, -impulse);
-                angularImpulseA = applyInverseInertia(contact.invInertiaA, angularImpulseA) * angularImpulseScale;
-                // Clamp angular impulse magnitude
-                const float angImpLen = glm::length(angularImpulseA);
-                if (angImpLen > maxAngularImpulse) {
-                    angularImpulseA *= maxAngularImpulse / angImpLen;
+                if (contact.invMassA > 0.0f) {
+                    glm::vec3 angularImpulseA = glm::cross(contact.ra, -impulse);
+                    angularImpulseA = applyInverseInertia(contact.invInertiaA, angularImpulseA) * angularImpulseScale;
+                    // Clamp angular impulse magnitude
+                    const float angImpLen = glm::length(angularImpulseA);
+                    if (angImpLen > maxAngularImpulse) {
+                        angularImpulseA *= maxAngularImpulse / angImpLen;
+                    }
+                    angularVelocityA += angularImpulseA;
                 }
-                propsA.angularVelocity += angularImpulseA;
-            }
-            if (contact.invMassB > 0.0f) {
-                glm::vec3 angularImpulseB = glm::cross(contact.rb, impulse);
-                angularImpulseB = applyInverseInertia(contact.invInertiaB, angularImpulseB) * angularImpulseScale;
-                // Clamp angular impulse magnitude
-                const float angImpLen = glm::length(angularImpulseB);
-                if (angImpLen > maxAngularImpulse) {
-                    angularImpulseB *= maxAngularImpulse / angImpLen;
+                if (contact.invMassB > 0.0f) {
+                    glm::vec3 angularImpulseB = glm::cross(contact.rb, impulse);
+                    angularImpulseB = applyInverseInertia(contact.invInertiaB, angularImpulseB) * angularImpulseScale;
+                    // Clamp angular impulse magnitude
+                    const float angImpLen = glm::length(angularImpulseB);
+                    if (angImpLen > maxAngularImpulse) {
+                        angularImpulseB *= maxAngularImpulse / angImpLen;
+                    }
+                    angularVelocityB += angularImpulseB;
                 }
-                propsB.angularVelocity += angularImpulseB;
-            }
 
-            // Friction impulse (with angular contribution)
-            const glm::vec3 newVelPointA = propsA.velocity + glm::cross(propsA.angularVelocity, contact.ra);
-            const glm::vec3 newVelPointB = propsB.velocity + glm::cross(propsB.angularVelocity, contact.rb);
-            const glm::vec3 newRelativeVel = newVelPointB - newVelPointA;
-            glm::vec3 tangent = newRelativeVel - glm::dot(newRelativeVel, contact.normal) * contact.normal;
-            const float tangentLenSq = glm::dot(tangent, tangent);
+                // Friction impulse (with angular contribution)
+                const glm::vec3 newVelPointA = velocityA + glm::cross(angularVelocityA, contact.ra);
+                const glm::vec3 newVelPointB = velocityB + glm::cross(angularVelocityB, contact.rb);
+                const glm::vec3 newRelativeVel = newVelPointB - newVelPointA;
+                glm::vec3 tangent = newRelativeVel - glm::dot(newRelativeVel, contact.normal) * contact.normal;
+                const float tangentLenSq = glm::dot(tangent, tangent);
 
-            if (tangentLenSq > 1e-8f && (contact.staticFriction > 0.0f || contact.dynamicFriction > 0.0f)) {
-                tangent /= std::sqrt(tangentLenSq);
+                if (tangentLenSq > 1e-8f && (contact.staticFriction > 0.0f || contact.dynamicFriction > 0.0f)) {
+                    tangent /= std::sqrt(tangentLenSq);
                 
-                // Compute friction effective mass
-                const glm::vec3 raCrossT = glm::cross(contact.ra, tangent);
-                const glm::vec3 rbCrossT = glm::cross(contact.rb, tangent);
-                float frictionDenom = invMassSum;
-                frictionDenom += glm::dot(raCrossT, applyInverseInertia(contact.invInertiaA, raCrossT));
-                frictionDenom += glm::dot(rbCrossT, applyInverseInertia(contact.invInertiaB, rbCrossT));
+                    // Compute friction effective mass
+                    const glm::vec3 raCrossT = glm::cross(contact.ra, tangent);
+                    const glm::vec3 rbCrossT = glm::cross(contact.rb, tangent);
+                    float frictionDenom = invMassSum;
+                    frictionDenom += glm::dot(raCrossT, applyInverseInertia(contact.invInertiaA, raCrossT));
+                    frictionDenom += glm::dot(rbCrossT, applyInverseInertia(contact.invInertiaB, rbCrossT));
                 
-                const float tangentVel = glm::dot(newRelativeVel, tangent);
-                float frictionImpulseMag = -tangentVel / frictionDenom;
+                    const float tangentVel = glm::dot(newRelativeVel, tangent);
+                    float frictionImpulseMag = -tangentVel / frictionDenom;
                 
-                // Coulomb friction model
-                const float maxFriction = normalImpulseMag * contact.staticFriction;
-                if (std::abs(frictionImpulseMag) > maxFriction) {
-                    frictionImpulseMag = -glm::sign(tangentVel) * normalImpulseMag * contact.dynamicFriction;
-                }
+                    // Coulomb friction model
+                    const float maxFriction = normalImpulseMag * contact.staticFriction;
+                    if (std::abs(frictionImpulseMag) > maxFriction) {
+                        frictionImpulseMag = -glm::sign(tangentVel) * normalImpulseMag * contact.dynamicFriction;
+                    }
                 
-                // Clamp friction
-                constexpr float maxFrictionImpulse = 15.0f;
-                frictionImpulseMag = std::clamp(frictionImpulseMag, -maxFrictionImpulse, maxFrictionImpulse);
-
-                const glm::vec3 frictionImpulse = frictionImpulseMag * tangent;
+                    // Clamp friction
+                    constexpr float maxFrictionImpulse = 15.0f;
+                    frictionImpulseMag = std::clamp(frictionImpulseMag, -maxFrictionImpulse, maxFrictionImpulse);
+
+                    const glm::vec3 frictionImpulse = frictionImpulseMag * tangent;
+
+                    if (contact.invMassA > 0.0f) {
+                        velocityA -= frictionImpulse * contact.invMassA;
+                        // Angular friction
+                        glm::vec3 angFricA = glm::cross(contact.ra, -frictionImpulse);
+                        angFricA = applyInverseInertia(contact.invInertiaA, angFricA) * angularImpulseScale;
+                        const float angFricLenA = glm::length(angFricA);
+                        if (angFricLenA > maxAngularImpulse) {
+                            angFricA *= maxAngularImpulse / angFricLenA;
+                        }
+                        angularVelocityA += angFricA;
+                    }
+                    if (contact.invMassB > 0.0f) {
+                        velocityB += frictionImpulse * contact.invMassB;
+                        // Angular friction
+                        glm::vec3 angFricB = glm::cross(contact.rb, frictionImpulse);
+                        angFricB = applyInverseInertia(contact.invInertiaB, angFricB) * angularImpulseScale;
+                        const float angFricLenB = glm::length(angFricB);
+                        if (angFricLenB > maxAngularImpulse) {
+                            angFricB *= maxAngularImpulse / angFricLenB;
+                        }
+                        angularVelocityB += angFricB;
+                    }
+                }
 
                 if (contact.invMassA > 0.0f) {
-                    propsA.velocity -= frictionImpulse * contact.invMassA;
-                    // Angular friction
-                    glm::vec3 angFricA = glm::cross(contact.ra, -frictionImpulse);
-                    angFricA = applyInverseInertia(contact.invInertiaA, angFricA) * angularImpulseScale;
-                    const float angFricLenA = glm::length(angFricA);
-                    if (angFricLenA > maxAngularImpulse) {
-                        angFricA *= maxAngularImpulse / angFricLenA;
-                    }
-                    propsA.angularVelocity += angFricA;
+                    store.setVelocity(contact.indexA, velocityA);
+                    store.setAngularVelocity(contact.indexA, angularVelocityA);
                 }
                 if (contact.invMassB > 0.0f) {
-                    propsB.velocity += frictionImpulse * contact.invMassB;
-                    // Angular friction
-                    glm::vec3 angFricB = glm::cross(contact.rb, frictionImpulse);
-                    angFricB = applyInverseInertia(contact.invInertiaB, angFricB) * angularImpulseScale;
-                    const float angFricLenB = glm::length(angFricB);
-                    if (angFricLenB > maxAngularImpulse) {
-                        angFricB *= maxAngularImpulse / angFricLenB;
-                    }
-                    propsB.angularVelocity += angFricB;
+                    store.setVelocity(contact.indexB, velocityB);
+                    store.setAngularVelocity(contact.indexB, angularVelocityB);
                 }
             }
         }
-    }
 
-    // Position correction
-    for (auto& contact : contacts) {
-        const float invMassSum = contact.totalInverseMass();
-        if (invMassSum <= 0.0f) {
-            continue;
-        }
+        // Position correction
+        for (auto& contact : islandContacts) {
+            const float invMassSum = contact.totalInverseMass();
+            if (invMassSum <= 0.0f) {
+                continue;
+            }
 
-        const float penetration = std::max(contact.penetration - penetrationSlop, 0.0f);
-        if (penetration <= 0.0f) {
-            continue;
-        }
+            const float penetration = std::max(contact.penetration - penetrationSlop, 0.0f);
+            if (penetration <= 0.0f) {
+                continue;
+            }
 
-        const glm::vec3 correction = (penetration / invMassSum) * positionCorrectionPercent * contact.normal;
+            const glm::vec3 correction = (penetration / invMassSum) * positionCorrectionPercent * contact.normal;
 
-        if (contact.invMassA > 0.0f) {
-            contact.a->transform().position -= correction * (contact.invMassA / invMassSum);
+            if (contact.invMassA > 0.0f) {
+                store.setPosition(contact.indexA, store.position(contact.indexA) - correction * (contact.invMassA / invMassSum));
+            }
+            if (contact.invMassB > 0.0f) {
+                store.setPosition(contact.indexB, store.position(contact.indexB) + correction * (contact.invMassB / invMassSum));
+            }
         }
-        if (contact.invMassB > 0.0f) {
-            contact.b->transform().position += correction * (contact.invMassB / invMassSum);
+    
+        // Apply contact velocity damping to ensure energy loss for objects in contact
+        // This helps objects settle and prevents perpetual bouncing
+        constexpr float contactVelocityDamping = 0.995f; // 0.5% velocity reduction per contact
+        for (auto& contact : islandContacts) {
+            if (contact.invMassA > 0.0f) {
+                store.setVelocity(contact.indexA, store.velocity(contact.indexA) * contactVelocityDamping);
+                store.setAngularVelocity(contact.indexA, store.angularVelocity(contact.indexA) * contactVelocityDamping);
+            }
+            if (contact.invMassB > 0.0f) {
+                store.setVelocity(contact.indexB, store.velocity(contact.indexB) * contactVelocityDamping);
+                store.setAngularVelocity(contact.indexB, store.angularVelocity(contact.indexB) * contactVelocityDamping);
+            }
         }
+    };
+    core::parallelFor(islandCount, 1, solveIsland);
+
+    lastIslandCount = islandCount;
+    if (!sleepingEnabled || stepStartPositions.size() != objects.size()) {
+        return;
     }
-    
-    // Apply contact velocity damping to ensure energy loss for objects in contact
-    // This helps objects settle and prevents perpetual bouncing
-    constexpr float contactVelocityDamping = 0.995f; // 0.5% velocity reduction per contact
-    for (auto& contact : contacts) {
-        if (contact.invMassA > 0.0f) {
-            auto& propsA = contact.a->physics();
-            propsA.velocity *= contactVelocityDamping;
-            propsA.angularVelocity *= contactVelocityDamping;
+
+    // An island falls asleep once its most recently active body has been at rest for kTimeToSleep.
+    // Linear rest is judged from the displacement over the step: the Baumgarte bias leaves bodies
+    // in resting contact with a small separating velocity even though they do not move.
+    const float maxRestDisplacement = kSleepLinearVelocity * deltaSeconds;
+    std::vector<float> islandRestTime(objects.size(), std::numeric_limits<float>::max());
+    for (uint32_t i = 0; i < objects.size(); ++i) {
+        if (inverseMasses[i] <= 0.0f || store.isSleeping(i)) {
+            continue;
         }
-        if (contact.invMassB > 0.0f) {
-            auto& propsB = contact.b->physics();
-            propsB.velocity *= contactVelocityDamping;
-            propsB.angularVelocity *= contactVelocityDamping;
+        const glm::vec3 displacement = store.position(i) - stepStartPositions[i];
+        const glm::vec3 angularVelocity = store.angularVelocity(i);
+        const bool resting = glm::dot(displacement, displacement) <= maxRestDisplacement * maxRestDisplacement &&
+                             glm::dot(angularVelocity, angularVelocity) <= kSleepAngularVelocity * kSleepAngularVelocity;
+        store.sleepTime[i] = resting ? store.sleepTime[i] + deltaSeconds : 0.0f;
+        float& restTime = islandRestTime[findIsland(i)];
+        restTime = std::min(restTime, store.sleepTime[i]);
+    }
+    for (uint32_t i = 0; i < objects.size(); ++i) {
+        if (inverseMasses[i] <= 0.0f) {
+            continue;
+        }
+        if (!store.isSleeping(i) && islandRestTime[findIsland(i)] >= kTimeToSleep) {
+            store.putToSleep(i);
+        }
+        if (store.isSleeping(i)) {
+            ++lastSleepingCount;
         }
     }
 }
@@ -0,0 +1,370 @@
+#include "engine/RigidBodyStore.hpp"
+
+#include "core/ParallelFor.hpp"
+#include "core/SimdLanes.hpp"
+#include "engine/GameEngine.hpp"
+
+#include <glm/gtc/constants.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace vkengine {
+
+namespace {
+
+constexpr float kMinInertia = 0.001f;
+constexpr float kMaxInverseInertia = 100.0f;
+constexpr float kMaxAngularSpeed = 15.0f;
+
+// Bodies per parallel chunk for the ECS sync and the integrator.
+constexpr std::size_t kMinBodiesPerChunk = 1024;
+
+} // namespace
+
+// Integrates bodies [begin, end) kWidth at a time and returns the first index it did not reach.
+// Mirrors the per-object integrator PhysicsSystem used before: inertia is applied in the body
+// frame through the orientation quaternion instead of building world-space tensors.
+template<typename L>
+struct RigidBodyKernel {
+    using F = typename L::Float;
+
+    struct V3 {
+        F x, y, z;
+    };
+
+    static V3 load3(const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& z, std::size_t i)
+    {
+        return {L::load(x.data() + i), L::load(y.data() + i), L::load(z.data() + i)};
+    }
+    static void store3(std::vector<float>& x, std::vector<float>& y, std::vector<float>& z, std::size_t i, const V3& v)
+    {
+        L::store(x.data() + i, v.x);
+        L::store(y.data() + i, v.y);
+        L::store(z.data() + i, v.z);
+    }
+    static V3 add(const V3& a, const V3& b) { return {L::add(a.x, b.x), L::add(a.y, b.y), L::add(a.z, b.z)}; }
+    static V3 sub(const V3& a, const V3& b) { return {L::sub(a.x, b.x), L::sub(a.y, b.y), L::sub(a.z, b.z)}; }
+    static V3 mul(const V3& a, const V3& b) { return {L::mul(a.x, b.x), L::mul(a.y, b.y), L::mul(a.z, b.z)}; }
+    static V3 scale(const V3& a, F s) { return {L::mul(a.x, s), L::mul(a.y, s), L::mul(a.z, s)}; }
+    static F dot(const V3& a, const V3& b) { return L::add(L::add(L::mul(a.x, b.x), L::mul(a.y, b.y)), L::mul(a.z, b.z)); }
+    static V3 cross(const V3& a, const V3& b)
+    {
+        return {L::sub(L::mul(a.y, b.z), L::mul(a.z, b.y)),
+                L::sub(L::mul(a.z, b.x), L::mul(a.x, b.z)),
+                L::sub(L::mul(a.x, b.y), L::mul(a.y, b.x))};
+    }
+    static V3 select(typename L::Mask m, const V3& a, const V3& b)
+    {
+        return {L::select(m, a.x, b.x), L::select(m, a.y, b.y), L::select(m, a.z, b.z)};
+    }
+    // v' = v + w t + u x t with t = 2 (u x v), the rotation of v by the unit quaternion (u, w).
+    static V3 rotate(const V3& u, F w, const V3& v)
+    {
+        const V3 t = scale(cross(u, v), L::set1(2.0f));
+        return add(add(v, scale(t, w)), cross(u, t));
+    }
+
+    static std::size_t run(RigidBodyStore& s, const glm::vec3& gravity, float deltaSeconds, std::size_t begin, std::size_t end)
+    {
+        const F zero = L::set1(0.0f);
+        const F one = L::set1(1.0f);
+        const F half = L::set1(0.5f);
+        const F dt = L::set1(deltaSeconds);
+        const F maxAngularSpeed = L::set1(kMaxAngularSpeed);
+        const F tiny = L::set1(1e-20f);
+        const V3 g{L::set1(gravity.x), L::set1(gravity.y), L::set1(gravity.z)};
+
+        std::size_t i = begin;
+        for (; i + L::kWidth <= end; i += L::kWidth) {
+            const auto awake = L::greater(L::load(s.integrationMask.data() + i), zero);
+
+            // Linear: v += (g + F / m) dt, damped, then p += v dt.
+            const V3 force = load3(s.forceX, s.forceY, s.forceZ, i);
+            const V3 acceleration = add(g, scale(force, L::load(s.inverseMass.data() + i)));
+            const V3 oldVelocity = load3(s.velX, s.velY, s.velZ, i);
+            const F linearDamping = L::max(zero, L::sub(one, L::mul(L::load(s.linearDamping.data() + i), dt)));
+            const V3 velocity = scale(add(oldVelocity, scale(acceleration, dt)), linearDamping);
+            const V3 oldPosition = load3(s.posX, s.posY, s.posZ, i);
+            const V3 position = add(oldPosition, scale(velocity, dt));
+
+            // Angular: alpha = I^-1 (torque - w x I w - c w) with I = R diag(I_body) R^T.
+            const V3 qv = load3(s.rotX, s.rotY, s.rotZ, i);
+            const F qw = L::load(s.rotW.data() + i);
+            const V3 qvInverse{L::sub(zero, qv.x), L::sub(zero, qv.y), L::sub(zero, qv.z)};
+            const V3 oldOmega = load3(s.angX, s.angY, s.angZ, i);
+            const V3 inertia = load3(s.inertiaX, s.inertiaY, s.inertiaZ, i);
+            const V3 inverseInertia = load3(s.invInertiaX, s.invInertiaY, s.invInertiaZ, i);
+
+            const V3 momentum = rotate(qv, qw, mul(inertia, rotate(qvInverse, qw, oldOmega)));
+            const V3 gyroscopicTorque = cross(oldOmega, momentum);
+            const V3 dampingTorque = scale(oldOmega, L::load(s.angularDissipation.data() + i));
+            const V3 torque = sub(sub(load3(s.torqueX, s.torqueY, s.torqueZ, i), gyroscopicTorque), dampingTorque);
+            const V3 angularAcceleration = rotate(qv, qw, mul(inverseInertia, rotate(qvInverse, qw, torque)));
+
+            V3 omega = add(oldOmega, scale(angularAcceleration, dt));
+            const F speed = L::sqrt(dot(omega, omega));
+            omega = scale(omega, L::min(one, L::div(maxAngularSpeed, L::max(speed, tiny))));
+
+            // q += 0.5 (0, w) q dt, then renormalize.
+            const F dqw = L::mul(L::sub(zero, dot(omega, qv)), half);
+            const V3 dqv = scale(add(scale(omega, qw), cross(omega, qv)), half);
+            V3 newQv = add(qv, scale(dqv, dt));
+            F newQw = L::add(qw, L::mul(dqw, dt));
+            const F inverseLength = L::div(one, L::sqrt(L::add(dot(newQv, newQv), L::mul(newQw, newQw))));
+            newQv = scale(newQv, inverseLength);
+            newQw = L::mul(newQw, inverseLength);
+
+            store3(s.velX, s.velY, s.velZ, i, select(awake, velocity, oldVelocity));
+            store3(s.posX, s.posY, s.posZ, i, select(awake, position, oldPosition));
+            store3(s.angX, s.angY, s.angZ, i, select(awake, omega, oldOmega));
+            store3(s.rotX, s.rotY, s.rotZ, i, select(awake, newQv, qv));
+            L::store(s.rotW.data() + i, L::select(awake, newQw, qw));
+            store3(s.accelX, s.accelY, s.accelZ, i, select(awake, acceleration, V3{zero, zero, zero}));
+        }
+        return i;
+    }
+};
+
+std::size_t RigidBodyStore::simdWidth() noexcept
+{
+    return core::simd::WidestLanes::kWidth;
+}
+
+void RigidBodyStore::resize(std::size_t newCount)
+{
+    count = newCount;
+    for (auto* array : {&posX, &posY, &posZ, &velX, &velY, &velZ, &angX, &angY, &angZ, &rotX, &rotY, &rotZ, &rotW,
+                        &forceX, &forceY, &forceZ, &torqueX, &torqueY, &torqueZ, &accelX, &accelY, &accelZ,
+                        &inverseMass, &linearDamping, &angularDissipation, &inertiaX, &inertiaY, &inertiaZ,
+                        &invInertiaX, &invInertiaY, &invInertiaZ, &halfX, &halfY, &halfZ, &integrationMask,
+                        &contactInverseMass, &restitution, &staticFriction, &dynamicFriction, &sleepTime}) {
+        array->resize(newCount, 0.0f);
+    }
+    flags.resize(newCount, 0);
+    entities.resize(newCount, 0);
+    eulerRotation.resize(newCount, glm::vec3(0.0f));
+}
+
+void RigidBodyStore::gather(const std::vector<GameObject*>& objects, bool allowSleeping)
+{
+    resize(objects.size());
+
+    // Registry reads are lock-free and every body only writes its own slots, so the sync with the
+    // ECS is split across the job pool like the integrator.
+    core::parallelFor(count, kMinBodiesPerChunk, [&](std::size_t i) {
+        GameObject& object = *objects[i];
+        const auto& transform = object.transform();
+        const auto& props = object.physics();
+        const Collider* collider = object.collider();
+        const core::ecs::EntityId entity = object.entity().id;
+
+        setPosition(i, transform.position);
+        setVelocity(i, props.velocity);
+        setAngularVelocity(i, props.angularVelocity);
+        forceX[i] = props.accumulatedForces.x;
+        forceY[i] = props.accumulatedForces.y;
+        forceZ[i] = props.accumulatedForces.z;
+        torqueX[i] = props.accumulatedTorque.x;
+        torqueY[i] = props.accumulatedTorque.y;
+        torqueZ[i] = props.accumulatedTorque.z;
+        accelX[i] = accelY[i] = accelZ[i] = 0.0f;
+
+        // Keep the quaternion from the previous frame unless game code touched the rotation, so
+        // the orientation does not take an Euler round trip every frame.
+        if (entities[i] != entity || eulerRotation[i] != transform.rotation) {
+            const glm::quat q(transform.rotation);
+            rotX[i] = q.x;
+            rotY[i] = q.y;
+            rotZ[i] = q.z;
+            rotW[i] = q.w;
+            eulerRotation[i] = transform.rotation;
+        }
+        entities[i] = entity;
+
+        const bool validMass = props.mass > 0.0f && std::isfinite(props.mass);
+        std::uint8_t bodyFlags = 0;
+        if (collider) {
+            bodyFlags |= kHasCollider;
+            if (collider->isStatic) {
+                bodyFlags |= kStaticCollider;
+            }
+        }
+        if (props.simulate && validMass) {
+            bodyFlags |= kSimulated;
+        }
+        if (props.sleeping) {
+            bodyFlags |= kSleeping;
+        }
+        flags[i] = bodyFlags;
+
+        inverseMass[i] = validMass ? 1.0f / props.mass : 0.0f;
+        contactInverseMass[i] = (collider && !collider->isStatic) ? inverseMass[i] : 0.0f;
+        linearDamping[i] = std::clamp(props.linearDamping, 0.0f, 1.0f);
+        const float materialDissipation = std::clamp(props.dynamicFriction + (1.0f - props.restitution) * 0.5f, 0.0f, 1.0f);
+        angularDissipation[i] = std::clamp(std::clamp(props.angularDamping, 0.0f, 1.0f) + materialDissipation, 0.0f, 1.5f);
+        restitution[i] = props.restitution;
+        staticFriction[i] = props.staticFriction;
+        dynamicFriction[i] = props.dynamicFriction;
+        sleepTime[i] = props.sleepTime;
+
+        const glm::vec3 halfExtents = collider ? collider->halfExtents : glm::vec3(0.0f);
+        halfX[i] = halfExtents.x;
+        halfY[i] = halfExtents.y;
+        halfZ[i] = halfExtents.z;
+
+        // Box inertia, as in physics_detail::inertiaTensorBody / inverseInertiaTensor.
+        if (collider && validMass) {
+            const glm::vec3 size = halfExtents * 2.0f;
+            const float factor = props.mass / 12.0f;
+            inertiaX[i] = std::max(kMinInertia, factor * (size.y * size.y + size.z * size.z));
+            inertiaY[i] = std::max(kMinInertia, factor * (size.x * size.x + size.z * size.z));
+            inertiaZ[i] = std::max(kMinInertia, factor * (size.x * size.x + size.y * size.y));
+            invInertiaX[i] = std::min(kMaxInverseInertia, 1.0f / inertiaX[i]);
+            invInertiaY[i] = std::min(kMaxInverseInertia, 1.0f / inertiaY[i]);
+            invInertiaZ[i] = std::min(kMaxInverseInertia, 1.0f / inertiaZ[i]);
+        } else {
+            inertiaX[i] = inertiaY[i] = inertiaZ[i] = 0.0f;
+            invInertiaX[i] = invInertiaY[i] = invInertiaZ[i] = 0.0f;
+        }
+
+        // Sleeping bodies were left with zero velocity, so anything else means game code pushed them.
+        if (isSleeping(i) && isSimulated(i)) {
+            const bool disturbed = props.velocity != glm::vec3(0.0f) || props.angularVelocity != glm::vec3(0.0f) ||
+                                   props.accumulatedForces != glm::vec3(0.0f) || props.accumulatedTorque != glm::vec3(0.0f);
+            if (!allowSleeping || disturbed) {
+                wake(i);
+            }
+        }
+        refreshIntegrationMask(i);
+    });
+    forcesPending = true;
+}
+
+void RigidBodyStore::scatter(const std::vector<GameObject*>& objects)
+{
+    const std::size_t limit = std::min(count, objects.size());
+    core::parallelFor(limit, kMinBodiesPerChunk, [&](std::size_t i) {
+        GameObject& object = *objects[i];
+        auto& transform = object.transform();
+        auto& props = object.physics();
+
+        transform.position = position(i);
+        props.velocity = velocity(i);
+        props.angularVelocity = angularVelocity(i);
+        props.lastAcceleration = {accelX[i], accelY[i], accelZ[i]};
+        props.sleeping = isSleeping(i);
+        props.sleepTime = sleepTime[i];
+        props.clearForces();
+        props.clearTorques();
+
+        if (isSimulated(i)) {
+            glm::vec3 euler = glm::eulerAngles(orientation(i));
+            for (int axis = 0; axis < 3; ++axis) {
+                euler[axis] = std::fmod(euler[axis], glm::two_pi<float>());
+                if (euler[axis] < 0.0f) {
+                    euler[axis] += glm::two_pi<float>();
+                }
+            }
+            transform.rotation = euler;
+            eulerRotation[i] = euler;
+        }
+    });
+}
+
+void RigidBodyStore::integrate(const glm::vec3& gravity, float deltaSeconds)
+{
+    core::parallelForRange(count, kMinBodiesPerChunk, [&](std::size_t begin, std::size_t end) {
+        integrateRange(gravity, deltaSeconds, begin, end);
+    });
+    finishIntegration();
+}
+
+void RigidBodyStore::integrateScalar(const glm::vec3& gravity, float deltaSeconds)
+{
+    RigidBodyKernel<core::simd::ScalarLanes>::run(*this, gravity, deltaSeconds, 0, count);
+    finishIntegration();
+}
+
+void RigidBodyStore::integrateRange(const glm::vec3& gravity, float deltaSeconds, std::size_t begin, std::size_t end)
+{
+#if defined(VKENGINE_SIMD_AVX2)
+    begin = RigidBodyKernel<core::simd::AvxLanes>::run(*this, gravity, deltaSeconds, begin, end);
+#endif
+#if defined(VKENGINE_SIMD_SSE2)
+    begin = RigidBodyKernel<core::simd::SseLanes>::run(*this, gravity, deltaSeconds, begin, end);
+#endif
+    RigidBodyKernel<core::simd::ScalarLanes>::run(*this, gravity, deltaSeconds, begin, end);
+}
+
+void RigidBodyStore::finishIntegration()
+{
+    // Accumulated forces only act on the first substep of a frame.
+    if (forcesPending) {
+        for (auto* array : {&forceX, &forceY, &forceZ, &torqueX, &torqueY, &torqueZ}) {
+            std::fill(array->begin(), array->end(), 0.0f);
+        }
+        forcesPending = false;
+    }
+}
+
+float RigidBodyStore::maxPredictedSpeed(const glm::vec3& gravity, float deltaSeconds) const
+{
+    float maxSpeed = 0.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (integrationMask[i] <= 0.0f) {
+            continue;
+        }
+        const glm::vec3 acceleration = gravity + glm::vec3(forceX[i], forceY[i], forceZ[i]) * inverseMass[i];
+        maxSpeed = std::max(maxSpeed, glm::length(velocity(i) + acceleration * deltaSeconds));
+    }
+    return maxSpeed;
+}
+
+AABB RigidBodyStore::worldBounds(std::size_t i) const
+{
+    const glm::vec3 center = position(i);
+    if (!hasCollider(i)) {
+        return {center, center};
+    }
+    const glm::mat3 rotation = glm::mat3_cast(orientation(i));
+    const glm::mat3 absRotation{glm::abs(rotation[0]), glm::abs(rotation[1]), glm::abs(rotation[2])};
+    const glm::vec3 rotatedHalfSize = absRotation * halfExtents(i);
+    return {center - rotatedHalfSize, center + rotatedHalfSize};
+}
+
+glm::mat3 RigidBodyStore::inverseInertiaWorld(std::size_t i) const
+{
+    if (invInertiaX[i] == 0.0f && invInertiaY[i] == 0.0f && invInertiaZ[i] == 0.0f) {
+        return glm::mat3(0.0f);
+    }
+    const glm::mat3 rotation = glm::mat3_cast(orientation(i));
+    const glm::mat3 invBody{
+        invInertiaX[i], 0.0f, 0.0f,
+        0.0f, invInertiaY[i], 0.0f,
+        0.0f, 0.0f, invInertiaZ[i]
+    };
+    return rotation * invBody * glm::transpose(rotation);
+}
+
+void RigidBodyStore::wake(std::size_t i)
+{
+    flags[i] &= static_cast<std::uint8_t>(~kSleeping);
+    sleepTime[i] = 0.0f;
+    refreshIntegrationMask(i);
+}
+
+void RigidBodyStore::putToSleep(std::size_t i)
+{
+    flags[i] |= kSleeping;
+    setVelocity(i, glm::vec3(0.0f));
+    setAngularVelocity(i, glm::vec3(0.0f));
+    refreshIntegrationMask(i);
+}
+
+void RigidBodyStore::refreshIntegrationMask(std::size_t i)
+{
+    integrationMask[i] = (isSimulated(i) && !isSleeping(i)) ? 1.0f : 0.0f;
+}
+
+} // namespace vkengine
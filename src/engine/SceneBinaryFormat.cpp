@@ -0,0 +1,492 @@
+#include "engine/Serialization.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VKENGINE_SCENE_MMAP 1
+#endif
+
+namespace vkengine {
+
+// ============================================================================
+// Binary Scene Format
+// ============================================================================
+//
+// Layout: FileHeader, SectionEntry[sectionCount], then the sections, each 8-byte aligned. A
+// section is `count` records of `elementSize` bytes; readers accept records larger than the ones
+// they know (a newer minor layout that appended fields) and read the prefix. All values are in
+// the writer's byte order, which the endianness marker lets readers check.
+
+namespace {
+
+constexpr char kMagic[4] = {'V', 'K', 'S', 'B'};
+constexpr std::uint32_t kEndianMarker = 0x01020304u;
+
+enum class SectionId : std::uint32_t {
+    StringBytes = 1,
+    StringOffsets = 2,  // stringCount + 1 offsets into StringBytes.
+    SceneInfo = 3,
+    ObjectNames = 4,    // String index per object.
+    Transforms = 5,
+    Physics = 6,
+    Render = 7,
+    Colliders = 8,      // Sparse: only objects with a collider.
+    Lights = 9,
+};
+
+struct FileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t endianMarker;
+    std::uint32_t sectionCount;
+    std::uint64_t fileSize;
+};
+
+struct SectionEntry {
+    std::uint32_t id;
+    std::uint32_t elementSize;
+    std::uint64_t offset;
+    std::uint64_t count;
+};
+
+struct SceneInfoRecord {
+    float cameraPosition[3];
+};
+
+struct TransformRecord {
+    float position[3];
+    float rotation[3];
+    float scale[3];
+};
+
+struct PhysicsRecord {
+    float mass;
+    float velocity[3];
+    float angularVelocity[3];
+    float linearDamping;
+    float angularDamping;
+    float restitution;
+    float staticFriction;
+    float dynamicFriction;
+    std::uint32_t simulate;
+};
+
+struct RenderRecord {
+    std::uint32_t mesh;
+    std::uint32_t meshResource;
+    std::uint32_t albedoTexture;
+    std::uint32_t materialName;
+    float baseColor[4];
+    float metallic;
+    float roughness;
+    float specular;
+    float emissive[3];
+    float emissiveIntensity;
+    float opacity;
+    std::uint32_t visible;
+};
+
+struct ColliderRecord {
+    std::uint32_t object;
+    float halfExtents[3];
+    std::uint32_t isStatic;
+};
+
+struct LightRecord {
+    std::uint32_t name;
+    float position[3];
+    float color[3];
+    float intensity;
+    std::uint32_t type;
+    float direction[3];
+    float range;
+    float innerConeAngle;
+    float outerConeAngle;
+    float areaSize[2];
+    float up[3];
+    std::uint32_t enabled;
+};
+
+static_assert(sizeof(FileHeader) == 24 && sizeof(SectionEntry) == 24);
+static_assert(sizeof(TransformRecord) == 36 && sizeof(PhysicsRecord) == 52 && sizeof(RenderRecord) == 68);
+static_assert(sizeof(ColliderRecord) == 20 && sizeof(LightRecord) == 84);
+
+void storeVec(float* out, const glm::vec2& v) { out[0] = v.x; out[1] = v.y; }
+void storeVec(float* out, const glm::vec3& v) { out[0] = v.x; out[1] = v.y; out[2] = v.z; }
+void storeVec(float* out, const glm::vec4& v) { out[0] = v.x; out[1] = v.y; out[2] = v.z; out[3] = v.w; }
+glm::vec2 loadVec2(const float* in) { return {in[0], in[1]}; }
+glm::vec3 loadVec3(const float* in) { return {in[0], in[1], in[2]}; }
+glm::vec4 loadVec4(const float* in) { return {in[0], in[1], in[2], in[3]}; }
+
+class StringTable {
+public:
+    std::uint32_t intern(const std::string& value) {
+        auto [it, inserted] = indices.try_emplace(value, static_cast<std::uint32_t>(offsets.size() - 1));
+        if (inserted) {
+            bytes.insert(bytes.end(), value.begin(), value.end());
+            offsets.push_back(static_cast<std::uint32_t>(bytes.size()));
+        }
+        return it->second;
+    }
+
+    std::vector<char> bytes;
+    std::vector<std::uint32_t> offsets{0};
+
+private:
+    std::unordered_map<std::string, std::uint32_t> indices;
+};
+
+class BinaryWriter {
+public:
+    BinaryWriter() { out.resize(sizeof(FileHeader)); }
+
+    template<typename T>
+    void addSection(SectionId id, const std::vector<T>& records) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        while (out.size() % 8 != 0) out.push_back(0);
+        sections.push_back(SectionEntry{static_cast<std::uint32_t>(id), static_cast<std::uint32_t>(sizeof(T)), out.size(),
+                                        records.size()});
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(records.data());
+        out.insert(out.end(), bytes, bytes + records.size() * sizeof(T));
+    }
+
+    // Moves the section table in front of the sections and fills in the header.
+    std::vector<std::uint8_t> finish() {
+        const std::size_t tableSize = sections.size() * sizeof(SectionEntry);
+        for (SectionEntry& section : sections) {
+            section.offset += tableSize;
+        }
+        out.insert(out.begin() + sizeof(FileHeader), tableSize, 0);
+        std::memcpy(out.data() + sizeof(FileHeader), sections.data(), tableSize);
+
+        FileHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = SceneSerializer::BinaryVersion;
+        header.endianMarker = kEndianMarker;
+        header.sectionCount = static_cast<std::uint32_t>(sections.size());
+        header.fileSize = out.size();
+        std::memcpy(out.data(), &header, sizeof(header));
+        return std::move(out);
+    }
+
+private:
+    std::vector<std::uint8_t> out;
+    std::vector<SectionEntry> sections;
+};
+
+// Bounds-checked view of a file's sections.
+class BinaryReader {
+public:
+    bool open(const std::uint8_t* fileData, std::size_t fileSize) {
+        data = fileData;
+        size = fileSize;
+        FileHeader header{};
+        if (size < sizeof(header)) return false;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.endianMarker != kEndianMarker ||
+            header.version == 0 || header.version > SceneSerializer::BinaryVersion || header.fileSize != size) {
+            return false;
+        }
+        if (header.sectionCount > (size - sizeof(header)) / sizeof(SectionEntry)) return false;
+        sections.resize(header.sectionCount);
+        std::memcpy(sections.data(), data + sizeof(header), sections.size() * sizeof(SectionEntry));
+        for (const SectionEntry& section : sections) {
+            if (section.elementSize == 0 || section.offset > size ||
+                section.count > (size - section.offset) / section.elementSize) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Copies the records of a section into `out`; missing sections read as empty. False if the
+    // section's records are smaller than T.
+    template<typename T>
+    bool read(SectionId id, std::vector<T>& out) const {
+        out.clear();
+        for (const SectionEntry& section : sections) {
+            if (section.id != static_cast<std::uint32_t>(id)) continue;
+            if (section.elementSize < sizeof(T)) return false;
+            out.resize(section.count);
+            if (section.elementSize == sizeof(T)) {
+                std::memcpy(out.data(), data + section.offset, out.size() * sizeof(T));
+            } else {
+                for (std::size_t i = 0; i < out.size(); ++i) {
+                    std::memcpy(&out[i], data + section.offset + i * section.elementSize, sizeof(T));
+                }
+            }
+            return true;
+        }
+        return true;
+    }
+
+    [[nodiscard]] std::string_view bytes(SectionId id) const {
+        for (const SectionEntry& section : sections) {
+            if (section.id == static_cast<std::uint32_t>(id) && section.elementSize == 1) {
+                return {reinterpret_cast<const char*>(data + section.offset), static_cast<std::size_t>(section.count)};
+            }
+        }
+        return {};
+    }
+
+private:
+    const std::uint8_t* data{nullptr};
+    std::size_t size{0};
+    std::vector<SectionEntry> sections;
+};
+
+} // namespace
+
+std::vector<std::uint8_t> SceneSerializer::serializeBinary(const Scene& scene) const {
+    const auto& objects = scene.objects();
+    StringTable strings;
+    std::vector<std::uint32_t> names(objects.size());
+    std::vector<TransformRecord> transforms(objects.size());
+    std::vector<PhysicsRecord> physics(objects.size());
+    std::vector<RenderRecord> render(objects.size());
+    std::vector<ColliderRecord> colliders;
+
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        const GameObject& object = objects[i];
+        names[i] = strings.intern(object.name());
+
+        const Transform& t = object.transform();
+        storeVec(transforms[i].position, t.position);
+        storeVec(transforms[i].rotation, t.rotation);
+        storeVec(transforms[i].scale, t.scale);
+
+        const PhysicsProperties& p = object.physics();
+        PhysicsRecord& pr = physics[i];
+        pr.mass = p.mass;
+        storeVec(pr.velocity, p.velocity);
+        storeVec(pr.angularVelocity, p.angularVelocity);
+        pr.linearDamping = p.linearDamping;
+        pr.angularDamping = p.angularDamping;
+        pr.restitution = p.restitution;
+        pr.staticFriction = p.staticFriction;
+        pr.dynamicFriction = p.dynamicFriction;
+        pr.simulate = p.simulate ? 1u : 0u;
+
+        const RenderComponent& r = object.render();
+        RenderRecord& rr = render[i];
+        rr.mesh = static_cast<std::uint32_t>(r.mesh);
+        rr.meshResource = strings.intern(r.meshResource);
+        rr.albedoTexture = strings.intern(r.albedoTexture);
+        rr.materialName = strings.intern(r.materialName);
+        storeVec(rr.baseColor, r.baseColor);
+        rr.metallic = r.metallic;
+        rr.roughness = r.roughness;
+        rr.specular = r.specular;
+        storeVec(rr.emissive, r.emissive);
+        rr.emissiveIntensity = r.emissiveIntensity;
+        rr.opacity = r.opacity;
+        rr.visible = r.visible ? 1u : 0u;
+
+        if (const Collider* collider = object.collider()) {
+            ColliderRecord cr{};
+            cr.object = static_cast<std::uint32_t>(i);
+            storeVec(cr.halfExtents, collider->halfExtents);
+            cr.isStatic = collider->isStatic ? 1u : 0u;
+            colliders.push_back(cr);
+        }
+    }
+
+    std::vector<LightRecord> lights;
+    lights.reserve(scene.lights().size());
+    for (const Light& light : scene.lights()) {
+        LightRecord lr{};
+        lr.name = strings.intern(light.name());
+        storeVec(lr.position, light.position());
+        storeVec(lr.color, light.color());
+        lr.intensity = light.intensity();
+        lr.type = static_cast<std::uint32_t>(light.type());
+        storeVec(lr.direction, light.direction());
+        lr.range = light.range();
+        lr.innerConeAngle = light.innerConeAngle();
+        lr.outerConeAngle = light.outerConeAngle();
+        storeVec(lr.areaSize, light.areaSize());
+        storeVec(lr.up, light.up());
+        lr.enabled = light.isEnabled() ? 1u : 0u;
+        lights.push_back(lr);
+    }
+
+    SceneInfoRecord info{};
+    storeVec(info.cameraPosition, scene.camera().getPosition());
+
+    BinaryWriter writer;
+    writer.addSection(SectionId::SceneInfo, std::vector<SceneInfoRecord>{info});
+    writer.addSection(SectionId::StringOffsets, strings.offsets);
+    writer.addSection(SectionId::StringBytes, strings.bytes);
+    writer.addSection(SectionId::ObjectNames, names);
+    writer.addSection(SectionId::Transforms, transforms);
+    writer.addSection(SectionId::Physics, physics);
+    writer.addSection(SectionId::Render, render);
+    writer.addSection(SectionId::Colliders, colliders);
+    writer.addSection(SectionId::Lights, lights);
+    return writer.finish();
+}
+
+bool SceneSerializer::deserializeBinary(Scene& scene, const std::uint8_t* data, std::size_t size) const {
+    BinaryReader reader;
+    if (!reader.open(data, size)) return false;
+
+    std::vector<SceneInfoRecord> info;
+    std::vector<std::uint32_t> stringOffsets;
+    std::vector<std::uint32_t> names;
+    std::vector<TransformRecord> transforms;
+    std::vector<PhysicsRecord> physics;
+    std::vector<RenderRecord> render;
+    std::vector<ColliderRecord> colliders;
+    std::vector<LightRecord> lights;
+    if (!reader.read(SectionId::SceneInfo, info) || !reader.read(SectionId::StringOffsets, stringOffsets) ||
+        !reader.read(SectionId::ObjectNames, names) || !reader.read(SectionId::Transforms, transforms) ||
+        !reader.read(SectionId::Physics, physics) || !reader.read(SectionId::Render, render) ||
+        !reader.read(SectionId::Colliders, colliders) || !reader.read(SectionId::Lights, lights)) {
+        return false;
+    }
+
+    // Validate everything before touching the scene.
+    const std::string_view stringBytes = reader.bytes(SectionId::StringBytes);
+    if (stringOffsets.empty() || stringOffsets.front() != 0 || stringOffsets.back() > stringBytes.size()) return false;
+    for (std::size_t i = 1; i < stringOffsets.size(); ++i) {
+        if (stringOffsets[i] < stringOffsets[i - 1]) return false;
+    }
+    const std::uint32_t stringCount = static_cast<std::uint32_t>(stringOffsets.size() - 1);
+    const std::size_t objectCount = names.size();
+    if (transforms.size() != objectCount || physics.size() != objectCount || render.size() != objectCount) return false;
+    for (std::size_t i = 0; i < objectCount; ++i) {
+        const RenderRecord& rr = render[i];
+        if (names[i] >= stringCount || rr.meshResource >= stringCount || rr.albedoTexture >= stringCount ||
+            rr.materialName >= stringCount || rr.mesh > static_cast<std::uint32_t>(MeshType::CustomMesh)) {
+            return false;
+        }
+    }
+    for (const ColliderRecord& cr : colliders) {
+        if (cr.object >= objectCount) return false;
+    }
+    for (const LightRecord& lr : lights) {
+        if (lr.name >= stringCount || lr.type > static_cast<std::uint32_t>(LightType::Area)) return false;
+    }
+    const auto string = [&](std::uint32_t index) {
+        return std::string(stringBytes.substr(stringOffsets[index], stringOffsets[index + 1] - stringOffsets[index]));
+    };
+
+    scene.clear();
+    if (!info.empty()) {
+        scene.camera().setPosition(loadVec3(info.front().cameraPosition));
+    }
+
+    const std::vector<GameObject*> created = scene.createObjects(objectCount, MeshType::Cube);
+    auto& registry = scene.registry();
+    for (std::size_t i = 0; i < objectCount; ++i) {
+        GameObject& object = *created[i];
+        registry.get<NameComponent>(object.entity()).value = string(names[i]);
+
+        Transform& t = object.transform();
+        t.position = loadVec3(transforms[i].position);
+        t.rotation = loadVec3(transforms[i].rotation);
+        t.scale = loadVec3(transforms[i].scale);
+
+        const PhysicsRecord& pr = physics[i];
+        PhysicsProperties& p = object.physics();
+        p.mass = pr.mass;
+        p.velocity = loadVec3(pr.velocity);
+        p.angularVelocity = loadVec3(pr.angularVelocity);
+        p.linearDamping = pr.linearDamping;
+        p.angularDamping = pr.angularDamping;
+        p.restitution = pr.restitution;
+        p.staticFriction = pr.staticFriction;
+        p.dynamicFriction = pr.dynamicFriction;
+        p.simulate = pr.simulate != 0;
+
+        const RenderRecord& rr = render[i];
+        RenderComponent& r = object.render();
+        r.mesh = static_cast<MeshType>(rr.mesh);
+        r.meshResource = string(rr.meshResource);
+        r.albedoTexture = string(rr.albedoTexture);
+        r.materialName = string(rr.materialName);
+        r.baseColor = loadVec4(rr.baseColor);
+        r.metallic = rr.metallic;
+        r.roughness = rr.roughness;
+        r.specular = rr.specular;
+        r.emissive = loadVec3(rr.emissive);
+        r.emissiveIntensity = rr.emissiveIntensity;
+        r.opacity = rr.opacity;
+        r.visible = rr.visible != 0;
+    }
+
+    for (const ColliderRecord& cr : colliders) {
+        GameObject& object = *created[cr.object];
+        const PhysicsProperties saved = object.physics();
+        object.enableCollider(loadVec3(cr.halfExtents), cr.isStatic != 0);
+        object.physics().simulate = saved.simulate;
+        object.physics().mass = saved.mass;
+    }
+
+    for (const LightRecord& lr : lights) {
+        LightCreateInfo light;
+        light.name = string(lr.name);
+        light.position = loadVec3(lr.position);
+        light.color = loadVec3(lr.color);
+        light.intensity = lr.intensity;
+        light.type = static_cast<LightType>(lr.type);
+        light.direction = loadVec3(lr.direction);
+        light.range = lr.range;
+        light.innerConeAngle = lr.innerConeAngle;
+        light.outerConeAngle = lr.outerConeAngle;
+        light.areaSize = loadVec2(lr.areaSize);
+        light.up = loadVec3(lr.up);
+        light.enabled = lr.enabled != 0;
+        scene.createLight(light);
+    }
+    return true;
+}
+
+bool SceneSerializer::saveBinaryFile(const Scene& scene, const std::filesystem::path& path) const {
+    const std::vector<std::uint8_t> bytes = serializeBinary(scene);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return file.good();
+}
+
+bool SceneSerializer::loadBinaryFile(Scene& scene, const std::filesystem::path& path, bool memoryMap) const {
+#if defined(VKENGINE_SCENE_MMAP)
+    if (memoryMap) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info {};
+        if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        const auto size = static_cast<std::size_t>(info.st_size);
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) return false;
+        const bool loaded = deserializeBinary(scene, static_cast<const std::uint8_t*>(mapped), size);
+        ::munmap(mapped, size);
+        return loaded;
+    }
+#else
+    (void)memoryMap;
+#endif
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    const std::streamsize size = file.tellg();
+    if (size <= 0) return false;
+    std::vector<std::uint8_t> bytes(static_cast<std::size_t>(size));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), size)) return false;
+    return deserializeBinary(scene, bytes.data(), bytes.size());
+}
+
+} // namespace vkengine
@@ -1,6 +1,8 @@
 #include "engine/Serialization.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
@@ -72,7 +74,12 @@ std::string JsonValue::stringifyImpl(int currentIndent, int indentStep) const {
     } else if (isBool()) {
         oss << (asBool() ? "true" : "false");
     } else if (isNumber()) {
-        oss << std::setprecision(10) << asNumber();
+        // JSON has no infinities (static bodies have infinite mass); they round-trip as null.
+        if (std::isfinite(asNumber())) {
+            oss << std::setprecision(10) << asNumber();
+        } else {
+            oss << "null";
+        }
     } else if (isString()) {
         oss << '"';
         for (char c : asString()) {
@@ -122,9 +129,164 @@ std::string JsonValue::stringify(int indent) const {
     return stringifyImpl(0, indent);
 }
 
-std::shared_ptr<JsonValue> JsonValue::parse(const std::string& /*json*/) {
-    // Simplified stub - full parser would be more complex
-    return std::make_shared<JsonValue>();
+namespace {
+
+// Recursive-descent parser for the subset stringify() writes (plus \uXXXX escapes in the ASCII
+// range). Returns nullptr on malformed input.
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text(text) {}
+
+    std::shared_ptr<JsonValue> parseDocument() {
+        auto result = parseValue();
+        skipWhitespace();
+        return result && pos == text.size() ? result : nullptr;
+    }
+
+private:
+    void skipWhitespace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t')) {
+            ++pos;
+        }
+    }
+
+    bool consume(const char* literal) {
+        const std::size_t length = std::char_traits<char>::length(literal);
+        if (text.compare(pos, length, literal) != 0) return false;
+        pos += length;
+        return true;
+    }
+
+    std::shared_ptr<JsonValue> parseValue() {
+        if (++depth > kMaxDepth) return nullptr;
+        skipWhitespace();
+        std::shared_ptr<JsonValue> result;
+        if (pos >= text.size()) {
+            result = nullptr;
+        } else if (text[pos] == '{') {
+            result = parseObject();
+        } else if (text[pos] == '[') {
+            result = parseArray();
+        } else if (text[pos] == '"') {
+            std::string value;
+            if (parseString(value)) result = json(std::move(value));
+        } else if (consume("true")) {
+            result = json(true);
+        } else if (consume("false")) {
+            result = json(false);
+        } else if (consume("null")) {
+            result = json(nullptr);
+        } else {
+            result = parseNumber();
+        }
+        --depth;
+        return result;
+    }
+
+    std::shared_ptr<JsonValue> parseObject() {
+        ++pos;  // '{'
+        JsonObject object;
+        skipWhitespace();
+        if (pos < text.size() && text[pos] == '}') {
+            ++pos;
+            return json(std::move(object));
+        }
+        while (true) {
+            skipWhitespace();
+            std::string key;
+            if (pos >= text.size() || text[pos] != '"' || !parseString(key)) return nullptr;
+            skipWhitespace();
+            if (pos >= text.size() || text[pos++] != ':') return nullptr;
+            auto value = parseValue();
+            if (!value) return nullptr;
+            object[std::move(key)] = std::move(value);
+            skipWhitespace();
+            if (pos >= text.size()) return nullptr;
+            if (text[pos] == ',') {
+                ++pos;
+            } else if (text[pos++] == '}') {
+                return json(std::move(object));
+            } else {
+                return nullptr;
+            }
+        }
+    }
+
+    std::shared_ptr<JsonValue> parseArray() {
+        ++pos;  // '['
+        JsonArray array;
+        skipWhitespace();
+        if (pos < text.size() && text[pos] == ']') {
+            ++pos;
+            return json(std::move(array));
+        }
+        while (true) {
+            auto value = parseValue();
+            if (!value) return nullptr;
+            array.push_back(std::move(value));
+            skipWhitespace();
+            if (pos >= text.size()) return nullptr;
+            if (text[pos] == ',') {
+                ++pos;
+            } else if (text[pos++] == ']') {
+                return json(std::move(array));
+            } else {
+                return nullptr;
+            }
+        }
+    }
+
+    bool parseString(std::string& out) {
+        ++pos;  // '"'
+        while (pos < text.size()) {
+            const char c = text[pos++];
+            if (c == '"') return true;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= text.size()) return false;
+            switch (text[pos++]) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    if (pos + 4 > text.size()) return false;
+                    const unsigned long code = std::strtoul(text.substr(pos, 4).c_str(), nullptr, 16);
+                    pos += 4;
+                    out += code < 0x80 ? static_cast<char>(code) : '?';
+                    break;
+                }
+                default: return false;
+            }
+        }
+        return false;
+    }
+
+    std::shared_ptr<JsonValue> parseNumber() {
+        const char* begin = text.c_str() + pos;
+        char* end = nullptr;
+        const double value = std::strtod(begin, &end);
+        if (end == begin) return nullptr;
+        pos += static_cast<std::size_t>(end - begin);
+        return json(value);
+    }
+
+    static constexpr int kMaxDepth = 256;
+    const std::string& text;
+    std::size_t pos{0};
+    int depth{0};
+};
+
+} // namespace
+
+std::shared_ptr<JsonValue> JsonValue::parse(const std::string& json) {
+    return JsonParser(json).parseDocument();
 }
 
 // ============================================================================
@@ -212,9 +374,13 @@ Transform deserializeTransform(const JsonValue& v) {
 std::shared_ptr<JsonValue> serializePhysicsProperties(const PhysicsProperties& p) {
     auto obj = std::make_shared<JsonValue>(JsonObject{});
     obj->asObject()["velocity"] = serializeVec3(p.velocity);
+    obj->asObject()["angularVelocity"] = serializeVec3(p.angularVelocity);
     obj->asObject()["mass"] = json(p.mass);
     obj->asObject()["restitution"] = json(p.restitution);
+    obj->asObject()["staticFriction"] = json(p.staticFriction);
+    obj->asObject()["dynamicFriction"] = json(p.dynamicFriction);
     obj->asObject()["simulate"] = json(p.simulate);
+    obj->asObject()["collidable"] = json(p.collidable);
     obj->asObject()["linearDamping"] = json(p.linearDamping);
     obj->asObject()["angularDamping"] = json(p.angularDamping);
     return obj;
@@ -223,36 +389,98 @@ std::shared_ptr<JsonValue> serializePhysicsProperties(const PhysicsProperties& p
 PhysicsProperties deserializePhysicsProperties(const JsonValue& v) {
     PhysicsProperties p;
     if (v.has("velocity")) p.velocity = deserializeVec3(v["velocity"]);
-    if (v.has("mass")) p.mass = v["mass"].asFloat();
+    if (v.has("angularVelocity")) p.angularVelocity = deserializeVec3(v["angularVelocity"]);
+    if (v.has("mass") && v["mass"].isNumber()) p.mass = v["mass"].asFloat();
     if (v.has("restitution")) p.restitution = v["restitution"].asFloat();
+    if (v.has("staticFriction")) p.staticFriction = v["staticFriction"].asFloat();
+    if (v.has("dynamicFriction")) p.dynamicFriction = v["dynamicFriction"].asFloat();
     if (v.has("simulate")) p.simulate = v["simulate"].asBool();
+    if (v.has("collidable")) p.collidable = v["collidable"].asBool();
     if (v.has("linearDamping")) p.linearDamping = v["linearDamping"].asFloat();
     if (v.has("angularDamping")) p.angularDamping = v["angularDamping"].asFloat();
     return p;
 }
 
-std::shared_ptr<JsonValue> serializeCollider(const Collider& /*c*/) {
-    return std::make_shared<JsonValue>(JsonObject{});
-}
-
-Collider deserializeCollider(const JsonValue& /*v*/) {
-    return Collider{};
+std::shared_ptr<JsonValue> serializeCollider(const Collider& c) {
+    auto obj = std::make_shared<JsonValue>(JsonObject{});
+    obj->asObject()["halfExtents"] = serializeVec3(c.halfExtents);
+    obj->asObject()["isStatic"] = json(c.isStatic);
+    return obj;
 }
 
-std::shared_ptr<JsonValue> serializeRenderComponent(const RenderComponent& /*r*/) {
-    return std::make_shared<JsonValue>(JsonObject{});
+Collider deserializeCollider(const JsonValue& v) {
+    Collider c;
+    if (v.has("halfExtents")) c.halfExtents = deserializeVec3(v["halfExtents"]);
+    if (v.has("isStatic")) c.isStatic = v["isStatic"].asBool();
+    return c;
 }
 
-RenderComponent deserializeRenderComponent(const JsonValue& /*v*/) {
-    return RenderComponent{};
+std::shared_ptr<JsonValue> serializeRenderComponent(const RenderComponent& r) {
+    auto obj = std::make_shared<JsonValue>(JsonObject{});
+    obj->asObject()["mesh"] = json(static_cast<int>(r.mesh));
+    obj->asObject()["meshResource"] = json(r.meshResource);
+    obj->asObject()["albedoTexture"] = json(r.albedoTexture);
+    obj->asObject()["baseColor"] = serializeVec4(r.baseColor);
+    obj->asObject()["materialName"] = json(r.materialName);
+    obj->asObject()["metallic"] = json(r.metallic);
+    obj->asObject()["roughness"] = json(r.roughness);
+    obj->asObject()["specular"] = json(r.specular);
+    obj->asObject()["emissive"] = serializeVec3(r.emissive);
+    obj->asObject()["emissiveIntensity"] = json(r.emissiveIntensity);
+    obj->asObject()["opacity"] = json(r.opacity);
+    obj->asObject()["visible"] = json(r.visible);
+    return obj;
 }
 
-std::shared_ptr<JsonValue> serializeLightComponent(const LightComponent& /*l*/) {
-    return std::make_shared<JsonValue>(JsonObject{});
+RenderComponent deserializeRenderComponent(const JsonValue& v) {
+    RenderComponent r;
+    if (v.has("mesh")) r.mesh = static_cast<MeshType>(v["mesh"].asInt());
+    if (v.has("meshResource")) r.meshResource = v["meshResource"].asString();
+    if (v.has("albedoTexture")) r.albedoTexture = v["albedoTexture"].asString();
+    if (v.has("baseColor")) r.baseColor = deserializeVec4(v["baseColor"]);
+    if (v.has("materialName")) r.materialName = v["materialName"].asString();
+    if (v.has("metallic")) r.metallic = v["metallic"].asFloat();
+    if (v.has("roughness")) r.roughness = v["roughness"].asFloat();
+    if (v.has("specular")) r.specular = v["specular"].asFloat();
+    if (v.has("emissive")) r.emissive = deserializeVec3(v["emissive"]);
+    if (v.has("emissiveIntensity")) r.emissiveIntensity = v["emissiveIntensity"].asFloat();
+    if (v.has("opacity")) r.opacity = v["opacity"].asFloat();
+    if (v.has("visible")) r.visible = v["visible"].asBool();
+    return r;
+}
+
+std::shared_ptr<JsonValue> serializeLightComponent(const LightComponent& l) {
+    auto obj = std::make_shared<JsonValue>(JsonObject{});
+    obj->asObject()["name"] = json(l.name);
+    obj->asObject()["position"] = serializeVec3(l.position);
+    obj->asObject()["color"] = serializeVec3(l.color);
+    obj->asObject()["intensity"] = json(l.intensity);
+    obj->asObject()["type"] = json(static_cast<int>(l.type));
+    obj->asObject()["direction"] = serializeVec3(l.direction);
+    obj->asObject()["range"] = json(l.range);
+    obj->asObject()["innerConeAngle"] = json(l.innerConeAngle);
+    obj->asObject()["outerConeAngle"] = json(l.outerConeAngle);
+    obj->asObject()["areaSize"] = serializeVec2(l.areaSize);
+    obj->asObject()["up"] = serializeVec3(l.up);
+    obj->asObject()["enabled"] = json(l.enabled);
+    return obj;
 }
 
-LightComponent deserializeLightComponent(const JsonValue& /*v*/) {
-    return LightComponent{};
+LightComponent deserializeLightComponent(const JsonValue& v) {
+    LightComponent l;
+    if (v.has("name")) l.name = v["name"].asString();
+    if (v.has("position")) l.position = deserializeVec3(v["position"]);
+    if (v.has("color")) l.color = deserializeVec3(v["color"]);
+    if (v.has("intensity")) l.intensity = v["intensity"].asFloat();
+    if (v.has("type")) l.type = static_cast<LightType>(v["type"].asInt());
+    if (v.has("direction")) l.direction = deserializeVec3(v["direction"]);
+    if (v.has("range")) l.range = v["range"].asFloat();
+    if (v.has("innerConeAngle")) l.innerConeAngle = v["innerConeAngle"].asFloat();
+    if (v.has("outerConeAngle")) l.outerConeAngle = v["outerConeAngle"].asFloat();
+    if (v.has("areaSize")) l.areaSize = deserializeVec2(v["areaSize"]);
+    if (v.has("up")) l.up = deserializeVec3(v["up"]);
+    if (v.has("enabled")) l.enabled = v["enabled"].asBool();
+    return l;
 }
 
 std::shared_ptr<JsonValue> serializeMaterial(const Material& /*m*/) {
@@ -325,12 +553,40 @@ bool PrefabLibrary::loadFromFile(const std::filesystem::path& /*path*/) {
 // SceneSerializer Implementation
 // ============================================================================
 
-std::shared_ptr<JsonValue> SceneSerializer::serialize(const Scene& /*scene*/) const {
-    return std::make_shared<JsonValue>(JsonObject{});
+std::shared_ptr<JsonValue> SceneSerializer::serialize(const Scene& scene) const {
+    auto root = std::make_shared<JsonValue>(JsonObject{});
+    auto& obj = root->asObject();
+    obj["version"] = json(static_cast<int>(JsonVersion));
+    obj["cameraPosition"] = serialization::serializeVec3(scene.camera().getPosition());
+
+    auto objects = std::make_shared<JsonValue>(JsonArray{});
+    objects->asArray().reserve(scene.objects().size());
+    for (const auto& object : scene.objects()) {
+        objects->asArray().push_back(serializeGameObject(object));
+    }
+    obj["gameObjects"] = objects;
+
+    auto lights = std::make_shared<JsonValue>(JsonArray{});
+    for (const auto& light : scene.lights()) {
+        lights->asArray().push_back(serializeLight(light));
+    }
+    obj["lights"] = lights;
+    return root;
 }
 
-void SceneSerializer::deserialize(Scene& /*scene*/, const JsonValue& /*data*/) const {
-    // Stub
+void SceneSerializer::deserialize(Scene& scene, const JsonValue& data) const {
+    scene.clear();
+    if (data.has("cameraPosition")) {
+        scene.camera().setPosition(serialization::deserializeVec3(data["cameraPosition"]));
+    }
+    const JsonValue& objects = data["gameObjects"];
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        deserializeGameObject(scene, objects[i]);
+    }
+    const JsonValue& lights = data["lights"];
+    for (std::size_t i = 0; i < lights.size(); ++i) {
+        deserializeLight(scene, lights[i]);
+    }
 }
 
 bool SceneSerializer::saveToFile(const Scene& scene, const std::filesystem::path& path) const {
@@ -346,24 +602,82 @@ bool SceneSerializer::loadFromFile(Scene& scene, const std::filesystem::path& pa
     if (!file.is_open()) return false;
     std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
     auto data = JsonValue::parse(content);
-    if (data) deserialize(scene, *data);
+    if (!data) return false;
+    deserialize(scene, *data);
     return true;
 }
 
-std::shared_ptr<JsonValue> SceneSerializer::serializeGameObject(const GameObject& /*object*/) const {
-    return std::make_shared<JsonValue>(JsonObject{});
-}
-
-void SceneSerializer::deserializeGameObject(Scene& /*scene*/, const JsonValue& /*data*/) const {
-    // Stub
-}
-
-std::shared_ptr<JsonValue> SceneSerializer::serializeLight(const Light& /*light*/) const {
-    return std::make_shared<JsonValue>(JsonObject{});
+std::shared_ptr<JsonValue> SceneSerializer::serializeGameObject(const GameObject& object) const {
+    auto root = std::make_shared<JsonValue>(JsonObject{});
+    auto& obj = root->asObject();
+    obj["name"] = json(object.name());
+    obj["transform"] = serialization::serializeTransform(object.transform());
+    obj["physics"] = serialization::serializePhysicsProperties(object.physics());
+    obj["render"] = serialization::serializeRenderComponent(object.render());
+    if (const Collider* collider = object.collider()) {
+        obj["collider"] = serialization::serializeCollider(*collider);
+    }
+    for (const auto& [typeName, serializer] : customSerializers) {
+        if (auto component = serializer(object)) {
+            (*root)["components"][typeName] = *component;
+        }
+    }
+    return root;
+}
+
+void SceneSerializer::deserializeGameObject(Scene& scene, const JsonValue& data) const {
+    RenderComponent render = serialization::deserializeRenderComponent(data["render"]);
+    GameObject& object = scene.createObject(data.has("name") ? data["name"].asString() : std::string{}, render.mesh);
+    object.render() = std::move(render);
+    object.transform() = serialization::deserializeTransform(data["transform"]);
+    object.physics() = serialization::deserializePhysicsProperties(data["physics"]);
+    if (data.has("collider")) {
+        const bool simulate = object.physics().simulate;
+        const Collider collider = serialization::deserializeCollider(data["collider"]);
+        object.enableCollider(collider.halfExtents, collider.isStatic);
+        object.physics().simulate = simulate;
+    }
+    const JsonValue& components = data["components"];
+    for (const auto& [typeName, deserializer] : customDeserializers) {
+        if (components.has(typeName)) {
+            deserializer(object, components[typeName]);
+        }
+    }
 }
 
-void SceneSerializer::deserializeLight(Scene& /*scene*/, const JsonValue& /*data*/) const {
-    // Stub
+std::shared_ptr<JsonValue> SceneSerializer::serializeLight(const Light& light) const {
+    LightComponent l;
+    l.name = light.name();
+    l.position = light.position();
+    l.color = light.color();
+    l.intensity = light.intensity();
+    l.type = light.type();
+    l.direction = light.direction();
+    l.range = light.range();
+    l.innerConeAngle = light.innerConeAngle();
+    l.outerConeAngle = light.outerConeAngle();
+    l.areaSize = light.areaSize();
+    l.up = light.up();
+    l.enabled = light.isEnabled();
+    return serialization::serializeLightComponent(l);
+}
+
+void SceneSerializer::deserializeLight(Scene& scene, const JsonValue& data) const {
+    const LightComponent l = serialization::deserializeLightComponent(data);
+    LightCreateInfo info;
+    info.name = l.name;
+    info.position = l.position;
+    info.color = l.color;
+    info.intensity = l.intensity;
+    info.type = l.type;
+    info.direction = l.direction;
+    info.range = l.range;
+    info.innerConeAngle = l.innerConeAngle;
+    info.outerConeAngle = l.outerConeAngle;
+    info.areaSize = l.areaSize;
+    info.up = l.up;
+    info.enabled = l.enabled;
+    scene.createLight(info);
 }
 
 void SceneSerializer::registerComponentSerializer(const std::string& typeName, ComponentSerializer serializer) {
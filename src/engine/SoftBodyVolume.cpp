@@ -1,7 +1,5 @@
 #include "engine/SoftBodyVolume.hpp"
 
-#include <glm/gtx/norm.hpp>
-
 #include <algorithm>
 #include <cmath>
 
@@ -17,7 +15,7 @@ SoftBodyVolume::SoftBodyVolume(int sizeX, int sizeY, int sizeZ, float baseSpacin
     , dimZ(std::max(2, sizeZ))
     , spacing(std::max(0.05f, baseSpacing))
 {
-    nodeData.resize(static_cast<std::size_t>(dimX * dimY * dimZ));
+    network.resize(static_cast<std::size_t>(dimX * dimY * dimZ));
 
     const glm::vec3 halfExtent{
         (static_cast<float>(dimX) - 1.0f) * spacing * 0.5f,
@@ -28,14 +26,11 @@ SoftBodyVolume::SoftBodyVolume(int sizeX, int sizeY, int sizeZ, float baseSpacin
     for (int z = 0; z < dimZ; ++z) {
         for (int y = 0; y < dimY; ++y) {
             for (int x = 0; x < dimX; ++x) {
-                const std::size_t idx = index(x, y, z);
-                nodeData[idx].position = glm::vec3{
+                network.setPosition(index(x, y, z), glm::vec3{
                     x * spacing - halfExtent.x,
                     y * spacing - halfExtent.y,
                     z * spacing - halfExtent.z
-                };
-                nodeData[idx].velocity = glm::vec3(0.0f);
-                nodeData[idx].pinned = false;
+                });
             }
         }
     }
@@ -74,6 +69,7 @@ SoftBodyVolume::SoftBodyVolume(int sizeX, int sizeY, int sizeZ, float baseSpacin
     }
 
     buildSurfaceMesh();
+    network.setTriangles(meshIndices);
 }
 
 void SoftBodyVolume::pinLayerY(int layer, bool value) noexcept
@@ -83,20 +79,20 @@ void SoftBodyVolume::pinLayerY(int layer, bool value) noexcept
     }
     for (int z = 0; z < dimZ; ++z) {
         for (int x = 0; x < dimX; ++x) {
-            nodeData[index(x, layer, z)].pinned = value;
+            network.setPinned(index(x, layer, z), value);
         }
     }
 }
 
 void SoftBodyVolume::addImpulse(const glm::vec3& impulse) noexcept
 {
-    if (nodeData.empty()) {
+    if (network.size() == 0) {
         return;
     }
-    const glm::vec3 perNodeImpulse = impulse / static_cast<float>(nodeData.size());
-    for (auto& node : nodeData) {
-        if (!node.pinned) {
-            node.velocity += perNodeImpulse;
+    const glm::vec3 perNodeImpulse = impulse / static_cast<float>(network.size());
+    for (std::size_t i = 0; i < network.size(); ++i) {
+        if (!network.pinned(i)) {
+            network.setVelocity(i, network.velocity(i) + perNodeImpulse);
         }
     }
 }
@@ -105,57 +101,27 @@ void SoftBodyVolume::addSpring(int ax, int ay, int az, int bx, int by, int bz, f
 {
     const std::size_t ia = index(ax, ay, az);
     const std::size_t ib = index(bx, by, bz);
-    const glm::vec3 delta = nodeData[ib].position - nodeData[ia].position;
-    const float rest = std::max(MIN_LENGTH, glm::length(delta));
-    springs.push_back(Spring{ia, ib, rest, stiffness * stiffnessScale});
+    const float rest = std::max(MIN_LENGTH, glm::length(network.position(ib) - network.position(ia)));
+    network.addSpring(ia, ib, rest, stiffness * stiffnessScale);
 }
 
 void SoftBodyVolume::simulate(float deltaSeconds, const glm::vec3& gravity) noexcept
 {
-    if (deltaSeconds <= 0.0f || nodeData.empty()) {
+    if (deltaSeconds <= 0.0f || network.size() == 0) {
         return;
     }
 
-    const float dt = std::min(deltaSeconds, MAX_DT);
-    std::vector<glm::vec3> accelerations(nodeData.size(), gravity);
-
-    for (const Spring& spring : springs) {
-        const Node& a = nodeData[spring.a];
-        const Node& b = nodeData[spring.b];
-        glm::vec3 delta = b.position - a.position;
-        float length = glm::length(delta);
-        if (length < MIN_LENGTH) {
-            continue;
-        }
-        glm::vec3 dir = delta / length;
-        float stretch = length - spring.restLength;
-        glm::vec3 force = spring.stiffness * stretch * dir;
-        if (!a.pinned) {
-            accelerations[spring.a] += force / massPerNode;
-        }
-        if (!b.pinned) {
-            accelerations[spring.b] -= force / massPerNode;
-        }
-    }
-
-    for (std::size_t i = 0; i < nodeData.size(); ++i) {
-        Node& node = nodeData[i];
-        if (node.pinned) {
-            node.velocity = glm::vec3(0.0f);
-            continue;
-        }
-
-        glm::vec3 accel = accelerations[i] - damping * node.velocity;
-        node.velocity += accel * dt;
-        node.position += node.velocity * dt;
-
-        if (node.position.y < floorY) {
-            node.position.y = floorY;
-            if (node.velocity.y < 0.0f) {
-                node.velocity.y *= -0.3f;
-            }
-        }
-    }
+    MassSpringSystem::StepParams params;
+    params.gravity = gravity;
+    params.deltaSeconds = std::min(deltaSeconds, MAX_DT);
+    params.massPerNode = massPerNode;
+    params.damping = damping;
+    params.velocityRetention = 1.0f;
+    params.minSpringLength = MIN_LENGTH;
+    params.floorY = floorY;
+    params.floorRestitution = 0.3f;
+    params.floorUpwardRetention = 1.0f;
+    network.step(params);
 }
 
 void SoftBodyVolume::buildSurfaceMesh()
@@ -216,29 +182,7 @@ void SoftBodyVolume::buildSurfaceMesh()
 
 void SoftBodyVolume::computeVertexNormals(std::vector<glm::vec3>& outNormals) const
 {
-    outNormals.assign(nodeData.size(), glm::vec3(0.0f));
-    for (std::size_t i = 0; i + 2 < meshIndices.size(); i += 3) {
-        const uint32_t ia = meshIndices[i];
-        const uint32_t ib = meshIndices[i + 1];
-        const uint32_t ic = meshIndices[i + 2];
-        const glm::vec3& a = nodeData[ia].position;
-        const glm::vec3& b = nodeData[ib].position;
-        const glm::vec3& c = nodeData[ic].position;
-        glm::vec3 normal = glm::cross(b - a, c - a);
-        if (glm::length2(normal) < MIN_LENGTH) {
-            continue;
-        }
-        outNormals[ia] += normal;
-        outNormals[ib] += normal;
-        outNormals[ic] += normal;
-    }
-    for (auto& normal : outNormals) {
-        if (glm::length2(normal) > MIN_LENGTH) {
-            normal = glm::normalize(normal);
-        } else {
-            normal = glm::vec3(0.0f, 1.0f, 0.0f);
-        }
-    }
+    network.computeVertexNormals(MIN_LENGTH, outNormals);
 }
 
 } // namespace vkengine
@@ -1,16 +1,106 @@
 #include "engine/assets/MeshLoader.hpp"
 
+#include "core/ParallelFor.hpp"
+
 #include <glm/gtx/norm.hpp>
 
+#include <algorithm>
 #include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <limits>
-#include <sstream>
 #include <stdexcept>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VKENGINE_MESH_MMAP 1
+#endif
 
 namespace vkengine {
 namespace {
 
+constexpr std::size_t kStlHeaderSize = 84;
+constexpr std::size_t kStlTriangleSize = 50;
+// Work granularity for the parallel passes: triangles per chunk for binary STL and per-face
+// work, bytes per chunk for ASCII STL.
+constexpr std::size_t kTrianglesPerChunk = 16384;
+constexpr std::size_t kAsciiBytesPerChunk = std::size_t{1} << 20;
+
+struct StlTriangle {
+    glm::vec3 normal{0.0f};
+    std::array<glm::vec3, 3> verts{};
+};
+
+// Read-only view of a whole file: a private mapping where available, otherwise a single read.
+class FileView {
+public:
+    explicit FileView(const std::filesystem::path& path)
+    {
+#if defined(VKENGINE_MESH_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open STL file: " + path.string());
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat STL file: " + path.string());
+        }
+        length = static_cast<std::size_t>(info.st_size);
+        if (length > 0) {
+            void* view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) {
+                ::posix_madvise(view, length, POSIX_MADV_WILLNEED);
+                bytes = static_cast<const std::uint8_t*>(view);
+                mapped = true;
+            }
+        }
+        ::close(fd);
+        if (mapped || length == 0) {
+            return;
+        }
+#endif
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        if (!stream) {
+            throw std::runtime_error("Failed to open STL file: " + path.string());
+        }
+        buffer.resize(static_cast<std::size_t>(stream.tellg()));
+        stream.seekg(0);
+        if (!stream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
+            throw std::runtime_error("Failed to read STL file: " + path.string());
+        }
+        bytes = buffer.data();
+        length = buffer.size();
+    }
+
+    ~FileView()
+    {
+#if defined(VKENGINE_MESH_MMAP)
+        if (mapped) {
+            ::munmap(const_cast<std::uint8_t*>(bytes), length);
+        }
+#endif
+    }
+
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+
+    [[nodiscard]] const std::uint8_t* data() const { return bytes; }
+    [[nodiscard]] std::size_t size() const { return length; }
+
+private:
+    const std::uint8_t* bytes = nullptr;
+    std::size_t length = 0;
+    bool mapped = false;
+    std::vector<std::uint8_t> buffer;
+};
+
 glm::vec2 computePlanarUV(const glm::vec3& normal, const glm::vec3& position)
 {
     const glm::vec3 absNormal = glm::abs(normal);
@@ -23,162 +113,328 @@ glm::vec2 computePlanarUV(const glm::vec3& normal, const glm::vec3& position)
     return {position.x, position.y};
 }
 
-void appendTriangle(MeshData& mesh, const glm::vec3& rawNormal,
-                    const std::array<glm::vec3, 3>& verts)
+glm::vec3 faceNormal(const StlTriangle& triangle)
 {
-    glm::vec3 normal = rawNormal;
-    if (glm::length2(normal) < 1e-8f) {
-        normal = glm::normalize(glm::cross(verts[1] - verts[0], verts[2] - verts[0]));
-    } else {
-        normal = glm::normalize(normal);
+    if (glm::length2(triangle.normal) >= 1e-8f) {
+        return glm::normalize(triangle.normal);
     }
+    const glm::vec3 cross =
+        glm::cross(triangle.verts[1] - triangle.verts[0], triangle.verts[2] - triangle.verts[0]);
+    const float lengthSquared = glm::length2(cross);
+    return lengthSquared > 0.0f ? cross / std::sqrt(lengthSquared) : glm::vec3(0.0f, 1.0f, 0.0f);
+}
 
-    for (const auto& position : verts) {
-        MeshVertex vertex{};
-        vertex.position = position;
-        vertex.normal = normal;
-        vertex.uv = computePlanarUV(normal, position);
-        mesh.vertices.push_back(vertex);
-        mesh.indices.push_back(static_cast<std::uint32_t>(mesh.vertices.size() - 1));
-
-        mesh.boundsMin = glm::min(mesh.boundsMin, position);
-        mesh.boundsMax = glm::max(mesh.boundsMax, position);
+// Binary STL is a size-exact 84-byte header plus 50-byte records; anything else is read as ASCII.
+bool isBinaryStl(const std::uint8_t* data, std::size_t size)
+{
+    if (size < kStlHeaderSize) {
+        return false;
     }
+    std::uint32_t triangleCount = 0;
+    std::memcpy(&triangleCount, data + 80, sizeof(triangleCount));
+    return size == kStlHeaderSize + static_cast<std::size_t>(triangleCount) * kStlTriangleSize;
 }
 
-MeshData parseBinaryStl(std::ifstream& stream, std::uint32_t triangleCount)
+std::vector<StlTriangle> decodeBinaryStl(const std::uint8_t* data, std::size_t size)
 {
-    MeshData mesh{};
-    mesh.boundsMin = glm::vec3(std::numeric_limits<float>::max());
-    mesh.boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
-    mesh.vertices.reserve(static_cast<size_t>(triangleCount) * 3);
-    mesh.indices.reserve(static_cast<size_t>(triangleCount) * 3);
+    const std::size_t triangleCount = (size - kStlHeaderSize) / kStlTriangleSize;
+    std::vector<StlTriangle> triangles(triangleCount);
+    core::parallelForRange(triangleCount, kTrianglesPerChunk, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            // Records are 50 bytes, so the floats are unaligned after the first one.
+            std::array<float, 12> floats{};
+            std::memcpy(floats.data(), data + kStlHeaderSize + i * kStlTriangleSize, sizeof(floats));
+            StlTriangle& triangle = triangles[i];
+            triangle.normal = {floats[0], floats[1], floats[2]};
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+                triangle.verts[corner] = {floats[3 + corner * 3], floats[4 + corner * 3], floats[5 + corner * 3]};
+            }
+        }
+    });
+    return triangles;
+}
 
-    stream.seekg(84, std::ios::beg);
-    for (std::uint32_t i = 0; i < triangleCount; ++i) {
-        std::array<float, 3> normalFloats{};
-        stream.read(reinterpret_cast<char*>(normalFloats.data()), sizeof(float) * 3);
-        glm::vec3 normal{normalFloats[0], normalFloats[1], normalFloats[2]};
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
 
-        std::array<glm::vec3, 3> verts{};
-        for (auto& vert : verts) {
-            std::array<float, 3> coords{};
-            stream.read(reinterpret_cast<char*>(coords.data()), sizeof(float) * 3);
-            vert = {coords[0], coords[1], coords[2]};
+class AsciiCursor {
+public:
+    AsciiCursor(const char* begin, const char* end) : at(begin), end(end) {}
+
+    std::string_view nextToken()
+    {
+        skipSpace();
+        const char* start = at;
+        while (at < end && !isSpace(*at)) {
+            ++at;
         }
+        return {start, static_cast<std::size_t>(at - start)};
+    }
 
-        std::uint16_t attributeByteCount = 0;
-        stream.read(reinterpret_cast<char*>(&attributeByteCount), sizeof(attributeByteCount));
-        (void)attributeByteCount;
+    bool nextVec3(glm::vec3& out)
+    {
+        return nextFloat(out.x) && nextFloat(out.y) && nextFloat(out.z);
+    }
 
-        appendTriangle(mesh, normal, verts);
+private:
+    bool nextFloat(float& out)
+    {
+        skipSpace();
+        if (at < end && *at == '+') {
+            ++at;  // from_chars rejects an explicit plus sign.
+        }
+        const auto [next, error] = std::from_chars(at, end, out);
+        if (error != std::errc{}) {
+            nextToken();
+            return false;
+        }
+        at = next;
+        return true;
     }
 
-    if (mesh.vertices.empty()) {
-        mesh.boundsMin = glm::vec3(0.0f);
-        mesh.boundsMax = glm::vec3(0.0f);
+    void skipSpace()
+    {
+        while (at < end && isSpace(*at)) {
+            ++at;
+        }
     }
-    return mesh;
-}
 
-MeshData parseAsciiStl(std::ifstream& stream)
-{
-    MeshData mesh{};
-    mesh.boundsMin = glm::vec3(std::numeric_limits<float>::max());
-    mesh.boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+    const char* at;
+    const char* end;
+};
 
-    std::string line;
-    glm::vec3 currentNormal{0.0f, 1.0f, 0.0f};
-    std::array<glm::vec3, 3> verts{};
+// Facets with unparsable numbers are dropped rather than emitted with garbage corners.
+void parseAsciiRange(const char* begin, const char* end, std::vector<StlTriangle>& triangles)
+{
+    AsciiCursor cursor(begin, end);
+    StlTriangle current{};
+    current.normal = glm::vec3(0.0f, 1.0f, 0.0f);
     std::size_t vertIndex = 0;
+    bool valid = true;
 
-    while (std::getline(stream, line)) {
-        if (line.empty()) {
-            continue;
-        }
-        std::stringstream ss(line);
-        std::string token;
-        ss >> token;
+    for (std::string_view token = cursor.nextToken(); !token.empty(); token = cursor.nextToken()) {
         if (token == "facet") {
-            std::string normalKeyword;
-            ss >> normalKeyword;
-            ss >> currentNormal.x >> currentNormal.y >> currentNormal.z;
+            cursor.nextToken();  // "normal"
+            valid = cursor.nextVec3(current.normal);
             vertIndex = 0;
         } else if (token == "vertex") {
             if (vertIndex >= 3) {
                 continue;
             }
-            ss >> verts[vertIndex].x >> verts[vertIndex].y >> verts[vertIndex].z;
-            ++vertIndex;
-            if (vertIndex == 3) {
-                appendTriangle(mesh, currentNormal, verts);
+            valid = cursor.nextVec3(current.verts[vertIndex]) && valid;
+            if (++vertIndex == 3) {
+                if (valid) {
+                    triangles.push_back(current);
+                }
                 vertIndex = 0;
             }
         }
     }
+}
 
-    if (mesh.vertices.empty()) {
-        mesh.boundsMin = glm::vec3(0.0f);
-        mesh.boundsMax = glm::vec3(0.0f);
+// Start of the first "facet" keyword at or after `from` ("endfacet" does not count).
+std::size_t nextFacetStart(std::string_view text, std::size_t from)
+{
+    for (std::size_t at = text.find("facet", from); at != std::string_view::npos; at = text.find("facet", at + 1)) {
+        if (at == 0 || isSpace(text[at - 1])) {
+            return at;
+        }
     }
-    return mesh;
+    return text.size();
 }
 
-bool isAsciiStl(const std::filesystem::path& path)
+// Splits the text at facet boundaries so every chunk holds whole facets, parses the chunks in
+// parallel and concatenates them in file order.
+std::vector<StlTriangle> parseAsciiStl(const char* data, std::size_t size)
 {
-    std::ifstream stream(path, std::ios::binary);
-    if (!stream) {
-        throw std::runtime_error("Failed to open STL file: " + path.string());
+    const std::string_view text(data, size);
+    const std::size_t chunkCount = std::max<std::size_t>(1, size / kAsciiBytesPerChunk);
+    std::vector<std::size_t> bounds(chunkCount + 1, size);
+    bounds[0] = 0;
+    for (std::size_t chunk = 1; chunk < chunkCount; ++chunk) {
+        bounds[chunk] = nextFacetStart(text, std::max(bounds[chunk - 1], chunk * size / chunkCount));
     }
 
-    std::array<char, 80> header{};
-    stream.read(header.data(), header.size());
-    if (!stream) {
-        throw std::runtime_error("Failed to read STL header: " + path.string());
+    std::vector<std::vector<StlTriangle>> chunkTriangles(chunkCount);
+    core::parallelFor(chunkCount, 1, [&](std::size_t chunk) {
+        // A facet in typical exporter formatting takes roughly 250 bytes.
+        chunkTriangles[chunk].reserve((bounds[chunk + 1] - bounds[chunk]) / 200);
+        parseAsciiRange(data + bounds[chunk], data + bounds[chunk + 1], chunkTriangles[chunk]);
+    });
+
+    std::vector<std::size_t> offsets(chunkCount + 1, 0);
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        offsets[chunk + 1] = offsets[chunk] + chunkTriangles[chunk].size();
+    }
+    if (chunkCount == 1) {
+        return std::move(chunkTriangles[0]);
     }
+    std::vector<StlTriangle> triangles(offsets[chunkCount]);
+    core::parallelFor(chunkCount, 1, [&](std::size_t chunk) {
+        std::copy(chunkTriangles[chunk].begin(), chunkTriangles[chunk].end(), triangles.begin() + offsets[chunk]);
+    });
+    return triangles;
+}
 
-    std::uint32_t triangleCount = 0;
-    stream.read(reinterpret_cast<char*>(&triangleCount), sizeof(triangleCount));
-    if (!stream) {
-        throw std::runtime_error("Failed to read STL triangle count: " + path.string());
+// Hash grid over quantized positions. Corners that land in the same weldTolerance-sized cell
+// and whose face normals agree within the crease angle share one output vertex; the table is
+// sized up front for every corner, so it never rehashes.
+class VertexWelder {
+public:
+    VertexWelder(MeshData& mesh, std::size_t cornerCount, const MeshLoadOptions& options)
+        : mesh(mesh),
+          inverseCellSize(1.0 / std::max(static_cast<double>(options.weldTolerance), 1e-9)),
+          // Faces that are exactly coplanar can still differ in the last bit of their normals.
+          minNormalDot(std::min(std::cos(glm::radians(std::max(options.creaseAngleDegrees, 0.0f))), 0.99999f))
+    {
+        std::size_t capacity = 16;
+        while (capacity < cornerCount * 2) {
+            capacity *= 2;
+        }
+        slots.assign(capacity, kEmpty);
+        mask = capacity - 1;
+        mesh.vertices.reserve(cornerCount / 2);
+        cells.reserve(cornerCount / 2);
+        faceNormals.reserve(cornerCount / 2);
+        normalSums.reserve(cornerCount / 2);
     }
 
-    stream.seekg(0, std::ios::end);
-    const std::streamoff fileSize = stream.tellg();
-    const std::streamoff expectedSize = 84 + static_cast<std::streamoff>(triangleCount) * 50;
-    return fileSize != expectedSize;
-}
+    std::uint32_t add(const glm::vec3& position, const glm::vec3& normal)
+    {
+        const Cell cell = cellOf(position);
+        std::size_t slot = hashCell(cell) & mask;
+        for (; slots[slot] != kEmpty; slot = (slot + 1) & mask) {
+            const std::uint32_t candidate = slots[slot];
+            if (cells[candidate] == cell && glm::dot(faceNormals[candidate], normal) >= minNormalDot) {
+                normalSums[candidate] += normal;
+                return candidate;
+            }
+        }
 
-} // namespace
+        const auto index = static_cast<std::uint32_t>(mesh.vertices.size());
+        slots[slot] = index;
+        MeshVertex vertex{};
+        vertex.position = position;
+        mesh.vertices.push_back(vertex);
+        cells.push_back(cell);
+        faceNormals.push_back(normal);
+        normalSums.push_back(normal);
+        return index;
+    }
 
-MeshData loadStlMesh(const std::filesystem::path& path)
-{
-    if (!std::filesystem::exists(path)) {
-        throw std::runtime_error("STL file does not exist: " + path.string());
+    // Resolves the accumulated normals and the UVs that depend on them.
+    void finish()
+    {
+        core::parallelForRange(mesh.vertices.size(), kTrianglesPerChunk, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                MeshVertex& vertex = mesh.vertices[i];
+                const float lengthSquared = glm::length2(normalSums[i]);
+                vertex.normal = lengthSquared > 0.0f ? normalSums[i] / std::sqrt(lengthSquared) : faceNormals[i];
+                vertex.uv = computePlanarUV(vertex.normal, vertex.position);
+            }
+        });
     }
 
-    if (isAsciiStl(path)) {
-        std::ifstream stream(path);
-        if (!stream) {
-            throw std::runtime_error("Failed to open STL file: " + path.string());
+private:
+    using Cell = std::array<std::int64_t, 3>;
+    static constexpr std::uint32_t kEmpty = std::numeric_limits<std::uint32_t>::max();
+
+    Cell cellOf(const glm::vec3& position) const
+    {
+        return {static_cast<std::int64_t>(std::floor(static_cast<double>(position.x) * inverseCellSize)),
+                static_cast<std::int64_t>(std::floor(static_cast<double>(position.y) * inverseCellSize)),
+                static_cast<std::int64_t>(std::floor(static_cast<double>(position.z) * inverseCellSize))};
+    }
+
+    static std::size_t hashCell(const Cell& cell)
+    {
+        std::uint64_t hash = static_cast<std::uint64_t>(cell[0]) * 0x9E3779B185EBCA87ull;
+        hash ^= static_cast<std::uint64_t>(cell[1]) * 0xC2B2AE3D27D4EB4Full;
+        hash ^= static_cast<std::uint64_t>(cell[2]) * 0x165667B19E3779F9ull;
+        return static_cast<std::size_t>(hash ^ (hash >> 29));
+    }
+
+    MeshData& mesh;
+    double inverseCellSize;
+    float minNormalDot;
+    std::vector<std::uint32_t> slots;
+    std::size_t mask = 0;
+    std::vector<Cell> cells;
+    std::vector<glm::vec3> faceNormals;
+    std::vector<glm::vec3> normalSums;
+};
+
+MeshData buildMesh(const std::vector<StlTriangle>& triangles, const MeshLoadOptions& options)
+{
+    MeshData mesh{};
+    const std::size_t cornerCount = triangles.size() * 3;
+    std::vector<glm::vec3> normals(triangles.size());
+    core::parallelForRange(triangles.size(), kTrianglesPerChunk, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            normals[i] = faceNormal(triangles[i]);
+        }
+    });
+
+    if (options.weldVertices) {
+        VertexWelder welder(mesh, cornerCount, options);
+        mesh.indices.resize(cornerCount);
+        for (std::size_t i = 0; i < triangles.size(); ++i) {
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+                mesh.indices[i * 3 + corner] = welder.add(triangles[i].verts[corner], normals[i]);
+            }
         }
-        return parseAsciiStl(stream);
+        welder.finish();
+    } else {
+        mesh.vertices.resize(cornerCount);
+        mesh.indices.resize(cornerCount);
+        core::parallelForRange(triangles.size(), kTrianglesPerChunk, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                for (std::size_t corner = 0; corner < 3; ++corner) {
+                    MeshVertex& vertex = mesh.vertices[i * 3 + corner];
+                    vertex.position = triangles[i].verts[corner];
+                    vertex.normal = normals[i];
+                    vertex.uv = computePlanarUV(normals[i], vertex.position);
+                    mesh.indices[i * 3 + corner] = static_cast<std::uint32_t>(i * 3 + corner);
+                }
+            }
+        });
     }
 
-    std::ifstream stream(path, std::ios::binary);
-    if (!stream) {
-        throw std::runtime_error("Failed to open STL file: " + path.string());
+    if (mesh.vertices.empty()) {
+        return mesh;
+    }
+    mesh.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+    mesh.boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+    for (const MeshVertex& vertex : mesh.vertices) {
+        mesh.boundsMin = glm::min(mesh.boundsMin, vertex.position);
+        mesh.boundsMax = glm::max(mesh.boundsMax, vertex.position);
     }
+    return mesh;
+}
 
-    std::array<char, 80> header{};
-    stream.read(header.data(), header.size());
-    std::uint32_t triangleCount = 0;
-    stream.read(reinterpret_cast<char*>(&triangleCount), sizeof(triangleCount));
-    if (!stream) {
-        throw std::runtime_error("Invalid STL binary header: " + path.string());
+} // namespace
+
+MeshData parseStlMesh(const std::uint8_t* data, std::size_t size, const MeshLoadOptions& options)
+{
+    if (size == 0) {
+        return {};
+    }
+    if (isBinaryStl(data, size)) {
+        return buildMesh(decodeBinaryStl(data, size), options);
+    }
+    return buildMesh(parseAsciiStl(reinterpret_cast<const char*>(data), size), options);
+}
+
+MeshData loadStlMesh(const std::filesystem::path& path, const MeshLoadOptions& options)
+{
+    if (!std::filesystem::exists(path)) {
+        throw std::runtime_error("STL file does not exist: " + path.string());
     }
 
-    return parseBinaryStl(stream, triangleCount);
+    const FileView file(path);
+    return parseStlMesh(file.data(), file.size(), options);
 }
 
 } // namespace vkengine
@@ -2,15 +2,36 @@
 
 
 #include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
 #include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "core/ParallelFor.hpp"
+#include "engine/DebugTools.hpp"
 #include "engine/GameEngine.hpp"
+#include "engine/JobScheduler.hpp"
+#include "engine/Network.hpp"
+#include "engine/Serialization.hpp"
+#include "engine/assets/MeshLoader.hpp"
 
 namespace {
 
@@ -30,6 +51,76 @@ TEST(GameEngineTests, CameraDefaultsAreReasonable) {
     EXPECT_GT(glm::length(camera.getPosition()), 0.0f);
 }
 
+TEST(GameEngineTests, FixedTimestepDecouplesSimulationFromFrameRate) {
+    const auto addBody = [](vkengine::GameEngine& engine) -> vkengine::GameObject& {
+        auto& body = engine.scene().createObject("Body", vkengine::MeshType::Cube);
+        body.physics().simulate = true;
+        body.physics().velocity = glm::vec3(3.0f, 4.0f, 0.0f);
+        body.physics().angularVelocity = glm::vec3(0.0f, 0.0f, 2.0f);
+        return body;
+    };
+
+    // The same number of ticks gives the same state whatever the frame pacing.
+    vkengine::GameEngine steady;
+    vkengine::GameEngine jittery;
+    auto& steadyBody = addBody(steady);
+    auto& jitteryBody = addBody(jittery);
+    for (int frame = 0; frame < 60; ++frame) {
+        steady.update(1.0f / 60.0f);
+        EXPECT_EQ(steady.ticksLastUpdate(), 1);
+    }
+    constexpr std::array<float, 5> kJitter{0.004f, 0.031f, 0.0125f, 0.0005f, 0.022f};
+    for (std::size_t frame = 0; jittery.tickCount() < steady.tickCount(); ++frame) {
+        jittery.update(kJitter[frame % kJitter.size()]);
+    }
+    ASSERT_EQ(steady.tickCount(), 60u);
+    ASSERT_EQ(jittery.tickCount(), 60u);
+    EXPECT_EQ(steadyBody.transform().position.x, jitteryBody.transform().position.x);
+    EXPECT_EQ(steadyBody.transform().position.y, jitteryBody.transform().position.y);
+    EXPECT_EQ(steadyBody.transform().rotation.z, jitteryBody.transform().rotation.z);
+
+    // Rendering blends the last two ticks by the time left in the accumulator.
+    vkengine::GameEngine engine;
+    auto& body = addBody(engine);
+    engine.update(1.5f * engine.fixedDeltaSeconds());
+    EXPECT_EQ(engine.ticksLastUpdate(), 1);
+    EXPECT_NEAR(engine.interpolationAlpha(), 0.5f, 1.0e-3f);
+    const auto* interpolated = engine.scene().registry().tryGet<vkengine::InterpolatedTransform>(body.entity());
+    ASSERT_NE(interpolated, nullptr);
+    const glm::vec3 previous = interpolated->previous.position;
+    const glm::vec3 current = body.transform().position;
+    EXPECT_GT(current.x, previous.x);
+    const glm::vec3 expected = previous + (current - previous) * engine.interpolationAlpha();
+    EXPECT_NEAR(interpolated->render.position.x, expected.x, 1.0e-5f);
+    EXPECT_NEAR(interpolated->render.position.y, expected.y, 1.0e-5f);
+    const glm::mat4 model = body.modelMatrix();
+    const glm::mat4 blended = interpolated->render.matrix();
+    for (int column = 0; column < 4; ++column) {
+        for (int row = 0; row < 4; ++row) {
+            EXPECT_EQ(model[column][row], blended[column][row]);
+        }
+    }
+    EXPECT_NEAR(interpolated->render.rotation.z,
+                interpolated->previous.rotation.z +
+                    (body.transform().rotation.z - interpolated->previous.rotation.z) * engine.interpolationAlpha(),
+                1.0e-5f);
+
+    // A long stall runs at most the catch-up budget and drops the rest.
+    engine.update(1.0f);
+    EXPECT_EQ(engine.ticksLastUpdate(), engine.fixedTimestep().maxTicksPerUpdate);
+    EXPECT_NEAR(engine.droppedSimulationSeconds(),
+                1.0 - engine.fixedTimestep().maxTicksPerUpdate / 60.0 + 0.5 / 60.0, 1.0e-3);
+
+    // Without interpolation objects draw at their live transform.
+    vkengine::FixedTimestepSettings settings = engine.fixedTimestep();
+    settings.tickRate = 120.0f;
+    settings.interpolate = false;
+    engine.setFixedTimestep(settings);
+    engine.update(1.0f / 240.0f);
+    EXPECT_EQ(engine.scene().registry().tryGet<vkengine::InterpolatedTransform>(body.entity()), nullptr);
+    EXPECT_EQ(body.modelMatrix()[3].x, body.transform().matrix()[3].x);
+}
+
 TEST(SceneTests, CreateObjectAssignsDefaults) {
     vkengine::Scene scene;
     auto& object = scene.createObject("", vkengine::MeshType::Cube);
@@ -119,6 +210,1482 @@ TEST(GameObjectTests, MeshResourceSwitchesToCustomMesh) {
     EXPECT_EQ(object.meshResource(), "assets/models/actor.gltf");
 }
 
+TEST(RegistryTests, RemoveKeepsRemainingComponentsAddressable) {
+    core::ecs::Registry registry;
+    std::vector<core::ecs::Entity> entities;
+    for (int i = 0; i < 64; ++i) {
+        auto entity = registry.createEntity();
+        registry.emplace<vkengine::NameComponent>(entity, vkengine::NameComponent{std::to_string(i)});
+        entities.push_back(entity);
+    }
+
+    for (std::size_t i = 0; i < entities.size(); i += 2) {
+        registry.remove<vkengine::NameComponent>(entities[i]);
+    }
+
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        const auto* name = registry.tryGet<vkengine::NameComponent>(entities[i]);
+        if (i % 2 == 0) {
+            EXPECT_EQ(name, nullptr);
+        } else {
+            ASSERT_NE(name, nullptr);
+            EXPECT_EQ(name->value, std::to_string(i));
+        }
+    }
+}
+
+TEST(RegistryTests, ViewVisitsOnlyEntitiesWithAllComponents) {
+    core::ecs::Registry registry;
+    for (int i = 0; i < 30; ++i) {
+        auto entity = registry.createEntity();
+        registry.emplace<vkengine::Transform>(entity);
+        if (i % 3 == 0) {
+            registry.emplace<vkengine::NameComponent>(entity, vkengine::NameComponent{std::to_string(i)});
+        }
+    }
+
+    std::size_t visited = 0;
+    registry.view<vkengine::Transform, vkengine::NameComponent>(
+        [&](core::ecs::Entity entity, vkengine::Transform& transform, vkengine::NameComponent& name) {
+            EXPECT_TRUE(registry.has<vkengine::NameComponent>(entity));
+            EXPECT_EQ(transform.scale, glm::vec3(1.0f));
+            EXPECT_FALSE(name.value.empty());
+            ++visited;
+        });
+    EXPECT_EQ(visited, 10u);
+}
+
+TEST(RegistryTests, ParallelViewVisitsEachMatchingEntityOnce) {
+    vkengine::JobSystem::instance().initialize(4);
+    core::ecs::Registry registry;
+    constexpr std::size_t kCount = 3000;
+    std::vector<core::ecs::Entity> entities;
+    for (std::size_t i = 0; i < kCount; ++i) {
+        entities.push_back(registry.createEntity());
+    }
+    // Transforms in creation order on two entities out of three; names on the even ones, added
+    // back to front and then thinned out, so the name pool is sparse and out of entity order.
+    for (std::size_t i = 0; i < kCount; ++i) {
+        if (i % 3 != 0) {
+            registry.emplace<vkengine::Transform>(entities[i]);
+        }
+    }
+    for (std::size_t i = kCount; i-- > 0;) {
+        if (i % 2 == 0) {
+            registry.emplace<vkengine::NameComponent>(entities[i], vkengine::NameComponent{std::to_string(i)});
+        }
+    }
+    for (std::size_t i = 0; i < kCount; i += 10) {
+        registry.remove<vkengine::NameComponent>(entities[i]);
+    }
+    for (std::size_t i = 0; i < kCount; i += 7) {
+        if (i % 3 != 0) {
+            registry.remove<vkengine::Transform>(entities[i]);
+        }
+    }
+    const auto matches = [&](std::size_t i, bool needsName) {
+        return i % 3 != 0 && (i % 7 != 0) && (!needsName || (i % 2 == 0 && i % 10 != 0));
+    };
+
+    // Small chunks put many chunk boundaries through both pools.
+    for (const std::size_t chunkSize : {std::size_t{7}, std::size_t{64}, std::size_t{0}}) {
+        std::vector<std::atomic<int>> visits(kCount + 1);
+        registry.parallelView<vkengine::Transform, vkengine::NameComponent>(
+            [&](core::ecs::Entity entity, vkengine::Transform&, vkengine::NameComponent& name) {
+                visits[entity.index()].fetch_add(1, std::memory_order_relaxed);
+                EXPECT_EQ(name.value, std::to_string(entity.index() - 1));
+            },
+            chunkSize);
+        std::vector<std::atomic<int>> transformVisits(kCount + 1);
+        registry.parallelView<vkengine::Transform>(
+            [&](core::ecs::Entity entity, vkengine::Transform&) {
+                transformVisits[entity.index()].fetch_add(1, std::memory_order_relaxed);
+            },
+            chunkSize);
+
+        for (std::size_t i = 0; i < kCount; ++i) {
+            const std::uint32_t index = entities[i].index();
+            ASSERT_EQ(visits[index].load(), matches(i, true) ? 1 : 0) << "entity " << i << " chunk " << chunkSize;
+            ASSERT_EQ(transformVisits[index].load(), matches(i, false) ? 1 : 0) << "entity " << i << " chunk " << chunkSize;
+        }
+    }
+}
+
+TEST(RegistryTests, DestroyedHandlesGoStaleWhenSlotIsRecycled) {
+    core::ecs::Registry registry;
+    auto first = registry.createEntity();
+    auto second = registry.createEntity();
+    registry.emplace<vkengine::NameComponent>(first, vkengine::NameComponent{"first"});
+
+    registry.destroyEntity(first);
+    auto recycled = registry.createEntity();
+
+    EXPECT_EQ(recycled.index(), first.index());
+    EXPECT_NE(recycled, first);
+    EXPECT_FALSE(registry.contains(first));
+    EXPECT_TRUE(registry.contains(second));
+    EXPECT_TRUE(registry.contains(recycled));
+    EXPECT_FALSE(registry.has<vkengine::NameComponent>(recycled));
+    EXPECT_EQ(registry.tryGet<vkengine::NameComponent>(first), nullptr);
+    EXPECT_THROW(registry.emplace<vkengine::NameComponent>(first), std::runtime_error);
+    EXPECT_EQ(registry.entities().size(), 2u);
+}
+
+TEST(RegistryTests, DeferredCommandsApplyAtFlush) {
+    core::ecs::Registry registry;
+    std::vector<core::ecs::Entity> entities;
+    for (int i = 0; i < 128; ++i) {
+        auto entity = registry.createEntity();
+        registry.emplace<vkengine::Transform>(entity);
+        entities.push_back(entity);
+    }
+
+    constexpr int kWorkers = 4;
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < kWorkers; ++worker) {
+        workers.emplace_back([&, worker]() {
+            auto& commands = registry.deferred();
+            for (std::size_t i = worker; i < entities.size(); i += kWorkers) {
+                EXPECT_TRUE(registry.has<vkengine::Transform>(entities[i]));
+                auto spawned = commands.createEntity();
+                commands.emplace<vkengine::NameComponent>(spawned, vkengine::NameComponent{"spawned"});
+                commands.remove<vkengine::Transform>(entities[i]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    EXPECT_EQ(registry.entities().size(), entities.size());
+    registry.flushDeferred();
+    EXPECT_EQ(registry.entities().size(), entities.size() * 2);
+
+    std::size_t transforms = 0;
+    registry.view<vkengine::Transform>([&](core::ecs::Entity, vkengine::Transform&) { ++transforms; });
+    std::size_t names = 0;
+    registry.view<vkengine::NameComponent>([&](core::ecs::Entity, vkengine::NameComponent&) { ++names; });
+    EXPECT_EQ(transforms, 0u);
+    EXPECT_EQ(names, entities.size());
+}
+
+TEST(RegistryTests, FlushActivatesCreatesBeforeOtherBuffersUseThem) {
+    core::ecs::Registry registry;
+    std::promise<void> consumerRegistered;
+    std::promise<core::ecs::Entity> created;
+    std::promise<void> consumerRecorded;
+
+    // The consumer's buffer is registered first, so it replays before the creator's buffer.
+    std::thread consumer([&]() {
+        auto& commands = registry.deferred();
+        consumerRegistered.set_value();
+        const core::ecs::Entity entity = created.get_future().get();
+        commands.emplace<vkengine::NameComponent>(entity, vkengine::NameComponent{"from another thread"});
+        consumerRecorded.set_value();
+    });
+    std::thread creator([&]() {
+        consumerRegistered.get_future().wait();
+        created.set_value(registry.deferred().createEntity());
+    });
+    creator.join();
+    consumerRecorded.get_future().wait();
+    consumer.join();
+
+    ASSERT_NO_THROW(registry.flushDeferred());
+    ASSERT_EQ(registry.entities().size(), 1u);
+    const core::ecs::Entity entity{registry.entities().front()};
+    ASSERT_TRUE(registry.has<vkengine::NameComponent>(entity));
+    EXPECT_EQ(registry.get<vkengine::NameComponent>(entity).value, "from another thread");
+}
+
+TEST(RegistryTests, RecordingCreatesDoesNotDisturbLockFreeReaders) {
+    core::ecs::Registry registry;
+    std::vector<core::ecs::Entity> existing;
+    for (int i = 0; i < 64; ++i) {
+        auto entity = registry.createEntity();
+        registry.emplace<vkengine::Transform>(entity);
+        existing.push_back(entity);
+    }
+
+    // Enough creates to append several pages of entity slots while readers are running.
+    constexpr int kWriters = 2;
+    constexpr int kCreatesPerWriter = 10000;
+    std::atomic<int> writersRunning{kWriters};
+    std::atomic<int> missedReads{0};
+    std::vector<std::vector<core::ecs::Entity>> spawned(kWriters);
+    std::vector<std::thread> threads;
+    for (int writer = 0; writer < kWriters; ++writer) {
+        threads.emplace_back([&, writer]() {
+            auto& commands = registry.deferred();
+            for (int i = 0; i < kCreatesPerWriter; ++i) {
+                const auto entity = commands.createEntity();
+                commands.emplace<vkengine::Transform>(entity);
+                spawned[writer].push_back(entity);
+            }
+            --writersRunning;
+        });
+    }
+    for (int reader = 0; reader < 2; ++reader) {
+        threads.emplace_back([&]() {
+            do {
+                for (const auto entity : existing) {
+                    if (!registry.contains(entity)) {
+                        ++missedReads;
+                    }
+                }
+                std::size_t visited = 0;
+                registry.view<vkengine::Transform>([&](core::ecs::Entity, vkengine::Transform&) { ++visited; });
+                if (visited != existing.size()) {
+                    ++missedReads;
+                }
+            } while (writersRunning.load() > 0);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(missedReads.load(), 0);
+
+    for (const auto& entities : spawned) {
+        for (const auto entity : entities) {
+            EXPECT_FALSE(registry.contains(entity));
+        }
+    }
+    registry.flushDeferred();
+    EXPECT_EQ(registry.entities().size(), existing.size() + kWriters * kCreatesPerWriter);
+    for (const auto& entities : spawned) {
+        for (const auto entity : entities) {
+            ASSERT_TRUE(registry.has<vkengine::Transform>(entity));
+        }
+    }
+}
+
+TEST(JobSystemTests, FrameGraphRunsStagesInDependencyOrder) {
+    auto& jobs = vkengine::JobSystem::instance();
+    jobs.initialize(4);
+
+    for (int frame = 0; frame < 100; ++frame) {
+        std::mutex logMutex;
+        std::vector<int> stages;
+        auto record = [&](int stage) {
+            std::lock_guard<std::mutex> lock(logMutex);
+            stages.push_back(stage);
+        };
+
+        auto input = jobs.submit([&]() { record(0); });
+        auto physics = jobs.submit([&]() { record(1); }, input);
+        auto particles = jobs.submit([&]() { record(2); }, physics);
+        auto animation = jobs.submit([&]() { record(3); }, particles);
+        auto renderPrep = jobs.submit([&]() { record(4); }, {animation, physics});
+        jobs.wait(renderPrep);
+
+        ASSERT_EQ(stages, (std::vector<int>{0, 1, 2, 3, 4}));
+        EXPECT_TRUE(jobs.isComplete(input));
+    }
+
+    std::atomic<int> finished{0};
+    std::vector<vkengine::JobHandle> producers;
+    for (int i = 0; i < 64; ++i) {
+        producers.push_back(jobs.submit([&]() { ++finished; }));
+    }
+    int observed = -1;
+    jobs.wait(jobs.submit([&]() { observed = finished.load(); }, producers));
+    EXPECT_EQ(observed, 64);
+
+    jobs.shutdown();
+}
+
+TEST(JobSystemTests, ConcurrentFirstUseStartsOnePool) {
+    auto& jobs = vkengine::JobSystem::instance();
+    jobs.shutdown();
+    ASSERT_EQ(jobs.threadCount(), 0u);
+
+    // Several threads hit core::parallelFor at once while the pool is down; exactly one of them
+    // starts it and every loop still covers its whole range.
+    constexpr int kCallers = 4;
+    constexpr std::size_t kCount = 4096;
+    std::atomic<int> arrived{0};
+    std::vector<std::size_t> sums(kCallers, 0);
+    std::vector<std::thread> callers;
+    for (int caller = 0; caller < kCallers; ++caller) {
+        callers.emplace_back([&, caller]() {
+            ++arrived;
+            while (arrived.load() < kCallers) {
+                std::this_thread::yield();
+            }
+            std::atomic<std::size_t> sum{0};
+            core::parallelFor(kCount, 64, [&](std::size_t i) { sum.fetch_add(i, std::memory_order_relaxed); });
+            sums[caller] = sum.load();
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    const std::size_t hardwareThreads = std::thread::hardware_concurrency();
+    EXPECT_EQ(jobs.threadCount(), hardwareThreads == 0 ? 4u : hardwareThreads);
+    for (const std::size_t sum : sums) {
+        EXPECT_EQ(sum, kCount * (kCount - 1) / 2);
+    }
+}
+
+TEST(WorkStealingDequeTests, EveryItemIsTakenOnceUnderStealing) {
+    // A small initial ring so the owner also grows it while thieves are reading.
+    vkengine::WorkStealingDeque<std::uint32_t> deque(4);
+    constexpr std::uint32_t kItems = 100000;
+    constexpr int kThieves = 3;
+    std::vector<std::atomic<int>> taken(kItems);
+    std::atomic<bool> ownerDone{false};
+
+    std::vector<std::thread> thieves;
+    for (int thief = 0; thief < kThieves; ++thief) {
+        thieves.emplace_back([&]() {
+            while (!ownerDone.load() || !deque.empty()) {
+                if (auto item = deque.steal()) {
+                    taken[*item].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (std::uint32_t item = 0; item < kItems; ++item) {
+        deque.push(item);
+        if (item % 3 == 0) {
+            if (auto popped = deque.pop()) {
+                taken[*popped].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    while (auto popped = deque.pop()) {
+        taken[*popped].fetch_add(1, std::memory_order_relaxed);
+    }
+    ownerDone = true;
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+    for (std::uint32_t item = 0; item < kItems; ++item) {
+        ASSERT_EQ(taken[item].load(), 1) << "item " << item;
+    }
+}
+
+TEST(WorkStealingDequeTests, PopAndStealRaceForTheLastItemHasOneWinner) {
+    vkengine::WorkStealingDeque<int> deque;
+    constexpr int kRounds = 20000;
+    std::atomic<int> released{-1};
+    std::atomic<int> thiefDone{-1};
+    std::atomic<int> stolen{0};
+
+    std::thread thief([&]() {
+        for (int r = 0; r < kRounds; ++r) {
+            while (released.load() < r) {
+                std::this_thread::yield();
+            }
+            if (deque.steal()) {
+                ++stolen;
+            }
+            thiefDone = r;
+        }
+    });
+    int popped = 0;
+    int firstBadRound = -1;
+    for (int r = 0; r < kRounds; ++r) {
+        // The deque holds exactly one item while the owner pops and the thief steals it.
+        deque.push(r);
+        released = r;
+        if (deque.pop()) {
+            ++popped;
+        }
+        while (thiefDone.load() < r) {
+            std::this_thread::yield();
+        }
+        if (firstBadRound < 0 && (popped + stolen.load() != r + 1 || !deque.empty())) {
+            firstBadRound = r;
+        }
+    }
+    thief.join();
+    EXPECT_EQ(firstBadRound, -1);
+    EXPECT_EQ(popped + stolen.load(), kRounds);
+    EXPECT_FALSE(deque.pop().has_value());
+    EXPECT_FALSE(deque.steal().has_value());
+}
+
+TEST(JobSystemTests, JobsSpawnedFromAWorkerRunOnceWhileBeingStolen) {
+    auto& jobs = vkengine::JobSystem::instance();
+    jobs.initialize(4);
+
+    // Children are pushed onto one worker's deque, so every other worker has to steal them.
+    constexpr std::size_t kChildren = 20000;
+    std::vector<std::atomic<int>> runs(kChildren);
+    std::vector<vkengine::JobHandle> children;
+    children.reserve(kChildren);
+    jobs.wait(jobs.submit([&]() {
+        for (std::size_t i = 0; i < kChildren; ++i) {
+            children.push_back(jobs.submit([&runs, i]() { runs[i].fetch_add(1, std::memory_order_relaxed); }));
+        }
+    }));
+    for (const auto& child : children) {
+        jobs.wait(child);
+    }
+    for (std::size_t i = 0; i < kChildren; ++i) {
+        ASSERT_EQ(runs[i].load(), 1) << "job " << i;
+    }
+}
+
+TEST(JobSystemTests, SuccessorWaitsForFinishedAndRunningPredecessors) {
+    auto& jobs = vkengine::JobSystem::instance();
+    jobs.initialize(4);
+
+    // Half the predecessors have already finished when the successor is attached; only the
+    // unfinished ones may count towards it, and it must start exactly once, after all of them.
+    for (int round = 0; round < 50; ++round) {
+        constexpr int kPredecessors = 16;
+        std::atomic<int> finished{0};
+        std::vector<vkengine::JobHandle> predecessors;
+        for (int i = 0; i < kPredecessors / 2; ++i) {
+            predecessors.push_back(jobs.submit([&]() { ++finished; }));
+        }
+        for (const auto& done : predecessors) {
+            jobs.wait(done);
+        }
+        for (int i = kPredecessors / 2; i < kPredecessors; ++i) {
+            predecessors.push_back(jobs.submit([&]() {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                ++finished;
+            }));
+        }
+
+        std::atomic<int> successorRuns{0};
+        int observed = -1;
+        const auto successor = jobs.submit([&]() {
+            observed = finished.load();
+            ++successorRuns;
+        }, predecessors);
+        const auto chained = jobs.submit([&]() { ++successorRuns; }, successor);
+        jobs.wait(chained);
+
+        ASSERT_EQ(observed, kPredecessors) << "round " << round;
+        ASSERT_EQ(successorRuns.load(), 2) << "round " << round;
+    }
+}
+
+TEST(JobSystemTests, ParallelReduceKeepsChunksApartAcrossNestedWaits) {
+    vkengine::JobSystem::instance().initialize(4);
+
+    // Every element reads the accumulator, waits on a nested loop (which may run another chunk of
+    // the same reduce on this worker) and writes back; sharing one accumulator would lose updates.
+    // The nested iterations sleep so the waiting worker finds the outer chunks to run meanwhile.
+    constexpr std::size_t kCount = 256;
+    for (int round = 0; round < 5; ++round) {
+        const std::uint64_t total = core::parallelReduce(
+            kCount, 8, std::uint64_t{0},
+            [](std::uint64_t& sum, std::size_t i) {
+                const std::uint64_t before = sum;
+                std::atomic<std::size_t> inner{0};
+                core::parallelFor(4, 1, [&](std::size_t) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    inner.fetch_add(1, std::memory_order_relaxed);
+                });
+                sum = before + i + (inner.load() == 4 ? 0 : 1);
+            },
+            [](std::uint64_t lhs, std::uint64_t rhs) { return lhs + rhs; });
+        EXPECT_EQ(total, std::uint64_t{kCount} * (kCount - 1) / 2) << "round " << round;
+    }
+}
+
+TEST(PacketTests, BitPackedValuesRoundTripThroughWireFormat) {
+    vkengine::Packet packet(vkengine::PacketTypes::StateSnapshot);
+    packet.setSequence(77);
+    packet.writeUInt16(0xBEEF);
+    packet.writeBool(true);
+    packet.writeBits(5, 3);
+    packet.writeVarUInt(300);
+    packet.writeVarInt(-2);
+    packet.writeQuantizedVec3(glm::vec3(1.25f, -3.5f, 100.0f), -512.0f, 512.0f, 20);
+    const glm::quat rotation = glm::normalize(glm::quat(0.3f, -0.8f, 0.1f, 0.5f));
+    packet.writeCompressedQuat(rotation);
+    packet.writeString("eve");  // Byte-aligned again after the bit-level values.
+    packet.writeFloat(0.5f);
+
+    // 2 bytes, then 4 + 16 + 8 + 60 + 32 = 120 bits packed into 15 bytes, then 5 + 4 bytes.
+    EXPECT_EQ(packet.payloadSize(), 26u);
+
+    std::vector<std::uint8_t> wire(vkengine::MaxDatagramSize);
+    const std::size_t size = packet.serializeInto(wire.data(), wire.size());
+    ASSERT_EQ(size, vkengine::Packet::HeaderSize + packet.payloadSize());
+    EXPECT_EQ(packet.serializeInto(wire.data(), size - 1), 0u);
+
+    vkengine::Packet received;
+    ASSERT_TRUE(received.deserialize(wire.data(), size));
+    EXPECT_FALSE(received.deserialize(wire.data(), size - 1));
+    ASSERT_TRUE(received.deserialize(wire.data(), size));
+    EXPECT_EQ(received.type(), vkengine::PacketTypes::StateSnapshot);
+    EXPECT_EQ(received.sequence(), 77u);
+    EXPECT_EQ(received.readUInt16(), 0xBEEF);
+    EXPECT_TRUE(received.readBool());
+    EXPECT_EQ(received.readBits(3), 5u);
+    EXPECT_EQ(received.readVarUInt(), 300u);
+    EXPECT_EQ(received.readVarInt(), -2);
+    const glm::vec3 position = received.readQuantizedVec3(-512.0f, 512.0f, 20);
+    EXPECT_NEAR(position.x, 1.25f, 1e-3f);
+    EXPECT_NEAR(position.y, -3.5f, 1e-3f);
+    EXPECT_NEAR(position.z, 100.0f, 1e-3f);
+    const glm::quat decoded = received.readCompressedQuat();
+    EXPECT_GT(std::abs(glm::dot(decoded, rotation)), 0.9999f);
+    std::string text;
+    received.readString(text);
+    EXPECT_EQ(text, "eve");
+    EXPECT_FLOAT_EQ(received.readFloat(), 0.5f);
+    EXPECT_FALSE(received.readOverflowed());
+    EXPECT_EQ(received.readUInt32(), 0u);
+    EXPECT_TRUE(received.readOverflowed());
+}
+
+TEST(PacketTests, PayloadBuffersAreRecycled) {
+    auto& pool = vkengine::PacketBufferPool::shared();
+    {
+        vkengine::Packet warm(vkengine::PacketTypes::EntityUpdate);
+        vkengine::Packet warmCopy = warm;
+        warm.writeUInt32(1);
+        warmCopy.writeUInt32(1);
+    }
+    const std::size_t pooled = pool.pooledCount();
+    ASSERT_GE(pooled, 2u);
+    {
+        vkengine::Packet packet(vkengine::PacketTypes::EntityUpdate);
+        packet.writeUInt32(1);
+        EXPECT_EQ(pool.pooledCount(), pooled - 1);
+        vkengine::Packet copy = packet;
+        EXPECT_EQ(copy.data(), packet.data());
+        vkengine::Packet moved = std::move(copy);
+        EXPECT_EQ(moved.readUInt32(), 1u);
+        EXPECT_EQ(pool.pooledCount(), pooled - 2);
+    }
+    EXPECT_EQ(pool.pooledCount(), pooled);
+}
+
+TEST(SocketTests, BatchedDatagramsRoundTripOverLoopback) {
+    vkengine::Socket sender;
+    vkengine::Socket receiver;
+    ASSERT_TRUE(sender.bind(0));
+    ASSERT_TRUE(receiver.bind(0));
+    receiver.setNonBlocking(true);
+    const vkengine::NetworkAddress target{"127.0.0.1", receiver.localPort()};
+
+    // More datagrams than one receive batch holds.
+    constexpr std::uint32_t kCount = 40;
+    std::vector<std::uint32_t> payloads(kCount);
+    std::vector<vkengine::Datagram> datagrams;
+    for (std::uint32_t i = 0; i < kCount; ++i) {
+        payloads[i] = i * 7 + 1;
+        datagrams.push_back(vkengine::Datagram{target, reinterpret_cast<const std::uint8_t*>(&payloads[i]), sizeof(std::uint32_t)});
+    }
+    EXPECT_EQ(sender.sendBatch(datagrams.data(), datagrams.size()), kCount);
+
+    vkengine::DatagramBatch batch;
+    std::set<std::uint32_t> received;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (received.size() < kCount && std::chrono::steady_clock::now() < deadline) {
+        if (!receiver.waitReadable(50)) {
+            continue;
+        }
+        while (receiver.receiveBatch(batch) > 0) {
+            EXPECT_LE(batch.size(), batch.capacity());
+            for (std::size_t i = 0; i < batch.size(); ++i) {
+                ASSERT_EQ(batch[i].size, sizeof(std::uint32_t));
+                EXPECT_EQ(batch[i].address.port, sender.localPort());
+                std::uint32_t value = 0;
+                std::memcpy(&value, batch[i].data, sizeof(value));
+                received.insert(value);
+            }
+        }
+    }
+    EXPECT_EQ(received.size(), kCount);
+    EXPECT_EQ(*received.rbegin(), (kCount - 1) * 7 + 1);
+}
+
+TEST(NetworkTests, ServerReceivesTypedPacketsFromClient) {
+    vkengine::NetworkServer server;
+    ASSERT_TRUE(server.start(0));
+    ASSERT_NE(server.port(), 0);
+    vkengine::NetworkClient client;
+    ASSERT_TRUE(client.connect("127.0.0.1", server.port()));
+
+    vkengine::Packet packet(vkengine::PacketTypes::UserBase);
+    packet.writeUInt32(0xC0FFEE);
+    client.send(packet);
+
+    bool connected = false;
+    bool received = false;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!received && std::chrono::steady_clock::now() < deadline) {
+        vkengine::NetworkEvent event;
+        while (server.pollEvent(event)) {
+            if (event.type == vkengine::NetworkEvent::Type::Connected) {
+                connected = true;
+            } else if (event.type == vkengine::NetworkEvent::Type::DataReceived &&
+                       event.packet->type() == vkengine::PacketTypes::UserBase) {
+                EXPECT_EQ(event.packet->readUInt32(), 0xC0FFEEu);
+                received = true;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(connected);
+    EXPECT_TRUE(received);
+    EXPECT_EQ(server.clientCount(), 1u);
+
+    client.disconnect();
+    server.stop();
+}
+
+TEST(NetworkTests, ClientDropsMalformedAndOversizedDatagrams) {
+    // A raw socket stands in for the server so the client can be fed arbitrary bytes.
+    vkengine::Socket fakeServer;
+    ASSERT_TRUE(fakeServer.bind(0));
+    fakeServer.setNonBlocking(true);
+    vkengine::NetworkClient client;
+    EXPECT_EQ(client.maxPacketSize(), vkengine::DefaultMaxPacketSize);
+    ASSERT_TRUE(client.connect("127.0.0.1", fakeServer.localPort()));
+
+    vkengine::NetworkAddress clientAddress;
+    std::vector<std::uint8_t> buffer(vkengine::MaxDatagramSize);
+    const auto connectDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (fakeServer.receiveFrom(clientAddress, buffer.data(), buffer.size()) <= 0 &&
+           std::chrono::steady_clock::now() < connectDeadline) {
+        fakeServer.waitReadable(50);
+    }
+    ASSERT_NE(clientAddress.port, 0);
+
+    const std::array<std::uint8_t, 5> garbage{0xDE, 0xAD, 0xBE, 0xEF, 0x00};
+    EXPECT_TRUE(fakeServer.sendTo(clientAddress, garbage.data(), garbage.size()));
+
+    // Larger than the client's receive slots: arrives truncated and must not parse.
+    vkengine::Packet oversized(vkengine::PacketTypes::UserBase);
+    for (std::size_t i = 0; i < vkengine::DefaultMaxPacketSize; ++i) {
+        oversized.writeUInt8(static_cast<std::uint8_t>(i));
+    }
+    const std::size_t oversizedBytes = oversized.serializeInto(buffer.data(), buffer.size());
+    ASSERT_GT(oversizedBytes, client.maxPacketSize());
+    EXPECT_TRUE(fakeServer.sendTo(clientAddress, buffer.data(), oversizedBytes));
+
+    vkengine::Packet valid(vkengine::PacketTypes::UserBase);
+    valid.writeUInt32(0xC0FFEE);
+    const std::size_t validBytes = valid.serializeInto(buffer.data(), buffer.size());
+    EXPECT_TRUE(fakeServer.sendTo(clientAddress, buffer.data(), validBytes));
+
+    std::vector<std::uint32_t> received;
+    std::size_t dataEvents = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while ((received.empty() || client.droppedPackets() < 2) && std::chrono::steady_clock::now() < deadline) {
+        vkengine::NetworkEvent event;
+        while (client.pollEvent(event)) {
+            ASSERT_EQ(event.type, vkengine::NetworkEvent::Type::DataReceived);
+            ASSERT_NE(event.packet, nullptr);
+            ++dataEvents;
+            received.push_back(event.packet->readUInt32());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(client.droppedPackets(), 2u);
+    EXPECT_EQ(dataEvents, 1u);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received.front(), 0xC0FFEEu);
+
+    client.disconnect();
+}
+
+TEST(NetworkSyncTests, LossyDeltasConvergeAgainstAcknowledgedBaselines) {
+    constexpr vkengine::ClientId kClient = 7;
+    constexpr int kObjectCount = 64;
+    vkengine::Scene serverScene;
+    vkengine::Scene clientScene;
+    vkengine::NetworkSyncSystem serverSync;
+    vkengine::NetworkSyncSystem clientSync;
+
+    std::vector<vkengine::GameObject*> objects = serverScene.createObjects(kObjectCount, vkengine::MeshType::Cube);
+    for (int i = 0; i < kObjectCount; ++i) {
+        objects[i]->transform().position = glm::vec3(static_cast<float>(i), 0.5f, -2.0f);
+        serverSync.registerEntity(*objects[i]);
+    }
+
+    // Every datagram goes through the wire format; deltas and acks are dropped on fixed ticks.
+    std::vector<std::uint8_t> wire(vkengine::MaxDatagramSize);
+    const auto transmit = [&](const vkengine::Packet& packet) {
+        vkengine::Packet received;
+        const std::size_t size = packet.serializeInto(wire.data(), wire.size());
+        EXPECT_TRUE(received.deserialize(wire.data(), size));
+        return received;
+    };
+
+    const std::size_t fullSize = serverSync.createSnapshot(serverScene).payloadSize();
+    std::size_t largestSteadyDelta = 0;
+    for (int tick = 0; tick < 120; ++tick) {
+        for (int k = 0; k < 3; ++k) {
+            objects[(tick * 3 + k) % kObjectCount]->transform().position.y += 0.25f;
+        }
+        objects[tick % kObjectCount]->transform().rotation.y += 0.1f;
+
+        const vkengine::Packet delta = serverSync.createDelta(serverScene, kClient);
+        if (tick > 10 && serverSync.acknowledgedSnapshot(kClient) != 0) {
+            largestSteadyDelta = std::max(largestSteadyDelta, delta.payloadSize());
+        }
+        if (tick % 3 == 1) {
+            continue;
+        }
+        EXPECT_TRUE(clientSync.processPacket(clientScene, vkengine::InvalidClientId, transmit(delta)));
+        if (tick % 4 != 2) {
+            EXPECT_TRUE(serverSync.processPacket(serverScene, kClient, transmit(clientSync.createAck())));
+        }
+    }
+    EXPECT_NE(serverSync.acknowledgedSnapshot(kClient), 0u);
+    EXPECT_LT(largestSteadyDelta, fullSize / 4);
+
+    ASSERT_TRUE(clientSync.applyDelta(clientScene, transmit(serverSync.createDelta(serverScene, kClient))));
+    ASSERT_EQ(clientScene.objects().size(), static_cast<std::size_t>(kObjectCount));
+    for (vkengine::GameObject* object : objects) {
+        const vkengine::GameObject* replica = clientSync.getObject(serverSync.getNetworkId(*object));
+        ASSERT_NE(replica, nullptr);
+        const vkengine::Transform& expected = object->transform();
+        const vkengine::Transform& actual = replica->transform();
+        for (int axis = 0; axis < 3; ++axis) {
+            EXPECT_NEAR(actual.position[axis], expected.position[axis], vkengine::NetworkSyncSystem::PositionResolution);
+            EXPECT_NEAR(actual.rotation[axis], expected.rotation[axis], vkengine::NetworkSyncSystem::RotationResolution);
+            EXPECT_NEAR(actual.scale[axis], expected.scale[axis], vkengine::NetworkSyncSystem::ScaleResolution);
+        }
+    }
+
+    // A removed entity disappears from the client's registry with the next delta.
+    const std::uint32_t removedId = serverSync.getNetworkId(*objects.front());
+    serverSync.unregisterEntity(*objects.front());
+    serverSync.processPacket(serverScene, kClient, transmit(clientSync.createAck()));
+    ASSERT_TRUE(clientSync.applyDelta(clientScene, transmit(serverSync.createDelta(serverScene, kClient))));
+    EXPECT_EQ(clientSync.getObject(removedId), nullptr);
+}
+
+TEST(NetworkSyncTests, InterestViewAndBudgetLimitWhatIsReplicated) {
+    constexpr vkengine::ClientId kClient = 3;
+    constexpr int kObjectCount = 100;
+    vkengine::Scene serverScene;
+    vkengine::Scene clientScene;
+    vkengine::NetworkSyncSystem serverSync;
+    vkengine::NetworkSyncSystem clientSync;
+    serverSync.setInterestCellSize(16.0f);
+    serverSync.setBandwidthBudget(40);
+
+    std::vector<vkengine::GameObject*> objects = serverScene.createObjects(kObjectCount, vkengine::MeshType::Cube);
+    for (int i = 0; i < kObjectCount; ++i) {
+        objects[i]->transform().position = glm::vec3(2.0f * static_cast<float>(i), 0.0f, 0.0f);
+        serverSync.registerEntity(*objects[i]);
+    }
+    const auto replicated = [&](int index) {
+        return clientSync.getObject(serverSync.getNetworkId(*objects[index])) != nullptr;
+    };
+    // Client objects are created in networkId order, so index i is the replica of objects[i].
+    const auto shown = [&](int index) {
+        return clientScene.objects()[static_cast<std::size_t>(index)].render().visible;
+    };
+    const auto tick = [&]() {
+        ASSERT_TRUE(clientSync.applyDelta(clientScene, serverSync.createDelta(serverScene, kClient)));
+        serverSync.acknowledgeSnapshot(kClient, clientSync.lastAppliedSnapshot());
+    };
+
+    // Within the budget the nearest entities go first; the rest follow on later ticks.
+    serverSync.setClientView(kClient, glm::vec3(0.0f), 40.0f);
+    tick();
+    EXPECT_TRUE(replicated(0));
+    EXPECT_FALSE(replicated(20));
+    for (int i = 0; i < 20; ++i) {
+        tick();
+    }
+    for (int i = 0; i <= 20; ++i) {
+        EXPECT_TRUE(replicated(i)) << i;
+    }
+    EXPECT_FALSE(replicated(21));
+    EXPECT_EQ(clientScene.objects().size(), 21u);
+
+    // Moving the view drops what it left and brings in what it reached.
+    serverSync.setBandwidthBudget(0);
+    serverSync.setClientView(kClient, glm::vec3(198.0f, 0.0f, 0.0f), 10.0f);
+    tick();
+    EXPECT_FALSE(replicated(0));
+    EXPECT_TRUE(replicated(99));
+    EXPECT_TRUE(replicated(94));
+    EXPECT_FALSE(replicated(93));
+    ASSERT_EQ(clientScene.objects().size(), 27u);
+    for (int i = 0; i <= 20; ++i) {
+        EXPECT_FALSE(shown(i)) << "Replica " << i << " left the view but is still drawn.";
+    }
+    for (int i = 21; i < 27; ++i) {
+        EXPECT_TRUE(shown(i)) << i;
+    }
+
+    // Replicas that come back into view reuse their objects and are drawn again; the ones left
+    // behind are hidden.
+    serverSync.setClientView(kClient, glm::vec3(0.0f), 40.0f);
+    tick();
+    EXPECT_TRUE(replicated(0));
+    EXPECT_EQ(clientScene.objects().size(), 27u);
+    EXPECT_EQ(clientSync.getObject(serverSync.getNetworkId(*objects[5])), &clientScene.objects()[5]);
+    for (int i = 0; i <= 20; ++i) {
+        EXPECT_TRUE(shown(i)) << i;
+    }
+    for (int i = 21; i < 27; ++i) {
+        EXPECT_FALSE(shown(i)) << "Replica of object " << 73 + i << " left the view but is still drawn.";
+    }
+}
+
+TEST(NetworkSyncTests, StateLargerThanADatagramArrivesOverSeveralDeltas) {
+    constexpr vkengine::ClientId kClient = 5;
+    constexpr int kObjectCount = 600;
+    vkengine::Scene serverScene;
+    vkengine::Scene clientScene;
+    vkengine::NetworkSyncSystem serverSync;
+    vkengine::NetworkSyncSystem clientSync;
+
+    std::vector<vkengine::GameObject*> objects = serverScene.createObjects(kObjectCount, vkengine::MeshType::Cube);
+    for (int i = 0; i < kObjectCount; ++i) {
+        objects[i]->transform().position = glm::vec3(0.5f * static_cast<float>(i), 1.0f, -static_cast<float>(i % 10));
+        serverSync.registerEntity(*objects[i]);
+    }
+    ASSERT_EQ(serverSync.getBandwidthBudget(), 0u);
+
+    // No budget set: every delta still fits one datagram and the rest follows on later ticks.
+    std::vector<std::uint8_t> wire(vkengine::DefaultMaxPacketSize);
+    ASSERT_GT(serverSync.createSnapshot(serverScene).wireSize(), wire.size());
+    int ticks = 0;
+    while (clientScene.objects().size() < static_cast<std::size_t>(kObjectCount) && ticks < 100) {
+        const vkengine::Packet delta = serverSync.createDelta(serverScene, kClient);
+        const std::size_t size = delta.serializeInto(wire.data(), wire.size());
+        ASSERT_GT(size, 0u) << "Delta on tick " << ticks << " does not fit one datagram.";
+        vkengine::Packet received;
+        ASSERT_TRUE(received.deserialize(wire.data(), size));
+        ASSERT_TRUE(clientSync.processPacket(clientScene, vkengine::InvalidClientId, received));
+        serverSync.acknowledgeSnapshot(kClient, clientSync.lastAppliedSnapshot());
+        ++ticks;
+    }
+    EXPECT_GT(ticks, 1);
+    ASSERT_EQ(clientScene.objects().size(), static_cast<std::size_t>(kObjectCount));
+    for (vkengine::GameObject* object : objects) {
+        const vkengine::GameObject* replica = clientSync.getObject(serverSync.getNetworkId(*object));
+        ASSERT_NE(replica, nullptr);
+        EXPECT_NEAR(replica->transform().position.x, object->transform().position.x,
+                    vkengine::NetworkSyncSystem::PositionResolution);
+    }
+
+    // A delta cut short inside its removals is rejected before any replica is touched.
+    const std::uint32_t removedId = serverSync.getNetworkId(*objects.back());
+    serverSync.unregisterEntity(*objects.back());
+    const vkengine::Packet removal = serverSync.createDelta(serverScene, kClient);
+    vkengine::Packet truncated(removal.data().data(), removal.payloadSize() - 1);
+    truncated.setType(vkengine::PacketTypes::StateDelta);
+    truncated.setSequence(removal.sequence());
+    EXPECT_FALSE(clientSync.applyDelta(clientScene, truncated));
+    for (int i = 0; i < kObjectCount; ++i) {
+        ASSERT_NE(clientSync.getObject(static_cast<std::uint32_t>(i + 1)), nullptr) << i;
+    }
+    vkengine::GameObject* replica = clientSync.getObject(removedId);
+    EXPECT_TRUE(replica->render().visible);
+
+    // The intact delta removes the entity and hides its replica.
+    ASSERT_TRUE(clientSync.applyDelta(clientScene, removal));
+    EXPECT_EQ(clientSync.getObject(removedId), nullptr);
+    EXPECT_FALSE(replica->render().visible);
+}
+
+TEST(NetworkSyncTests, FullSnapshotAfterLongOutageHidesDestroyedReplicas) {
+    constexpr vkengine::ClientId kClient = 9;
+    constexpr int kObjectCount = 8;
+    vkengine::Scene serverScene;
+    vkengine::Scene clientScene;
+    vkengine::NetworkSyncSystem serverSync;
+    vkengine::NetworkSyncSystem clientSync;
+
+    std::vector<vkengine::GameObject*> objects = serverScene.createObjects(kObjectCount, vkengine::MeshType::Cube);
+    for (int i = 0; i < kObjectCount; ++i) {
+        objects[i]->transform().position = glm::vec3(static_cast<float>(i), 0.0f, 0.0f);
+        serverSync.registerEntity(*objects[i]);
+    }
+    const auto exchange = [&](bool linkUp) {
+        const vkengine::Packet delta = serverSync.createDelta(serverScene, kClient);
+        if (!linkUp) return;
+        ASSERT_TRUE(clientSync.applyDelta(clientScene, delta));
+        serverSync.processPacket(serverScene, kClient, clientSync.createAck());
+    };
+    for (int tick = 0; tick < 3; ++tick) {
+        exchange(true);
+    }
+    const std::uint32_t destroyedId = serverSync.getNetworkId(*objects[3]);
+    vkengine::GameObject* replica = clientSync.getObject(destroyedId);
+    ASSERT_NE(replica, nullptr);
+    ASSERT_TRUE(replica->render().visible);
+
+    // The entity is destroyed while every delta and ack is lost for longer than the server keeps
+    // baselines, so the server falls back to a full snapshot that never mentions the removal.
+    serverSync.unregisterEntity(*objects[3]);
+    for (std::size_t tick = 0; tick <= vkengine::NetworkSyncSystem::SnapshotWindow; ++tick) {
+        objects[0]->transform().position.y += 0.25f;
+        exchange(false);
+    }
+    exchange(true);
+
+    EXPECT_EQ(clientSync.getObject(destroyedId), nullptr);
+    EXPECT_FALSE(replica->render().visible) << "Destroyed entity left a ghost replica.";
+    for (int i = 0; i < kObjectCount; ++i) {
+        if (i == 3) continue;
+        const vkengine::GameObject* survivor = clientSync.getObject(serverSync.getNetworkId(*objects[i]));
+        ASSERT_NE(survivor, nullptr) << i;
+        EXPECT_TRUE(survivor->render().visible) << i;
+    }
+    EXPECT_NEAR(clientSync.getObject(serverSync.getNetworkId(*objects[0]))->transform().position.y,
+                objects[0]->transform().position.y, vkengine::NetworkSyncSystem::PositionResolution);
+}
+
+TEST(LagCompensationTests, RewindInterpolatesRingHistoryAndRestores) {
+    vkengine::Scene scene;
+    std::vector<vkengine::GameObject*> objects = scene.createObjects(10, vkengine::MeshType::Cube);
+    vkengine::LagCompensation history(0.5f, 10.0f);
+    const std::size_t capacity = history.capacity();
+
+    // Object i sits at z = 3i and moves along x at 10 units per second.
+    for (int tick = 0; tick <= 20; ++tick) {
+        const float time = 0.1f * static_cast<float>(tick);
+        for (std::size_t i = 0; i < objects.size(); ++i) {
+            objects[i]->transform().position = glm::vec3(10.0f * time, 0.0f, 3.0f * static_cast<float>(i));
+        }
+        history.recordState(scene, time);
+    }
+    EXPECT_EQ(history.capacity(), capacity);
+    EXPECT_EQ(history.historySize(), capacity);
+
+    vkengine::Transform sampled;
+    ASSERT_TRUE(history.sample(4, 1.83f, sampled));
+    EXPECT_NEAR(sampled.position.x, 18.3f, 1e-3f);
+    ASSERT_TRUE(history.sample(4, 0.2f, sampled));
+    EXPECT_NEAR(sampled.position.x, 15.0f, 1e-3f) << "Older requests clamp to the oldest kept tick.";
+    EXPECT_FALSE(history.sample(10, 1.9f, sampled));
+
+    history.rewindTo(scene, 1.75f);
+    EXPECT_EQ(history.rewoundObjects().size(), objects.size());
+    EXPECT_NEAR(objects[7]->transform().position.x, 17.5f, 1e-3f);
+    history.restoreState(scene);
+    EXPECT_NEAR(objects[7]->transform().position.x, 20.0f, 1e-3f);
+
+    // A ray along x at z = 6 only rewinds object 2 (and not the ones 3 units away).
+    const std::size_t moved =
+        history.rewindAlongRay(scene, 1.75f, glm::vec3(0.0f, 0.0f, 6.0f), glm::vec3(1.0f, 0.0f, 0.0f), 100.0f, 1.0f);
+    ASSERT_EQ(moved, 1u);
+    EXPECT_EQ(history.rewoundObjects().front(), 2u);
+    EXPECT_NEAR(objects[2]->transform().position.x, 17.5f, 1e-3f);
+    EXPECT_NEAR(objects[3]->transform().position.x, 20.0f, 1e-3f);
+    history.restoreState(scene);
+    EXPECT_NEAR(objects[2]->transform().position.x, 20.0f, 1e-3f);
+    EXPECT_TRUE(history.rewoundObjects().empty());
+}
+
+TEST(LagCompensationTests, RotationTakesTheShortWayAcrossThePiWrap) {
+    vkengine::Scene scene;
+    vkengine::GameObject& turret = scene.createObject("Turret", vkengine::MeshType::Cube);
+    vkengine::LagCompensation history(1.0f, 10.0f);
+
+    // Yaw turns 0.28 rad across the seam: 3.0 to -3.0 is the same as 3.0 to 3.28.
+    turret.transform().rotation = glm::vec3(0.0f, 3.0f, -3.1f);
+    history.recordState(scene, 0.0f);
+    turret.transform().rotation = glm::vec3(0.0f, -3.0f, 3.1f);
+    history.recordState(scene, 0.1f);
+
+    const auto offSeam = [](float angle) { return std::remainder(angle - glm::pi<float>(), glm::two_pi<float>()); };
+    vkengine::Transform sampled;
+    ASSERT_TRUE(history.sample(0, 0.05f, sampled));
+    EXPECT_NEAR(offSeam(sampled.rotation.y), 0.0f, 1e-3f) << "Halfway should sit on the seam, not at 0.";
+    EXPECT_NEAR(offSeam(sampled.rotation.z), 0.0f, 1e-3f);
+    ASSERT_TRUE(history.sample(0, 0.025f, sampled));
+    EXPECT_NEAR(offSeam(sampled.rotation.y), -0.5f * (glm::pi<float>() - 3.0f), 1e-3f);
+
+    // Rewinds blend the same way.
+    history.rewindTo(scene, 0.05f);
+    EXPECT_NEAR(offSeam(turret.transform().rotation.y), 0.0f, 1e-3f);
+    history.restoreState(scene);
+    EXPECT_FLOAT_EQ(turret.transform().rotation.y, -3.0f);
+}
+
+TEST(SceneSerializerTests, JsonAndBinaryFormatsRoundTripTheScene) {
+    vkengine::Scene scene;
+    scene.camera().setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    auto& crate = scene.createObject("Crate", vkengine::MeshType::Cube);
+    crate.transform().position = glm::vec3(0.5f, -1.25f, 4.0f);
+    crate.transform().rotation = glm::vec3(0.1f, 0.2f, 0.3f);
+    crate.physics().velocity = glm::vec3(3.0f, 0.0f, -1.0f);
+    crate.physics().simulate = true;
+    crate.physics().angularVelocity = glm::vec3(0.0f, 1.5f, -0.25f);
+    crate.physics().staticFriction = 0.9f;
+    crate.physics().dynamicFriction = 0.7f;
+    crate.render().materialName = "metal";
+    crate.render().baseColor = glm::vec4(0.2f, 0.4f, 0.6f, 0.8f);
+    auto& floor = scene.createObject("Floor \"main\"", vkengine::MeshType::Cube);
+    floor.enableCollider(glm::vec3(10.0f, 0.5f, 10.0f), /*isStatic=*/true);
+    auto& actor = scene.createObject("Actor", vkengine::MeshType::Cube);
+    actor.setMeshResource("assets/models/actor.gltf");
+    actor.render().materialName = "metal";
+    vkengine::LightCreateInfo lightInfo{};
+    lightInfo.name = "Key";
+    lightInfo.type = vkengine::LightType::Spot;
+    lightInfo.intensity = 3.5f;
+    scene.createLight(lightInfo);
+
+    const auto expectSameScene = [&](const vkengine::Scene& loaded) {
+        ASSERT_EQ(loaded.objects().size(), scene.objects().size());
+        ASSERT_EQ(loaded.lights().size(), 1u);
+        EXPECT_EQ(loaded.camera().getPosition(), scene.camera().getPosition());
+        for (std::size_t i = 0; i < scene.objects().size(); ++i) {
+            const auto& expected = scene.objects()[i];
+            const auto& actual = loaded.objects()[i];
+            EXPECT_EQ(actual.name(), expected.name());
+            EXPECT_EQ(actual.mesh(), expected.mesh());
+            EXPECT_EQ(actual.meshResource(), expected.meshResource());
+            EXPECT_EQ(actual.render().materialName, expected.render().materialName);
+            EXPECT_EQ(actual.render().baseColor, expected.render().baseColor);
+            EXPECT_EQ(actual.transform().position, expected.transform().position);
+            EXPECT_EQ(actual.transform().rotation, expected.transform().rotation);
+            EXPECT_EQ(actual.physics().velocity, expected.physics().velocity);
+            EXPECT_EQ(actual.physics().simulate, expected.physics().simulate);
+            EXPECT_EQ(actual.physics().mass, expected.physics().mass);
+            EXPECT_EQ(actual.physics().angularVelocity, expected.physics().angularVelocity);
+            EXPECT_EQ(actual.physics().staticFriction, expected.physics().staticFriction);
+            EXPECT_EQ(actual.physics().dynamicFriction, expected.physics().dynamicFriction);
+            EXPECT_EQ(actual.physics().collidable, expected.physics().collidable);
+            EXPECT_EQ(actual.hasCollider(), expected.hasCollider());
+        }
+        ASSERT_NE(loaded.objects()[1].collider(), nullptr);
+        EXPECT_TRUE(loaded.objects()[1].collider()->isStatic);
+        EXPECT_EQ(loaded.objects()[1].collider()->halfExtents, glm::vec3(10.0f, 0.5f, 10.0f));
+        EXPECT_EQ(loaded.lights().front().name(), "Key");
+        EXPECT_EQ(loaded.lights().front().type(), vkengine::LightType::Spot);
+        EXPECT_FLOAT_EQ(loaded.lights().front().intensity(), 3.5f);
+    };
+
+    vkengine::SceneSerializer serializer;
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto jsonPath = directory / "vkengine_scene_roundtrip.json";
+    const auto binaryPath = directory / "vkengine_scene_roundtrip.vksb";
+    ASSERT_TRUE(serializer.saveToFile(scene, jsonPath));
+    ASSERT_TRUE(serializer.saveBinaryFile(scene, binaryPath));
+
+    const auto json = serializer.serialize(scene);
+    EXPECT_EQ((*json)["version"].asInt(), static_cast<int>(vkengine::SceneSerializer::JsonVersion));
+    vkengine::Scene fromJson;
+    ASSERT_TRUE(serializer.loadFromFile(fromJson, jsonPath));
+    expectSameScene(fromJson);
+    vkengine::Scene fromMap;
+    ASSERT_TRUE(serializer.loadBinaryFile(fromMap, binaryPath, /*memoryMap=*/true));
+    expectSameScene(fromMap);
+    vkengine::Scene fromRead;
+    ASSERT_TRUE(serializer.loadBinaryFile(fromRead, binaryPath, /*memoryMap=*/false));
+    expectSameScene(fromRead);
+
+    // Truncated or corrupted data is rejected without touching the scene.
+    std::vector<std::uint8_t> bytes = serializer.serializeBinary(scene);
+    EXPECT_FALSE(serializer.deserializeBinary(fromRead, bytes.data(), bytes.size() - 1));
+    bytes[4] = 99;  // Version from the future.
+    EXPECT_FALSE(serializer.deserializeBinary(fromRead, bytes.data(), bytes.size()));
+    EXPECT_EQ(fromRead.objects().size(), scene.objects().size());
+    EXPECT_EQ(vkengine::JsonValue::parse("{\"a\": [1, 2,]}"), nullptr);
+
+    std::filesystem::remove(jsonPath);
+    std::filesystem::remove(binaryPath);
+}
+
+TEST(MeshLoaderTests, AsciiAndBinaryStlLoadTheSameWeldedMesh) {
+    // Unit cube as 12 outward-facing triangles.
+    const std::array<glm::vec3, 8> corners = {
+        glm::vec3(0, 0, 0), glm::vec3(1, 0, 0), glm::vec3(1, 1, 0), glm::vec3(0, 1, 0),
+        glm::vec3(0, 0, 1), glm::vec3(1, 0, 1), glm::vec3(1, 1, 1), glm::vec3(0, 1, 1)};
+    const std::array<std::array<int, 3>, 12> faces = {{{0, 2, 1}, {0, 3, 2}, {4, 5, 6}, {4, 6, 7},
+                                                       {0, 1, 5}, {0, 5, 4}, {3, 7, 6}, {3, 6, 2},
+                                                       {0, 4, 7}, {0, 7, 3}, {1, 2, 6}, {1, 6, 5}}};
+
+    std::string ascii = "solid cube\n";
+    std::vector<std::uint8_t> binary(84, 0);
+    const auto appendBytes = [&](const void* source, std::size_t count) {
+        const auto* bytes = static_cast<const std::uint8_t*>(source);
+        binary.insert(binary.end(), bytes, bytes + count);
+    };
+    const auto triangleCount = static_cast<std::uint32_t>(faces.size());
+    std::memcpy(binary.data() + 80, &triangleCount, sizeof(triangleCount));
+    for (const auto& face : faces) {
+        // Leave the normal zero in the binary file so the loader derives it from the winding.
+        const float zeroNormal[3] = {0.0f, 0.0f, 0.0f};
+        appendBytes(zeroNormal, sizeof(zeroNormal));
+        const glm::vec3 normal = glm::normalize(
+            glm::cross(corners[face[1]] - corners[face[0]], corners[face[2]] - corners[face[0]]));
+        ascii += "  facet normal " + std::to_string(normal.x) + " " + std::to_string(normal.y) + " " +
+                 std::to_string(normal.z) + "\n    outer loop\n";
+        for (int index : face) {
+            const glm::vec3& p = corners[index];
+            appendBytes(&p.x, sizeof(float) * 3);
+            ascii += "      vertex " + std::to_string(p.x) + "e+00 +" + std::to_string(p.y) + " " +
+                     std::to_string(p.z) + "\n";
+        }
+        const std::uint16_t attributes = 0;
+        appendBytes(&attributes, sizeof(attributes));
+        ascii += "    endloop\n  endfacet\n";
+    }
+    ascii += "endsolid cube\n";
+
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto asciiPath = directory / "vkengine_cube_ascii.stl";
+    const auto binaryPath = directory / "vkengine_cube_binary.stl";
+    {
+        std::ofstream(asciiPath, std::ios::binary) << ascii;
+        std::ofstream(binaryPath, std::ios::binary)
+            .write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+    }
+
+    const vkengine::MeshData fromAscii = vkengine::loadStlMesh(asciiPath);
+    const vkengine::MeshData fromBinary = vkengine::loadStlMesh(binaryPath);
+    for (const auto* mesh : {&fromAscii, &fromBinary}) {
+        ASSERT_EQ(mesh->indices.size(), 36u);
+        // Flat shading keeps the faces apart: four corners per side.
+        EXPECT_EQ(mesh->vertices.size(), 24u);
+        EXPECT_EQ(mesh->boundsMin, glm::vec3(0.0f));
+        EXPECT_EQ(mesh->boundsMax, glm::vec3(1.0f));
+    }
+    for (std::size_t i = 0; i < fromAscii.indices.size(); ++i) {
+        const auto& a = fromAscii.vertices[fromAscii.indices[i]];
+        const auto& b = fromBinary.vertices[fromBinary.indices[i]];
+        EXPECT_EQ(a.position, b.position);
+        EXPECT_NEAR(glm::dot(a.normal, b.normal), 1.0f, 1e-5f);
+    }
+
+    vkengine::MeshLoadOptions unwelded{};
+    unwelded.weldVertices = false;
+    EXPECT_EQ(vkengine::loadStlMesh(binaryPath, unwelded).vertices.size(), 36u);
+
+    vkengine::MeshLoadOptions smooth{};
+    smooth.creaseAngleDegrees = 100.0f;
+    const vkengine::MeshData smoothed = vkengine::loadStlMesh(binaryPath, smooth);
+    ASSERT_EQ(smoothed.vertices.size(), 8u);
+    for (const auto& vertex : smoothed.vertices) {
+        // Each corner averages three face normals (corners shared by two triangles of one face
+        // count that face twice), so it points away from the cube centre.
+        EXPECT_GT(glm::dot(vertex.normal, vertex.position - glm::vec3(0.5f)), 0.0f);
+    }
+
+    EXPECT_THROW((void)vkengine::loadStlMesh(directory / "vkengine_missing.stl"), std::runtime_error);
+    std::filesystem::remove(asciiPath);
+    std::filesystem::remove(binaryPath);
+}
+
+TEST(ProfilerTests, ScopesFromManyThreadsAggregateAtFrameBoundaries) {
+    auto& profiler = vkengine::Profiler::instance();
+    profiler.collect();  // Leave out engine scopes recorded by earlier tests.
+    profiler.setHistorySize(8);
+    const std::uint32_t outerId = profiler.internName("ProfilerTests.Outer");
+    const std::uint32_t innerId = profiler.internName("ProfilerTests.Inner");
+    const auto countOwnSamples = [&]() {
+        return std::count_if(profiler.currentFrame().samples.begin(), profiler.currentFrame().samples.end(),
+                             [&](const auto& sample) { return sample.nameId == outerId || sample.nameId == innerId; });
+    };
+    EXPECT_EQ(profiler.internName(std::string("ProfilerTests.") + "Outer"), outerId);
+    EXPECT_EQ(profiler.nameOf(outerId), "ProfilerTests.Outer");
+
+    constexpr int kThreads = 4;
+    constexpr int kCallsPerThread = 100;
+    const auto work = []() {
+        for (int i = 0; i < kCallsPerThread; ++i) {
+            PROFILE_SCOPE("ProfilerTests.Outer");
+            PROFILE_SCOPE("ProfilerTests.Inner");
+        }
+    };
+
+    profiler.beginFrame();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back(work);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    profiler.endFrame();
+
+    const auto outer = profiler.getStats("ProfilerTests.Outer");
+    const auto inner = profiler.getStats("ProfilerTests.Inner");
+    EXPECT_EQ(outer.callCount, static_cast<std::uint32_t>(kThreads * kCallsPerThread));
+    EXPECT_EQ(inner.callCount, static_cast<std::uint32_t>(kThreads * kCallsPerThread));
+    EXPECT_LE(outer.minTime, outer.avgTime);
+    EXPECT_LE(outer.avgTime, outer.maxTime);
+    EXPECT_GE(outer.avgTime, inner.avgTime);
+
+    std::size_t outerSamples = 0;
+    for (const auto& sample : profiler.currentFrame().samples) {
+        if (sample.nameId != outerId && sample.nameId != innerId) {
+            continue;
+        }
+        EXPECT_LE(sample.startTime, sample.endTime);
+        EXPECT_EQ(sample.depth, sample.name == "ProfilerTests.Outer" ? 0u : 1u);
+        outerSamples += sample.nameId == outerId ? 1 : 0;
+    }
+    EXPECT_EQ(outerSamples, static_cast<std::size_t>(kThreads * kCallsPerThread));
+
+    // Exited threads hand their rings to new threads instead of growing the pool.
+    profiler.beginFrame();
+    std::thread(work).join();
+    profiler.endFrame();
+    EXPECT_EQ(countOwnSamples(), 2 * kCallsPerThread);
+    EXPECT_EQ(profiler.getStats("ProfilerTests.Outer").callCount,
+              static_cast<std::uint32_t>((kThreads + 1) * kCallsPerThread));
+
+    // Old frames age out of the statistics.
+    for (int frame = 0; frame < 8; ++frame) {
+        profiler.beginFrame();
+        profiler.endFrame();
+    }
+    EXPECT_EQ(profiler.getStats("ProfilerTests.Outer").callCount, 0u);
+    const std::vector<float> frameTimes = profiler.frameTimeHistory();
+    ASSERT_EQ(frameTimes.size(), 8u);
+    EXPECT_EQ(frameTimes.back(), profiler.currentFrame().cpuTimeMs);
+
+    profiler.setEnabled(false);
+    profiler.beginFrame();
+    work();
+    profiler.endFrame();
+    profiler.setEnabled(true);
+    profiler.beginFrame();
+    profiler.endFrame();
+    EXPECT_EQ(profiler.getStats("ProfilerTests.Outer").callCount, 0u);
+
+    // A ring that fills up between collects drops scopes rather than blocking or allocating.
+    profiler.setThreadBufferCapacity(64);
+    const std::uint64_t droppedBefore = profiler.droppedSamples();
+    profiler.beginFrame();
+    std::thread([]() {
+        for (int i = 0; i < 100; ++i) {
+            PROFILE_SCOPE("ProfilerTests.Overflow");
+        }
+    }).join();
+    profiler.endFrame();
+    EXPECT_EQ(profiler.getStats("ProfilerTests.Overflow").callCount + profiler.droppedSamples() - droppedBefore, 100u);
+    profiler.setThreadBufferCapacity(1u << 16);
+
+    // Resizing keeps the newest frame times, oldest first.
+    const std::vector<float> beforeResize = profiler.frameTimeHistory();
+    profiler.setHistorySize(3);
+    EXPECT_EQ(profiler.frameTimeHistory(), std::vector<float>(beforeResize.end() - 3, beforeResize.end()));
+    profiler.setHistorySize(120);
+    EXPECT_EQ(profiler.frameTimeHistory().size(), 3u);
+}
+
+TEST(ProfilerTests, ChromeTraceCapturesPhysicsFramesFromAllThreads) {
+    constexpr int kFrames = 5;
+    vkengine::GameEngine engine;
+    auto& ground = engine.scene().createObject("Ground", vkengine::MeshType::Cube);
+    ground.enableCollider(glm::vec3(50.0f, 0.5f, 50.0f), /*isStatic=*/true);
+    std::vector<vkengine::GameObject*> boxes = engine.scene().createObjects(2000, vkengine::MeshType::Cube);
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        boxes[i]->transform().position =
+            glm::vec3(static_cast<float>(i % 40) * 1.1f - 22.0f, 1.0f + static_cast<float>(i / 1600),
+                      static_cast<float>((i / 40) % 40) * 1.1f - 22.0f);
+        boxes[i]->enableCollider(glm::vec3(0.5f), /*isStatic=*/false);
+    }
+
+    auto& profiler = vkengine::Profiler::instance();
+    profiler.setThreadName("Main");
+    profiler.beginCapture(kFrames);
+    for (int frame = 0; frame < kFrames + 2; ++frame) {
+        profiler.beginFrame();
+        engine.update(1.0f / 60.0f);
+        core::parallelFor(64, 1, [](std::size_t) { PROFILE_SCOPE("ProfilerTests.WorkerTask"); });
+        profiler.endFrame();
+    }
+    EXPECT_FALSE(profiler.isCapturing());
+    EXPECT_EQ(profiler.capturedFrameCount(), static_cast<std::size_t>(kFrames));
+
+    const auto path = std::filesystem::temp_directory_path() / "vkengine_profiler_trace.json";
+    ASSERT_TRUE(profiler.writeChromeTrace(path));
+    std::ifstream file(path);
+    const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove(path);
+
+    const auto trace = vkengine::JsonValue::parse(text);
+    ASSERT_NE(trace, nullptr);
+    ASSERT_TRUE(trace->has("traceEvents"));
+    const auto& events = (*trace)["traceEvents"];
+    ASSERT_TRUE(events.isArray());
+
+    std::map<int, std::string> threadNames;
+    std::map<std::string, int> counts;
+    std::map<int, std::vector<std::pair<double, double>>> spansByThread;
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const auto& event = events[i];
+        ASSERT_TRUE(event["name"].isString());
+        ASSERT_TRUE(event["tid"].isNumber());
+        const std::string phase = event["ph"].asString();
+        const int tid = event["tid"].asInt();
+        if (phase == "M") {
+            if (event["name"].asString() == "thread_name") {
+                threadNames[tid] = event["args"]["name"].asString();
+            }
+            continue;
+        }
+        ASSERT_EQ(phase, "X");
+        const double ts = event["ts"].asNumber();
+        const double dur = event["dur"].asNumber();
+        EXPECT_GE(dur, 0.0);
+        EXPECT_TRUE(threadNames.count(tid)) << "Event on a thread without a name record: " << tid;
+        ++counts[tid == 0 ? std::string("frame") : event["name"].asString()];
+        if (tid != 0) {
+            spansByThread[tid].emplace_back(ts, ts + dur);
+        }
+    }
+
+    EXPECT_EQ(threadNames[0], "Frames");
+    EXPECT_EQ(counts["frame"], kFrames);
+    EXPECT_EQ(counts["GameEngine.Update"], kFrames);
+    EXPECT_EQ(counts["PhysicsSystem.Update"], kFrames);
+    EXPECT_GE(counts["PhysicsSystem.ResolveCollisions"], kFrames);
+    EXPECT_EQ(counts["ProfilerTests.WorkerTask"], 64 * kFrames);
+    EXPECT_GE(counts["JobSystem.Job"], kFrames);
+    EXPECT_TRUE(std::any_of(threadNames.begin(), threadNames.end(),
+                            [](const auto& entry) { return entry.second == "Main"; }));
+    if (spansByThread.size() > 1) {
+        // Everything off the main thread here runs on the job pool.
+        EXPECT_TRUE(std::any_of(threadNames.begin(), threadNames.end(), [](const auto& entry) {
+            return entry.second.rfind("JobSystem Worker ", 0) == 0;
+        }));
+    }
+
+    // Scopes on one thread nest: each span either contains the next one or ends before it starts.
+    for (auto& [tid, spans] : spansByThread) {
+        std::sort(spans.begin(), spans.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first || (a.first == b.first && a.second > b.second);
+        });
+        std::vector<double> open;
+        for (const auto& [start, end] : spans) {
+            while (!open.empty() && open.back() <= start) {
+                open.pop_back();
+            }
+            if (!open.empty()) {
+                EXPECT_LE(end, open.back() + 0.002) << "Overlapping scopes on trace thread " << tid;
+            }
+            open.push_back(end);
+        }
+    }
+}
+
+TEST(LoggerTests, AsyncWriterKeepsOrderAndAppliesOverflowPolicy) {
+    auto& logger = vkengine::Logger::instance();
+    logger.flush();
+    const vkengine::LogLevel previousLevel = logger.getMinLevel();
+    const vkengine::LogOverflowPolicy previousPolicy = logger.getOverflowPolicy();
+    logger.setConsoleOutput(false);
+    logger.setMaxEntries(std::size_t{1} << 15);
+    logger.setMinLevel(vkengine::LogLevel::Info);
+    logger.clear();
+
+    // Filtered levels never build their message.
+    int evaluated = 0;
+    EVE_LOG_DEBUG((++evaluated, std::string("skipped")));
+    EXPECT_EQ(evaluated, 0);
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "vkengine_logger_test.log";
+    std::filesystem::remove(path);
+    logger.setLogFile(path.string());
+
+    // Many producers, one writer: every record reaches the file once, in order per producer.
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 2000;
+    logger.setOverflowPolicy(vkengine::LogOverflowPolicy::Block);
+    const std::uint64_t droppedBefore = logger.droppedCount();
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t) {
+        producers.emplace_back([&logger, t]() {
+            for (int i = 0; i < kPerThread; ++i) {
+                logger.info("worker " + std::to_string(t) + " record " + std::to_string(i), "LoggerTests");
+                logger.trace("filtered", "LoggerTests");
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    logger.flush();
+    logger.closeLogFile();
+    EXPECT_EQ(logger.droppedCount(), droppedBefore);
+    EXPECT_EQ(logger.entries().size(), static_cast<std::size_t>(kThreads * kPerThread));
+
+    std::ifstream file(path);
+    std::vector<int> nextRecord(kThreads, 0);
+    std::string line;
+    int lines = 0;
+    while (std::getline(file, line)) {
+        ++lines;
+        ASSERT_NE(line.find("[INFO]  [LoggerTests] worker "), std::string::npos) << line;
+        int thread = -1;
+        int record = -1;
+        ASSERT_EQ(std::sscanf(line.c_str() + line.find("worker "), "worker %d record %d", &thread, &record), 2);
+        ASSERT_GE(thread, 0);
+        ASSERT_LT(thread, kThreads);
+        EXPECT_EQ(record, nextRecord[thread]++);
+    }
+    EXPECT_EQ(lines, kThreads * kPerThread);
+    file.close();
+    std::filesystem::remove(path);
+
+    // Stall the writer inside a callback so the queue fills up.
+    std::atomic<bool> stalled{false};
+    std::atomic<bool> release{false};
+    logger.addCallback("stall", [&](const vkengine::LogEntry&) {
+        stalled = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    constexpr std::size_t kOverflow = vkengine::Logger::QueueCapacity + 100;
+
+    logger.setOverflowPolicy(vkengine::LogOverflowPolicy::Drop);
+    logger.clear();
+    logger.info("first");
+    while (!stalled) {
+        std::this_thread::yield();
+    }
+    for (std::size_t i = 0; i < kOverflow; ++i) {
+        logger.info("overflow");
+    }
+    EXPECT_EQ(logger.droppedCount() - droppedBefore, 100u);
+    release = true;
+    logger.flush();
+    EXPECT_EQ(logger.entries().size(), 1 + vkengine::Logger::QueueCapacity);
+
+    logger.setOverflowPolicy(vkengine::LogOverflowPolicy::Block);
+    logger.clear();
+    stalled = false;
+    release = false;
+    logger.info("first");
+    while (!stalled) {
+        std::this_thread::yield();
+    }
+    std::atomic<bool> producerDone{false};
+    std::thread producer([&]() {
+        for (std::size_t i = 0; i < kOverflow; ++i) {
+            logger.info("overflow");
+        }
+        producerDone = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(producerDone.load());
+    release = true;
+    producer.join();
+    logger.flush();
+    EXPECT_EQ(logger.droppedCount() - droppedBefore, 100u);
+    EXPECT_EQ(logger.entries().size(), 1 + kOverflow);
+
+    logger.removeCallback("stall");
+    logger.clear();
+    logger.setMaxEntries(1000);
+    logger.setOverflowPolicy(previousPolicy);
+    logger.setMinLevel(previousLevel);
+    logger.setConsoleOutput(true);
+}
+
 TEST(SanityCheck, BasicMath) {
     EXPECT_EQ(2 + 2, 4);
 }
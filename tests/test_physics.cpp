@@ -3,12 +3,22 @@
 #include <glm/glm.hpp>
 
 #include <cmath>
+#include <cstdint>
 #include <limits>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "engine/Broadphase.hpp"
 #include "engine/GameEngine.hpp"
+#include "engine/GravityOctree.hpp"
+#include "engine/MassSpringSystem.hpp"
+#include "engine/ParticleStore.hpp"
+#include "engine/MolecularDynamics.hpp"
 #include "engine/PhysicsDetail.hpp"
 #include "engine/PhysicsSystem.hpp"
+#include "engine/RigidBodyStore.hpp"
 
 namespace {
 
@@ -229,4 +239,372 @@ TEST(PhysicsSystemTests, HigherMaterialDissipationSlowsSpinMore)
     EXPECT_LT(highSpeed, lowSpeed);
 }
 
+TEST(PhysicsSystemTests, RestingIslandsSleepUntilTouched)
+{
+    Scene scene;
+    auto& mover = createDynamicCube(scene, "Mover", {0.0f, 0.0f, 0.0f}, glm::vec3(0.5f));
+    auto& target = createDynamicCube(scene, "Target", {3.0f, 0.0f, 0.0f}, glm::vec3(0.5f));
+    auto& bystander = createDynamicCube(scene, "Bystander", {0.0f, 10.0f, 0.0f}, glm::vec3(0.5f));
+
+    PhysicsSystem system;
+    system.setGravity({0.0f, 0.0f, 0.0f});
+    const int stepsToSleep = static_cast<int>(std::ceil(PhysicsSystem::kTimeToSleep / 0.016f)) + 2;
+    for (int i = 0; i < stepsToSleep; ++i) {
+        system.update(scene, 0.016f);
+    }
+    EXPECT_TRUE(mover.physics().sleeping);
+    EXPECT_TRUE(target.physics().sleeping);
+    EXPECT_TRUE(bystander.physics().sleeping);
+    EXPECT_EQ(system.sleepingBodyCount(), 3u);
+
+    // Setting a velocity wakes the mover; hitting the target wakes it, the bystander keeps sleeping.
+    mover.physics().velocity = glm::vec3(4.0f, 0.0f, 0.0f);
+    for (int i = 0; i < 60; ++i) {
+        system.update(scene, 0.016f);
+    }
+    EXPECT_FALSE(mover.physics().sleeping);
+    EXPECT_FALSE(target.physics().sleeping);
+    EXPECT_GT(target.transform().position.x, 3.0f);
+    EXPECT_TRUE(bystander.physics().sleeping);
+    EXPECT_FLOAT_EQ(bystander.transform().position.y, 10.0f);
+}
+
+TEST(RigidBodyStoreTests, VectorIntegratorMatchesScalarKernel)
+{
+    // 19 bodies so the vector paths also leave a scalar tail.
+    Scene scene;
+    for (int i = 0; i < 19; ++i) {
+        const float f = static_cast<float>(i);
+        auto& object = createDynamicCube(scene, "Body" + std::to_string(i), {f, 0.5f * f, -f},
+                                         glm::vec3(0.2f + 0.05f * f, 0.5f, 0.3f), 0.5f + 0.25f * f);
+        object.transform().rotation = {0.1f * f, 0.2f * f, 0.05f * f};
+        auto& props = object.physics();
+        props.velocity = {std::sin(f), std::cos(f), 0.5f};
+        props.angularVelocity = {0.3f * f, -1.0f, std::cos(2.0f * f)};
+        props.accumulatedForces = {f, -2.0f * f, 1.0f};
+        props.accumulatedTorque = {0.5f, 0.1f * f, -0.2f};
+        props.linearDamping = 0.05f * static_cast<float>(i % 4);
+        props.simulate = (i % 7) != 3;
+    }
+
+    RigidBodyStore vectorStore;
+    RigidBodyStore scalarStore;
+    vectorStore.gather(scene.objectsCached(), true);
+    scalarStore.gather(scene.objectsCached(), true);
+    const glm::vec3 gravity{0.0f, -9.81f, 0.0f};
+    for (int step = 0; step < 10; ++step) {
+        vectorStore.integrate(gravity, 1.0f / 120.0f);
+        scalarStore.integrateScalar(gravity, 1.0f / 120.0f);
+    }
+
+    const auto& objects = scene.objectsCached();
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        const glm::vec3 p = vectorStore.position(i) - scalarStore.position(i);
+        const glm::vec3 v = vectorStore.velocity(i) - scalarStore.velocity(i);
+        const glm::vec3 w = vectorStore.angularVelocity(i) - scalarStore.angularVelocity(i);
+        const glm::quat q = vectorStore.orientation(i);
+        const glm::quat r = scalarStore.orientation(i);
+        EXPECT_LT(glm::length(p) + glm::length(v) + glm::length(w), 1e-4f) << "body " << i;
+        EXPECT_NEAR(std::abs(glm::dot(q, r)), 1.0f, 1e-5f) << "body " << i;
+        if (!objects[i]->physics().simulate) {
+            EXPECT_EQ(vectorStore.position(i), objects[i]->transform().position) << "body " << i;
+        }
+    }
+}
+
+TEST(MolecularDynamicsTests, NeighborListForcesMatchAllPairs)
+{
+    // Jittered lattice big enough for the parallel force blocks.
+    MolecularDynamicsSimulation simulation;
+    MdMaterial material = MdMaterial::copper();
+    material.damping = 0.0f;
+    simulation.setMaterial(material);
+    simulation.setMinimumInteractionDistance(0.2f);
+    simulation.setBounds(MdBox{glm::vec3(-10.0f), glm::vec3(10.0f)});
+    for (int z = 0; z < 13; ++z) {
+        for (int y = 0; y < 13; ++y) {
+            for (int x = 0; x < 13; ++x) {
+                const float f = static_cast<float>(x + 13 * (y + 13 * z));
+                const glm::vec3 jitter{0.1f * std::sin(f), 0.1f * std::cos(1.3f * f), 0.1f * std::sin(0.7f * f)};
+                simulation.addAtom(glm::vec3(x, y, z) * 1.12f - glm::vec3(6.7f) + jitter,
+                                   glm::vec3(std::cos(f), std::sin(2.0f * f), 0.5f));
+            }
+        }
+    }
+
+    const auto expectAllPairForces = [&](const char* stage) {
+        const auto& atoms = simulation.atoms();
+        const float cutoffSquared = material.cutoffRadius * material.cutoffRadius;
+        std::vector<glm::vec3> reference(atoms.size(), glm::vec3(0.0f));
+        for (std::size_t i = 0; i < atoms.size(); ++i) {
+            for (std::size_t j = i + 1; j < atoms.size(); ++j) {
+                const glm::vec3 delta = atoms[j].position - atoms[i].position;
+                const float r2 = std::max(glm::dot(delta, delta), 0.04f);
+                if (r2 > cutoffSquared) {
+                    continue;
+                }
+                const float term = 1.0f / (r2 * r2 * r2);
+                const glm::vec3 force = 24.0f * material.epsilon / r2 * term * (2.0f * term - 1.0f) * delta;
+                reference[i] += force;
+                reference[j] -= force;
+            }
+        }
+        for (std::size_t i = 0; i < atoms.size(); ++i) {
+            EXPECT_LT(glm::length(atoms[i].force - reference[i]), 1e-4f + 1e-3f * glm::length(reference[i]))
+                << stage << " atom " << i;
+        }
+    };
+
+    // step() leaves the forces at the final positions in MdAtom::force.
+    for (int i = 0; i < 20; ++i) {
+        simulation.step(0.001f);
+    }
+    expectAllPairForces("after steps");
+    EXPECT_GE(simulation.neighborListRebuildCount(), 1u);
+    EXPECT_LT(simulation.neighborListRebuildCount(), 20u);
+
+    // Teleporting an atom next to another one invalidates the list.
+    const std::uint64_t rebuilds = simulation.neighborListRebuildCount();
+    simulation.atoms()[0].position = simulation.atoms()[1000].position + glm::vec3(0.9f, 0.0f, 0.0f);
+    simulation.step(0.001f);
+    EXPECT_GT(simulation.neighborListRebuildCount(), rebuilds);
+    expectAllPairForces("after teleport");
+}
+
+TEST(GravityOctreeTests, FieldsApproachDirectSum)
+{
+    // Two offset clusters plus a sparse halo, with coincident points to reach the depth limit.
+    std::vector<glm::vec3> positions;
+    std::vector<float> masses;
+    for (int i = 0; i < 3000; ++i) {
+        const float f = static_cast<float>(i);
+        const glm::vec3 jitter{std::sin(1.3f * f), std::cos(0.7f * f), std::sin(2.9f * f + 1.0f)};
+        const glm::vec3 center = (i % 3 == 0) ? glm::vec3(20.0f, 0.0f, 0.0f) : glm::vec3(-5.0f, 3.0f, 0.0f);
+        positions.push_back(center + jitter * (i % 10 == 0 ? 30.0f : 4.0f));
+        masses.push_back(0.5f + 0.25f * static_cast<float>(i % 5));
+    }
+    positions.insert(positions.end(), 20, glm::vec3(1.0f, 2.0f, 3.0f));
+    masses.insert(masses.end(), 20, 1.0f);
+
+    constexpr float kGravity = 2.0f;
+    constexpr float kSoftening = 0.25f;
+    const std::size_t count = positions.size();
+    std::vector<glm::vec3> direct(count, glm::vec3(0.0f));
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t j = 0; j < count; ++j) {
+            if (i != j) {
+                const glm::vec3 offset = positions[j] - positions[i];
+                const float invDist = 1.0f / std::sqrt(glm::dot(offset, offset) + kSoftening);
+                direct[i] += offset * (kGravity * masses[j] * invDist * invDist * invDist);
+            }
+        }
+    }
+
+    const auto relativeError = [&](const std::vector<glm::vec3>& fields) {
+        double error = 0.0;
+        double norm = 0.0;
+        for (std::size_t i = 0; i < count; ++i) {
+            error += static_cast<double>(glm::dot(fields[i] - direct[i], fields[i] - direct[i]));
+            norm += static_cast<double>(glm::dot(direct[i], direct[i]));
+        }
+        return std::sqrt(error / norm);
+    };
+
+    GravityOctree tree;
+    tree.build(positions.data(), masses.data(), count);
+    EXPECT_EQ(tree.size(), count);
+    EXPECT_GT(tree.nodeCount(), count / GravityOctree::kLeafCapacity);
+
+    std::vector<glm::vec3> exact(count);
+    tree.computeFields(kGravity, kSoftening, 0.0f, exact.data());
+    EXPECT_LT(relativeError(exact), 1e-5);
+
+    std::vector<glm::vec3> approximate(count);
+    tree.computeFields(kGravity, kSoftening, 0.5f, approximate.data());
+    EXPECT_LT(relativeError(approximate), 1e-2);
+}
+
+TEST(ParticleStoreTests, DeadParticlesAreSwapRemovedAndKernelsCoverTail)
+{
+    // 11 particles so the vector paths leave a scalar tail.
+    ParticleStore store;
+    store.setCapacity(11);
+    for (int i = 0; i < 12; ++i) {
+        Particle particle{};
+        particle.position = {static_cast<float>(i), 0.0f, 0.0f};
+        particle.velocity = {1.0f, static_cast<float>(i), -1.0f};
+        particle.lifetime = static_cast<float>(i);
+        store.push(particle);
+    }
+    ASSERT_EQ(store.size(), 11u);
+    EXPECT_TRUE(store.full());
+
+    std::vector<float> accelX(11, 2.0f);
+    std::vector<float> accelY(11, 0.0f);
+    std::vector<float> accelZ(11, -4.0f);
+    store.integrate(accelX.data(), accelY.data(), accelZ.data(), 0.5f, 0.5f);
+    for (std::size_t i = 0; i < store.size(); ++i) {
+        // v = (v + a dt) * damping, p += v dt.
+        EXPECT_FLOAT_EQ(store.velocitiesX()[i], 1.0f);
+        EXPECT_FLOAT_EQ(store.velocitiesY()[i], 0.5f * static_cast<float>(i));
+        EXPECT_FLOAT_EQ(store.velocitiesZ()[i], -1.5f);
+        EXPECT_FLOAT_EQ(store.positionsX()[i], static_cast<float>(i) + 0.5f);
+        EXPECT_FLOAT_EQ(store.positionsZ()[i], -0.75f);
+    }
+
+    // Lifetimes 0..4 run out; the survivors stay packed at the front.
+    store.advanceAges(4.5f);
+    ASSERT_EQ(store.size(), 6u);
+    std::set<float> lifetimes(store.lifetimes().begin(), store.lifetimes().end());
+    EXPECT_EQ(lifetimes, (std::set<float>{5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f}));
+    for (std::size_t i = 0; i < store.size(); ++i) {
+        const Particle particle = store.get(i);
+        EXPECT_FLOAT_EQ(particle.age, 4.5f);
+        EXPECT_FLOAT_EQ(particle.position.x, particle.lifetime + 0.5f) << "particle moved with its slot";
+    }
+
+    store.updateColors(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f, 1.0f, 0.0f, 0.0f));
+    for (std::size_t i = 0; i < store.size(); ++i) {
+        const float t = 4.5f / store.lifetimes()[i];
+        EXPECT_FLOAT_EQ(store.normalizedAges()[i], t);
+        EXPECT_FLOAT_EQ(store.colorsR()[i], 1.0f - t);
+        EXPECT_FLOAT_EQ(store.colorsG()[i], t);
+        EXPECT_FLOAT_EQ(store.colorsA()[i], 1.0f - t);
+    }
+}
+
+TEST(MassSpringSystemTests, GatheredSpringForcesMatchScatteredReference)
+{
+    // 11 nodes in a zig-zag chain so the vector paths leave a scalar tail; node 0 is pinned and the
+    // last nodes start below the floor.
+    constexpr std::size_t kNodes = 11;
+    MassSpringSystem network;
+    network.resize(kNodes);
+    std::vector<glm::vec3> positions(kNodes);
+    std::vector<glm::vec3> velocities(kNodes, glm::vec3(0.0f));
+    for (std::size_t i = 0; i < kNodes; ++i) {
+        positions[i] = {0.3f * static_cast<float>(i), (i % 2 == 0 ? 0.0f : 0.2f) - 0.05f * static_cast<float>(i), 0.0f};
+        velocities[i] = {0.0f, i % 3 == 0 ? 0.5f : -0.5f, 0.1f};
+        network.setPosition(i, positions[i]);
+        network.setVelocity(i, velocities[i]);
+    }
+    network.setPinned(0, true);
+
+    struct Spring {
+        std::size_t a;
+        std::size_t b;
+        float rest;
+        float stiffness;
+    };
+    std::vector<Spring> springs;
+    for (std::size_t i = 0; i + 1 < kNodes; ++i) {
+        springs.push_back({i, i + 1, 0.25f, 50.0f});
+        if (i + 2 < kNodes) {
+            springs.push_back({i + 2, i, 0.5f, 20.0f});
+        }
+    }
+    for (const Spring& spring : springs) {
+        network.addSpring(spring.a, spring.b, spring.rest, spring.stiffness);
+    }
+
+    MassSpringSystem::StepParams params;
+    params.gravity = {0.0f, -9.81f, 0.0f};
+    params.deltaSeconds = 1.0f / 60.0f;
+    params.massPerNode = 0.5f;
+    params.damping = 0.1f;
+    params.velocityRetention = 0.95f;
+    params.floorY = -0.4f;
+    params.floorRestitution = 0.3f;
+    params.floorUpwardRetention = 0.0f;
+
+    for (int step = 0; step < 30; ++step) {
+        network.step(params);
+
+        std::vector<glm::vec3> accelerations(kNodes, params.gravity);
+        for (const Spring& spring : springs) {
+            const glm::vec3 delta = positions[spring.b] - positions[spring.a];
+            const float length = glm::length(delta);
+            const glm::vec3 force = spring.stiffness * (length - spring.rest) * delta / length;
+            accelerations[spring.a] += force / params.massPerNode;
+            accelerations[spring.b] -= force / params.massPerNode;
+        }
+        for (std::size_t i = 1; i < kNodes; ++i) {
+            velocities[i] += (accelerations[i] - params.damping * velocities[i]) * params.deltaSeconds;
+            velocities[i] *= params.velocityRetention;
+            positions[i] += velocities[i] * params.deltaSeconds;
+            if (positions[i].y < params.floorY) {
+                positions[i].y = params.floorY;
+                velocities[i].y = velocities[i].y < 0.0f ? -params.floorRestitution * velocities[i].y : 0.0f;
+            }
+        }
+    }
+
+    EXPECT_EQ(network.position(0), positions[0]);
+    EXPECT_EQ(network.velocity(0), glm::vec3(0.0f));
+    for (std::size_t i = 1; i < kNodes; ++i) {
+        EXPECT_NEAR(network.position(i).x, positions[i].x, 1e-4f) << "node " << i;
+        EXPECT_NEAR(network.position(i).y, positions[i].y, 1e-4f) << "node " << i;
+        EXPECT_NEAR(network.position(i).z, positions[i].z, 1e-4f) << "node " << i;
+        EXPECT_NEAR(network.velocity(i).y, velocities[i].y, 1e-3f) << "node " << i;
+        EXPECT_GE(network.position(i).y, params.floorY);
+    }
+
+    // A flat quad in the XZ plane: every corner gets the face normal, unreferenced nodes get +Y.
+    MassSpringSystem quad;
+    quad.resize(5);
+    quad.setPosition(0, {0.0f, 0.0f, 0.0f});
+    quad.setPosition(1, {1.0f, 0.0f, 0.0f});
+    quad.setPosition(2, {0.0f, 0.0f, 1.0f});
+    quad.setPosition(3, {1.0f, 0.0f, 1.0f});
+    quad.setTriangles({0, 2, 1, 1, 2, 3});
+    std::vector<glm::vec3> normals;
+    quad.computeVertexNormals(1e-5f, normals);
+    ASSERT_EQ(normals.size(), 5u);
+    for (std::size_t i = 0; i < 4; ++i) {
+        EXPECT_NEAR(normals[i].y, 1.0f, 1e-6f);
+    }
+    EXPECT_EQ(normals[4], glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+TEST(BroadphaseTests, PairsFollowMovingAndRemovedBodies)
+{
+    const auto box = [](const glm::vec3& center) { return AABB{center - glm::vec3(0.5f), center + glm::vec3(0.5f)}; };
+    const auto collectPairs = [](const Broadphase& broadphase) {
+        std::set<std::pair<std::uint32_t, std::uint32_t>> pairs;
+        broadphase.forEachPair([&](std::uint32_t a, std::uint32_t b) { pairs.emplace(std::min(a, b), std::max(a, b)); });
+        return pairs;
+    };
+    const auto a = core::ecs::makeEntityId(1, 1);
+    const auto b = core::ecs::makeEntityId(2, 1);
+    const auto c = core::ecs::makeEntityId(3, 1);
+
+    Broadphase broadphase;
+    broadphase.updateBody(a, box({0.0f, 0.0f, 0.0f}), glm::vec3(0.0f), 0);
+    broadphase.updateBody(b, box({0.8f, 0.0f, 0.0f}), glm::vec3(0.0f), 1);
+    broadphase.updateBody(c, box({5.0f, 0.0f, 0.0f}), glm::vec3(0.0f), 2);
+    broadphase.finishUpdate();
+    EXPECT_EQ(collectPairs(broadphase), (std::set<std::pair<std::uint32_t, std::uint32_t>>{{0, 1}}));
+
+    // Small jitter stays inside the fat bounds and does not touch the tree.
+    broadphase.updateBody(a, box({0.01f, 0.0f, 0.0f}), glm::vec3(0.0f), 0);
+    broadphase.updateBody(b, box({0.8f, 0.0f, 0.0f}), glm::vec3(0.0f), 1);
+    broadphase.updateBody(c, box({5.0f, 0.0f, 0.0f}), glm::vec3(0.0f), 2);
+    broadphase.finishUpdate();
+    EXPECT_EQ(broadphase.movedLastUpdate(), 0u);
+
+    // C moves next to B, A is no longer updated and is dropped.
+    broadphase.updateBody(b, box({0.8f, 0.0f, 0.0f}), glm::vec3(0.0f), 0);
+    broadphase.updateBody(c, box({1.6f, 0.0f, 0.0f}), glm::vec3(-3.4f, 0.0f, 0.0f), 1);
+    broadphase.finishUpdate();
+    EXPECT_EQ(broadphase.bodyCount(), 2u);
+    EXPECT_EQ(collectPairs(broadphase), (std::set<std::pair<std::uint32_t, std::uint32_t>>{{0, 1}}));
+
+    // A recycled entity slot is a new body, not a continuation of the old one.
+    broadphase.updateBody(core::ecs::makeEntityId(2, 2), box({20.0f, 0.0f, 0.0f}), glm::vec3(0.0f), 0);
+    broadphase.updateBody(c, box({1.6f, 0.0f, 0.0f}), glm::vec3(0.0f), 1);
+    broadphase.finishUpdate();
+    EXPECT_EQ(broadphase.bodyCount(), 2u);
+    EXPECT_TRUE(collectPairs(broadphase).empty());
+}
+
 } // namespace
@@ -1,19 +1,49 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iomanip>
+#include <limits>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <glm/glm.hpp>
 
+#include "core/ParallelFor.hpp"
 #include "core/VulkanRenderer.hpp"
+#include "engine/Broadphase.hpp"
+#include "engine/DebugTools.hpp"
+#include "engine/DeformableBody.hpp"
 #include "engine/GameEngine.hpp"
+#include "engine/GravityOctree.hpp"
 #include "engine/HeadlessCapture.hpp"
+#include "engine/JobScheduler.hpp"
+#include "engine/MolecularDynamics.hpp"
+#include "engine/Network.hpp"
+#include "engine/ParticleSystem.hpp"
+#include "engine/PhysicsDetail.hpp"
+#include "engine/PhysicsSystem.hpp"
+#include "engine/RigidBodyStore.hpp"
+#include "engine/Serialization.hpp"
+#include "engine/SoftBodyVolume.hpp"
+#include "engine/assets/MeshLoader.hpp"
 
 namespace {
 
@@ -139,6 +169,163 @@ TimingResult measureFrames(VulkanRenderer& renderer,
     return {success, end - start};
 }
 
+// Mirrors the original hash-map component pools so the sparse-set registry has a baseline.
+struct MapPoolBaseline {
+    std::vector<core::ecs::EntityId> entities;
+    std::unordered_map<core::ecs::EntityId, vkengine::Transform> transforms;
+    std::unordered_map<core::ecs::EntityId, vkengine::PhysicsProperties> physics;
+
+    template <typename Func>
+    void view(Func&& func) {
+        for (auto id : entities) {
+            auto transformIt = transforms.find(id);
+            auto physicsIt = physics.find(id);
+            if (transformIt != transforms.end() && physicsIt != physics.end()) {
+                func(transformIt->second, physicsIt->second);
+            }
+        }
+    }
+};
+
+// Single mutex-guarded FIFO shared by all workers, i.e. the scheduler JobSystem used before it
+// switched to work-stealing deques. Kept here as the contention baseline.
+class SharedQueueBaseline {
+public:
+    explicit SharedQueueBaseline(std::size_t threadCount) {
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~SharedQueueBaseline() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            running = false;
+        }
+        queueCondition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    template <typename Func>
+    void parallelFor(std::size_t count, std::size_t batchSize, Func&& func) {
+        std::atomic<std::size_t> remaining{(count + batchSize - 1) / batchSize};
+        for (std::size_t begin = 0; begin < count; begin += batchSize) {
+            const std::size_t end = std::min(count, begin + batchSize);
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                jobQueue.push_back([&, begin, end]() {
+                    for (std::size_t i = begin; i < end; ++i) {
+                        func(i);
+                    }
+                    remaining.fetch_sub(1, std::memory_order_acq_rel);
+                });
+            }
+            queueCondition.notify_one();
+        }
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    void workerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCondition.wait(lock, [this]() { return !running || !jobQueue.empty(); });
+                if (!running && jobQueue.empty()) {
+                    return;
+                }
+                job = std::move(jobQueue.front());
+                jobQueue.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobQueue;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    bool running{true};
+};
+
+// The previous core::parallelFor: fresh threads per call, one index per atomic increment.
+template <typename Func>
+void threadPerCallParallelFor(std::size_t count, std::size_t minChunkSize, Func&& func) {
+    const std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t threadCount = std::min(maxThreads, (count + minChunkSize - 1) / minChunkSize);
+    std::atomic_size_t index{0};
+    auto worker = [&]() {
+        for (std::size_t i = index.fetch_add(1, std::memory_order_relaxed); i < count;
+             i = index.fetch_add(1, std::memory_order_relaxed)) {
+            func(i);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t + 1 < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// The previous PhysicsSystem broadphase: a uniform grid and pair set rebuilt from scratch on
+// every substep. Returns the number of candidate pairs whose bounds actually overlap.
+std::size_t gridBroadphaseOverlaps(const std::vector<vkengine::AABB>& bounds, float cellSize) {
+    struct Cell {
+        int x, y, z;
+        bool operator==(const Cell& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+    struct CellHash {
+        std::size_t operator()(const Cell& c) const {
+            return (static_cast<std::size_t>(c.x) * 73856093u) ^ (static_cast<std::size_t>(c.y) * 19349663u) ^
+                   (static_cast<std::size_t>(c.z) * 83492791u);
+        }
+    };
+    const auto toCell = [cellSize](const glm::vec3& p) {
+        return Cell{static_cast<int>(std::floor(p.x / cellSize)), static_cast<int>(std::floor(p.y / cellSize)),
+                    static_cast<int>(std::floor(p.z / cellSize))};
+    };
+
+    std::unordered_map<Cell, std::vector<std::uint32_t>, CellHash> grid;
+    grid.reserve(bounds.size() * 2);
+    for (std::uint32_t i = 0; i < bounds.size(); ++i) {
+        const Cell lo = toCell(bounds[i].min);
+        const Cell hi = toCell(bounds[i].max);
+        for (int z = lo.z; z <= hi.z; ++z) {
+            for (int y = lo.y; y <= hi.y; ++y) {
+                for (int x = lo.x; x <= hi.x; ++x) {
+                    grid[Cell{x, y, z}].push_back(i);
+                }
+            }
+        }
+    }
+
+    std::unordered_set<std::uint64_t> pairs;
+    pairs.reserve(bounds.size() * 4);
+    std::size_t overlaps = 0;
+    for (const auto& [cell, indices] : grid) {
+        for (std::size_t a = 0; a < indices.size(); ++a) {
+            for (std::size_t b = a + 1; b < indices.size(); ++b) {
+                const std::uint64_t key = (static_cast<std::uint64_t>(std::min(indices[a], indices[b])) << 32u) |
+                                          std::max(indices[a], indices[b]);
+                vkengine::physics_detail::CollisionResult result;
+                if (pairs.insert(key).second &&
+                    vkengine::physics_detail::computePenetration(bounds[indices[a]], bounds[indices[b]], result)) {
+                    ++overlaps;
+                }
+            }
+        }
+    }
+    return overlaps;
+}
+
 void configureRenderer(VulkanRenderer& renderer) {
     WindowConfig config{};
     config.width = 640;
@@ -345,6 +532,1180 @@ TEST(RenderPerformanceTests, HeadlessFrameTimingLargeScene) {
                                        << " avg=" << avgFrameMs << "ms threshold=" << thresholdMs << "ms";
 }
 
+TEST(PerformanceTests, RegistrySparseSetVersusMapPools) {
+    constexpr std::size_t kEntityCount = 50000;
+    constexpr std::size_t kIterations = 10;
+
+    core::ecs::Registry registry;
+    MapPoolBaseline baseline;
+    for (std::size_t i = 0; i < kEntityCount; ++i) {
+        auto entity = registry.createEntity();
+        registry.emplace<vkengine::Transform>(entity);
+        baseline.entities.push_back(entity.id);
+        baseline.transforms.emplace(entity.id, vkengine::Transform{});
+        if (i % 2 == 0) {
+            auto& props = registry.emplace<vkengine::PhysicsProperties>(entity);
+            props.velocity = glm::vec3{0.0f, 1.0f, 0.0f};
+            baseline.physics.emplace(entity.id, props);
+        }
+    }
+
+    const float dt = 1.0f / 60.0f;
+    const double sparseMs = averageMillis(kIterations, [&]() {
+        registry.view<vkengine::Transform, vkengine::PhysicsProperties>(
+            [&](core::ecs::Entity, vkengine::Transform& transform, vkengine::PhysicsProperties& props) {
+                transform.position += props.velocity * dt;
+            });
+    });
+    const double mapMs = averageMillis(kIterations, [&]() {
+        baseline.view([&](vkengine::Transform& transform, vkengine::PhysicsProperties& props) {
+            transform.position += props.velocity * dt;
+        });
+    });
+
+    RecordProperty("registry_view_sparse_ms", sparseMs);
+    RecordProperty("registry_view_map_ms", mapMs);
+    recordMetric("registry_view_sparse_ms", sparseMs);
+    recordMetric("registry_view_map_ms", mapMs);
+
+    const float thresholdMs = envFloatOrDefault("VKENGINE_REGISTRY_VIEW_MS", 50.0f);
+    EXPECT_LE(sparseMs, thresholdMs) << "Registry view exceeded threshold."
+                                     << " ms=" << sparseMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, RegistryParallelViewScaling) {
+    constexpr std::size_t kEntityCount = 100000;
+    constexpr std::size_t kIterations = 10;
+
+    core::ecs::Registry registry;
+    for (std::size_t i = 0; i < kEntityCount; ++i) {
+        auto entity = registry.createEntity();
+        registry.emplace<vkengine::Transform>(entity);
+        auto& props = registry.emplace<vkengine::PhysicsProperties>(entity);
+        props.velocity = glm::vec3{static_cast<float>(i % 7), 1.0f, 0.5f};
+    }
+
+    const float dt = 1.0f / 60.0f;
+    auto integrate = [&]() {
+        registry.parallelView<vkengine::Transform, vkengine::PhysicsProperties>(
+            [&](core::ecs::Entity, vkengine::Transform& transform, vkengine::PhysicsProperties& props) {
+                const float speed = glm::length(props.velocity);
+                props.velocity *= 1.0f - props.linearDamping * dt;
+                transform.position += props.velocity * dt;
+                transform.rotation.y += std::sqrt(speed + 1.0f) * dt;
+            });
+    };
+
+    auto& jobs = vkengine::JobSystem::instance();
+    const std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    double singleThreadMs = 0.0;
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        jobs.shutdown();
+        jobs.initialize(threads);
+        const double averageMs = averageMillis(kIterations, integrate);
+        if (threads == 1) {
+            singleThreadMs = averageMs;
+        }
+
+        const std::string keyMs = "registry_parallel_view_ms_t" + std::to_string(threads);
+        const std::string keySpeedup = "registry_parallel_view_speedup_t" + std::to_string(threads);
+        const double speedup = averageMs > 0.0 ? singleThreadMs / averageMs : 0.0;
+        RecordProperty(keyMs, averageMs);
+        RecordProperty(keySpeedup, speedup);
+        recordMetric(keyMs, averageMs);
+        recordMetric(keySpeedup, speedup);
+    }
+    jobs.shutdown();
+
+    std::size_t moved = 0;
+    registry.view<vkengine::Transform>([&](core::ecs::Entity, const vkengine::Transform& transform) {
+        if (transform.position.y > 0.0f) {
+            ++moved;
+        }
+    });
+    EXPECT_EQ(moved, kEntityCount);
+}
+
+TEST(PerformanceTests, JobSchedulerContention) {
+    constexpr std::size_t kElementCount = 1 << 20;
+    constexpr std::size_t kBatchSize = 64;
+    constexpr std::size_t kIterations = 5;
+
+    const std::size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<float> values(kElementCount, 1.0f);
+    auto kernel = [&](std::size_t i) { values[i] = values[i] * 0.5f + 1.0f; };
+
+    double sharedQueueMs = 0.0;
+    {
+        SharedQueueBaseline baseline(threadCount);
+        sharedQueueMs = averageMillis(kIterations, [&]() { baseline.parallelFor(kElementCount, kBatchSize, kernel); });
+    }
+
+    auto& jobs = vkengine::JobSystem::instance();
+    jobs.shutdown();
+    jobs.initialize(threadCount);
+    const double workStealingMs = averageMillis(kIterations, [&]() {
+        jobs.wait(jobs.parallelFor(kElementCount, kBatchSize, kernel));
+    });
+    const std::size_t stolen = jobs.stolenJobs();
+    jobs.shutdown();
+
+    RecordProperty("job_scheduler_shared_queue_ms", sharedQueueMs);
+    RecordProperty("job_scheduler_work_stealing_ms", workStealingMs);
+    recordMetric("job_scheduler_shared_queue_ms", sharedQueueMs);
+    recordMetric("job_scheduler_work_stealing_ms", workStealingMs);
+    recordMetric("job_scheduler_stolen_jobs", static_cast<double>(stolen));
+
+    for (float value : values) {
+        ASSERT_GT(value, 1.0f);
+    }
+}
+
+TEST(PerformanceTests, ParallelForCallOverhead) {
+    constexpr std::size_t kSmallCount = 64;
+    constexpr std::size_t kLargeCount = 1 << 20;
+    constexpr std::size_t kSmallRuns = 200;
+    constexpr std::size_t kLargeRuns = 5;
+
+    std::vector<float> values(kLargeCount, 1.0f);
+    auto kernel = [&](std::size_t i) { values[i] = values[i] * 0.5f + 1.0f; };
+
+    // Warm the pool so its startup is not charged to the first call.
+    core::parallelFor(kSmallCount, 4, kernel);
+
+    const double pooledSmallUs = averageMillis(kSmallRuns, [&]() { core::parallelFor(kSmallCount, 4, kernel); }) * 1000.0;
+    const double spawnedSmallUs =
+        averageMillis(kSmallRuns, [&]() { threadPerCallParallelFor(kSmallCount, 4, kernel); }) * 1000.0;
+    const double pooledLargeMs = averageMillis(kLargeRuns, [&]() { core::parallelFor(kLargeCount, 256, kernel); });
+    const double spawnedLargeMs =
+        averageMillis(kLargeRuns, [&]() { threadPerCallParallelFor(kLargeCount, 256, kernel); });
+
+    const double sum = core::parallelReduce(
+        kLargeCount, 256, 0.0, [&](double& acc, std::size_t i) { acc += values[i]; },
+        [](double lhs, double rhs) { return lhs + rhs; });
+
+    RecordProperty("parallel_for_small_pooled_us", pooledSmallUs);
+    RecordProperty("parallel_for_small_thread_per_call_us", spawnedSmallUs);
+    RecordProperty("parallel_for_large_pooled_ms", pooledLargeMs);
+    RecordProperty("parallel_for_large_thread_per_call_ms", spawnedLargeMs);
+    recordMetric("parallel_for_small_pooled_us", pooledSmallUs);
+    recordMetric("parallel_for_small_thread_per_call_us", spawnedSmallUs);
+    recordMetric("parallel_for_large_pooled_ms", pooledLargeMs);
+    recordMetric("parallel_for_large_thread_per_call_ms", spawnedLargeMs);
+
+    EXPECT_GT(sum, static_cast<double>(kLargeCount));
+
+    vkengine::JobSystem::instance().shutdown();
+}
+
+TEST(PerformanceTests, PhysicsBroadphaseTenThousandBoxes) {
+    constexpr int kSide = 100;
+    constexpr std::size_t kBoxCount = static_cast<std::size_t>(kSide) * kSide;
+    constexpr int kFrames = 30;
+    constexpr float kSpacing = 0.95f;  // Neighbouring unit boxes overlap slightly.
+
+    std::vector<glm::vec3> positions(kBoxCount);
+    std::vector<glm::vec3> velocities(kBoxCount, glm::vec3(0.0f));
+    for (int z = 0; z < kSide; ++z) {
+        for (int x = 0; x < kSide; ++x) {
+            const std::size_t index = static_cast<std::size_t>(z) * kSide + x;
+            positions[index] = {x * kSpacing, 0.5f, z * kSpacing};
+            // One box in ten is moving at any time; the rest are resting.
+            if (index % 10 == 0) {
+                velocities[index] = {std::sin(index * 0.37f) * 2.0f, 0.0f, std::cos(index * 0.53f) * 2.0f};
+            }
+        }
+    }
+
+    constexpr float kDelta = 1.0f / 60.0f;
+    std::vector<vkengine::AABB> bounds(kBoxCount);
+    vkengine::Broadphase broadphase;
+    double gridMs = 0.0;
+    double persistentMs = 0.0;
+    std::size_t gridOverlaps = 0;
+    std::size_t persistentOverlaps = 0;
+    for (int frame = 0; frame < kFrames; ++frame) {
+        for (std::size_t i = 0; i < kBoxCount; ++i) {
+            positions[i] += velocities[i] * kDelta;
+            bounds[i] = {positions[i] - glm::vec3(0.5f), positions[i] + glm::vec3(0.5f)};
+        }
+
+        gridMs += measureMillis([&]() { gridOverlaps = gridBroadphaseOverlaps(bounds, 1.0f); });
+        persistentMs += measureMillis([&]() {
+            for (std::uint32_t i = 0; i < kBoxCount; ++i) {
+                broadphase.updateBody(core::ecs::makeEntityId(i + 1, 1), bounds[i], velocities[i] * kDelta, i);
+            }
+            broadphase.finishUpdate();
+            persistentOverlaps = 0;
+            broadphase.forEachPair([&](std::uint32_t a, std::uint32_t b) {
+                vkengine::physics_detail::CollisionResult result;
+                if (vkengine::physics_detail::computePenetration(bounds[a], bounds[b], result)) {
+                    ++persistentOverlaps;
+                }
+            });
+        });
+        ASSERT_EQ(persistentOverlaps, gridOverlaps) << "frame " << frame;
+    }
+    gridMs /= kFrames;
+    persistentMs /= kFrames;
+
+    // Full physics step on the same layout: boxes resting on a static floor.
+    vkengine::Scene scene;
+    auto& floor = scene.createObject("Floor", vkengine::MeshType::Cube);
+    floor.transform().position = {kSide * kSpacing * 0.5f, -0.5f, kSide * kSpacing * 0.5f};
+    floor.enableCollider({kSide * kSpacing, 0.5f, kSide * kSpacing}, /*isStatic=*/true);
+    floor.physics().simulate = false;
+    auto boxes = scene.createObjects(kBoxCount, vkengine::MeshType::Cube, "Box");
+    for (std::size_t i = 0; i < kBoxCount; ++i) {
+        auto* box = boxes[i];
+        box->transform().position = {positions[i].x * 1.1f, 0.5f, positions[i].z * 1.1f};
+        box->enableCollider(glm::vec3(0.5f));
+        auto& props = box->physics();
+        props.mass = 1.0f;
+        props.simulate = true;
+        props.velocity = velocities[i];
+    }
+    vkengine::PhysicsSystem physics;
+    physics.update(scene, kDelta);
+    const double stepMs = averageMillis(10, [&]() { physics.update(scene, kDelta); });
+
+    RecordProperty("physics_broadphase_grid_rebuild_ms", gridMs);
+    RecordProperty("physics_broadphase_persistent_ms", persistentMs);
+    RecordProperty("physics_step_10k_boxes_ms", stepMs);
+    recordMetric("physics_broadphase_grid_rebuild_ms", gridMs);
+    recordMetric("physics_broadphase_persistent_ms", persistentMs);
+    recordMetric("physics_broadphase_moved_bodies", static_cast<double>(broadphase.movedLastUpdate()));
+    recordMetric("physics_step_10k_boxes_ms", stepMs);
+
+    const float thresholdMs = envFloatOrDefault("VKENGINE_PHYSICS_STEP_10K_MS", 1000.0f);
+    EXPECT_LE(stepMs, thresholdMs) << "10k box physics step exceeded threshold."
+                                   << " ms=" << stepMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, PhysicsSettledPilesSleep) {
+    constexpr int kSide = 32;
+    constexpr int kStackHeight = 2;
+    constexpr float kSpacing = 1.5f;
+    constexpr float kDelta = 1.0f / 60.0f;
+    constexpr std::size_t kBoxCount = static_cast<std::size_t>(kSide) * kSide * kStackHeight;
+
+    const auto buildPiles = [&](vkengine::Scene& scene) {
+        auto& floor = scene.createObject("Floor", vkengine::MeshType::Cube);
+        floor.transform().position = {kSide * kSpacing * 0.5f, -0.5f, kSide * kSpacing * 0.5f};
+        floor.enableCollider({kSide * kSpacing, 0.5f, kSide * kSpacing}, /*isStatic=*/true);
+        floor.physics().simulate = false;
+        auto boxes = scene.createObjects(kBoxCount, vkengine::MeshType::Cube, "Box");
+        for (std::size_t i = 0; i < kBoxCount; ++i) {
+            const std::size_t column = i / kStackHeight;
+            const std::size_t level = i % kStackHeight;
+            auto* box = boxes[i];
+            box->transform().position = {static_cast<float>(column % kSide) * kSpacing, 0.5f + static_cast<float>(level),
+                                         static_cast<float>(column / kSide) * kSpacing};
+            box->enableCollider(glm::vec3(0.5f));
+            auto& props = box->physics();
+            props.mass = 1.0f;
+            props.simulate = true;
+        }
+    };
+
+    vkengine::Scene awakeScene;
+    vkengine::Scene sleepingScene;
+    buildPiles(awakeScene);
+    buildPiles(sleepingScene);
+
+    vkengine::PhysicsSystem awakePhysics;
+    awakePhysics.setSleepingEnabled(false);
+    vkengine::PhysicsSystem sleepingPhysics;
+
+    // Let the piles settle for long enough to fall asleep.
+    const int settleFrames = static_cast<int>(std::ceil(vkengine::PhysicsSystem::kTimeToSleep / kDelta)) * 3;
+    for (int frame = 0; frame < settleFrames; ++frame) {
+        awakePhysics.update(awakeScene, kDelta);
+        sleepingPhysics.update(sleepingScene, kDelta);
+    }
+
+    const double awakeMs = averageMillis(10, [&]() { awakePhysics.update(awakeScene, kDelta); });
+    const double sleepingMs = averageMillis(10, [&]() { sleepingPhysics.update(sleepingScene, kDelta); });
+    const auto sleepingBodies = sleepingPhysics.sleepingBodyCount();
+
+    RecordProperty("physics_settled_step_awake_ms", awakeMs);
+    RecordProperty("physics_settled_step_sleeping_ms", sleepingMs);
+    recordMetric("physics_settled_step_awake_ms", awakeMs);
+    recordMetric("physics_settled_step_sleeping_ms", sleepingMs);
+    recordMetric("physics_settled_islands_awake", static_cast<double>(awakePhysics.islandCount()));
+    recordMetric("physics_settled_sleeping_bodies", static_cast<double>(sleepingBodies));
+
+    EXPECT_GT(sleepingBodies, kBoxCount / 2) << "Settled piles did not fall asleep.";
+    const float thresholdMs = envFloatOrDefault("VKENGINE_PHYSICS_SETTLED_STEP_MS", 1000.0f);
+    EXPECT_LE(sleepingMs, thresholdMs) << "Settled physics step exceeded threshold."
+                                       << " ms=" << sleepingMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, PhysicsSoaIntegratorThroughput) {
+    constexpr std::size_t kBodyCount = 100000;
+    constexpr float kDelta = 1.0f / 60.0f;
+    const glm::vec3 gravity{0.0f, -9.81f, 0.0f};
+
+    // Spinning, falling boxes without colliders: the step is dominated by integration.
+    vkengine::Scene scene;
+    auto bodies = scene.createObjects(kBodyCount, vkengine::MeshType::Cube, "Body");
+    for (std::size_t i = 0; i < kBodyCount; ++i) {
+        const float f = static_cast<float>(i);
+        auto* body = bodies[i];
+        body->transform().position = {std::fmod(f, 100.0f), 50.0f, std::floor(f / 100.0f)};
+        body->transform().rotation = {0.01f * f, 0.0f, 0.0f};
+        auto& props = body->physics();
+        props.mass = 1.0f;
+        props.simulate = true;
+        props.velocity = {std::sin(f), 0.0f, std::cos(f)};
+        props.angularVelocity = {0.5f, std::sin(f * 0.1f), 0.25f};
+    }
+
+    vkengine::RigidBodyStore store;
+    store.gather(scene.objectsCached(), false);
+    const double gatherMs = averageMillis(5, [&]() { store.gather(scene.objectsCached(), false); });
+    const double scatterMs = averageMillis(5, [&]() { store.scatter(scene.objectsCached()); });
+    const double scalarMs = averageMillis(10, [&]() { store.integrateScalar(gravity, kDelta); });
+    const double vectorMs = averageMillis(10, [&]() { store.integrate(gravity, kDelta); });
+
+    vkengine::PhysicsSystem physics;
+    physics.update(scene, kDelta);
+    const double stepMs = averageMillis(5, [&]() { physics.update(scene, kDelta); });
+
+    RecordProperty("physics_soa_integrate_scalar_ms", scalarMs);
+    RecordProperty("physics_soa_integrate_vector_ms", vectorMs);
+    RecordProperty("physics_step_100k_bodies_ms", stepMs);
+    recordMetric("physics_soa_gather_ms", gatherMs);
+    recordMetric("physics_soa_scatter_ms", scatterMs);
+    recordMetric("physics_soa_integrate_scalar_ms", scalarMs);
+    recordMetric("physics_soa_integrate_vector_ms", vectorMs);
+    recordMetric("physics_soa_simd_width", static_cast<double>(vkengine::RigidBodyStore::simdWidth()));
+    recordMetric("physics_step_100k_bodies_ms", stepMs);
+
+    const float thresholdMs = envFloatOrDefault("VKENGINE_PHYSICS_STEP_100K_MS", 1000.0f);
+    EXPECT_LE(stepMs, thresholdMs) << "100k body physics step exceeded threshold."
+                                   << " ms=" << stepMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, MolecularDynamicsHundredThousandAtoms) {
+    constexpr int kAtomsPerAxis = 47;
+    constexpr float kSpacing = 1.12f;
+    constexpr float kDelta = 0.0015f;
+
+    // Warm copper lattice at the Lennard-Jones minimum spacing, as in examples/molecular_dynamics.
+    vkengine::MolecularDynamicsSimulation simulation;
+    simulation.setMaterial(vkengine::MdMaterial::copper());
+    const float half = 0.5f * kSpacing * static_cast<float>(kAtomsPerAxis);
+    simulation.setBounds(vkengine::MdBox{glm::vec3(-half - 1.0f), glm::vec3(half + 1.0f)});
+    for (int z = 0; z < kAtomsPerAxis; ++z) {
+        for (int y = 0; y < kAtomsPerAxis; ++y) {
+            for (int x = 0; x < kAtomsPerAxis; ++x) {
+                const float f = static_cast<float>(x + kAtomsPerAxis * (y + kAtomsPerAxis * z));
+                const glm::vec3 position = glm::vec3(x, y, z) * kSpacing - glm::vec3(half);
+                simulation.addAtom(position, glm::vec3(std::sin(f), std::cos(1.7f * f), std::sin(0.3f * f)));
+            }
+        }
+    }
+
+    simulation.step(kDelta);
+    const std::uint64_t rebuildsBefore = simulation.neighborListRebuildCount();
+    constexpr int kSteps = 10;
+    const double stepMs = averageMillis(kSteps, [&]() { simulation.step(kDelta); });
+    const double rebuilds = static_cast<double>(simulation.neighborListRebuildCount() - rebuildsBefore);
+
+    RecordProperty("md_step_100k_atoms_ms", stepMs);
+    recordMetric("md_step_100k_atoms_ms", stepMs);
+    recordMetric("md_neighbor_rebuilds_per_step", rebuilds / kSteps);
+
+    const float thresholdMs = envFloatOrDefault("VKENGINE_MD_STEP_100K_MS", 2000.0f);
+    EXPECT_LE(stepMs, thresholdMs) << "100k atom molecular dynamics step exceeded threshold."
+                                   << " ms=" << stepMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, ParticleGravityBarnesHutVersusDirect) {
+    constexpr std::size_t kDirectCount = 8000;
+    constexpr std::size_t kTreeCount = 100000;
+    constexpr float kDelta = 1.0f / 60.0f;
+
+    // Flattened disc like the nbody example.
+    const auto seedDisc = [](vkengine::ParticleEmitter& emitter, std::size_t count) {
+        emitter.setEmissionRate(0.0f);
+        emitter.setMaxParticles(count);
+        emitter.setLifetimeRange(1.0e6f, 1.0e6f);
+        emitter.setSolverSubsteps(1);
+        emitter.update(1.0e-6f);
+        auto& particles = emitter.particles();
+        particles.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            const float f = static_cast<float>(i);
+            const float radius = 5.0f + 70.0f * std::fmod(f * 0.618034f, 1.0f);
+            const float angle = f * 2.39996f;
+            vkengine::Particle particle{};
+            particle.position = {radius * std::cos(angle), 2.0f * std::sin(f * 0.37f), radius * std::sin(angle)};
+            particle.mass = 0.4f + 1.2f * std::fmod(f * 0.414214f, 1.0f);
+            particle.lifetime = 1.0e6f;
+            particles.push(particle);
+        }
+    };
+
+    vkengine::ParticleEmitter direct("Direct");
+    seedDisc(direct, kDirectCount);
+    const double directMs = averageMillis(3, [&]() { direct.update(kDelta); });
+
+    vkengine::ParticleEmitter tree("BarnesHut");
+    tree.setGravitySolver(vkengine::ParticleGravitySolver::BarnesHut);
+    tree.setOpeningAngle(0.6f);
+    seedDisc(tree, kDirectCount);
+    const double treeMs = averageMillis(3, [&]() { tree.update(kDelta); });
+
+    // Accuracy of the field itself against the exact (opening angle 0) evaluation.
+    std::vector<glm::vec3> positions;
+    std::vector<float> masses;
+    const auto& treeParticles = tree.particles();
+    for (std::size_t i = 0; i < treeParticles.size(); ++i) {
+        positions.push_back(treeParticles.position(i));
+        masses.push_back(treeParticles.mass(i));
+    }
+    vkengine::GravityOctree octree;
+    octree.build(positions.data(), masses.data(), positions.size());
+    std::vector<glm::vec3> exact(positions.size());
+    std::vector<glm::vec3> approximate(positions.size());
+    octree.computeFields(40.0f, 0.25f, 0.0f, exact.data());
+    octree.computeFields(40.0f, 0.25f, 0.6f, approximate.data());
+    double error = 0.0;
+    double norm = 0.0;
+    for (std::size_t i = 0; i < exact.size(); ++i) {
+        error += glm::dot(approximate[i] - exact[i], approximate[i] - exact[i]);
+        norm += glm::dot(exact[i], exact[i]);
+    }
+    const double relativeError = std::sqrt(error / std::max(norm, 1e-30));
+
+    vkengine::ParticleEmitter large("BarnesHut100k");
+    large.setGravitySolver(vkengine::ParticleGravitySolver::BarnesHut);
+    large.setOpeningAngle(0.6f);
+    seedDisc(large, kTreeCount);
+    const double largeMs = averageMillis(2, [&]() { large.update(kDelta); });
+
+    RecordProperty("particle_gravity_direct_8k_ms", directMs);
+    RecordProperty("particle_gravity_barnes_hut_8k_ms", treeMs);
+    RecordProperty("particle_gravity_barnes_hut_100k_ms", largeMs);
+    recordMetric("particle_gravity_direct_8k_ms", directMs);
+    recordMetric("particle_gravity_barnes_hut_8k_ms", treeMs);
+    recordMetric("particle_gravity_barnes_hut_100k_ms", largeMs);
+    recordMetric("particle_gravity_barnes_hut_relative_error", relativeError);
+
+    EXPECT_LT(relativeError, 0.02) << "Barnes-Hut field error too large at opening angle 0.6.";
+    const float thresholdMs = envFloatOrDefault("VKENGINE_PARTICLE_GRAVITY_100K_MS", 5000.0f);
+    EXPECT_LE(largeMs, thresholdMs) << "100k particle Barnes-Hut update exceeded threshold."
+                                    << " ms=" << largeMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, ParticleSoaUpdateThroughput) {
+    constexpr std::size_t kParticleCount = 500000;
+    constexpr float kDelta = 1.0f / 60.0f;
+
+    // Short-lived fountain without mutual gravity: a steady stream of deaths and spawns, so the
+    // update is integration, aging, compaction and the color gradient.
+    vkengine::ParticleEmitter emitter("Fountain");
+    emitter.setMaxParticles(kParticleCount);
+    emitter.setGravityConstant(0.0f);
+    emitter.setLifetimeRange(0.5f, 2.0f);
+    emitter.setEmissionRate(static_cast<float>(kParticleCount));
+    emitter.setSolverSubsteps(2);
+    emitter.update(kDelta);
+
+    const double updateMs = averageMillis(10, [&]() { emitter.update(kDelta); });
+    const double aliveFraction = static_cast<double>(emitter.particles().size()) / static_cast<double>(kParticleCount);
+
+    RecordProperty("particle_soa_update_500k_ms", updateMs);
+    recordMetric("particle_soa_update_500k_ms", updateMs);
+    recordMetric("particle_soa_alive_fraction", aliveFraction);
+    recordMetric("particle_soa_simd_width", static_cast<double>(vkengine::ParticleStore::simdWidth()));
+
+    const float thresholdMs = envFloatOrDefault("VKENGINE_PARTICLE_UPDATE_500K_MS", 500.0f);
+    EXPECT_LE(updateMs, thresholdMs) << "500k particle update exceeded threshold."
+                                     << " ms=" << updateMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, MassSpringClothsAndSoftBodies) {
+    constexpr int kClothCount = 32;
+    constexpr int kVolumeCount = 8;
+    constexpr float kDelta = 1.0f / 60.0f;
+    const glm::vec3 gravity{0.0f, -9.81f, 0.0f};
+
+    std::vector<std::unique_ptr<vkengine::DeformableBody>> cloths;
+    for (int i = 0; i < kClothCount; ++i) {
+        cloths.push_back(std::make_unique<vkengine::DeformableBody>(64, 64, 0.05f));
+        cloths.back()->pinTopEdge();
+    }
+    std::vector<std::unique_ptr<vkengine::SoftBodyVolume>> volumes;
+    for (int i = 0; i < kVolumeCount; ++i) {
+        volumes.push_back(std::make_unique<vkengine::SoftBodyVolume>(16, 16, 16, 0.1f));
+        volumes.back()->addImpulse(glm::vec3(0.0f, 20.0f, 0.0f));
+    }
+
+    // Same shape as GameEngine::update: bodies spread over the pool, each body's passes nested.
+    const auto stepAll = [&]() {
+        core::parallelFor(cloths.size(), 8, [&](std::size_t i) { cloths[i]->simulate(kDelta, gravity); });
+        core::parallelFor(volumes.size(), 8, [&](std::size_t i) { volumes[i]->simulate(kDelta, gravity); });
+    };
+    stepAll();
+    const double stepMs = averageMillis(10, stepAll);
+
+    std::vector<glm::vec3> normals;
+    const double normalsMs = averageMillis(10, [&]() {
+        for (const auto& cloth : cloths) {
+            cloth->computeVertexNormals(normals);
+        }
+        for (const auto& volume : volumes) {
+            volume->computeVertexNormals(normals);
+        }
+    });
+
+    RecordProperty("mass_spring_step_ms", stepMs);
+    recordMetric("mass_spring_step_ms", stepMs);
+    recordMetric("mass_spring_normals_ms", normalsMs);
+
+    const float thresholdMs = envFloatOrDefault("VKENGINE_MASS_SPRING_STEP_MS", 250.0f);
+    EXPECT_LE(stepMs, thresholdMs) << "Mass-spring step exceeded threshold."
+                                   << " ms=" << stepMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, PacketSnapshotSerialization) {
+    constexpr std::size_t kEntityCount = 1000;
+    constexpr std::size_t kRuns = 200;
+
+    std::vector<glm::vec3> positions(kEntityCount);
+    std::vector<glm::quat> rotations(kEntityCount);
+    for (std::size_t i = 0; i < kEntityCount; ++i) {
+        const float f = static_cast<float>(i);
+        positions[i] = glm::vec3(std::sin(f) * 200.0f, std::fmod(f, 17.0f), std::cos(f) * 200.0f);
+        rotations[i] = glm::normalize(glm::quat(std::cos(f), 0.1f * f, std::sin(f), 0.5f));
+    }
+
+    std::vector<std::uint8_t> sendBuffer(vkengine::MaxDatagramSize);
+    vkengine::Packet packet(vkengine::PacketTypes::StateSnapshot);
+    std::size_t fullBytes = 0;
+    const double fullMs = averageMillis(kRuns, [&]() {
+        packet.reset();
+        packet.setType(vkengine::PacketTypes::StateSnapshot);
+        for (std::size_t i = 0; i < kEntityCount; ++i) {
+            packet.writeUInt32(static_cast<std::uint32_t>(i + 1));
+            packet.writeVec3(positions[i]);
+            packet.writeQuat(rotations[i]);
+        }
+        fullBytes = packet.serializeInto(sendBuffer.data(), sendBuffer.size());
+    });
+
+    std::size_t packedBytes = 0;
+    const double packedMs = averageMillis(kRuns, [&]() {
+        packet.reset();
+        packet.setType(vkengine::PacketTypes::StateSnapshot);
+        for (std::size_t i = 0; i < kEntityCount; ++i) {
+            packet.writeVarUInt(1);  // Network id delta.
+            packet.writeQuantizedVec3(positions[i], -512.0f, 512.0f, 20);
+            packet.writeCompressedQuat(rotations[i]);
+        }
+        packedBytes = packet.serializeInto(sendBuffer.data(), sendBuffer.size());
+    });
+    ASSERT_GT(packedBytes, 0u);
+    ASSERT_GT(fullBytes, 0u);
+
+    RecordProperty("packet_snapshot_packed_ms", packedMs);
+    recordMetric("packet_snapshot_full_ms", fullMs);
+    recordMetric("packet_snapshot_packed_ms", packedMs);
+    recordMetric("packet_snapshot_full_bytes", static_cast<double>(fullBytes));
+    recordMetric("packet_snapshot_packed_bytes", static_cast<double>(packedBytes));
+
+    EXPECT_LT(packedBytes * 2, fullBytes) << "Bit packing should at least halve the snapshot.";
+    const float thresholdMs = envFloatOrDefault("VKENGINE_PACKET_SNAPSHOT_MS", 5.0f);
+    EXPECT_LE(packedMs, thresholdMs) << "Packed 1000-entity snapshot exceeded threshold."
+                                     << " ms=" << packedMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, NetworkLoopbackThroughputAndLatency) {
+    constexpr std::size_t kPacketCount = 20000;
+    constexpr std::size_t kBurst = 64;
+    constexpr std::size_t kMaxInFlight = 4 * kBurst;  // Keeps the socket buffer from overflowing.
+
+    vkengine::NetworkServer server;
+    ASSERT_TRUE(server.start(0, 4));
+    vkengine::NetworkClient client;
+    ASSERT_TRUE(client.connect("127.0.0.1", server.port()));
+
+    // Every packet carries its send time; the server side measures send-to-poll latency.
+    std::vector<double> latenciesMs;
+    latenciesMs.reserve(kPacketCount);
+    const auto drain = [&]() {
+        vkengine::NetworkEvent event;
+        while (server.pollEvent(event)) {
+            if (event.type != vkengine::NetworkEvent::Type::DataReceived ||
+                event.packet->type() != vkengine::PacketTypes::UserBase) {
+                continue;
+            }
+            const auto sentNs = static_cast<std::chrono::steady_clock::rep>(event.packet->readUInt64());
+            const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+            latenciesMs.push_back(static_cast<double>(now - sentNs) / 1.0e6);
+        }
+    };
+
+    vkengine::Packet packet(vkengine::PacketTypes::UserBase);
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t sent = 0; sent < kPacketCount; sent += kBurst) {
+        for (std::size_t i = 0; i < kBurst; ++i) {
+            packet.reset();
+            packet.setType(vkengine::PacketTypes::UserBase);
+            packet.writeUInt64(static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+            client.send(packet);
+        }
+        const auto burstDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+        drain();
+        while (latenciesMs.size() + kMaxInFlight < sent + kBurst && std::chrono::steady_clock::now() < burstDeadline) {
+            std::this_thread::yield();
+            drain();
+        }
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (latenciesMs.size() < kPacketCount && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        drain();
+    }
+    const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    client.disconnect();
+    server.stop();
+
+    ASSERT_FALSE(latenciesMs.empty());
+    std::sort(latenciesMs.begin(), latenciesMs.end());
+    const double p50Ms = latenciesMs[latenciesMs.size() / 2];
+    const double p99Ms = latenciesMs[latenciesMs.size() * 99 / 100];
+    const double packetsPerSecond = static_cast<double>(latenciesMs.size()) / elapsedSeconds;
+    const double deliveredFraction = static_cast<double>(latenciesMs.size()) / static_cast<double>(kPacketCount);
+
+    RecordProperty("network_loopback_p99_ms", p99Ms);
+    recordMetric("network_loopback_packets_per_second", packetsPerSecond);
+    recordMetric("network_loopback_p50_ms", p50Ms);
+    recordMetric("network_loopback_p99_ms", p99Ms);
+    recordMetric("network_loopback_delivered_fraction", deliveredFraction);
+
+    EXPECT_GE(deliveredFraction, 0.9) << "Loopback dropped too many datagrams.";
+    const float thresholdMs = envFloatOrDefault("VKENGINE_NETWORK_P99_MS", 20.0f);
+    EXPECT_LE(p99Ms, thresholdMs) << "Loopback p99 latency exceeded threshold."
+                                  << " ms=" << p99Ms << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, NetworkDeltaSnapshotBandwidth) {
+    constexpr std::size_t kClients = 8;
+    constexpr std::size_t kTicks = 30;
+    constexpr std::size_t kMovingPercent = 5;
+
+    double largestDeltaMs = 0.0;
+    for (const std::size_t entityCount : {256u, 1024u, 4096u}) {
+        vkengine::Scene scene;
+        vkengine::NetworkSyncSystem sync;
+        std::vector<vkengine::GameObject*> objects = scene.createObjects(entityCount, vkengine::MeshType::Cube);
+        for (std::size_t i = 0; i < entityCount; ++i) {
+            objects[i]->transform().position = glm::vec3(static_cast<float>(i % 64), 0.0f, static_cast<float>(i / 64));
+            sync.registerEntity(*objects[i]);
+        }
+        const std::size_t fullBytes = sync.createSnapshot(scene).payloadSize();
+
+        // Each client acknowledges every snapshot one tick late, so deltas are against the previous tick.
+        std::vector<vkengine::SequenceNumber> pendingAcks(kClients, 0);
+        std::size_t deltaBytes = 0;
+        std::size_t deltaCount = 0;
+        const std::size_t moving = entityCount * kMovingPercent / 100;
+        const double deltaMs = averageMillis(kTicks, [&]() {
+            for (std::size_t k = 0; k < moving; ++k) {
+                objects[(deltaCount * 7 + k * 19) % entityCount]->transform().position.y += 0.125f;
+            }
+            for (std::size_t c = 0; c < kClients; ++c) {
+                const auto clientId = static_cast<vkengine::ClientId>(c + 1);
+                if (pendingAcks[c] != 0) {
+                    sync.acknowledgeSnapshot(clientId, pendingAcks[c]);
+                }
+                const vkengine::Packet delta = sync.createDelta(scene, clientId);
+                pendingAcks[c] = delta.sequence();
+                if (sync.acknowledgedSnapshot(clientId) != 0) {
+                    deltaBytes += delta.payloadSize();
+                    ++deltaCount;
+                }
+            }
+        });
+        ASSERT_GT(deltaCount, 0u);
+        const double bytesPerClient = static_cast<double>(deltaBytes) / static_cast<double>(deltaCount);
+        largestDeltaMs = std::max(largestDeltaMs, deltaMs);
+
+        const std::string suffix = std::to_string(entityCount);
+        recordMetric("network_delta_full_bytes_" + suffix, static_cast<double>(fullBytes));
+        recordMetric("network_delta_bytes_per_client_" + suffix, bytesPerClient);
+        recordMetric("network_delta_tick_ms_" + suffix, deltaMs);
+
+        EXPECT_LT(bytesPerClient * 5.0, static_cast<double>(fullBytes))
+            << "Deltas against acknowledged baselines should be a fraction of the full snapshot.";
+    }
+
+    RecordProperty("network_delta_tick_ms", largestDeltaMs);
+    const float thresholdMs = envFloatOrDefault("VKENGINE_NETWORK_DELTA_MS", 20.0f);
+    EXPECT_LE(largestDeltaMs, thresholdMs) << "Delta snapshots for 8 clients exceeded threshold."
+                                           << " ms=" << largestDeltaMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, NetworkInterestManagementTwoHundredClients) {
+    constexpr std::size_t kClients = 200;
+    constexpr std::size_t kEntityCount = 16384;
+    constexpr std::size_t kTicks = 20;
+    constexpr std::size_t kBudgetBytes = 1200;
+    constexpr float kWorldSize = 1024.0f;
+    constexpr float kViewRadius = 64.0f;
+
+    vkengine::Scene serverScene;
+    vkengine::NetworkSyncSystem serverSync;
+    serverSync.setInterestCellSize(kViewRadius);
+    serverSync.setBandwidthBudget(kBudgetBytes);
+    std::vector<vkengine::GameObject*> objects = serverScene.createObjects(kEntityCount, vkengine::MeshType::Cube);
+    for (std::size_t i = 0; i < kEntityCount; ++i) {
+        const float f = static_cast<float>(i);
+        objects[i]->transform().position =
+            glm::vec3(std::fmod(f * 37.31f, kWorldSize), 0.0f, std::fmod(f * 91.77f, kWorldSize));
+        serverSync.registerEntity(*objects[i]);
+    }
+
+    // Simulated clients behind an in-process loopback: every delta and ack goes through the wire format.
+    std::vector<vkengine::ClientId> clientIds(kClients);
+    std::vector<glm::vec3> views(kClients);
+    std::vector<std::unique_ptr<vkengine::Scene>> clientScenes;
+    std::vector<std::unique_ptr<vkengine::NetworkSyncSystem>> clientSyncs;
+    for (std::size_t c = 0; c < kClients; ++c) {
+        clientIds[c] = static_cast<vkengine::ClientId>(c + 1);
+        const float f = static_cast<float>(c);
+        views[c] = glm::vec3(std::fmod(f * 131.0f, kWorldSize), 0.0f, std::fmod(f * 277.0f, kWorldSize));
+        clientScenes.push_back(std::make_unique<vkengine::Scene>());
+        clientSyncs.push_back(std::make_unique<vkengine::NetworkSyncSystem>());
+    }
+
+    std::vector<std::uint8_t> wire(vkengine::MaxDatagramSize);
+    std::vector<std::vector<std::uint8_t>> inFlight(kClients);
+    std::size_t totalBytes = 0;
+    std::size_t largestBytes = 0;
+    std::size_t applied = 0;
+    double serverTickMs = 0.0;
+    for (std::size_t tick = 0; tick < kTicks; ++tick) {
+        for (std::size_t i = tick % 10; i < kEntityCount; i += 10) {
+            objects[i]->transform().position.y += 0.25f;
+        }
+        for (std::size_t c = 0; c < kClients; ++c) {
+            views[c].x = std::fmod(views[c].x + 4.0f, kWorldSize);
+            serverSync.setClientView(clientIds[c], views[c], kViewRadius);
+        }
+        serverTickMs += averageMillis(1, [&]() {
+            serverSync.createDeltas(serverScene, clientIds, [&](vkengine::ClientId clientId, const vkengine::Packet& packet) {
+                const std::size_t size = packet.serializeInto(wire.data(), wire.size());
+                inFlight[clientId - 1].assign(wire.begin(), wire.begin() + static_cast<std::ptrdiff_t>(size));
+                totalBytes += size;
+                largestBytes = std::max(largestBytes, packet.payloadSize());
+            });
+        }) / static_cast<double>(kTicks);
+
+        // Clients apply the deltas and acknowledge them; this is not part of the server's time.
+        for (std::size_t c = 0; c < kClients; ++c) {
+            vkengine::Packet delta;
+            ASSERT_TRUE(delta.deserialize(inFlight[c].data(), inFlight[c].size()));
+            applied += clientSyncs[c]->applyDelta(*clientScenes[c], delta) ? 1 : 0;
+            const std::size_t size = clientSyncs[c]->createAck().serializeInto(wire.data(), wire.size());
+            vkengine::Packet ack;
+            ASSERT_TRUE(ack.deserialize(wire.data(), size));
+            serverSync.processPacket(serverScene, clientIds[c], ack);
+        }
+    }
+
+    const double bytesPerClientTick = static_cast<double>(totalBytes) / static_cast<double>(kTicks * kClients);
+    const std::size_t fullWorldBytes = serverSync.createSnapshot(serverScene).payloadSize();
+    RecordProperty("network_interest_server_tick_ms", serverTickMs);
+    recordMetric("network_interest_server_tick_ms", serverTickMs);
+    recordMetric("network_interest_bytes_per_client_tick", bytesPerClientTick);
+    recordMetric("network_interest_largest_payload_bytes", static_cast<double>(largestBytes));
+    recordMetric("network_interest_full_world_bytes", static_cast<double>(fullWorldBytes));
+
+    EXPECT_EQ(applied, kClients * kTicks);
+    EXPECT_LE(largestBytes, kBudgetBytes) << "Deltas must stay within the per-client budget.";
+    const float thresholdMs = envFloatOrDefault("VKENGINE_NETWORK_INTEREST_TICK_MS", 50.0f);
+    EXPECT_LE(serverTickMs, thresholdMs) << "Interest-managed deltas for 200 clients exceeded threshold."
+                                         << " ms=" << serverTickMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, LagCompensationHitScanRewind) {
+    constexpr std::size_t kPlayers = 400;
+    constexpr std::size_t kShotsPerTick = 16;
+    constexpr std::size_t kTicks = 120;
+    constexpr float kTickSeconds = 1.0f / 60.0f;
+
+    vkengine::Scene scene;
+    std::vector<vkengine::GameObject*> players = scene.createObjects(kPlayers, vkengine::MeshType::Cube);
+    vkengine::LagCompensation history(1.0f, 60.0f);
+    const auto movePlayers = [&](float time) {
+        for (std::size_t i = 0; i < kPlayers; ++i) {
+            const float phase = static_cast<float>(i) * 0.37f;
+            players[i]->transform().position =
+                glm::vec3(std::fmod(static_cast<float>(i) * 13.0f, 400.0f) + 4.0f * std::sin(time + phase), 1.0f,
+                          std::fmod(static_cast<float>(i) * 29.0f, 400.0f) + 4.0f * std::cos(time + phase));
+        }
+    };
+
+    // Each tick: record the players, then validate shots fired 100 ms ago at random players.
+    std::size_t tick = 0;
+    std::size_t candidates = 0;
+    const auto runTick = [&](bool rayOnly) {
+        const float time = static_cast<float>(tick++) * kTickSeconds;
+        movePlayers(time);
+        history.recordState(scene, time);
+        for (std::size_t shot = 0; shot < kShotsPerTick; ++shot) {
+            const std::size_t target = (tick * 31 + shot * 97) % kPlayers;
+            const glm::vec3 origin = players[target]->transform().position - glm::vec3(30.0f, 0.0f, 0.0f);
+            if (rayOnly) {
+                candidates += history.rewindAlongRay(scene, time - 0.1f, origin, glm::vec3(1.0f, 0.0f, 0.0f), 60.0f, 5.0f);
+            } else {
+                history.rewindTo(scene, time - 0.1f);
+            }
+            history.restoreState(scene);
+        }
+    };
+
+    const double fullMs = averageMillis(kTicks, [&]() { runTick(false); });
+    const double rayMs = averageMillis(kTicks, [&]() { runTick(true); });
+    ASSERT_GT(candidates, 0u);
+
+    RecordProperty("lag_compensation_ray_tick_ms", rayMs);
+    recordMetric("lag_compensation_full_tick_ms", fullMs);
+    recordMetric("lag_compensation_ray_tick_ms", rayMs);
+    recordMetric("lag_compensation_ray_candidates_per_shot",
+                 static_cast<double>(candidates) / static_cast<double>(kTicks * kShotsPerTick));
+
+    EXPECT_LT(rayMs, fullMs) << "Rewinding near the ray should beat rewinding every player.";
+    const float thresholdMs = envFloatOrDefault("VKENGINE_LAG_COMPENSATION_TICK_MS", 4.0f);
+    EXPECT_LE(rayMs, thresholdMs) << "Lag-compensated hit validation exceeded threshold."
+                                  << " ms=" << rayMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, SceneSerializationJsonVersusBinary) {
+    constexpr std::size_t kObjects = 10000;
+    constexpr int kIterations = 3;
+
+    vkengine::Scene scene;
+    std::vector<vkengine::GameObject*> objects = scene.createObjects(kObjects, vkengine::MeshType::Cube);
+    for (std::size_t i = 0; i < kObjects; ++i) {
+        auto& object = *objects[i];
+        const float f = static_cast<float>(i);
+        object.transform().position = glm::vec3(std::fmod(f * 1.7f, 300.0f), f * 0.01f, std::fmod(f * 3.1f, 300.0f));
+        object.transform().rotation = glm::vec3(0.0f, f * 0.05f, 0.0f);
+        object.physics().velocity = glm::vec3(1.0f, 0.0f, -1.0f);
+        object.render().materialName = (i % 4 == 0) ? "metal" : "default";
+        if (i % 8 == 0) {
+            object.enableCollider(glm::vec3(0.5f), /*isStatic=*/i % 16 == 0);
+        }
+    }
+    for (int i = 0; i < 16; ++i) {
+        scene.createLight("");
+    }
+
+    vkengine::SceneSerializer serializer;
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto jsonPath = directory / "vkengine_scene_bench.json";
+    const auto binaryPath = directory / "vkengine_scene_bench.vksb";
+
+    bool ok = true;
+    const double jsonSaveMs = averageMillis(kIterations, [&]() { ok &= serializer.saveToFile(scene, jsonPath); });
+    const double binarySaveMs =
+        averageMillis(kIterations, [&]() { ok &= serializer.saveBinaryFile(scene, binaryPath); });
+    vkengine::Scene loaded;
+    const double jsonLoadMs = averageMillis(kIterations, [&]() { ok &= serializer.loadFromFile(loaded, jsonPath); });
+    const double binaryLoadMs =
+        averageMillis(kIterations, [&]() { ok &= serializer.loadBinaryFile(loaded, binaryPath); });
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(loaded.objects().size(), kObjects);
+
+    const auto jsonBytes = static_cast<double>(std::filesystem::file_size(jsonPath));
+    const auto binaryBytes = static_cast<double>(std::filesystem::file_size(binaryPath));
+    std::filesystem::remove(jsonPath);
+    std::filesystem::remove(binaryPath);
+
+    RecordProperty("scene_binary_load_ms", binaryLoadMs);
+    recordMetric("scene_json_save_ms", jsonSaveMs);
+    recordMetric("scene_json_load_ms", jsonLoadMs);
+    recordMetric("scene_binary_save_ms", binarySaveMs);
+    recordMetric("scene_binary_load_ms", binaryLoadMs);
+    recordMetric("scene_json_bytes", jsonBytes);
+    recordMetric("scene_binary_bytes", binaryBytes);
+
+    EXPECT_LT(binaryLoadMs, jsonLoadMs) << "Binary scenes should load faster than JSON.";
+    EXPECT_LT(binaryBytes, jsonBytes);
+    const float thresholdMs = envFloatOrDefault("VKENGINE_SCENE_BINARY_LOAD_MS", 100.0f);
+    EXPECT_LE(binaryLoadMs, thresholdMs) << "Binary scene load exceeded threshold."
+                                         << " ms=" << binaryLoadMs << " threshold=" << thresholdMs;
+}
+
+TEST(PerformanceTests, StlLoadMillionTriangles) {
+    // A rippled 708x708 quad grid: just over a million triangles, like a dense CAD export.
+    constexpr std::size_t kGrid = 708;
+    const auto height = [](std::size_t x, std::size_t z) {
+        return 0.5f * std::sin(static_cast<float>(x) * 0.05f) * std::cos(static_cast<float>(z) * 0.05f);
+    };
+    std::vector<std::array<glm::vec3, 3>> triangles;
+    triangles.reserve(kGrid * kGrid * 2);
+    for (std::size_t z = 0; z < kGrid; ++z) {
+        for (std::size_t x = 0; x < kGrid; ++x) {
+            const auto corner = [&](std::size_t cx, std::size_t cz) {
+                return glm::vec3(static_cast<float>(cx) * 0.1f, height(cx, cz), static_cast<float>(cz) * 0.1f);
+            };
+            triangles.push_back({corner(x, z), corner(x, z + 1), corner(x + 1, z)});
+            triangles.push_back({corner(x + 1, z), corner(x, z + 1), corner(x + 1, z + 1)});
+        }
+    }
+
+    std::string binary(84, '\0');
+    const auto triangleCount = static_cast<std::uint32_t>(triangles.size());
+    std::memcpy(binary.data() + 80, &triangleCount, sizeof(triangleCount));
+    std::string ascii = "solid terrain\n";
+    binary.reserve(84 + triangles.size() * 50);
+    ascii.reserve(triangles.size() * 200);
+    char number[32];
+    const auto appendFloat = [&](float value) {
+        const auto result = std::to_chars(number, number + sizeof(number), value);
+        ascii.push_back(' ');
+        ascii.append(number, result.ptr);
+    };
+    for (const auto& triangle : triangles) {
+        const glm::vec3 normal = glm::normalize(glm::cross(triangle[1] - triangle[0], triangle[2] - triangle[0]));
+        binary.append(reinterpret_cast<const char*>(&normal.x), sizeof(float) * 3);
+        ascii += "facet normal";
+        appendFloat(normal.x);
+        appendFloat(normal.y);
+        appendFloat(normal.z);
+        ascii += "\n outer loop\n";
+        for (const auto& vertex : triangle) {
+            binary.append(reinterpret_cast<const char*>(&vertex.x), sizeof(float) * 3);
+            ascii += "  vertex";
+            appendFloat(vertex.x);
+            appendFloat(vertex.y);
+            appendFloat(vertex.z);
+            ascii += "\n";
+        }
+        binary.append(2, '\0');
+        ascii += " endloop\nendfacet\n";
+    }
+    ascii += "endsolid terrain\n";
+
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto binaryPath = directory / "vkengine_perf_terrain_binary.stl";
+    const auto asciiPath = directory / "vkengine_perf_terrain_ascii.stl";
+    std::ofstream(binaryPath, std::ios::binary) << binary;
+    std::ofstream(asciiPath, std::ios::binary) << ascii;
+
+    // Smooth shading across the gentle ripples is what lets welding share the grid vertices.
+    vkengine::MeshLoadOptions options{};
+    options.creaseAngleDegrees = 45.0f;
+    vkengine::MeshData binaryMesh;
+    vkengine::MeshData asciiMesh;
+    const double binaryMs = averageMillis(3, [&]() { binaryMesh = vkengine::loadStlMesh(binaryPath, options); });
+    const double asciiMs = averageMillis(3, [&]() { asciiMesh = vkengine::loadStlMesh(asciiPath, options); });
+    std::filesystem::remove(binaryPath);
+    std::filesystem::remove(asciiPath);
+
+    ASSERT_EQ(binaryMesh.indices.size(), triangles.size() * 3);
+    ASSERT_EQ(asciiMesh.indices.size(), triangles.size() * 3);
+    EXPECT_EQ(binaryMesh.vertices.size(), (kGrid + 1) * (kGrid + 1));
+    EXPECT_EQ(asciiMesh.vertices.size(), binaryMesh.vertices.size());
+
+    const double weldRatio =
+        static_cast<double>(binaryMesh.vertices.size()) / static_cast<double>(binaryMesh.indices.size());
+    RecordProperty("stl_binary_load_ms", binaryMs);
+    recordMetric("stl_binary_load_ms", binaryMs);
+    recordMetric("stl_ascii_load_ms", asciiMs);
+    recordMetric("stl_ascii_mb_per_s", static_cast<double>(ascii.size()) / 1.0e6 / (asciiMs / 1000.0));
+    recordMetric("stl_welded_vertex_ratio", weldRatio);
+
+    const float binaryThresholdMs = envFloatOrDefault("VKENGINE_STL_BINARY_LOAD_MS", 750.0f);
+    const float asciiThresholdMs = envFloatOrDefault("VKENGINE_STL_ASCII_LOAD_MS", 3000.0f);
+    EXPECT_LE(binaryMs, binaryThresholdMs) << "Binary STL load exceeded threshold."
+                                           << " ms=" << binaryMs << " threshold=" << binaryThresholdMs;
+    EXPECT_LE(asciiMs, asciiThresholdMs) << "ASCII STL load exceeded threshold."
+                                         << " ms=" << asciiMs << " threshold=" << asciiThresholdMs;
+}
+
+TEST(PerformanceTests, ProfilerScopeOverhead) {
+    constexpr int kFrames = 32;
+    constexpr std::size_t kIterationsPerFrame = 16384;  // Two scopes each; well inside one thread's ring.
+    auto& profiler = vkengine::Profiler::instance();
+    std::uint64_t sink = 0;
+    const auto nestedScopes = [&]() {
+        for (std::size_t i = 0; i < kIterationsPerFrame; ++i) {
+            PROFILE_SCOPE("PerformanceTests.ProfilerOuter");
+            PROFILE_SCOPE("PerformanceTests.ProfilerInner");
+            sink += i;
+        }
+    };
+    const auto elapsedMs = [](auto&& body) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    double recordMs = 0.0;
+    double collectMs = 0.0;
+    profiler.collect();  // Start from empty rings; earlier tests record engine scopes too.
+    const std::uint64_t droppedBefore = profiler.droppedSamples();
+    for (int frame = 0; frame < kFrames; ++frame) {
+        profiler.beginFrame();
+        recordMs += elapsedMs(nestedScopes);
+        collectMs += elapsedMs([&]() { profiler.endFrame(); });
+    }
+    ASSERT_EQ(profiler.getStats("PerformanceTests.ProfilerOuter").callCount, kIterationsPerFrame * kFrames);
+
+    profiler.setEnabled(false);
+    const double disabledMs = averageMillis(kFrames, nestedScopes);
+    profiler.setEnabled(true);
+
+    // Worker threads record concurrently into their own rings.
+    profiler.beginFrame();
+    core::parallelFor(kIterationsPerFrame, 256, [&](std::size_t) { PROFILE_SCOPE("PerformanceTests.ProfilerWorker"); });
+    profiler.endFrame();
+    EXPECT_EQ(profiler.getStats("PerformanceTests.ProfilerWorker").callCount, kIterationsPerFrame);
+    EXPECT_EQ(profiler.droppedSamples(), droppedBefore);
+
+    const double scopes = static_cast<double>(kIterationsPerFrame * 2 * kFrames);
+    const double nsPerScope = recordMs * 1.0e6 / scopes;
+    RecordProperty("profiler_scope_ns", nsPerScope);
+    recordMetric("profiler_scope_ns", nsPerScope);
+    recordMetric("profiler_disabled_scope_ns", disabledMs * 1.0e6 / static_cast<double>(kIterationsPerFrame * 2));
+    recordMetric("profiler_collect_ms_per_frame", collectMs / kFrames);
+    EXPECT_NE(sink, 0u);
+
+    // The target is under 50 ns on bare metal; the default leaves room for hypervisors where each
+    // timestamp read alone costs ~25 ns.
+    const float thresholdNs = envFloatOrDefault("VKENGINE_PROFILE_SCOPE_NS", 100.0f);
+    EXPECT_LE(nsPerScope, thresholdNs) << "PROFILE_SCOPE overhead exceeded threshold."
+                                       << " ns=" << nsPerScope << " threshold=" << thresholdNs;
+}
+
+TEST(PerformanceTests, LoggerCallLatencyUnderContention) {
+    constexpr int kThreads = 4;
+    constexpr int kRounds = 10;
+    constexpr int kBurstPerThread = 2000;  // One round from all threads fits in the queue.
+    static_assert(kThreads * kBurstPerThread <= static_cast<int>(vkengine::Logger::QueueCapacity));
+    auto& logger = vkengine::Logger::instance();
+    logger.flush();
+    const vkengine::LogOverflowPolicy previousPolicy = logger.getOverflowPolicy();
+    logger.setConsoleOutput(false);
+    logger.setOverflowPolicy(vkengine::LogOverflowPolicy::Drop);
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "vkengine_logger_perf.log";
+    std::filesystem::remove(path);
+    logger.setLogFile(path.string());
+
+    // Callers pay for the timestamp and the queue push; formatting and I/O happen on the writer.
+    std::vector<std::vector<double>> latenciesNs(kThreads);
+    const std::uint64_t droppedBefore = logger.droppedCount();
+    double drainMs = 0.0;
+    for (int round = 0; round < kRounds; ++round) {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> producers;
+        for (int t = 0; t < kThreads; ++t) {
+            producers.emplace_back([&, t]() {
+                const std::string message = "snapshot sent to client " + std::to_string(t);
+                for (int i = 0; i < kBurstPerThread; ++i) {
+                    const auto callStart = std::chrono::steady_clock::now();
+                    logger.warning(message, "Network");
+                    latenciesNs[t].push_back(
+                        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - callStart).count());
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        logger.flush();
+        drainMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    const std::uint64_t dropped = logger.droppedCount() - droppedBefore;
+    logger.closeLogFile();
+    std::filesystem::remove(path);
+    logger.clear();
+    logger.setOverflowPolicy(previousPolicy);
+    logger.setConsoleOutput(true);
+    EXPECT_EQ(dropped, 0u);
+
+    std::vector<double> all;
+    for (const auto& perThread : latenciesNs) {
+        all.insert(all.end(), perThread.begin(), perThread.end());
+    }
+    std::sort(all.begin(), all.end());
+    const double p50Ns = all[all.size() / 2];
+    const double p99Ns = all[all.size() * 99 / 100];
+    const double records = static_cast<double>(all.size());
+
+    RecordProperty("logger_call_p99_ns", p99Ns);
+    recordMetric("logger_call_p50_ns", p50Ns);
+    recordMetric("logger_call_p99_ns", p99Ns);
+    recordMetric("logger_records_per_sec", records / std::max(1.0e-3, drainMs) * 1000.0);
+
+    const float thresholdNs = envFloatOrDefault("VKENGINE_LOG_CALL_P99_NS", 2000.0f);
+    EXPECT_LE(p99Ns, thresholdNs) << "Logger call p99 latency exceeded threshold."
+                                  << " ns=" << p99Ns << " threshold=" << thresholdNs;
+}
+
+TEST(PerformanceTests, FixedTimestepCostIsFlatAcrossFrameRates) {
+    constexpr std::size_t kBoxes = 1500;
+    constexpr std::array<int, 4> kRenderRates{30, 60, 144, 240};
+    const auto buildScene = [](vkengine::GameEngine& engine) {
+        auto& ground = engine.scene().createObject("Ground", vkengine::MeshType::Cube);
+        ground.enableCollider(glm::vec3(50.0f, 0.5f, 50.0f), /*isStatic=*/true);
+        std::vector<vkengine::GameObject*> boxes = engine.scene().createObjects(kBoxes, vkengine::MeshType::Cube);
+        for (std::size_t i = 0; i < boxes.size(); ++i) {
+            boxes[i]->transform().position =
+                glm::vec3(static_cast<float>(i % 40) * 1.1f - 22.0f, 1.0f + static_cast<float>(i / 1600),
+                          static_cast<float>((i / 40) % 40) * 1.1f - 22.0f);
+            boxes[i]->enableCollider(glm::vec3(0.5f), /*isStatic=*/false);
+        }
+    };
+
+    // One simulated second per render rate: the tick count and so the simulation cost should not
+    // depend on how finely the frames slice it.
+    double minMs = std::numeric_limits<double>::max();
+    double maxMs = 0.0;
+    for (const int renderRate : kRenderRates) {
+        vkengine::GameEngine engine;
+        buildScene(engine);
+        const float frameSeconds = 1.0f / static_cast<float>(renderRate);
+        double worstFrameMs = 0.0;
+        const double totalMs = measureMillis([&]() {
+            for (int frame = 0; frame < renderRate; ++frame) {
+                const auto start = std::chrono::steady_clock::now();
+                engine.update(frameSeconds);
+                worstFrameMs = std::max(
+                    worstFrameMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            }
+        });
+        EXPECT_NEAR(static_cast<double>(engine.tickCount()), 60.0, 1.0) << "render rate " << renderRate;
+        minMs = std::min(minMs, totalMs);
+        maxMs = std::max(maxMs, totalMs);
+        recordMetric("fixed_step_sim_second_ms_at_" + std::to_string(renderRate) + "hz", totalMs);
+        recordMetric("fixed_step_worst_frame_ms_at_" + std::to_string(renderRate) + "hz", worstFrameMs);
+    }
+
+    // A hitch never costs more than the catch-up budget.
+    vkengine::GameEngine engine;
+    buildScene(engine);
+    engine.update(1.0f / 60.0f);
+    const double hitchMs = measureMillis([&]() { engine.update(0.5f); });
+    EXPECT_EQ(engine.ticksLastUpdate(), engine.fixedTimestep().maxTicksPerUpdate);
+    recordMetric("fixed_step_hitch_update_ms", hitchMs);
+
+    const double spread = maxMs / std::max(1.0e-3, minMs);
+    RecordProperty("fixed_step_cost_spread", spread);
+    recordMetric("fixed_step_cost_spread", spread);
+    const float thresholdSpread = envFloatOrDefault("VKENGINE_FIXED_STEP_COST_SPREAD", 1.5f);
+    EXPECT_LE(spread, thresholdSpread) << "Simulation cost varied with render rate."
+                                       << " spread=" << spread << " threshold=" << thresholdSpread;
+}
+
 TEST(PerformanceTests, LightCreationPipeline) {
     vkengine::GameEngine engine;
     auto& scene = engine.scene();